@@ -1,10 +1,4 @@
-#include <cstdint>
-#include <execution>
-#include <fstream>
-#include <functional>
-#include <iostream>
 #include <string>
-#include <string_view>
 
 #include "util/load.h"
 
@@ -27,34 +21,13 @@ void aka_name() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(name);
-  DECLARE_NULL_ENUM_COL(imdb_index);
-  DECLARE_NULL_ENUM_COL(name_pcode_cf);
-  DECLARE_NULL_ENUM_COL(name_pcode_nf);
-  DECLARE_NULL_ENUM_COL(surname_pcode);
-  DECLARE_NULL_ENUM_COL(md5sum);
-
-  std::ifstream fin(raw + "aka_name.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 8);
-
-    APPEND_NOT_NULL_ENUM(name, data[2], tuple_idx);
-    APPEND_NULL_ENUM(imdb_index, data[3], tuple_idx);
-    APPEND_NULL_ENUM(name_pcode_cf, data[4], tuple_idx);
-    APPEND_NULL_ENUM(name_pcode_nf, data[5], tuple_idx);
-    APPEND_NULL_ENUM(surname_pcode, data[6], tuple_idx);
-    APPEND_NULL_ENUM(md5sum, data[7], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(name, dest, "akan_name_enum");
-  SERIALIZE_NULL_ENUM(imdb_index, dest, "akan_imdb_index_enum");
-  SERIALIZE_NULL_ENUM(name_pcode_cf, dest, "akan_name_pcode_cf_enum");
-  SERIALIZE_NULL_ENUM(name_pcode_nf, dest, "akan_name_pcode_nf_enum");
-  SERIALIZE_NULL_ENUM(surname_pcode, dest, "akan_surname_pcode_enum");
-  SERIALIZE_NULL_ENUM(md5sum, dest, "akan_md5sum_enum");
+  LoadTable(raw + "aka_name.csv", ',', dest,
+            {NotNullColumn(2, "akan_name_enum", LoadType::ENUM),
+             NullColumn(3, "akan_imdb_index_enum", LoadType::ENUM),
+             NullColumn(4, "akan_name_pcode_cf_enum", LoadType::ENUM),
+             NullColumn(5, "akan_name_pcode_nf_enum", LoadType::ENUM),
+             NullColumn(6, "akan_surname_pcode_enum", LoadType::ENUM),
+             NullColumn(7, "akan_md5sum_enum", LoadType::ENUM)});
   Print("aka_name complete");
 }
 
@@ -76,31 +49,12 @@ void aka_title() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(title);
-  DECLARE_NULL_ENUM_COL(imdb_index);
-  DECLARE_NULL_ENUM_COL(phonetic_code);
-  DECLARE_NULL_ENUM_COL(note);
-  DECLARE_NULL_ENUM_COL(md5sum);
-
-  std::ifstream fin(raw + "aka_title.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 12);
-
-    APPEND_NOT_NULL_ENUM(title, data[2], tuple_idx);
-    APPEND_NULL_ENUM(imdb_index, data[3], tuple_idx);
-    APPEND_NULL_ENUM(phonetic_code, data[6], tuple_idx);
-    APPEND_NULL_ENUM(note, data[10], tuple_idx);
-    APPEND_NULL_ENUM(md5sum, data[11], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(title, dest, "akat_title_enum");
-  SERIALIZE_NULL_ENUM(imdb_index, dest, "akat_imdb_index_enum");
-  SERIALIZE_NULL_ENUM(phonetic_code, dest, "akat_phonetic_code_enum");
-  SERIALIZE_NULL_ENUM(note, dest, "akat_note_enum");
-  SERIALIZE_NULL_ENUM(md5sum, dest, "akat_md5sum_enum");
+  LoadTable(raw + "aka_title.csv", ',', dest,
+            {NotNullColumn(2, "akat_title_enum", LoadType::ENUM),
+             NullColumn(3, "akat_imdb_index_enum", LoadType::ENUM),
+             NullColumn(6, "akat_phonetic_code_enum", LoadType::ENUM),
+             NullColumn(10, "akat_note_enum", LoadType::ENUM),
+             NullColumn(11, "akat_md5sum_enum", LoadType::ENUM)});
   Print("aka_title complete");
 }
 
@@ -117,19 +71,8 @@ void cast_info() {
     );
   */
 
-  DECLARE_NULL_ENUM_COL(note);
-
-  std::ifstream fin(raw + "cast_info.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 7);
-
-    APPEND_NULL_ENUM(note, data[4], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NULL_ENUM(note, dest, "ci_note_enum");
+  LoadTable(raw + "cast_info.csv", ',', dest,
+            {NullColumn(4, "ci_note_enum", LoadType::ENUM)});
   Print("cast_info complete");
 }
 
@@ -146,31 +89,12 @@ void char_name() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(name);
-  DECLARE_NULL_ENUM_COL(imdb_index);
-  DECLARE_NULL_ENUM_COL(name_pcode_nf);
-  DECLARE_NULL_ENUM_COL(surname_pcode);
-  DECLARE_NULL_ENUM_COL(md5sum);
-
-  std::ifstream fin(raw + "char_name.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 7);
-
-    APPEND_NOT_NULL_ENUM(name, data[1], tuple_idx);
-    APPEND_NULL_ENUM(imdb_index, data[2], tuple_idx);
-    APPEND_NULL_ENUM(name_pcode_nf, data[4], tuple_idx);
-    APPEND_NULL_ENUM(surname_pcode, data[5], tuple_idx);
-    APPEND_NULL_ENUM(md5sum, data[6], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(name, dest, "cn_name_enum");
-  SERIALIZE_NULL_ENUM(imdb_index, dest, "cn_imdb_index_enum");
-  SERIALIZE_NULL_ENUM(name_pcode_nf, dest, "cn_name_pcode_nf_enum");
-  SERIALIZE_NULL_ENUM(surname_pcode, dest, "cn_surname_pcode_enum");
-  SERIALIZE_NULL_ENUM(md5sum, dest, "cn_md5sum_enum");
+  LoadTable(raw + "char_name.csv", ',', dest,
+            {NotNullColumn(1, "cn_name_enum", LoadType::ENUM),
+             NullColumn(2, "cn_imdb_index_enum", LoadType::ENUM),
+             NullColumn(4, "cn_name_pcode_nf_enum", LoadType::ENUM),
+             NullColumn(5, "cn_surname_pcode_enum", LoadType::ENUM),
+             NullColumn(6, "cn_md5sum_enum", LoadType::ENUM)});
   Print("char_name complete");
 }
 
@@ -182,19 +106,8 @@ void comp_cast_type() {
     );
   */
 
-  DECLARE_NULL_ENUM_COL(kind);
-
-  std::ifstream fin(raw + "comp_cast_type.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 2);
-
-    APPEND_NULL_ENUM(kind, data[1], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NULL_ENUM(kind, dest, "cct_kind_enum");
+  LoadTable(raw + "comp_cast_type.csv", ',', dest,
+            {NullColumn(1, "cct_kind_enum", LoadType::ENUM)});
   Print("comp_cast_type complete");
 }
 
@@ -211,31 +124,12 @@ void company_name() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(name);
-  DECLARE_NULL_ENUM_COL(country_code);
-  DECLARE_NULL_ENUM_COL(name_pcode_nf);
-  DECLARE_NULL_ENUM_COL(name_pcode_sf);
-  DECLARE_NULL_ENUM_COL(md5sum);
-
-  std::ifstream fin(raw + "company_name.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 7);
-
-    APPEND_NOT_NULL_ENUM(name, data[1], tuple_idx);
-    APPEND_NULL_ENUM(country_code, data[2], tuple_idx);
-    APPEND_NULL_ENUM(name_pcode_nf, data[4], tuple_idx);
-    APPEND_NULL_ENUM(name_pcode_sf, data[5], tuple_idx);
-    APPEND_NULL_ENUM(md5sum, data[6], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(name, dest, "cmpn_name_enum");
-  SERIALIZE_NULL_ENUM(country_code, dest, "cmpn_country_code_enum");
-  SERIALIZE_NULL_ENUM(name_pcode_nf, dest, "cmpn_name_pcode_nf_enum");
-  SERIALIZE_NULL_ENUM(name_pcode_sf, dest, "cmpn_surname_pcode_enum");
-  SERIALIZE_NULL_ENUM(md5sum, dest, "cmpn_md5sum_enum");
+  LoadTable(raw + "company_name.csv", ',', dest,
+            {NotNullColumn(1, "cmpn_name_enum", LoadType::ENUM),
+             NullColumn(2, "cmpn_country_code_enum", LoadType::ENUM),
+             NullColumn(4, "cmpn_name_pcode_nf_enum", LoadType::ENUM),
+             NullColumn(5, "cmpn_surname_pcode_enum", LoadType::ENUM),
+             NullColumn(6, "cmpn_md5sum_enum", LoadType::ENUM)});
   Print("company_name complete");
 }
 
@@ -247,19 +141,8 @@ void company_type() {
     );
   */
 
-  DECLARE_NULL_ENUM_COL(kind);
-
-  std::ifstream fin(raw + "company_type.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 2);
-
-    APPEND_NULL_ENUM(kind, data[1], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NULL_ENUM(kind, dest, "ct_kind_enum");
+  LoadTable(raw + "company_type.csv", ',', dest,
+            {NullColumn(1, "ct_kind_enum", LoadType::ENUM)});
   Print("company_type complete");
 }
 
@@ -271,19 +154,8 @@ void info_type() {
     );
   */
 
-  DECLARE_NULL_ENUM_COL(info);
-
-  std::ifstream fin(raw + "info_type.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 2);
-
-    APPEND_NULL_ENUM(info, data[1], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NULL_ENUM(info, dest, "it_info_enum");
+  LoadTable(raw + "info_type.csv", ',', dest,
+            {NullColumn(1, "it_info_enum", LoadType::ENUM)});
   Print("info_type complete");
 }
 
@@ -296,22 +168,9 @@ void keyword() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(keyword);
-  DECLARE_NULL_ENUM_COL(phonetic_code);
-
-  std::ifstream fin(raw + "keyword.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 3);
-
-    APPEND_NOT_NULL_ENUM(keyword, data[1], tuple_idx);
-    APPEND_NULL_ENUM(phonetic_code, data[2], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(keyword, dest, "k_keyword_enum");
-  SERIALIZE_NULL_ENUM(phonetic_code, dest, "k_phonetic_code_enum");
+  LoadTable(raw + "keyword.csv", ',', dest,
+            {NotNullColumn(1, "k_keyword_enum", LoadType::ENUM),
+             NullColumn(2, "k_phonetic_code_enum", LoadType::ENUM)});
   Print("keyword complete");
 }
 
@@ -323,19 +182,8 @@ void kind_type() {
     );
   */
 
-  DECLARE_NULL_ENUM_COL(kind);
-
-  std::ifstream fin(raw + "kind_type.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 2);
-
-    APPEND_NULL_ENUM(kind, data[1], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NULL_ENUM(kind, dest, "kt_kind_enum");
+  LoadTable(raw + "kind_type.csv", ',', dest,
+            {NullColumn(1, "kt_kind_enum", LoadType::ENUM)});
   Print("kind_type complete");
 }
 
@@ -347,19 +195,8 @@ void link_type() {
     );
   */
 
-  DECLARE_NULL_ENUM_COL(link);
-
-  std::ifstream fin(raw + "link_type.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 2);
-
-    APPEND_NULL_ENUM(link, data[1], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NULL_ENUM(link, dest, "lt_link_enum");
+  LoadTable(raw + "link_type.csv", ',', dest,
+            {NullColumn(1, "lt_link_enum", LoadType::ENUM)});
   Print("link_type complete");
 }
 
@@ -374,19 +211,8 @@ void movie_companies() {
     );
   */
 
-  DECLARE_NULL_ENUM_COL(note);
-
-  std::ifstream fin(raw + "movie_companies.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 5);
-
-    APPEND_NULL_ENUM(note, data[4], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NULL_ENUM(note, dest, "mc_note_enum");
+  LoadTable(raw + "movie_companies.csv", ',', dest,
+            {NullColumn(4, "mc_note_enum", LoadType::ENUM)});
   Print("movie_companies complete");
 }
 
@@ -401,22 +227,9 @@ void movie_info() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(info);
-  DECLARE_NULL_ENUM_COL(note);
-
-  std::ifstream fin(raw + "movie_info.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 5);
-
-    APPEND_NOT_NULL_ENUM(info, data[3], tuple_idx);
-    APPEND_NULL_ENUM(note, data[4], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(info, dest, "mi_info_enum");
-  SERIALIZE_NULL_ENUM(note, dest, "mi_note_enum");
+  LoadTable(raw + "movie_info.csv", ',', dest,
+            {NotNullColumn(3, "mi_info_enum", LoadType::ENUM),
+             NullColumn(4, "mi_note_enum", LoadType::ENUM)});
   Print("movie_info complete");
 }
 
@@ -431,22 +244,9 @@ void movie_info_idx() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(info);
-  DECLARE_NULL_ENUM_COL(note);
-
-  std::ifstream fin(raw + "movie_info_idx.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 5);
-
-    APPEND_NOT_NULL_ENUM(info, data[3], tuple_idx);
-    APPEND_NULL_ENUM(note, data[4], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(info, dest, "mii_info_enum");
-  SERIALIZE_NULL_ENUM(note, dest, "mii_note_enum");
+  LoadTable(raw + "movie_info_idx.csv", ',', dest,
+            {NotNullColumn(3, "mii_info_enum", LoadType::ENUM),
+             NullColumn(4, "mii_note_enum", LoadType::ENUM)});
   Print("movie_info_idx complete");
 }
 
@@ -465,37 +265,14 @@ void name() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(name);
-  DECLARE_NULL_ENUM_COL(imdb_index);
-  DECLARE_NULL_ENUM_COL(gender);
-  DECLARE_NULL_ENUM_COL(name_pcode_cf);
-  DECLARE_NULL_ENUM_COL(name_pcode_nf);
-  DECLARE_NULL_ENUM_COL(surname_pcode);
-  DECLARE_NULL_ENUM_COL(md5sum);
-
-  std::ifstream fin(raw + "name.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 9);
-
-    APPEND_NOT_NULL_ENUM(name, data[1], tuple_idx);
-    APPEND_NULL_ENUM(imdb_index, data[2], tuple_idx);
-    APPEND_NULL_ENUM(gender, data[4], tuple_idx);
-    APPEND_NULL_ENUM(name_pcode_cf, data[5], tuple_idx);
-    APPEND_NULL_ENUM(name_pcode_nf, data[6], tuple_idx);
-    APPEND_NULL_ENUM(surname_pcode, data[7], tuple_idx);
-    APPEND_NULL_ENUM(md5sum, data[8], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(name, dest, "n_name_enum");
-  SERIALIZE_NULL_ENUM(imdb_index, dest, "n_imdb_index_enum");
-  SERIALIZE_NULL_ENUM(gender, dest, "n_gender_enum");
-  SERIALIZE_NULL_ENUM(name_pcode_cf, dest, "n_name_pcode_cf_enum");
-  SERIALIZE_NULL_ENUM(name_pcode_nf, dest, "n_name_pcode_nf_enum");
-  SERIALIZE_NULL_ENUM(surname_pcode, dest, "n_surname_pcode_enum");
-  SERIALIZE_NULL_ENUM(md5sum, dest, "n_md5sum_enum");
+  LoadTable(raw + "name.csv", ',', dest,
+            {NotNullColumn(1, "n_name_enum", LoadType::ENUM),
+             NullColumn(2, "n_imdb_index_enum", LoadType::ENUM),
+             NullColumn(4, "n_gender_enum", LoadType::ENUM),
+             NullColumn(5, "n_name_pcode_cf_enum", LoadType::ENUM),
+             NullColumn(6, "n_name_pcode_nf_enum", LoadType::ENUM),
+             NullColumn(7, "n_surname_pcode_enum", LoadType::ENUM),
+             NullColumn(8, "n_md5sum_enum", LoadType::ENUM)});
   Print("name complete");
 }
 
@@ -510,22 +287,9 @@ void person_info() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(info);
-  DECLARE_NULL_ENUM_COL(note);
-
-  std::ifstream fin(raw + "person_info.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 5);
-
-    APPEND_NOT_NULL_ENUM(info, data[3], tuple_idx);
-    APPEND_NULL_ENUM(note, data[4], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(info, dest, "pi_info_enum");
-  SERIALIZE_NULL_ENUM(note, dest, "pi_note_enum");
+  LoadTable(raw + "person_info.csv", ',', dest,
+            {NotNullColumn(3, "pi_info_enum", LoadType::ENUM),
+             NullColumn(4, "pi_note_enum", LoadType::ENUM)});
   Print("person_info complete");
 }
 
@@ -537,19 +301,8 @@ void role_type() {
     );
   */
 
-  DECLARE_NULL_ENUM_COL(role);
-
-  std::ifstream fin(raw + "role_type.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 2);
-
-    APPEND_NULL_ENUM(role, data[1], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NULL_ENUM(role, dest, "r_role_enum");
+  LoadTable(raw + "role_type.csv", ',', dest,
+            {NullColumn(1, "r_role_enum", LoadType::ENUM)});
   Print("role_type complete");
 }
 
@@ -571,31 +324,12 @@ void title() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(title);
-  DECLARE_NULL_ENUM_COL(imdb_index);
-  DECLARE_NULL_ENUM_COL(phonetic_code);
-  DECLARE_NULL_ENUM_COL(series_years);
-  DECLARE_NULL_ENUM_COL(md5sum);
-
-  std::ifstream fin(raw + "title.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 12);
-
-    APPEND_NOT_NULL_ENUM(title, data[1], tuple_idx);
-    APPEND_NULL_ENUM(imdb_index, data[2], tuple_idx);
-    APPEND_NULL_ENUM(phonetic_code, data[6], tuple_idx);
-    APPEND_NULL_ENUM(series_years, data[10], tuple_idx);
-    APPEND_NULL_ENUM(md5sum, data[11], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(title, dest, "t_title_enum");
-  SERIALIZE_NULL_ENUM(imdb_index, dest, "t_imdb_index_enum");
-  SERIALIZE_NULL_ENUM(phonetic_code, dest, "t_phonetic_code_enum");
-  SERIALIZE_NULL_ENUM(series_years, dest, "t_series_years_enum");
-  SERIALIZE_NULL_ENUM(md5sum, dest, "t_md5sum_enum");
+  LoadTable(raw + "title.csv", ',', dest,
+            {NotNullColumn(1, "t_title_enum", LoadType::ENUM),
+             NullColumn(2, "t_imdb_index_enum", LoadType::ENUM),
+             NullColumn(6, "t_phonetic_code_enum", LoadType::ENUM),
+             NullColumn(10, "t_series_years_enum", LoadType::ENUM),
+             NullColumn(11, "t_md5sum_enum", LoadType::ENUM)});
   Print("title complete");
 }
 
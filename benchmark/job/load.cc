@@ -1,12 +1,6 @@
 #include "util/load.h"
 
-#include <cstdint>
-#include <execution>
-#include <fstream>
-#include <functional>
-#include <iostream>
 #include <string>
-#include <string_view>
 
 using namespace kush::util;
 
@@ -27,40 +21,15 @@ void aka_name() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NOT_NULL_COL(int32_t, person_id);
-  DECLARE_NOT_NULL_COL(std::string, name);
-  DECLARE_NULL_COL(std::string, imdb_index);
-  DECLARE_NULL_COL(std::string, name_pcode_cf);
-  DECLARE_NULL_COL(std::string, name_pcode_nf);
-  DECLARE_NULL_COL(std::string, surname_pcode);
-  DECLARE_NULL_COL(std::string, md5sum);
-
-  std::ifstream fin(raw + "aka_name.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 8);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NOT_NULL(person_id, ParseInt32, data[1], tuple_idx);
-    APPEND_NOT_NULL(name, ParseString, data[2], tuple_idx);
-    APPEND_NULL(imdb_index, ParseString, data[3], tuple_idx);
-    APPEND_NULL(name_pcode_cf, ParseString, data[4], tuple_idx);
-    APPEND_NULL(name_pcode_nf, ParseString, data[5], tuple_idx);
-    APPEND_NULL(surname_pcode, ParseString, data[6], tuple_idx);
-    APPEND_NULL(md5sum, ParseString, data[7], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "akan_id");
-  SERIALIZE_NOT_NULL(int32_t, person_id, dest, "akan_person_id");
-  SERIALIZE_NOT_NULL(std::string, name, dest, "akan_name");
-  SERIALIZE_NULL(std::string, imdb_index, dest, "akan_imdb_index");
-  SERIALIZE_NULL(std::string, name_pcode_cf, dest, "akan_name_pcode_cf");
-  SERIALIZE_NULL(std::string, name_pcode_nf, dest, "akan_name_pcode_nf");
-  SERIALIZE_NULL(std::string, surname_pcode, dest, "akan_surname_pcode");
-  SERIALIZE_NULL(std::string, md5sum, dest, "akan_md5sum");
+  LoadTable(raw + "aka_name.csv", ',', dest,
+            {NotNullColumn(0, "akan_id", LoadType::INT32),
+             NotNullColumn(1, "akan_person_id", LoadType::INT32),
+             NotNullColumn(2, "akan_name", LoadType::TEXT),
+             NullColumn(3, "akan_imdb_index", LoadType::TEXT),
+             NullColumn(4, "akan_name_pcode_cf", LoadType::TEXT),
+             NullColumn(5, "akan_name_pcode_nf", LoadType::TEXT),
+             NullColumn(6, "akan_surname_pcode", LoadType::TEXT),
+             NullColumn(7, "akan_md5sum", LoadType::TEXT)});
   Print("aka_name complete");
 }
 
@@ -82,52 +51,19 @@ void aka_title() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NOT_NULL_COL(int32_t, movie_id);
-  DECLARE_NOT_NULL_COL(std::string, title);
-  DECLARE_NULL_COL(std::string, imdb_index);
-  DECLARE_NOT_NULL_COL(int32_t, kind_id);
-  DECLARE_NULL_COL(int32_t, production_year);
-  DECLARE_NULL_COL(std::string, phonetic_code);
-  DECLARE_NULL_COL(int32_t, episode_of_id);
-  DECLARE_NULL_COL(int32_t, season_nr);
-  DECLARE_NULL_COL(int32_t, episode_nr);
-  DECLARE_NULL_COL(std::string, note);
-  DECLARE_NULL_COL(std::string, md5sum);
-
-  std::ifstream fin(raw + "aka_title.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 12);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NOT_NULL(movie_id, ParseInt32, data[1], tuple_idx);
-    APPEND_NOT_NULL(title, ParseString, data[2], tuple_idx);
-    APPEND_NULL(imdb_index, ParseString, data[3], tuple_idx);
-    APPEND_NOT_NULL(kind_id, ParseInt32, data[4], tuple_idx);
-    APPEND_NULL(production_year, ParseInt32, data[5], tuple_idx);
-    APPEND_NULL(phonetic_code, ParseString, data[6], tuple_idx);
-    APPEND_NULL(episode_of_id, ParseInt32, data[7], tuple_idx);
-    APPEND_NULL(season_nr, ParseInt32, data[8], tuple_idx);
-    APPEND_NULL(episode_nr, ParseInt32, data[9], tuple_idx);
-    APPEND_NULL(note, ParseString, data[10], tuple_idx);
-    APPEND_NULL(md5sum, ParseString, data[11], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "akat_id");
-  SERIALIZE_NOT_NULL(int32_t, movie_id, dest, "akat_movie_id");
-  SERIALIZE_NOT_NULL(std::string, title, dest, "akat_title");
-  SERIALIZE_NULL(std::string, imdb_index, dest, "akat_imdb_index");
-  SERIALIZE_NOT_NULL(int32_t, kind_id, dest, "akat_kind_id");
-  SERIALIZE_NULL(int32_t, production_year, dest, "akat_production_year");
-  SERIALIZE_NULL(std::string, phonetic_code, dest, "akat_phonetic_code");
-  SERIALIZE_NULL(int32_t, episode_of_id, dest, "akat_episode_of_id");
-  SERIALIZE_NULL(int32_t, season_nr, dest, "akat_season_nr");
-  SERIALIZE_NULL(int32_t, episode_nr, dest, "akat_episode_nr");
-  SERIALIZE_NULL(std::string, note, dest, "akat_note");
-  SERIALIZE_NULL(std::string, md5sum, dest, "akat_md5sum");
+  LoadTable(raw + "aka_title.csv", ',', dest,
+            {NotNullColumn(0, "akat_id", LoadType::INT32),
+             NotNullColumn(1, "akat_movie_id", LoadType::INT32),
+             NotNullColumn(2, "akat_title", LoadType::TEXT),
+             NullColumn(3, "akat_imdb_index", LoadType::TEXT),
+             NotNullColumn(4, "akat_kind_id", LoadType::INT32),
+             NullColumn(5, "akat_production_year", LoadType::INT32),
+             NullColumn(6, "akat_phonetic_code", LoadType::TEXT),
+             NullColumn(7, "akat_episode_of_id", LoadType::INT32),
+             NullColumn(8, "akat_season_nr", LoadType::INT32),
+             NullColumn(9, "akat_episode_nr", LoadType::INT32),
+             NullColumn(10, "akat_note", LoadType::TEXT),
+             NullColumn(11, "akat_md5sum", LoadType::TEXT)});
   Print("aka_title complete");
 }
 
@@ -144,37 +80,14 @@ void cast_info() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NOT_NULL_COL(int32_t, person_id);
-  DECLARE_NOT_NULL_COL(int32_t, movie_id);
-  DECLARE_NULL_COL(int32_t, person_role_id);
-  DECLARE_NULL_COL(std::string, note);
-  DECLARE_NULL_COL(int32_t, nr_order);
-  DECLARE_NOT_NULL_COL(int32_t, role_id);
-
-  std::ifstream fin(raw + "cast_info.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 7);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NOT_NULL(person_id, ParseInt32, data[1], tuple_idx);
-    APPEND_NOT_NULL(movie_id, ParseInt32, data[2], tuple_idx);
-    APPEND_NULL(person_role_id, ParseInt32, data[3], tuple_idx);
-    APPEND_NULL(note, ParseString, data[4], tuple_idx);
-    APPEND_NULL(nr_order, ParseInt32, data[5], tuple_idx);
-    APPEND_NOT_NULL(role_id, ParseInt32, data[6], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "ci_id");
-  SERIALIZE_NOT_NULL(int32_t, person_id, dest, "ci_person_id");
-  SERIALIZE_NOT_NULL(int32_t, movie_id, dest, "ci_movie_id");
-  SERIALIZE_NULL(int32_t, person_role_id, dest, "ci_person_role_id");
-  SERIALIZE_NULL(std::string, note, dest, "ci_note");
-  SERIALIZE_NULL(int32_t, nr_order, dest, "ci_nr_order");
-  SERIALIZE_NOT_NULL(int32_t, role_id, dest, "ci_role_id");
+  LoadTable(raw + "cast_info.csv", ',', dest,
+            {NotNullColumn(0, "ci_id", LoadType::INT32),
+             NotNullColumn(1, "ci_person_id", LoadType::INT32),
+             NotNullColumn(2, "ci_movie_id", LoadType::INT32),
+             NullColumn(3, "ci_person_role_id", LoadType::INT32),
+             NullColumn(4, "ci_note", LoadType::TEXT),
+             NullColumn(5, "ci_nr_order", LoadType::INT32),
+             NotNullColumn(6, "ci_role_id", LoadType::INT32)});
   Print("cast_info complete");
 }
 
@@ -191,37 +104,14 @@ void char_name() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NOT_NULL_COL(std::string, name);
-  DECLARE_NULL_COL(std::string, imdb_index);
-  DECLARE_NULL_COL(int32_t, imdb_id);
-  DECLARE_NULL_COL(std::string, name_pcode_nf);
-  DECLARE_NULL_COL(std::string, surname_pcode);
-  DECLARE_NULL_COL(std::string, md5sum);
-
-  std::ifstream fin(raw + "char_name.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 7);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NOT_NULL(name, ParseString, data[1], tuple_idx);
-    APPEND_NULL(imdb_index, ParseString, data[2], tuple_idx);
-    APPEND_NULL(imdb_id, ParseInt32, data[3], tuple_idx);
-    APPEND_NULL(name_pcode_nf, ParseString, data[4], tuple_idx);
-    APPEND_NULL(surname_pcode, ParseString, data[5], tuple_idx);
-    APPEND_NULL(md5sum, ParseString, data[6], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "cn_id");
-  SERIALIZE_NOT_NULL(std::string, name, dest, "cn_name");
-  SERIALIZE_NULL(std::string, imdb_index, dest, "cn_imdb_index");
-  SERIALIZE_NULL(int32_t, imdb_id, dest, "cn_imdb_id");
-  SERIALIZE_NULL(std::string, name_pcode_nf, dest, "cn_name_pcode_nf");
-  SERIALIZE_NULL(std::string, surname_pcode, dest, "cn_surname_pcode");
-  SERIALIZE_NULL(std::string, md5sum, dest, "cn_md5sum");
+  LoadTable(raw + "char_name.csv", ',', dest,
+            {NotNullColumn(0, "cn_id", LoadType::INT32),
+             NotNullColumn(1, "cn_name", LoadType::TEXT),
+             NullColumn(2, "cn_imdb_index", LoadType::TEXT),
+             NullColumn(3, "cn_imdb_id", LoadType::INT32),
+             NullColumn(4, "cn_name_pcode_nf", LoadType::TEXT),
+             NullColumn(5, "cn_surname_pcode", LoadType::TEXT),
+             NullColumn(6, "cn_md5sum", LoadType::TEXT)});
   Print("char_name complete");
 }
 
@@ -233,22 +123,9 @@ void comp_cast_type() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NULL_COL(std::string, kind);
-
-  std::ifstream fin(raw + "comp_cast_type.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 2);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NULL(kind, ParseString, data[1], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "cct_id");
-  SERIALIZE_NULL(std::string, kind, dest, "cct_kind");
+  LoadTable(raw + "comp_cast_type.csv", ',', dest,
+            {NotNullColumn(0, "cct_id", LoadType::INT32),
+             NullColumn(1, "cct_kind", LoadType::TEXT)});
   Print("comp_cast_type complete");
 }
 
@@ -265,37 +142,14 @@ void company_name() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NOT_NULL_COL(std::string, name);
-  DECLARE_NULL_COL(std::string, country_code);
-  DECLARE_NULL_COL(int32_t, imdb_id);
-  DECLARE_NULL_COL(std::string, name_pcode_nf);
-  DECLARE_NULL_COL(std::string, name_pcode_sf);
-  DECLARE_NULL_COL(std::string, md5sum);
-
-  std::ifstream fin(raw + "company_name.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 7);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NOT_NULL(name, ParseString, data[1], tuple_idx);
-    APPEND_NULL(country_code, ParseString, data[2], tuple_idx);
-    APPEND_NULL(imdb_id, ParseInt32, data[3], tuple_idx);
-    APPEND_NULL(name_pcode_nf, ParseString, data[4], tuple_idx);
-    APPEND_NULL(name_pcode_sf, ParseString, data[5], tuple_idx);
-    APPEND_NULL(md5sum, ParseString, data[6], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "cmpn_id");
-  SERIALIZE_NOT_NULL(std::string, name, dest, "cmpn_name");
-  SERIALIZE_NULL(std::string, country_code, dest, "cmpn_country_code");
-  SERIALIZE_NULL(int32_t, imdb_id, dest, "cmpn_imdb_id");
-  SERIALIZE_NULL(std::string, name_pcode_nf, dest, "cmpn_name_pcode_nf");
-  SERIALIZE_NULL(std::string, name_pcode_sf, dest, "cmpn_surname_pcode");
-  SERIALIZE_NULL(std::string, md5sum, dest, "cmpn_md5sum");
+  LoadTable(raw + "company_name.csv", ',', dest,
+            {NotNullColumn(0, "cmpn_id", LoadType::INT32),
+             NotNullColumn(1, "cmpn_name", LoadType::TEXT),
+             NullColumn(2, "cmpn_country_code", LoadType::TEXT),
+             NullColumn(3, "cmpn_imdb_id", LoadType::INT32),
+             NullColumn(4, "cmpn_name_pcode_nf", LoadType::TEXT),
+             NullColumn(5, "cmpn_surname_pcode", LoadType::TEXT),
+             NullColumn(6, "cmpn_md5sum", LoadType::TEXT)});
   Print("company_name complete");
 }
 
@@ -307,22 +161,9 @@ void company_type() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NULL_COL(std::string, kind);
-
-  std::ifstream fin(raw + "company_type.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 2);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NULL(kind, ParseString, data[1], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "ct_id");
-  SERIALIZE_NULL(std::string, kind, dest, "ct_kind");
+  LoadTable(raw + "company_type.csv", ',', dest,
+            {NotNullColumn(0, "ct_id", LoadType::INT32),
+             NullColumn(1, "ct_kind", LoadType::TEXT)});
   Print("company_type complete");
 }
 
@@ -336,28 +177,11 @@ void complete_cast() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NULL_COL(int32_t, movie_id);
-  DECLARE_NOT_NULL_COL(int32_t, subject_id);
-  DECLARE_NOT_NULL_COL(int32_t, status_id);
-
-  std::ifstream fin(raw + "complete_cast.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 4);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NULL(movie_id, ParseInt32, data[1], tuple_idx);
-    APPEND_NOT_NULL(subject_id, ParseInt32, data[2], tuple_idx);
-    APPEND_NOT_NULL(status_id, ParseInt32, data[3], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "cc_id");
-  SERIALIZE_NULL(int32_t, movie_id, dest, "cc_movie_id");
-  SERIALIZE_NOT_NULL(int32_t, subject_id, dest, "cc_subject_id");
-  SERIALIZE_NOT_NULL(int32_t, status_id, dest, "cc_status_id");
+  LoadTable(raw + "complete_cast.csv", ',', dest,
+            {NotNullColumn(0, "cc_id", LoadType::INT32),
+             NullColumn(1, "cc_movie_id", LoadType::INT32),
+             NotNullColumn(2, "cc_subject_id", LoadType::INT32),
+             NotNullColumn(3, "cc_status_id", LoadType::INT32)});
   Print("complete_cast complete");
 }
 
@@ -369,22 +193,9 @@ void info_type() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NULL_COL(std::string, info);
-
-  std::ifstream fin(raw + "info_type.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 2);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NULL(info, ParseString, data[1], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "it_id");
-  SERIALIZE_NULL(std::string, info, dest, "it_info");
+  LoadTable(raw + "info_type.csv", ',', dest,
+            {NotNullColumn(0, "it_id", LoadType::INT32),
+             NullColumn(1, "it_info", LoadType::TEXT)});
   Print("info_type complete");
 }
 
@@ -397,25 +208,10 @@ void keyword() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NOT_NULL_COL(std::string, keyword);
-  DECLARE_NULL_COL(std::string, phonetic_code);
-
-  std::ifstream fin(raw + "keyword.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 3);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NOT_NULL(keyword, ParseString, data[1], tuple_idx);
-    APPEND_NULL(phonetic_code, ParseString, data[2], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "k_id");
-  SERIALIZE_NOT_NULL(std::string, keyword, dest, "k_keyword");
-  SERIALIZE_NULL(std::string, phonetic_code, dest, "k_phonetic_code");
+  LoadTable(raw + "keyword.csv", ',', dest,
+            {NotNullColumn(0, "k_id", LoadType::INT32),
+             NotNullColumn(1, "k_keyword", LoadType::TEXT),
+             NullColumn(2, "k_phonetic_code", LoadType::TEXT)});
   Print("keyword complete");
 }
 
@@ -427,22 +223,9 @@ void kind_type() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NULL_COL(std::string, kind);
-
-  std::ifstream fin(raw + "kind_type.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 2);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NULL(kind, ParseString, data[1], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "kt_id");
-  SERIALIZE_NULL(std::string, kind, dest, "kt_kind");
+  LoadTable(raw + "kind_type.csv", ',', dest,
+            {NotNullColumn(0, "kt_id", LoadType::INT32),
+             NullColumn(1, "kt_kind", LoadType::TEXT)});
   Print("kind_type complete");
 }
 
@@ -454,22 +237,9 @@ void link_type() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NULL_COL(std::string, link);
-
-  std::ifstream fin(raw + "link_type.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 2);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NULL(link, ParseString, data[1], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "lt_id");
-  SERIALIZE_NULL(std::string, link, dest, "lt_link");
+  LoadTable(raw + "link_type.csv", ',', dest,
+            {NotNullColumn(0, "lt_id", LoadType::INT32),
+             NullColumn(1, "lt_link", LoadType::TEXT)});
   Print("link_type complete");
 }
 
@@ -484,31 +254,12 @@ void movie_companies() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NOT_NULL_COL(int32_t, movie_id);
-  DECLARE_NOT_NULL_COL(int32_t, company_id);
-  DECLARE_NOT_NULL_COL(int32_t, company_type_id);
-  DECLARE_NULL_COL(std::string, note);
-
-  std::ifstream fin(raw + "movie_companies.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 5);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NOT_NULL(movie_id, ParseInt32, data[1], tuple_idx);
-    APPEND_NOT_NULL(company_id, ParseInt32, data[2], tuple_idx);
-    APPEND_NOT_NULL(company_type_id, ParseInt32, data[3], tuple_idx);
-    APPEND_NULL(note, ParseString, data[4], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "mc_id");
-  SERIALIZE_NOT_NULL(int32_t, movie_id, dest, "mc_movie_id");
-  SERIALIZE_NOT_NULL(int32_t, company_id, dest, "mc_company_id");
-  SERIALIZE_NOT_NULL(int32_t, company_type_id, dest, "mc_company_type_id");
-  SERIALIZE_NULL(std::string, note, dest, "mc_note");
+  LoadTable(raw + "movie_companies.csv", ',', dest,
+            {NotNullColumn(0, "mc_id", LoadType::INT32),
+             NotNullColumn(1, "mc_movie_id", LoadType::INT32),
+             NotNullColumn(2, "mc_company_id", LoadType::INT32),
+             NotNullColumn(3, "mc_company_type_id", LoadType::INT32),
+             NullColumn(4, "mc_note", LoadType::TEXT)});
   Print("movie_companies complete");
 }
 
@@ -523,31 +274,12 @@ void movie_info() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NOT_NULL_COL(int32_t, movie_id);
-  DECLARE_NOT_NULL_COL(int32_t, info_type_id);
-  DECLARE_NOT_NULL_COL(std::string, info);
-  DECLARE_NULL_COL(std::string, note);
-
-  std::ifstream fin(raw + "movie_info.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 5);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NOT_NULL(movie_id, ParseInt32, data[1], tuple_idx);
-    APPEND_NOT_NULL(info_type_id, ParseInt32, data[2], tuple_idx);
-    APPEND_NOT_NULL(info, ParseString, data[3], tuple_idx);
-    APPEND_NULL(note, ParseString, data[4], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "mi_id");
-  SERIALIZE_NOT_NULL(int32_t, movie_id, dest, "mi_movie_id");
-  SERIALIZE_NOT_NULL(int32_t, info_type_id, dest, "mi_info_type_id");
-  SERIALIZE_NOT_NULL(std::string, info, dest, "mi_info");
-  SERIALIZE_NULL(std::string, note, dest, "mi_note");
+  LoadTable(raw + "movie_info.csv", ',', dest,
+            {NotNullColumn(0, "mi_id", LoadType::INT32),
+             NotNullColumn(1, "mi_movie_id", LoadType::INT32),
+             NotNullColumn(2, "mi_info_type_id", LoadType::INT32),
+             NotNullColumn(3, "mi_info", LoadType::TEXT),
+             NullColumn(4, "mi_note", LoadType::TEXT)});
   Print("movie_info complete");
 }
 
@@ -562,31 +294,12 @@ void movie_info_idx() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NOT_NULL_COL(int32_t, movie_id);
-  DECLARE_NOT_NULL_COL(int32_t, info_type_id);
-  DECLARE_NOT_NULL_COL(std::string, info);
-  DECLARE_NULL_COL(std::string, note);
-
-  std::ifstream fin(raw + "movie_info_idx.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 5);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NOT_NULL(movie_id, ParseInt32, data[1], tuple_idx);
-    APPEND_NOT_NULL(info_type_id, ParseInt32, data[2], tuple_idx);
-    APPEND_NOT_NULL(info, ParseString, data[3], tuple_idx);
-    APPEND_NULL(note, ParseString, data[4], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "mii_id");
-  SERIALIZE_NOT_NULL(int32_t, movie_id, dest, "mii_movie_id");
-  SERIALIZE_NOT_NULL(int32_t, info_type_id, dest, "mii_info_type_id");
-  SERIALIZE_NOT_NULL(std::string, info, dest, "mii_info");
-  SERIALIZE_NULL(std::string, note, dest, "mii_note");
+  LoadTable(raw + "movie_info_idx.csv", ',', dest,
+            {NotNullColumn(0, "mii_id", LoadType::INT32),
+             NotNullColumn(1, "mii_movie_id", LoadType::INT32),
+             NotNullColumn(2, "mii_info_type_id", LoadType::INT32),
+             NotNullColumn(3, "mii_info", LoadType::TEXT),
+             NullColumn(4, "mii_note", LoadType::TEXT)});
   Print("movie_info_idx complete");
 }
 
@@ -599,25 +312,10 @@ void movie_keyword() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NOT_NULL_COL(int32_t, movie_id);
-  DECLARE_NOT_NULL_COL(int32_t, keyword_id);
-
-  std::ifstream fin(raw + "movie_keyword.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 3);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NOT_NULL(movie_id, ParseInt32, data[1], tuple_idx);
-    APPEND_NOT_NULL(keyword_id, ParseInt32, data[2], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "mk_id");
-  SERIALIZE_NOT_NULL(int32_t, movie_id, dest, "mk_movie_id");
-  SERIALIZE_NOT_NULL(int32_t, keyword_id, dest, "mk_keyword_id");
+  LoadTable(raw + "movie_keyword.csv", ',', dest,
+            {NotNullColumn(0, "mk_id", LoadType::INT32),
+             NotNullColumn(1, "mk_movie_id", LoadType::INT32),
+             NotNullColumn(2, "mk_keyword_id", LoadType::INT32)});
   Print("movie_keyword complete");
 }
 
@@ -631,28 +329,11 @@ void movie_link() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NOT_NULL_COL(int32_t, movie_id);
-  DECLARE_NOT_NULL_COL(int32_t, linked_movie_id);
-  DECLARE_NOT_NULL_COL(int32_t, link_type_id);
-
-  std::ifstream fin(raw + "movie_link.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 4);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NOT_NULL(movie_id, ParseInt32, data[1], tuple_idx);
-    APPEND_NOT_NULL(linked_movie_id, ParseInt32, data[2], tuple_idx);
-    APPEND_NOT_NULL(link_type_id, ParseInt32, data[3], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "ml_id");
-  SERIALIZE_NOT_NULL(int32_t, movie_id, dest, "ml_movie_id");
-  SERIALIZE_NOT_NULL(int32_t, linked_movie_id, dest, "ml_linked_movie_id");
-  SERIALIZE_NOT_NULL(int32_t, link_type_id, dest, "ml_link_type_id");
+  LoadTable(raw + "movie_link.csv", ',', dest,
+            {NotNullColumn(0, "ml_id", LoadType::INT32),
+             NotNullColumn(1, "ml_movie_id", LoadType::INT32),
+             NotNullColumn(2, "ml_linked_movie_id", LoadType::INT32),
+             NotNullColumn(3, "ml_link_type_id", LoadType::INT32)});
   Print("movie_link complete");
 }
 
@@ -671,43 +352,16 @@ void name() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NOT_NULL_COL(std::string, name);
-  DECLARE_NULL_COL(std::string, imdb_index);
-  DECLARE_NULL_COL(int32_t, imdb_id);
-  DECLARE_NULL_COL(std::string, gender);
-  DECLARE_NULL_COL(std::string, name_pcode_cf);
-  DECLARE_NULL_COL(std::string, name_pcode_nf);
-  DECLARE_NULL_COL(std::string, surname_pcode);
-  DECLARE_NULL_COL(std::string, md5sum);
-
-  std::ifstream fin(raw + "name.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 9);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NOT_NULL(name, ParseString, data[1], tuple_idx);
-    APPEND_NULL(imdb_index, ParseString, data[2], tuple_idx);
-    APPEND_NULL(imdb_id, ParseInt32, data[3], tuple_idx);
-    APPEND_NULL(gender, ParseString, data[4], tuple_idx);
-    APPEND_NULL(name_pcode_cf, ParseString, data[5], tuple_idx);
-    APPEND_NULL(name_pcode_nf, ParseString, data[6], tuple_idx);
-    APPEND_NULL(surname_pcode, ParseString, data[7], tuple_idx);
-    APPEND_NULL(md5sum, ParseString, data[8], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "n_id");
-  SERIALIZE_NOT_NULL(std::string, name, dest, "n_name");
-  SERIALIZE_NULL(std::string, imdb_index, dest, "n_imdb_index");
-  SERIALIZE_NULL(int32_t, imdb_id, dest, "n_imdb_id");
-  SERIALIZE_NULL(std::string, gender, dest, "n_gender");
-  SERIALIZE_NULL(std::string, name_pcode_cf, dest, "n_name_pcode_cf");
-  SERIALIZE_NULL(std::string, name_pcode_nf, dest, "n_name_pcode_nf");
-  SERIALIZE_NULL(std::string, surname_pcode, dest, "n_surname_pcode");
-  SERIALIZE_NULL(std::string, md5sum, dest, "n_md5sum");
+  LoadTable(raw + "name.csv", ',', dest,
+            {NotNullColumn(0, "n_id", LoadType::INT32),
+             NotNullColumn(1, "n_name", LoadType::TEXT),
+             NullColumn(2, "n_imdb_index", LoadType::TEXT),
+             NullColumn(3, "n_imdb_id", LoadType::INT32),
+             NullColumn(4, "n_gender", LoadType::TEXT),
+             NullColumn(5, "n_name_pcode_cf", LoadType::TEXT),
+             NullColumn(6, "n_name_pcode_nf", LoadType::TEXT),
+             NullColumn(7, "n_surname_pcode", LoadType::TEXT),
+             NullColumn(8, "n_md5sum", LoadType::TEXT)});
   Print("name complete");
 }
 
@@ -722,31 +376,12 @@ void person_info() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NOT_NULL_COL(int32_t, person_id);
-  DECLARE_NOT_NULL_COL(int32_t, info_type_id);
-  DECLARE_NOT_NULL_COL(std::string, info);
-  DECLARE_NULL_COL(std::string, note);
-
-  std::ifstream fin(raw + "person_info.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 5);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NOT_NULL(person_id, ParseInt32, data[1], tuple_idx);
-    APPEND_NOT_NULL(info_type_id, ParseInt32, data[2], tuple_idx);
-    APPEND_NOT_NULL(info, ParseString, data[3], tuple_idx);
-    APPEND_NULL(note, ParseString, data[4], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "pi_id");
-  SERIALIZE_NOT_NULL(int32_t, person_id, dest, "pi_person_id");
-  SERIALIZE_NOT_NULL(int32_t, info_type_id, dest, "pi_info_type_id");
-  SERIALIZE_NOT_NULL(std::string, info, dest, "pi_info");
-  SERIALIZE_NULL(std::string, note, dest, "pi_note");
+  LoadTable(raw + "person_info.csv", ',', dest,
+            {NotNullColumn(0, "pi_id", LoadType::INT32),
+             NotNullColumn(1, "pi_person_id", LoadType::INT32),
+             NotNullColumn(2, "pi_info_type_id", LoadType::INT32),
+             NotNullColumn(3, "pi_info", LoadType::TEXT),
+             NullColumn(4, "pi_note", LoadType::TEXT)});
   Print("person_info complete");
 }
 
@@ -758,22 +393,9 @@ void role_type() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NULL_COL(std::string, role);
-
-  std::ifstream fin(raw + "role_type.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 2);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NULL(role, ParseString, data[1], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "r_id");
-  SERIALIZE_NULL(std::string, role, dest, "r_role");
+  LoadTable(raw + "role_type.csv", ',', dest,
+            {NotNullColumn(0, "r_id", LoadType::INT32),
+             NullColumn(1, "r_role", LoadType::TEXT)});
   Print("role_type complete");
 }
 
@@ -795,52 +417,19 @@ void title() {
     );
   */
 
-  DECLARE_NOT_NULL_COL(int32_t, id);
-  DECLARE_NOT_NULL_COL(std::string, title);
-  DECLARE_NULL_COL(std::string, imdb_index);
-  DECLARE_NOT_NULL_COL(int32_t, kind_id);
-  DECLARE_NULL_COL(int32_t, production_year);
-  DECLARE_NULL_COL(int32_t, imdb_id);
-  DECLARE_NULL_COL(std::string, phonetic_code);
-  DECLARE_NULL_COL(int32_t, episode_of_id);
-  DECLARE_NULL_COL(int32_t, season_nr);
-  DECLARE_NULL_COL(int32_t, episode_nr);
-  DECLARE_NULL_COL(std::string, series_years);
-  DECLARE_NULL_COL(std::string, md5sum);
-
-  std::ifstream fin(raw + "title.csv");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, ',', 12);
-
-    APPEND_NOT_NULL(id, ParseInt32, data[0], tuple_idx);
-    APPEND_NOT_NULL(title, ParseString, data[1], tuple_idx);
-    APPEND_NULL(imdb_index, ParseString, data[2], tuple_idx);
-    APPEND_NOT_NULL(kind_id, ParseInt32, data[3], tuple_idx);
-    APPEND_NULL(production_year, ParseInt32, data[4], tuple_idx);
-    APPEND_NULL(imdb_id, ParseInt32, data[5], tuple_idx);
-    APPEND_NULL(phonetic_code, ParseString, data[6], tuple_idx);
-    APPEND_NULL(episode_of_id, ParseInt32, data[7], tuple_idx);
-    APPEND_NULL(season_nr, ParseInt32, data[8], tuple_idx);
-    APPEND_NULL(episode_nr, ParseInt32, data[9], tuple_idx);
-    APPEND_NULL(series_years, ParseString, data[10], tuple_idx);
-    APPEND_NULL(md5sum, ParseString, data[11], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL(int32_t, id, dest, "t_id");
-  SERIALIZE_NOT_NULL(std::string, title, dest, "t_title");
-  SERIALIZE_NULL(std::string, imdb_index, dest, "t_imdb_index");
-  SERIALIZE_NOT_NULL(int32_t, kind_id, dest, "t_kind_id");
-  SERIALIZE_NULL(int32_t, production_year, dest, "t_production_year");
-  SERIALIZE_NULL(int32_t, imdb_id, dest, "t_imdb_id");
-  SERIALIZE_NULL(std::string, phonetic_code, dest, "t_phonetic_code");
-  SERIALIZE_NULL(int32_t, episode_of_id, dest, "t_episode_of_id");
-  SERIALIZE_NULL(int32_t, season_nr, dest, "t_season_nr");
-  SERIALIZE_NULL(int32_t, episode_nr, dest, "t_episode_nr");
-  SERIALIZE_NULL(std::string, series_years, dest, "t_series_years");
-  SERIALIZE_NULL(std::string, md5sum, dest, "t_md5sum");
+  LoadTable(raw + "title.csv", ',', dest,
+            {NotNullColumn(0, "t_id", LoadType::INT32),
+             NotNullColumn(1, "t_title", LoadType::TEXT),
+             NullColumn(2, "t_imdb_index", LoadType::TEXT),
+             NotNullColumn(3, "t_kind_id", LoadType::INT32),
+             NullColumn(4, "t_production_year", LoadType::INT32),
+             NullColumn(5, "t_imdb_id", LoadType::INT32),
+             NullColumn(6, "t_phonetic_code", LoadType::TEXT),
+             NullColumn(7, "t_episode_of_id", LoadType::INT32),
+             NullColumn(8, "t_season_nr", LoadType::INT32),
+             NullColumn(9, "t_episode_nr", LoadType::INT32),
+             NullColumn(10, "t_series_years", LoadType::TEXT),
+             NullColumn(11, "t_md5sum", LoadType::TEXT)});
   Print("title complete");
 }
 
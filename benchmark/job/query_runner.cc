@@ -10,6 +10,7 @@
 #include "catalog/catalog_manager.h"
 #include "parse/parser.h"
 #include "plan/planner.h"
+#include "util/query_stats.h"
 #include "util/time_execute.h"
 
 using namespace kush;
@@ -30,11 +31,19 @@ int main(int argc, char** argv) {
   auto query_text = std::string((std::istreambuf_iterator<char>(fin)),
                                 std::istreambuf_iterator<char>());
 
-  auto parsed = parse::Parse(query_text);
+  std::vector<std::unique_ptr<parse::Statement>> parsed;
+  {
+    util::PhaseTimer timer("parse");
+    parsed = parse::Parse(query_text);
+  }
 
   for (const auto& stmt : parsed) {
     plan::Planner planner;
-    auto query = planner.Plan(*stmt);
+    std::unique_ptr<plan::Operator> query;
+    {
+      util::PhaseTimer timer("plan");
+      query = planner.Plan(*stmt);
+    }
     util::TimeExecute(*query);
   }
 
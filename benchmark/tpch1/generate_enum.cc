@@ -1,10 +1,4 @@
-#include <cstdint>
-#include <execution>
-#include <fstream>
-#include <functional>
-#include <iostream>
 #include <string>
-#include <string_view>
 
 #include "util/load.h"
 
@@ -22,22 +16,9 @@ void Region() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(r_name_enum);
-  DECLARE_NOT_NULL_ENUM_COL(r_comment_enum);
-
-  std::ifstream fin(raw + "region.tbl");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, '|', 3);
-
-    APPEND_NOT_NULL_ENUM(r_name_enum, data[1], tuple_idx);
-    APPEND_NOT_NULL_ENUM(r_comment_enum, data[2], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(r_name_enum, dest, "r_name_enum");
-  SERIALIZE_NOT_NULL_ENUM(r_comment_enum, dest, "r_comment_enum");
+  LoadTable(raw + "region.tbl", '|', dest,
+            {NotNullColumn(1, "r_name_enum", LoadType::ENUM),
+             NotNullColumn(2, "r_comment_enum", LoadType::ENUM)});
   Print("region complete");
 }
 
@@ -51,22 +32,9 @@ void Nation() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(n_name_enum);
-  DECLARE_NOT_NULL_ENUM_COL(n_comment_enum);
-
-  std::ifstream fin(raw + "nation.tbl");
-  int tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, '|', 4);
-
-    APPEND_NOT_NULL_ENUM(n_name_enum, data[1], tuple_idx);
-    APPEND_NOT_NULL_ENUM(n_comment_enum, data[3], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(n_name_enum, dest, "n_name_enum");
-  SERIALIZE_NOT_NULL_ENUM(n_comment_enum, dest, "n_comment_enum");
+  LoadTable(raw + "nation.tbl", '|', dest,
+            {NotNullColumn(1, "n_name_enum", LoadType::ENUM),
+             NotNullColumn(3, "n_comment_enum", LoadType::ENUM)});
   Print("nation complete");
 }
 
@@ -92,31 +60,12 @@ void Lineitem() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(l_returnflag_enum);
-  DECLARE_NOT_NULL_ENUM_COL(l_linestatus_enum);
-  DECLARE_NOT_NULL_ENUM_COL(l_shipinstruct_enum);
-  DECLARE_NOT_NULL_ENUM_COL(l_shipmode_enum);
-  DECLARE_NOT_NULL_ENUM_COL(l_comment_enum);
-
-  std::ifstream fin(raw + "lineitem.tbl");
-  int32_t tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, '|', 16);
-
-    APPEND_NOT_NULL_ENUM(l_returnflag_enum, data[8], tuple_idx);
-    APPEND_NOT_NULL_ENUM(l_linestatus_enum, data[9], tuple_idx);
-    APPEND_NOT_NULL_ENUM(l_shipinstruct_enum, data[13], tuple_idx);
-    APPEND_NOT_NULL_ENUM(l_shipmode_enum, data[14], tuple_idx);
-    APPEND_NOT_NULL_ENUM(l_comment_enum, data[15], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(l_returnflag_enum, dest, "l_returnflag_enum");
-  SERIALIZE_NOT_NULL_ENUM(l_linestatus_enum, dest, "l_linestatus_enum");
-  SERIALIZE_NOT_NULL_ENUM(l_shipinstruct_enum, dest, "l_shipinstruct_enum");
-  SERIALIZE_NOT_NULL_ENUM(l_shipmode_enum, dest, "l_shipmode_enum");
-  SERIALIZE_NOT_NULL_ENUM(l_comment_enum, dest, "l_comment_enum");
+  LoadTable(raw + "lineitem.tbl", '|', dest,
+            {NotNullColumn(8, "l_returnflag_enum", LoadType::ENUM),
+             NotNullColumn(9, "l_linestatus_enum", LoadType::ENUM),
+             NotNullColumn(13, "l_shipinstruct_enum", LoadType::ENUM),
+             NotNullColumn(14, "l_shipmode_enum", LoadType::ENUM),
+             NotNullColumn(15, "l_comment_enum", LoadType::ENUM)});
   Print("lineitem complete");
 }
 
@@ -135,28 +84,11 @@ void Orders() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(o_orderstatus_enum);
-  DECLARE_NOT_NULL_ENUM_COL(o_orderpriority_enum);
-  DECLARE_NOT_NULL_ENUM_COL(o_clerk_enum);
-  DECLARE_NOT_NULL_ENUM_COL(o_comment_enum);
-
-  std::ifstream fin(raw + "orders.tbl");
-  int32_t tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, '|', 9);
-
-    APPEND_NOT_NULL_ENUM(o_orderstatus_enum, data[2], tuple_idx);
-    APPEND_NOT_NULL_ENUM(o_orderpriority_enum, data[5], tuple_idx);
-    APPEND_NOT_NULL_ENUM(o_clerk_enum, data[6], tuple_idx);
-    APPEND_NOT_NULL_ENUM(o_comment_enum, data[8], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(o_orderstatus_enum, dest, "o_orderstatus_enum");
-  SERIALIZE_NOT_NULL_ENUM(o_orderpriority_enum, dest, "o_orderpriority_enum");
-  SERIALIZE_NOT_NULL_ENUM(o_clerk_enum, dest, "o_clerk_enum");
-  SERIALIZE_NOT_NULL_ENUM(o_comment_enum, dest, "o_comment_enum");
+  LoadTable(raw + "orders.tbl", '|', dest,
+            {NotNullColumn(2, "o_orderstatus_enum", LoadType::ENUM),
+             NotNullColumn(5, "o_orderpriority_enum", LoadType::ENUM),
+             NotNullColumn(6, "o_clerk_enum", LoadType::ENUM),
+             NotNullColumn(8, "o_comment_enum", LoadType::ENUM)});
   Print("orders complete");
 }
 
@@ -174,31 +106,12 @@ void Customer() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(c_name_enum);
-  DECLARE_NOT_NULL_ENUM_COL(c_address_enum);
-  DECLARE_NOT_NULL_ENUM_COL(c_phone_enum);
-  DECLARE_NOT_NULL_ENUM_COL(c_mktsegment_enum);
-  DECLARE_NOT_NULL_ENUM_COL(c_comment_enum);
-
-  std::ifstream fin(raw + "customer.tbl");
-  int32_t tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, '|', 8);
-
-    APPEND_NOT_NULL_ENUM(c_name_enum, data[1], tuple_idx);
-    APPEND_NOT_NULL_ENUM(c_address_enum, data[2], tuple_idx);
-    APPEND_NOT_NULL_ENUM(c_phone_enum, data[4], tuple_idx);
-    APPEND_NOT_NULL_ENUM(c_mktsegment_enum, data[6], tuple_idx);
-    APPEND_NOT_NULL_ENUM(c_comment_enum, data[7], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(c_name_enum, dest, "c_name_enum");
-  SERIALIZE_NOT_NULL_ENUM(c_address_enum, dest, "c_address_enum");
-  SERIALIZE_NOT_NULL_ENUM(c_phone_enum, dest, "c_phone_enum");
-  SERIALIZE_NOT_NULL_ENUM(c_mktsegment_enum, dest, "c_mktsegment_enum");
-  SERIALIZE_NOT_NULL_ENUM(c_comment_enum, dest, "c_comment_enum");
+  LoadTable(raw + "customer.tbl", '|', dest,
+            {NotNullColumn(1, "c_name_enum", LoadType::ENUM),
+             NotNullColumn(2, "c_address_enum", LoadType::ENUM),
+             NotNullColumn(4, "c_phone_enum", LoadType::ENUM),
+             NotNullColumn(6, "c_mktsegment_enum", LoadType::ENUM),
+             NotNullColumn(7, "c_comment_enum", LoadType::ENUM)});
   Print("customer complete");
 }
 
@@ -213,19 +126,8 @@ void Partsupp() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(ps_comment_enum);
-
-  std::ifstream fin(raw + "partsupp.tbl");
-  int32_t tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, '|', 5);
-
-    APPEND_NOT_NULL_ENUM(ps_comment_enum, data[4], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(ps_comment_enum, dest, "ps_comment_enum");
+  LoadTable(raw + "partsupp.tbl", '|', dest,
+            {NotNullColumn(4, "ps_comment_enum", LoadType::ENUM)});
   Print("partsupp complete");
 }
 
@@ -244,34 +146,13 @@ void Part() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(p_name_enum);
-  DECLARE_NOT_NULL_ENUM_COL(p_mfgr_enum);
-  DECLARE_NOT_NULL_ENUM_COL(p_brand_enum);
-  DECLARE_NOT_NULL_ENUM_COL(p_type_enum);
-  DECLARE_NOT_NULL_ENUM_COL(p_container_enum);
-  DECLARE_NOT_NULL_ENUM_COL(p_comment_enum);
-
-  std::ifstream fin(raw + "part.tbl");
-  int32_t tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, '|', 9);
-
-    APPEND_NOT_NULL_ENUM(p_name_enum, data[1], tuple_idx);
-    APPEND_NOT_NULL_ENUM(p_mfgr_enum, data[2], tuple_idx);
-    APPEND_NOT_NULL_ENUM(p_brand_enum, data[3], tuple_idx);
-    APPEND_NOT_NULL_ENUM(p_type_enum, data[4], tuple_idx);
-    APPEND_NOT_NULL_ENUM(p_container_enum, data[6], tuple_idx);
-    APPEND_NOT_NULL_ENUM(p_comment_enum, data[8], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(p_name_enum, dest, "p_name_enum");
-  SERIALIZE_NOT_NULL_ENUM(p_mfgr_enum, dest, "p_mfgr_enum");
-  SERIALIZE_NOT_NULL_ENUM(p_brand_enum, dest, "p_brand_enum");
-  SERIALIZE_NOT_NULL_ENUM(p_type_enum, dest, "p_type_enum");
-  SERIALIZE_NOT_NULL_ENUM(p_container_enum, dest, "p_container_enum");
-  SERIALIZE_NOT_NULL_ENUM(p_comment_enum, dest, "p_comment_enum");
+  LoadTable(raw + "part.tbl", '|', dest,
+            {NotNullColumn(1, "p_name_enum", LoadType::ENUM),
+             NotNullColumn(2, "p_mfgr_enum", LoadType::ENUM),
+             NotNullColumn(3, "p_brand_enum", LoadType::ENUM),
+             NotNullColumn(4, "p_type_enum", LoadType::ENUM),
+             NotNullColumn(6, "p_container_enum", LoadType::ENUM),
+             NotNullColumn(8, "p_comment_enum", LoadType::ENUM)});
   Print("part complete");
 }
 
@@ -288,28 +169,11 @@ void Supplier() {
     );
   */
 
-  DECLARE_NOT_NULL_ENUM_COL(s_name_enum);
-  DECLARE_NOT_NULL_ENUM_COL(s_address_enum);
-  DECLARE_NOT_NULL_ENUM_COL(s_phone_enum);
-  DECLARE_NOT_NULL_ENUM_COL(s_comment_enum);
-
-  std::ifstream fin(raw + "supplier.tbl");
-  int32_t tuple_idx = 0;
-  for (std::string line; std::getline(fin, line);) {
-    auto data = Split(line, '|', 7);
-
-    APPEND_NOT_NULL_ENUM(s_name_enum, data[1], tuple_idx);
-    APPEND_NOT_NULL_ENUM(s_address_enum, data[2], tuple_idx);
-    APPEND_NOT_NULL_ENUM(s_phone_enum, data[4], tuple_idx);
-    APPEND_NOT_NULL_ENUM(s_comment_enum, data[6], tuple_idx);
-
-    tuple_idx++;
-  }
-
-  SERIALIZE_NOT_NULL_ENUM(s_name_enum, dest, "s_name_enum");
-  SERIALIZE_NOT_NULL_ENUM(s_address_enum, dest, "s_address_enum");
-  SERIALIZE_NOT_NULL_ENUM(s_phone_enum, dest, "s_phone_enum");
-  SERIALIZE_NOT_NULL_ENUM(s_comment_enum, dest, "s_comment_enum");
+  LoadTable(raw + "supplier.tbl", '|', dest,
+            {NotNullColumn(1, "s_name_enum", LoadType::ENUM),
+             NotNullColumn(2, "s_address_enum", LoadType::ENUM),
+             NotNullColumn(4, "s_phone_enum", LoadType::ENUM),
+             NotNullColumn(6, "s_comment_enum", LoadType::ENUM)});
   Print("supplier complete");
 }
 
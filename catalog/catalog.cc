@@ -2,8 +2,10 @@
 
 #include <memory>
 #include <string>
+#include <unistd.h>
 
 #include "catalog/sql_type.h"
+#include "runtime/enum.h"
 
 namespace kush::catalog {
 
@@ -35,6 +37,26 @@ Column& Table::Insert(std::string_view attr, const Type& type,
   return name_to_col_.at(attr);
 }
 
+Column& Table::InsertText(std::string_view attr, std::string_view path,
+                          std::string_view null_path,
+                          std::string_view index_path) {
+  // The loader writes the encoded column to the TEXT column's name + "_enum".
+  constexpr std::string_view SUFFIX = ".kdb";
+  if (path.size() > SUFFIX.size() &&
+      path.substr(path.size() - SUFFIX.size()) == SUFFIX) {
+    auto prefix = std::string(path.substr(0, path.size() - SUFFIX.size()));
+    auto enum_path = prefix + "_enum.kdbenum";
+    if (access(enum_path.c_str(), F_OK) == 0) {
+      auto id = runtime::Enum::EnumManager::Get().Register(enum_path);
+      return Insert(attr, Type::Enum(id), prefix + "_enum.kdb",
+                    null_path.empty() ? "" : prefix + "_enum_null.kdb",
+                    index_path.empty() ? "" : prefix + "_enum.kdbindex");
+    }
+  }
+
+  return Insert(attr, Type::Text(), path, null_path, index_path);
+}
+
 std::string_view Table::Name() const { return name_; }
 
 const Column& Table::operator[](std::string_view attr) const {
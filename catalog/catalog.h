@@ -40,6 +40,12 @@ class Table {
   std::string_view Name() const;
   Column& Insert(std::string_view attr, const Type& type, std::string_view path,
                  std::string_view null_path, std::string_view index_path);
+
+  // Inserts a TEXT column. If the loader also wrote it dictionary encoded,
+  // the dictionary next to path is registered and the ENUM column is inserted
+  // instead.
+  Column& InsertText(std::string_view attr, std::string_view path,
+                     std::string_view null_path, std::string_view index_path);
   const Column& operator[](std::string_view attr) const;
   std::vector<std::reference_wrapper<const Column>> Columns() const;
 
@@ -0,0 +1,42 @@
+#include "catalog/catalog.h"
+
+#include <string>
+#include <unordered_map>
+
+#include "gtest/gtest.h"
+
+#include "catalog/sql_type.h"
+#include "runtime/enum.h"
+
+using namespace kush::catalog;
+using namespace kush::runtime;
+
+TEST(CatalogTest, InsertTextWithoutEncoding) {
+  auto path = testing::TempDir() + "catalog_plain.kdb";
+
+  Table table("t");
+  table.InsertText("name", path, "", "");
+
+  const auto& column = table["name"];
+  EXPECT_EQ(column.GetType().type_id, TypeId::TEXT);
+  EXPECT_EQ(column.Path(), path);
+  EXPECT_FALSE(column.Nullable());
+  EXPECT_FALSE(column.HasIndex());
+}
+
+TEST(CatalogTest, InsertTextRegistersEncodedColumn) {
+  auto prefix = testing::TempDir() + "catalog_encoded";
+  std::unordered_map<std::string, int32_t> dictionary{{"a", 0}, {"b", 1}};
+  Enum::Serialize(prefix + "_enum.kdbenum", dictionary);
+
+  Table table("t");
+  table.InsertText("name", prefix + ".kdb", prefix + "_null.kdb",
+                   prefix + ".kdbindex");
+
+  const auto& column = table["name"];
+  ASSERT_EQ(column.GetType().type_id, TypeId::ENUM);
+  EXPECT_EQ(Enum::GetValue(column.GetType().enum_id, "b"), 1);
+  EXPECT_EQ(column.Path(), prefix + "_enum.kdb");
+  EXPECT_EQ(column.NullPath(), prefix + "_enum_null.kdb");
+  EXPECT_EQ(column.IndexPath(), prefix + "_enum.kdbindex");
+}
@@ -6,6 +6,7 @@
 #include "compile/proxy/disk_column_index.h"
 #include "compile/proxy/hash_table.h"
 #include "compile/proxy/memory_column_index.h"
+#include "compile/proxy/predicate_order.h"
 #include "compile/proxy/skinner_join_executor.h"
 #include "compile/proxy/tuple_idx_table.h"
 #include "compile/proxy/value/ir_value.h"
@@ -57,6 +58,9 @@ void ForwardDeclare(khir::ProgramBuilder& program) {
 
   proxy::TupleIdxTable::ForwardDeclare(program);
   proxy::SkinnerJoinExecutor::ForwardDeclare(program);
+
+  // Forward declare the predicate reordering
+  proxy::PredicateOrder::ForwardDeclare(program);
 }
 
 }  // namespace kush::compile
\ No newline at end of file
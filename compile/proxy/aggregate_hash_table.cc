@@ -8,6 +8,7 @@
 #include "compile/proxy/control_flow/if.h"
 #include "compile/proxy/control_flow/loop.h"
 #include "compile/proxy/evaluate.h"
+#include "compile/proxy/hash.h"
 #include "compile/proxy/value/ir_value.h"
 #include "execution/query_state.h"
 #include "khir/program_builder.h"
@@ -311,25 +312,11 @@ AggregateHashTablePayload AggregateHashTable::Insert(
 }
 
 Int64 AggregateHashTable::Hash(const std::vector<SQLValue>& keys) {
-  Int64 hash(program_, 0);
-  Int64 magic(program_, 0xc6a4a7935bd1e995);
-  Int64 offset(program_, 0xe6546b64);
-  uint8_t r = 47;
-
+  Hasher hasher(program_);
   for (auto& k : keys) {
-    auto key_hash = Ternary(
-        program_, k.IsNull(), [&]() { return Int64(program_, 0); },
-        [&]() { return k.Get().Hash(); });
-
-    key_hash = key_hash * magic;
-    key_hash = key_hash ^ (key_hash >> r);
-    key_hash = key_hash * magic;
-    hash = hash ^ key_hash;
-    hash = hash * magic;
-    hash = hash + offset;
+    hasher.Combine(k);
   }
-
-  return hash;
+  return hasher.Finish();
 }
 
 Int16 AggregateHashTable::Salt(Int64 hash) {
@@ -429,13 +416,17 @@ AggregateHashTableEntry AggregateHashTable::GetEntry(Int32 entry_idx) {
 
 AggregateHashTablePayload AggregateHashTable::GetPayload(Int32 block_idx,
                                                          Int16 block_offset) {
+  auto block_base = program_.LoadPtr(
+      program_.StaticGEP(program_.GetStructType(StructName), value_, {0, 5}));
+  auto block_ptr_type = program_.PointerType(program_.I8Type());
+  auto block = program_.LoadPtr(
+      program_.DynamicGEP(block_ptr_type, block_base, block_idx.Get(), {}));
+  auto offset = program_.I32TruncI64(block_offset.Zext().Get());
+  auto payload = program_.DynamicGEP(program_.I8Type(), block, offset, {});
+
   auto type = program_.PointerType(payload_format_.Type());
-  return AggregateHashTablePayload(
-      program_, payload_format_,
-      program_.PointerCast(
-          program_.Call(program_.GetFunction(GetPayloadFnName),
-                        {value_, block_idx.Get(), block_offset.Zext().Get()}),
-          type));
+  return AggregateHashTablePayload(program_, payload_format_,
+                                   program_.PointerCast(payload, type));
 }
 
 void AggregateHashTable::ForwardDeclare(khir::ProgramBuilder& program) {
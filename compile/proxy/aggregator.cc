@@ -163,9 +163,7 @@ void MinMaxAggregator::Update(Struct& entry) {
             case catalog::TypeId::ENUM: {
               auto& v1 = static_cast<Enum&>(next.Get());
               auto& v2 = static_cast<Enum&>(current_value.Get());
-              auto str1 = v1.ToString();
-              auto str2 = v2.ToString();
-              If(program_, min_ ? str1 < str2 : str2 < str1,
+              If(program_, min_ ? v1 < v2 : v2 < v1,
                  [&]() { entry.Update(field_, not_null_next); });
               break;
             }
@@ -241,6 +241,7 @@ ColumnData<S>::ColumnData(khir::ProgramBuilder& program,
       value_(program_.PointerCast(
           program_.ConstPtr(Allocate<S>(state)),
           program_.PointerType(program.GetStructType(StructName<S>())))) {
+  state.AddFile(path);
   if constexpr (S == catalog::TypeId::TEXT) {
     result_ = String::Global(program_, "").Get();
   }
@@ -4,9 +4,11 @@
 #include <memory>
 
 #include "catalog/sql_type.h"
+#include "compile/proxy/control_flow/if.h"
 #include "compile/proxy/value/ir_value.h"
 #include "khir/program_builder.h"
 #include "runtime/column_index_bucket.h"
+#include "runtime/posting_list.h"
 
 namespace kush::compile::proxy {
 
@@ -21,6 +23,8 @@ constexpr std::string_view FastForwardBucketName(
     "kush::runtime::ColumnIndexBucket::FastForwardBucket");
 constexpr std::string_view ColumnIndexBucketGetName(
     "kush::runtime::ColumnIndexBucket::GetBucketValue");
+constexpr std::string_view BucketDecodeBlockName(
+    "kush::runtime::ColumnIndexBucket::BucketDecodeBlock");
 constexpr std::string_view BucketListGetName(
     "kush::runtime::ColumnIndexBucket::BucketListGet");
 constexpr std::string_view BucketListSortedIntersectionInitName(
@@ -55,6 +59,16 @@ void ColumnIndexBucket::Copy(const ColumnIndexBucket& rhs) {
   program_.StoreI32(
       program_.StaticGEP(st, value_, {0, 1}),
       program_.LoadI32(program_.StaticGEP(st, rhs.value_, {0, 1})));
+  program_.StorePtr(
+      program_.StaticGEP(st, value_, {0, 4}),
+      program_.LoadPtr(program_.StaticGEP(st, rhs.value_, {0, 4})));
+  program_.StoreI32(program_.StaticGEP(st, value_, {0, 6}),
+                    program_.ConstI32(-1));
+}
+
+void ColumnIndexBucket::SetBlockBuffer(khir::Value block_values) {
+  auto st = program_.GetStructType(ColumnIndexBucket::StructName);
+  program_.StorePtr(program_.StaticGEP(st, value_, {0, 5}), block_values);
 }
 
 Int32 ColumnIndexBucket::FastForwardToStart(const Int32& last_tuple) {
@@ -70,21 +84,50 @@ Int32 ColumnIndexBucket::Size() {
 }
 
 Int32 ColumnIndexBucket::operator[](const Int32& v) {
-  return Int32(program_,
-               program_.Call(program_.GetFunction(ColumnIndexBucketGetName),
-                             {value_, v.Get()}));
-}
+  static_assert((runtime::PostingList::BLOCK_SIZE &
+                 (runtime::PostingList::BLOCK_SIZE - 1)) == 0);
+  constexpr uint8_t BLOCK_SHIFT =
+      __builtin_ctz(runtime::PostingList::BLOCK_SIZE);
 
-Bool ColumnIndexBucket::DoesNotExist() {
   auto st = program_.GetStructType(ColumnIndexBucket::StructName);
-  return Bool(program_, program_.IsNullPtr(program_.LoadPtr(
-                            program_.StaticGEP(st, value_, {0, 0}))));
+  auto encoded = program_.LoadPtr(program_.StaticGEP(st, value_, {0, 4}));
+  return Ternary(
+      program_, Bool(program_, program_.IsNullPtr(encoded)),
+      [&]() {
+        auto data = program_.LoadPtr(program_.StaticGEP(st, value_, {0, 0}));
+        return Int32(program_, program_.LoadI32(program_.DynamicGEP(
+                                   program_.I32Type(), data, v.Get(), {})));
+      },
+      [&]() {
+        // Only decoding a block that is not the current one needs the
+        // runtime.
+        auto idx = program_.I64ZextI32(v.Get());
+        Int32 block(program_,
+                    program_.I32TruncI64(program_.RShiftI64(idx, BLOCK_SHIFT)));
+        Int32 current(program_,
+                      program_.LoadI32(program_.StaticGEP(st, value_, {0, 6})));
+        If(program_, block != current, [&]() {
+          program_.Call(program_.GetFunction(BucketDecodeBlockName),
+                        {value_, block.Get()});
+        });
+
+        auto values =
+            program_.LoadPtr(program_.StaticGEP(st, value_, {0, 5}));
+        auto offset = program_.AndI64(
+            idx, program_.ConstI64(runtime::PostingList::BLOCK_SIZE - 1));
+        return Int32(program_, program_.LoadI32(program_.DynamicGEP(
+                                   program_.I32Type(), values, offset, {})));
+      });
 }
 
+Bool ColumnIndexBucket::DoesNotExist() { return Size() == 0; }
+
 void ColumnIndexBucket::ForwardDeclare(khir::ProgramBuilder& program) {
   auto index_bucket_type = program.StructType(
       {program.PointerType(program.I32Type()), program.I32Type(),
-       program.I32Type(), program.PointerType(program.I8Type())},
+       program.I32Type(), program.PointerType(program.I8Type()),
+       program.PointerType(program.I8Type()),
+       program.PointerType(program.I32Type()), program.I32Type()},
       ColumnIndexBucket::StructName);
   auto index_bucket_ptr_type = program.PointerType(index_bucket_type);
 
@@ -108,6 +151,11 @@ void ColumnIndexBucket::ForwardDeclare(khir::ProgramBuilder& program) {
       {index_bucket_ptr_type, program.I32Type()},
       reinterpret_cast<void*>(&runtime::GetBucketValue));
 
+  program.DeclareExternalFunction(
+      BucketDecodeBlockName, program.VoidType(),
+      {index_bucket_ptr_type, program.I32Type()},
+      reinterpret_cast<void*>(&runtime::BucketDecodeBlock));
+
   program.DeclareExternalFunction(
       BucketListGetName, index_bucket_ptr_type,
       {index_bucket_ptr_type, program.I32Type()},
@@ -143,6 +191,28 @@ void ColumnIndexBucket::ForwardDeclare(khir::ProgramBuilder& program) {
 
 khir::Value ColumnIndexBucket::Get() const { return value_; }
 
+khir::Value ColumnIndexBucket::Empty(khir::ProgramBuilder& program) {
+  return program.ConstantStruct(
+      program.GetStructType(ColumnIndexBucket::StructName),
+      {program.NullPtr(program.PointerType(program.I32Type())),
+       program.ConstI32(0), program.ConstI32(0),
+       program.NullPtr(program.PointerType(program.I8Type())),
+       program.NullPtr(program.PointerType(program.I8Type())),
+       program.NullPtr(program.PointerType(program.I32Type())),
+       program.ConstI32(-1)});
+}
+
+khir::Value ColumnIndexBucket::BlockBuffer(khir::ProgramBuilder& program,
+                                           int num_buckets) {
+  auto type = program.ArrayType(program.I32Type(),
+                                num_buckets * runtime::PostingList::BLOCK_SIZE);
+  return program.Global(
+      type, program.ConstantArray(
+                type, std::vector<khir::Value>(
+                          num_buckets * runtime::PostingList::BLOCK_SIZE,
+                          program.ConstI32(0))));
+}
+
 ColumnIndexBucketArray::ColumnIndexBucketArray(khir::ProgramBuilder& program,
                                                int max_size)
     : program_(program),
@@ -153,14 +223,9 @@ ColumnIndexBucketArray::ColumnIndexBucketArray(khir::ProgramBuilder& program,
               program.ArrayType(
                   program.GetStructType(ColumnIndexBucket::StructName),
                   max_size),
-              std::vector<khir::Value>(
-                  max_size,
-                  program.ConstantStruct(
-                      program.GetStructType(ColumnIndexBucket::StructName),
-                      {program.NullPtr(program.PointerType(program.I32Type())),
-                       program.ConstI32(0), program.ConstI32(0),
-                       program.NullPtr(
-                           program.PointerType(program.I8Type()))}))))),
+              std::vector<khir::Value>(max_size,
+                                       ColumnIndexBucket::Empty(program))))),
+      block_values_(ColumnIndexBucket::BlockBuffer(program, max_size)),
       sorted_intersection_idx_value_(program.Global(
           program.ArrayType(program.I32Type(), max_size),
           program.ConstantArray(
@@ -195,6 +260,15 @@ void ColumnIndexBucketArray::PushBack(const ColumnIndexBucket& bucket) {
   auto idx = Size();
   auto dest = Get(idx);
   dest.Copy(bucket);
+
+  // Each slot decodes into its own block of the buffer.
+  dest.SetBlockBuffer(program_.DynamicGEP(
+      program_.I32Type(),
+      program_.StaticGEP(
+          program_.ArrayType(program_.I32Type(),
+                             max_size_ * runtime::PostingList::BLOCK_SIZE),
+          block_values_, {0, 0}),
+      (idx * runtime::PostingList::BLOCK_SIZE).Get(), {}));
   program_.StoreI32(idx_value_, (idx + 1).Get());
 }
 
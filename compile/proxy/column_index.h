@@ -16,7 +16,9 @@ class ColumnIndexBucket {
   Int32 operator[](const Int32& v);
   Int32 FastForwardToStart(const Int32& last_tuple);
   Bool DoesNotExist();
+  // Copies the values of rhs but not its block buffer.
   void Copy(const ColumnIndexBucket& rhs);
+  void SetBlockBuffer(khir::Value block_values);
   khir::Value Get() const;
 
   // Mutable
@@ -25,6 +27,13 @@ class ColumnIndexBucket {
 
   static void ForwardDeclare(khir::ProgramBuilder& program);
 
+  // Constant initializer of an empty bucket.
+  static khir::Value Empty(khir::ProgramBuilder& program);
+
+  // Global buffer that fits the decoded values of num_buckets blocks.
+  static khir::Value BlockBuffer(khir::ProgramBuilder& program,
+                                 int num_buckets);
+
   static std::string StructName;
 
  private:
@@ -53,6 +62,7 @@ class ColumnIndexBucketArray {
  private:
   khir::ProgramBuilder& program_;
   khir::Value value_;
+  khir::Value block_values_;
   khir::Value sorted_intersection_idx_value_;
   khir::Value idx_value_;
   int max_size_;
@@ -10,6 +10,7 @@
 #include "khir/program_builder.h"
 #include "runtime/column_index.h"
 #include "runtime/column_index_bucket.h"
+#include "runtime/posting_list.h"
 
 namespace kush::compile::proxy {
 
@@ -75,13 +76,12 @@ DiskColumnIndex<S>::DiskColumnIndex(khir::ProgramBuilder& program,
       value_(program.PointerCast(
           program.ConstPtr(state.Allocate<runtime::ColumnIndex::ColumnIndex>()),
           program.PointerType(program.GetStructType(DiskColumnIndexName)))),
-      get_value_(program.Global(
-          program.GetStructType(ColumnIndexBucket::StructName),
-          program.ConstantStruct(
-              program.GetStructType(ColumnIndexBucket::StructName),
-              {program.NullPtr(program.PointerType(program.I32Type())),
-               program.ConstI32(0), program.ConstI32(0),
-               program.NullPtr(program.PointerType(program.I8Type()))}))) {}
+      get_value_(
+          program.Global(program.GetStructType(ColumnIndexBucket::StructName),
+                         ColumnIndexBucket::Empty(program))),
+      block_values_(ColumnIndexBucket::BlockBuffer(program, 1)) {
+  state.AddFile(path);
+}
 
 template <catalog::TypeId S>
 DiskColumnIndex<S>::DiskColumnIndex(khir::ProgramBuilder& program,
@@ -90,13 +90,10 @@ DiskColumnIndex<S>::DiskColumnIndex(khir::ProgramBuilder& program,
       path_(path),
       path_value_(program.GlobalConstCharArray(path)),
       value_(v),
-      get_value_(program.Global(
-          program.GetStructType(ColumnIndexBucket::StructName),
-          program.ConstantStruct(
-              program.GetStructType(ColumnIndexBucket::StructName),
-              {program.NullPtr(program.PointerType(program.I32Type())),
-               program.ConstI32(0), program.ConstI32(0),
-               program.NullPtr(program.PointerType(program.I8Type()))}))) {}
+      get_value_(
+          program.Global(program.GetStructType(ColumnIndexBucket::StructName),
+                         ColumnIndexBucket::Empty(program))),
+      block_values_(ColumnIndexBucket::BlockBuffer(program, 1)) {}
 
 template <catalog::TypeId S>
 void DiskColumnIndex<S>::Init() {
@@ -111,9 +108,13 @@ void DiskColumnIndex<S>::Reset() {
 
 template <catalog::TypeId S>
 ColumnIndexBucket DiskColumnIndex<S>::GetBucket(const IRValue& v) {
+  ColumnIndexBucket bucket(program_, get_value_);
+  bucket.SetBlockBuffer(program_.StaticGEP(
+      program_.ArrayType(program_.I32Type(), runtime::PostingList::BLOCK_SIZE),
+      block_values_, {0, 0}));
   program_.Call(program_.GetFunction(DiskColumnIndexGetBucketFnName<S>()),
                 {value_, v.Get(), get_value_});
-  return ColumnIndexBucket(program_, get_value_);
+  return bucket;
 }
 
 template <catalog::TypeId S>
@@ -136,7 +137,8 @@ void DiskColumnIndex<S>::ForwardDeclare(khir::ProgramBuilder& program) {
   if constexpr (S == catalog::TypeId::SMALLINT) {
     auto col_idx_data = program.OpaqueType(DiskColumnIndexDataName);
     auto st = program.StructType(
-        {program.PointerType(col_idx_data), program.I64Type()},
+        {program.PointerType(col_idx_data), program.I64Type(),
+         program.PointerType(program.I8Type())},
         DiskColumnIndexName);
     auto struct_ptr = program.PointerType(st);
     auto string_type = program.PointerType(program.I8Type());
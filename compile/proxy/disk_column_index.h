@@ -34,6 +34,7 @@ class DiskColumnIndex : public ColumnIndex {
   khir::Value path_value_;
   khir::Value value_;
   khir::Value get_value_;
+  khir::Value block_values_;
 };
 
 }  // namespace kush::compile::proxy
\ No newline at end of file
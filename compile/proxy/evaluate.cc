@@ -202,7 +202,7 @@ SQLValue EvaluateBinaryEnum(plan::BinaryArithmeticExpressionType op_type,
 
           case plan::BinaryArithmeticExpressionType::LT: {
             if (auto* rhs_v = dynamic_cast<const Enum*>(&rhs.Get())) {
-              return SQLValue(lhs_v.ToString() < rhs_v->ToString(), null);
+              return SQLValue(lhs_v < *rhs_v, null);
             }
 
             if (auto* rhs_v = dynamic_cast<const String*>(&rhs.Get())) {
@@ -214,7 +214,7 @@ SQLValue EvaluateBinaryEnum(plan::BinaryArithmeticExpressionType op_type,
 
           case plan::BinaryArithmeticExpressionType::LEQ: {
             if (auto* rhs_v = dynamic_cast<const Enum*>(&rhs.Get())) {
-              return SQLValue(lhs_v.ToString() <= rhs_v->ToString(), null);
+              return SQLValue(lhs_v <= *rhs_v, null);
             }
 
             if (auto* rhs_v = dynamic_cast<const String*>(&rhs.Get())) {
@@ -226,7 +226,7 @@ SQLValue EvaluateBinaryEnum(plan::BinaryArithmeticExpressionType op_type,
 
           case plan::BinaryArithmeticExpressionType::GT: {
             if (auto* rhs_v = dynamic_cast<const Enum*>(&rhs.Get())) {
-              return SQLValue(lhs_v.ToString() > rhs_v->ToString(), null);
+              return SQLValue(lhs_v > *rhs_v, null);
             }
 
             if (auto* rhs_v = dynamic_cast<const String*>(&rhs.Get())) {
@@ -238,7 +238,7 @@ SQLValue EvaluateBinaryEnum(plan::BinaryArithmeticExpressionType op_type,
 
           case plan::BinaryArithmeticExpressionType::GEQ: {
             if (auto* rhs_v = dynamic_cast<const Enum*>(&rhs.Get())) {
-              return SQLValue(lhs_v.ToString() >= rhs_v->ToString(), null);
+              return SQLValue(lhs_v >= *rhs_v, null);
             }
 
             if (auto* rhs_v = dynamic_cast<const String*>(&rhs.Get())) {
@@ -390,7 +390,7 @@ Bool LessThan(const SQLValue& lhs, const SQLValue& rhs) {
                       case catalog::TypeId::ENUM: {
                         auto& lhs_v = static_cast<Enum&>(lhs.Get());
                         auto& rhs_v = static_cast<Enum&>(rhs.Get());
-                        return lhs_v.ToString() < rhs_v.ToString();
+                        return lhs_v < rhs_v;
                       }
 
                       case catalog::TypeId::BOOLEAN:
@@ -0,0 +1,135 @@
+#include "compile/proxy/hash.h"
+
+#include "absl/flags/flag.h"
+
+#include "catalog/sql_type.h"
+#include "compile/proxy/control_flow/if.h"
+#include "compile/proxy/control_flow/loop.h"
+#include "compile/proxy/value/ir_value.h"
+#include "compile/proxy/value/sql_value.h"
+#include "khir/program_builder.h"
+
+ABSL_FLAG(std::string, hash_function, "crc32",
+          "Hash function for hash table keys: crc32, murmur or combine");
+
+namespace kush::compile::proxy {
+
+HashFunction GetHashFunction() {
+  if (FLAGS_hash_function.CurrentValue() == "crc32") {
+    return HashFunction::CRC32;
+  } else if (FLAGS_hash_function.CurrentValue() == "murmur") {
+    return HashFunction::MURMUR;
+  } else if (FLAGS_hash_function.CurrentValue() == "combine") {
+    return HashFunction::COMBINE;
+  } else {
+    throw std::runtime_error("Unknown hash function.");
+  }
+}
+
+Hasher::Hasher(khir::ProgramBuilder& program)
+    : Hasher(program, GetHashFunction()) {}
+
+Hasher::Hasher(khir::ProgramBuilder& program, HashFunction function)
+    : program_(program), function_(function), hash_(program, 0) {}
+
+void Hasher::Combine(const SQLValue& key) {
+  hash_ = Ternary(
+      program_, key.IsNull(), [&]() { return Mix(hash_, Int64(program_, 0)); },
+      [&]() {
+        // The combine scheme keeps the runtime string hash for comparison.
+        if (key.Type().type_id == catalog::TypeId::TEXT &&
+            function_ != HashFunction::COMBINE) {
+          return HashString(hash_, static_cast<String&>(key.Get()));
+        }
+        return Mix(hash_, key.Get().Hash());
+      });
+}
+
+Int64 Hasher::Finish() {
+  switch (function_) {
+    case HashFunction::CRC32: {
+      // CRC32-C only produces 32 bits so spread them over the upper half.
+      auto hash = hash_ * Int64(program_, 0x9e3779b97f4a7c15);
+      return hash ^ (hash >> 32);
+    }
+
+    case HashFunction::MURMUR:
+    case HashFunction::COMBINE:
+      return hash_;
+  }
+}
+
+Int64 Hasher::Mix(const Int64& hash, const Int64& key) {
+  switch (function_) {
+    case HashFunction::CRC32:
+      return Int64(program_, program_.Crc32I64(hash.Get(), key.Get()));
+
+    case HashFunction::MURMUR: {
+      Int64 magic(program_, 0xc6a4a7935bd1e995);
+      uint8_t r = 47;
+
+      auto key_hash = key * magic;
+      key_hash = key_hash ^ (key_hash >> r);
+      key_hash = key_hash * magic;
+      return ((hash ^ key_hash) * magic) + 0xe6546b64;
+    }
+
+    case HashFunction::COMBINE:
+      return hash ^ (key + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+  }
+}
+
+Int64 Hasher::HashString(const Int64& hash, const String& key) {
+  auto data = key.Data();
+  auto length = key.Length();
+
+  // Hash eight bytes at a time while possible.
+  Loop word_loop(
+      program_,
+      [&](auto& loop) {
+        loop.AddLoopVariable(Int32(program_, 0));
+        loop.AddLoopVariable(hash);
+      },
+      [&](auto& loop) {
+        auto i = loop.template GetLoopVariable<Int32>(0);
+        return i + 8 <= length;
+      },
+      [&](auto& loop) {
+        auto i = loop.template GetLoopVariable<Int32>(0);
+        auto h = loop.template GetLoopVariable<Int64>(1);
+
+        auto word_ptr = program_.PointerCast(
+            program_.DynamicGEP(program_.I8Type(), data, i.Get(), {}),
+            program_.PointerType(program_.I64Type()));
+        Int64 word(program_, program_.LoadI64(word_ptr));
+        return loop.Continue(i + 8, Mix(h, word));
+      });
+
+  // Then fold in the remaining tail one byte at a time.
+  Loop byte_loop(
+      program_,
+      [&](auto& loop) {
+        loop.AddLoopVariable(word_loop.GetLoopVariable<Int32>(0));
+        loop.AddLoopVariable(word_loop.GetLoopVariable<Int64>(1));
+      },
+      [&](auto& loop) {
+        auto i = loop.template GetLoopVariable<Int32>(0);
+        return i < length;
+      },
+      [&](auto& loop) {
+        auto i = loop.template GetLoopVariable<Int32>(0);
+        auto h = loop.template GetLoopVariable<Int64>(1);
+
+        Int64 byte(program_,
+                   program_.I64ZextI8(program_.LoadI8(program_.DynamicGEP(
+                       program_.I8Type(), data, i.Get(), {}))));
+        return loop.Continue(i + 1, Mix(h, byte));
+      });
+
+  // Mix in the length so that strings differing only in trailing zero bytes
+  // do not collide.
+  return Mix(byte_loop.GetLoopVariable<Int64>(1),
+             Int64(program_, program_.I64ZextI32(length.Get())));
+}
+
+}  // namespace kush::compile::proxy
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "compile/proxy/value/ir_value.h"
+#include "compile/proxy/value/sql_value.h"
+#include "khir/program_builder.h"
+
+namespace kush::compile::proxy {
+
+// CRC32: CRC32-C over each key word followed by a multiply-shift finalizer.
+// MURMUR: murmur2 style multiply-xorshift mixing of each key.
+// COMBINE: boost style hash combine of the raw key hashes.
+enum class HashFunction { CRC32, MURMUR, COMBINE };
+
+HashFunction GetHashFunction();
+
+// Hashes a sequence of keys inline in the generated code. Integral keys are
+// fed in directly while TEXT keys are hashed word by word without calling
+// into the runtime.
+class Hasher {
+ public:
+  Hasher(khir::ProgramBuilder& program);
+  Hasher(khir::ProgramBuilder& program, HashFunction function);
+
+  void Combine(const SQLValue& key);
+  Int64 Finish();
+
+ private:
+  Int64 Mix(const Int64& hash, const Int64& key);
+  Int64 HashString(const Int64& hash, const String& key);
+
+  khir::ProgramBuilder& program_;
+  HashFunction function_;
+  Int64 hash_;
+};
+
+}  // namespace kush::compile::proxy
@@ -3,8 +3,8 @@
 #include <functional>
 #include <vector>
 
-#include "compile/proxy/control_flow/if.h"
 #include "compile/proxy/control_flow/loop.h"
+#include "compile/proxy/hash.h"
 #include "compile/proxy/struct.h"
 #include "compile/proxy/vector.h"
 #include "execution/query_state.h"
@@ -26,8 +26,6 @@ constexpr std::string_view GetBucketFnName(
 constexpr std::string_view GetAllBucketsFnName(
     "kush::runtime::HashTable::GetAllBuckets");
 constexpr std::string_view FreeFnName("kush::runtime::HashTable::Free");
-constexpr std::string_view HashCombineFnName(
-    "kush::runtime::HashTable::HashCombine");
 constexpr std::string_view BucketListSizeFnName =
     "kush::runtime::HashTable::BucketListSize";
 constexpr std::string_view BucketListFreeFnName =
@@ -43,15 +41,19 @@ class BucketList {
       : program_(program), content_(content), value_(value) {}
 
   Vector operator[](const Int32& i) {
-    auto ptr = program_.Call(program_.GetFunction(BucketListGetBucketIdxFnName),
-                             {value_, i.Get()});
+    auto st = program_.GetStructType(BucketListStructName);
+    auto buckets = program_.LoadPtr(program_.StaticGEP(st, value_, {0, 1}));
+    auto vector_ptr_type =
+        program_.PointerType(program_.GetStructType(Vector::VectorStructName));
+    auto ptr = program_.LoadPtr(
+        program_.DynamicGEP(vector_ptr_type, buckets, i.Get(), {}));
     return Vector(program_, content_, ptr);
   }
 
   Int32 Size() {
-    return Int32(
-        program_,
-        program_.Call(program_.GetFunction(BucketListSizeFnName), {value_}));
+    auto st = program_.GetStructType(BucketListStructName);
+    return Int32(program_,
+                 program_.LoadI32(program_.StaticGEP(st, value_, {0, 0})));
   }
 
   void Reset() {
@@ -94,7 +96,6 @@ HashTable::HashTable(khir::ProgramBuilder& program,
           program.ConstPtr(
               state.Allocate<kush::runtime::HashTable::HashTable>()),
           program.PointerType(program.GetStructType(HashTableStructName)))),
-      hash_ptr_(program_.Global(program_.I32Type(), program.ConstI32(0))),
       bucket_list_(program_.Global(
           program.GetStructType(BucketListStructName),
           program.ConstantStruct(
@@ -115,20 +116,11 @@ void HashTable::Reset() {
 }
 
 Struct HashTable::Insert(const std::vector<SQLValue>& keys) {
-  program_.StoreI32(hash_ptr_, program_.ConstI32(0));
+  Hasher hasher(program_);
   for (auto& k : keys) {
-    If(
-        program_, k.IsNull(),
-        [&]() {
-          program_.Call(program_.GetFunction(HashCombineFnName),
-                        {hash_ptr_, program_.ConstI64(0)});
-        },
-        [&]() {
-          program_.Call(program_.GetFunction(HashCombineFnName),
-                        {hash_ptr_, k.Get().Hash().Get()});
-        });
+    hasher.Combine(k);
   }
-  auto hash = program_.LoadI32(hash_ptr_);
+  auto hash = program_.I32TruncI64(hasher.Finish().Get());
 
   auto data = program_.Call(program_.GetFunction(InsertFnName), {value_, hash});
   auto ptr = program_.PointerCast(data, program_.PointerType(content_type_));
@@ -136,20 +128,11 @@ Struct HashTable::Insert(const std::vector<SQLValue>& keys) {
 }
 
 Vector HashTable::Get(const std::vector<SQLValue>& keys) {
-  program_.StoreI32(hash_ptr_, program_.ConstI32(0));
+  Hasher hasher(program_);
   for (auto& k : keys) {
-    If(
-        program_, k.IsNull(),
-        [&]() {
-          program_.Call(program_.GetFunction(HashCombineFnName),
-                        {hash_ptr_, program_.ConstI64(0)});
-        },
-        [&]() {
-          program_.Call(program_.GetFunction(HashCombineFnName),
-                        {hash_ptr_, k.Get().Hash().Get()});
-        });
+    hasher.Combine(k);
   }
-  auto hash = program_.LoadI32(hash_ptr_);
+  auto hash = program_.I32TruncI64(hasher.Finish().Get());
 
   auto bucket_ptr =
       program_.Call(program_.GetFunction(GetBucketFnName), {value_, hash});
@@ -193,11 +176,6 @@ void HashTable::ForwardDeclare(khir::ProgramBuilder& program) {
       GetAllBucketsFnName, program.VoidType(),
       {struct_ptr, bucket_list_struct_ptr},
       reinterpret_cast<void*>(&runtime::HashTable::GetAllBuckets));
-
-  program.DeclareExternalFunction(
-      HashCombineFnName, program.VoidType(),
-      {program.PointerType(program.I32Type()), program.I64Type()},
-      reinterpret_cast<void*>(&runtime::HashTable::HashCombine));
 }
 
 void HashTable::ForEach(std::function<void(Struct&)> handler) {
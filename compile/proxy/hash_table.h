@@ -28,7 +28,6 @@ class HashTable {
   StructBuilder& content_;
   khir::Type content_type_;
   khir::Value value_;
-  khir::Value hash_ptr_;
   khir::Value bucket_list_;
 };
 
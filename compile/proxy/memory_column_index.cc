@@ -235,13 +235,9 @@ MemoryColumnIndex::MemoryColumnIndex(khir::ProgramBuilder& program,
           program.ConstPtr(
               state.Allocate<runtime::MemoryColumnIndex::MemoryColumnIndex>()),
           program.PointerType(program.GetStructType(StructName)))),
-      get_value_(program.Global(
-          program.GetStructType(ColumnIndexBucket::StructName),
-          program.ConstantStruct(
-              program.GetStructType(ColumnIndexBucket::StructName),
-              {program.NullPtr(program.PointerType(program.I32Type())),
-               program.ConstI32(0), program.ConstI32(0),
-               program.NullPtr(program.PointerType(program.I8Type()))}))) {}
+      get_value_(
+          program.Global(program.GetStructType(ColumnIndexBucket::StructName),
+                         ColumnIndexBucket::Empty(program))) {}
 
 MemoryColumnIndex::MemoryColumnIndex(khir::ProgramBuilder& program,
                                      const catalog::Type& key_type,
@@ -251,13 +247,9 @@ MemoryColumnIndex::MemoryColumnIndex(khir::ProgramBuilder& program,
       payload_format_(
           MemoryColumnIndexPayload::ConstructPayloadFormat(program_, key_type)),
       value_(value),
-      get_value_(program.Global(
-          program.GetStructType(ColumnIndexBucket::StructName),
-          program.ConstantStruct(
-              program.GetStructType(ColumnIndexBucket::StructName),
-              {program.NullPtr(program.PointerType(program.I32Type())),
-               program.ConstI32(0), program.ConstI32(0),
-               program.NullPtr(program.PointerType(program.I8Type()))}))) {}
+      get_value_(
+          program.Global(program.GetStructType(ColumnIndexBucket::StructName),
+                         ColumnIndexBucket::Empty(program))) {}
 
 khir::Value MemoryColumnIndex::Serialize() {
   return program_.PointerCast(value_, program_.PointerType(program_.I8Type()));
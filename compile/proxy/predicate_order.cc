@@ -0,0 +1,128 @@
+#include "compile/proxy/predicate_order.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "absl/flags/flag.h"
+
+#include "compile/proxy/control_flow/if.h"
+#include "compile/proxy/value/ir_value.h"
+#include "khir/program_builder.h"
+#include "runtime/predicate_order.h"
+
+ABSL_FLAG(std::string, predicate_order, "static",
+          "Scan select predicate order: static or adaptive");
+
+namespace kush::compile::proxy {
+
+namespace {
+constexpr std::string_view reorder_fn("kush::runtime::ReorderPredicates");
+
+// Counts are only taken for one in every SAMPLE_RATE tuples.
+constexpr int64_t SAMPLE_RATE = 64;
+}  // namespace
+
+PredicateOrderMode GetPredicateOrderMode() {
+  if (FLAGS_predicate_order.CurrentValue() == "static") {
+    return PredicateOrderMode::STATIC;
+  } else if (FLAGS_predicate_order.CurrentValue() == "adaptive") {
+    return PredicateOrderMode::ADAPTIVE;
+  } else {
+    throw std::runtime_error("Unknown predicate order.");
+  }
+}
+
+PredicateOrder::PredicateOrder(khir::ProgramBuilder& program,
+                               const std::vector<int32_t>& costs)
+    : program_(program),
+      num_preds_(costs.size()),
+      i32_array_type_(program_.ArrayType(program_.I32Type(), num_preds_)),
+      i64_array_type_(program_.ArrayType(program_.I64Type(), 2 * num_preds_)) {
+  std::vector<khir::Value> initial_order;
+  std::vector<khir::Value> initial_costs;
+  for (int i = 0; i < num_preds_; i++) {
+    initial_order.push_back(program_.ConstI32(i));
+    initial_costs.push_back(program_.ConstI32(costs[i]));
+  }
+  std::vector<khir::Value> initial_counts(2 * num_preds_,
+                                          program_.ConstI64(0));
+
+  order_ = program_.Global(
+      i32_array_type_, program_.ConstantArray(i32_array_type_, initial_order));
+  costs_ = program_.Global(
+      i32_array_type_, program_.ConstantArray(i32_array_type_, initial_costs));
+  counts_ = program_.Global(
+      i64_array_type_, program_.ConstantArray(i64_array_type_, initial_counts));
+  samples_ = program_.Global(
+      i64_array_type_, program_.ConstantArray(i64_array_type_, initial_counts));
+}
+
+int32_t PredicateOrder::Size() const { return num_preds_; }
+
+Int32 PredicateOrder::Get(const Int32& position) {
+  auto order = program_.StaticGEP(i32_array_type_, order_, {0, 0});
+  return Int32(program_,
+               program_.LoadI32(program_.DynamicGEP(
+                   program_.I32Type(), order, position.Get(), {})));
+}
+
+void PredicateOrder::Switch(const Int32& pred,
+                            const std::function<void(int)>& case_fn) {
+  Switch(pred, 0, num_preds_, case_fn);
+}
+
+void PredicateOrder::Switch(const Int32& pred, int lo, int hi,
+                            const std::function<void(int)>& case_fn) {
+  if (hi - lo == 1) {
+    case_fn(lo);
+    return;
+  }
+
+  auto mid = lo + (hi - lo) / 2;
+  If(
+      program_, pred < mid, [&]() { Switch(pred, lo, mid, case_fn); },
+      [&]() { Switch(pred, mid, hi, case_fn); });
+}
+
+void PredicateOrder::Reorder() {
+  program_.Call(program_.GetFunction(reorder_fn),
+                {program_.ConstI32(num_preds_),
+                 program_.StaticGEP(i32_array_type_, order_, {0, 0}),
+                 program_.StaticGEP(i32_array_type_, costs_, {0, 0}),
+                 program_.StaticGEP(i64_array_type_, counts_, {0, 0}),
+                 program_.StaticGEP(i64_array_type_, samples_, {0, 0})});
+}
+
+Bool PredicateOrder::Sampled(const Int32& i) {
+  Int64 idx(program_, program_.I64ZextI32(i.Get()));
+  return (idx & (SAMPLE_RATE - 1)) == 0;
+}
+
+void PredicateOrder::Increment(const Bool& sampled, int idx) {
+  If(program_, sampled, [&]() {
+    auto ptr = program_.StaticGEP(i64_array_type_, samples_, {0, idx});
+    program_.StoreI64(
+        ptr, program_.AddI64(program_.LoadI64(ptr), program_.ConstI64(1)));
+  });
+}
+
+void PredicateOrder::Evaluated(const Bool& sampled, int pred) {
+  Increment(sampled, pred);
+}
+
+void PredicateOrder::Passed(const Bool& sampled, int pred) {
+  Increment(sampled, num_preds_ + pred);
+}
+
+void PredicateOrder::ForwardDeclare(khir::ProgramBuilder& program) {
+  program.DeclareExternalFunction(
+      reorder_fn, program.VoidType(),
+      {program.I32Type(), program.PointerType(program.I32Type()),
+       program.PointerType(program.I32Type()),
+       program.PointerType(program.I64Type()),
+       program.PointerType(program.I64Type())},
+      reinterpret_cast<void*>(&runtime::ReorderPredicates));
+}
+
+}  // namespace kush::compile::proxy
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "compile/proxy/value/ir_value.h"
+#include "khir/program_builder.h"
+
+namespace kush::compile::proxy {
+
+// STATIC: evaluate the conjunctive filters in planner order.
+// ADAPTIVE: evaluate them in an order that is updated at every morsel.
+enum class PredicateOrderMode { STATIC, ADAPTIVE };
+
+PredicateOrderMode GetPredicateOrderMode();
+
+// Permutable evaluation order of a conjunction. The generated code counts how
+// often each predicate is evaluated and passes on a sample of the tuples of a
+// morsel. At the start of the next morsel the samples are merged into the
+// totals and the order is recomputed without recompiling.
+class PredicateOrder {
+ public:
+  PredicateOrder(khir::ProgramBuilder& program,
+                 const std::vector<int32_t>& costs);
+
+  int32_t Size() const;
+
+  // Index of the predicate evaluated at position.
+  Int32 Get(const Int32& position);
+
+  // Generates case_fn(j) for each predicate j and branches to the one equal to
+  // pred. khir has no switch so the cases are split by binary search.
+  void Switch(const Int32& pred, const std::function<void(int)>& case_fn);
+
+  void Reorder();
+
+  // Whether the counts of the tuple at index i are sampled.
+  Bool Sampled(const Int32& i);
+  void Evaluated(const Bool& sampled, int pred);
+  void Passed(const Bool& sampled, int pred);
+
+  static void ForwardDeclare(khir::ProgramBuilder& program);
+
+ private:
+  void Switch(const Int32& pred, int lo, int hi,
+              const std::function<void(int)>& case_fn);
+  void Increment(const Bool& sampled, int idx);
+
+  khir::ProgramBuilder& program_;
+  int32_t num_preds_;
+  khir::Type i32_array_type_;
+  khir::Type i64_array_type_;
+  khir::Value order_;
+  khir::Value costs_;
+  khir::Value counts_;
+  khir::Value samples_;
+};
+
+}  // namespace kush::compile::proxy
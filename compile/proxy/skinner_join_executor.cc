@@ -25,7 +25,8 @@ void SkinnerJoinExecutor::ExecutePermutableJoin(
     const std::vector<int>* prefix_order, khir::Value join_handler_fn_arr,
     khir::Value valid_tuple_handler, int32_t num_flags, khir::Value flag_arr,
     khir::Value progress_arr, khir::Value table_ctr, khir::Value idx_arr,
-    khir::Value num_result_tuples, khir::Value offset_arr) {
+    khir::Value num_result_tuples, khir::Value offset_arr,
+    khir::Value tuple_idx_table) {
   program.Call(
       program.GetFunction(permutable_fn),
       {program.ConstI32(num_tables), program.ConstI32(num_preds),
@@ -33,7 +34,7 @@ void SkinnerJoinExecutor::ExecutePermutableJoin(
        program.ConstPtr(table_connections),
        program.ConstPtr((void*)prefix_order), join_handler_fn_arr,
        valid_tuple_handler, program.ConstI32(num_flags), flag_arr, progress_arr,
-       table_ctr, idx_arr, num_result_tuples, offset_arr});
+       table_ctr, idx_arr, num_result_tuples, offset_arr, tuple_idx_table});
 }
 
 void SkinnerJoinExecutor::ExecuteRecompilingJoin(
@@ -74,6 +75,7 @@ void SkinnerJoinExecutor::ForwardDeclare(khir::ProgramBuilder& program) {
           program.PointerType(program.I32Type()),
           program.PointerType(program.I32Type()),
           program.PointerType(program.I32Type()),
+          program.PointerType(program.GetOpaqueType(TupleIdxTable::TypeName)),
       },
       reinterpret_cast<void*>(&runtime::ExecutePermutableSkinnerJoin));
 
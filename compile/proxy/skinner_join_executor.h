@@ -23,7 +23,8 @@ class SkinnerJoinExecutor {
       const std::vector<int>* prefix_order, khir::Value join_handler_fn_arr,
       khir::Value valid_tuple_handler, int32_t num_flags, khir::Value flag_arr,
       khir::Value progress_arr, khir::Value table_ctr, khir::Value idx_arr,
-      khir::Value num_result_tuples, khir::Value offset_arr);
+      khir::Value num_result_tuples, khir::Value offset_arr,
+      khir::Value tuple_idx_table);
   static void ExecuteRecompilingJoin(
       khir::ProgramBuilder& program, int32_t num_tables,
       khir::Value cardinality_arr,
@@ -48,6 +48,42 @@ Bool Enum::operator!=(const Enum& rhs) const {
               program_.CmpI32(khir::CompType::NE, value_, rhs.value_));
 }
 
+bool Enum::CompareCodes(const Enum& rhs) const {
+  return rhs.enum_id_ == enum_id_ && runtime::Enum::Sorted(enum_id_);
+}
+
+Bool Enum::operator<(const Enum& rhs) const {
+  if (CompareCodes(rhs)) {
+    return Bool(program_,
+                program_.CmpI32(khir::CompType::LT, value_, rhs.value_));
+  }
+  return ToString() < rhs.ToString();
+}
+
+Bool Enum::operator<=(const Enum& rhs) const {
+  if (CompareCodes(rhs)) {
+    return Bool(program_,
+                program_.CmpI32(khir::CompType::LE, value_, rhs.value_));
+  }
+  return ToString() <= rhs.ToString();
+}
+
+Bool Enum::operator>(const Enum& rhs) const {
+  if (CompareCodes(rhs)) {
+    return Bool(program_,
+                program_.CmpI32(khir::CompType::GT, value_, rhs.value_));
+  }
+  return ToString() > rhs.ToString();
+}
+
+Bool Enum::operator>=(const Enum& rhs) const {
+  if (CompareCodes(rhs)) {
+    return Bool(program_,
+                program_.CmpI32(khir::CompType::GE, value_, rhs.value_));
+  }
+  return ToString() >= rhs.ToString();
+}
+
 String Enum::ToString() const {
   auto dest = String::Global(program_, "");
   program_.Call(program_.GetFunction(GetKeyFnName),
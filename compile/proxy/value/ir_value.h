@@ -8,6 +8,7 @@
 
 #include "khir/program_builder.h"
 #include "runtime/date.h"
+#include "runtime/like.h"
 
 namespace kush::compile::proxy {
 
@@ -276,8 +277,10 @@ class String : public IRValue {
   void Copy(const String& rhs) const;
   Bool Contains(const String& rhs) const;
   Bool StartsWith(const String& rhs) const;
+  Bool StartsWith(std::string_view prefix) const;
   Bool EndsWith(const String& rhs) const;
   Bool Like(re2::RE2* rhs) const;
+  Bool Like(runtime::Like::Pattern* pattern) const;
   Bool operator==(const String& rhs) const;
   Bool operator!=(const String& rhs) const;
   Bool operator<(const String& rhs) const;
@@ -285,6 +288,12 @@ class String : public IRValue {
   Bool operator>(const String& rhs) const;
   Bool operator>=(const String& rhs) const;
 
+  // Strings of up to runtime::String::INLINE_LENGTH bytes are stored in the
+  // struct itself. Data points at the characters in either case.
+  Int32 Length() const;
+  Bool IsInlined() const;
+  khir::Value Data() const;
+
   Int64 Hash() const override;
   khir::Value Get() const override;
   void Print(Printer& printer) const override;
@@ -296,6 +305,9 @@ class String : public IRValue {
       "kush::runtime::String::String";
 
  private:
+  Bool Compare(khir::CompType cmp, std::string_view fn,
+               const String& rhs) const;
+
   khir::ProgramBuilder& program_;
   khir::Value value_;
 };
@@ -341,6 +353,13 @@ class Enum : public IRValue {
   Bool operator==(const Enum& rhs) const;
   Bool operator!=(const Enum& rhs) const;
 
+  // Compares the codes when both sides use the same sorted dictionary and
+  // the keys otherwise.
+  Bool operator<(const Enum& rhs) const;
+  Bool operator<=(const Enum& rhs) const;
+  Bool operator>(const Enum& rhs) const;
+  Bool operator>=(const Enum& rhs) const;
+
   String ToString() const;
 
   Int64 Hash() const override;
@@ -354,6 +373,8 @@ class Enum : public IRValue {
   static void ForwardDeclare(khir::ProgramBuilder& program);
 
  private:
+  bool CompareCodes(const Enum& rhs) const;
+
   khir::ProgramBuilder& program_;
   int32_t enum_id_;
   khir::Value value_;
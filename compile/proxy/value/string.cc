@@ -1,7 +1,12 @@
 #include "runtime/string.h"
 
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
 #include "compile/proxy/value/ir_value.h"
 #include "khir/program_builder.h"
+#include "runtime/like.h"
 
 namespace kush::compile::proxy {
 
@@ -13,7 +18,6 @@ constexpr std::string_view EndsWithFnName("kush::runtime::String::EndsWith");
 constexpr std::string_view StartsWithFnName(
     "kush::runtime::String::StartsWith");
 constexpr std::string_view EqualsFnName("kush::runtime::String::Equals");
-constexpr std::string_view NotEqualsFnName("kush::runtime::String::NotEquals");
 constexpr std::string_view LessThanFnName("kush::runtime::String::LessThan");
 constexpr std::string_view LessThanEqualsFnName(
     "kush::runtime::String::LessThanEquals");
@@ -22,6 +26,72 @@ constexpr std::string_view GreaterThanFnName(
 constexpr std::string_view GreaterThanEqualsFnName(
     "kush::runtime::String::GreaterThanEquals");
 constexpr std::string_view HashFnName("kush::runtime::String::Hash");
+constexpr std::string_view MatchSequenceFnName(
+    "kush::runtime::Like::MatchSequence");
+
+// Returns the result of then_fn if cond holds and of else_fn otherwise.
+khir::Value Select(khir::ProgramBuilder& program, khir::Value cond,
+                   std::function<khir::Value()> then_fn,
+                   std::function<khir::Value()> else_fn) {
+  auto dest_block = program.GenerateBlock();
+  auto then_block = program.GenerateBlock();
+  auto else_block = program.GenerateBlock();
+  program.Branch(cond, then_block, else_block);
+
+  program.SetCurrentBlock(then_block);
+  auto then_value = then_fn();
+  auto then_phi_member = program.PhiMember(then_value);
+  program.Branch(dest_block);
+
+  program.SetCurrentBlock(else_block);
+  auto else_phi_member = program.PhiMember(else_fn());
+  program.Branch(dest_block);
+
+  program.SetCurrentBlock(dest_block);
+  auto phi = program.Phi(program.TypeOf(then_value));
+  program.UpdatePhiMember(phi, then_phi_member);
+  program.UpdatePhiMember(phi, else_phi_member);
+  return phi;
+}
+
+// Loads the length and prefix (word 0) or the inlined bytes or pointer
+// (word 1) as a single I64.
+khir::Value LoadWord(khir::ProgramBuilder& program, khir::Value str,
+                     int word) {
+  auto string_type = program.GetStructType(String::StringStructName);
+  auto ptr = word == 0 ? str : program.StaticGEP(string_type, str, {0, 2});
+  return program.LoadI64(
+      program.PointerCast(ptr, program.PointerType(program.I64Type())));
+}
+
+// Packs the prefix into an I64 that orders the same way as the strings when
+// the prefixes differ. Missing bytes of short strings are zero so a string
+// orders before its extensions.
+khir::Value PrefixKey(khir::ProgramBuilder& program, khir::Value str) {
+  auto string_type = program.GetStructType(String::StringStructName);
+  auto prefix = program.PointerCast(program.StaticGEP(string_type, str, {0, 1}),
+                                    program.PointerType(program.I8Type()));
+
+  auto key = program.ConstI64(0);
+  for (int i = 0; i < 4; i++) {
+    auto byte = program.I64ZextI8(
+        program.LoadI8(program.StaticGEP(program.I8Type(), prefix, {i})));
+    key = program.OrI64(key, program.LShiftI64(byte, 8 * (3 - i)));
+  }
+  return key;
+}
+
+khir::CompType Strict(khir::CompType cmp) {
+  switch (cmp) {
+    case khir::CompType::LE:
+      return khir::CompType::LT;
+    case khir::CompType::GE:
+      return khir::CompType::GT;
+    default:
+      return cmp;
+  }
+}
+
 }  // namespace
 
 String::String(khir::ProgramBuilder& program, const khir::Value& value)
@@ -53,6 +123,25 @@ Bool String::StartsWith(const String& rhs) const {
                                       {value_, rhs.Get()}));
 }
 
+Bool String::StartsWith(std::string_view prefix) const {
+  constexpr auto prefix_length = sizeof(runtime::String::String::prefix);
+  if (prefix.size() > prefix_length) {
+    return StartsWith(Global(program_, prefix));
+  }
+
+  // Short prefixes are checked against the prefix stored in the struct.
+  uint64_t expected = 0;
+  std::memcpy(&expected, prefix.data(), prefix.size());
+  uint64_t mask = (uint64_t(1) << (8 * prefix.size())) - 1;
+
+  auto stored = program_.AndI64(
+      program_.RShiftI64(LoadWord(program_, value_, 0), 32),
+      program_.ConstI64(mask));
+  return Length() >= int32_t(prefix.size()) &&
+         Bool(program_, program_.CmpI64(khir::CompType::EQ, stored,
+                                        program_.ConstI64(expected)));
+}
+
 Bool String::EndsWith(const String& rhs) const {
   return Bool(program_, program_.Call(program_.GetFunction(EndsWithFnName),
                                       {value_, rhs.Get()}));
@@ -63,36 +152,118 @@ Bool String::Like(re2::RE2* rhs) const {
                                       {value_, program_.ConstPtr(rhs)}));
 }
 
+Bool String::Like(runtime::Like::Pattern* pattern) const {
+  const auto& segments = pattern->Segments();
+  switch (pattern->Kind()) {
+    case runtime::Like::PatternKind::EXACT:
+      return *this == Global(program_, segments[0]);
+
+    case runtime::Like::PatternKind::PREFIX:
+      return StartsWith(segments[0]);
+
+    case runtime::Like::PatternKind::SUFFIX:
+      return EndsWith(Global(program_, segments[0]));
+
+    case runtime::Like::PatternKind::SUBSTRING:
+      return Contains(Global(program_, segments[0]));
+
+    case runtime::Like::PatternKind::SEQUENCE:
+      return Bool(program_,
+                  program_.Call(program_.GetFunction(MatchSequenceFnName),
+                                {value_, program_.ConstPtr(pattern)}));
+
+    case runtime::Like::PatternKind::WILDCARD:
+      return Like(pattern->Regex());
+  }
+
+  throw std::runtime_error("Unknown LIKE pattern kind");
+}
+
 Bool String::operator==(const String& rhs) const {
-  return Bool(program_, program_.Call(program_.GetFunction(EqualsFnName),
-                                      {value_, rhs.Get()}));
+  // Equal strings have equal lengths and prefixes. Inlined strings are then
+  // equal if the rest of their bytes are.
+  auto head_equal =
+      program_.CmpI64(khir::CompType::EQ, LoadWord(program_, value_, 0),
+                      LoadWord(program_, rhs.Get(), 0));
+  return Bool(
+      program_,
+      Select(
+          program_, head_equal,
+          [&]() {
+            return Select(
+                program_, IsInlined().Get(),
+                [&]() {
+                  return program_.CmpI64(khir::CompType::EQ,
+                                         LoadWord(program_, value_, 1),
+                                         LoadWord(program_, rhs.Get(), 1));
+                },
+                [&]() {
+                  return program_.Call(program_.GetFunction(EqualsFnName),
+                                       {value_, rhs.Get()});
+                });
+          },
+          [&]() { return program_.ConstI1(false); }));
 }
 
-Bool String::operator!=(const String& rhs) const {
-  return Bool(program_, program_.Call(program_.GetFunction(NotEqualsFnName),
-                                      {value_, rhs.Get()}));
+Bool String::operator!=(const String& rhs) const { return !(*this == rhs); }
+
+Bool String::Compare(khir::CompType cmp, std::string_view fn,
+                     const String& rhs) const {
+  // Strings with different prefixes are ordered by them.
+  auto lhs_key = PrefixKey(program_, value_);
+  auto rhs_key = PrefixKey(program_, rhs.Get());
+  auto prefix_differs = program_.CmpI64(khir::CompType::NE, lhs_key, rhs_key);
+  return Bool(program_,
+              Select(
+                  program_, prefix_differs,
+                  [&]() {
+                    return program_.CmpI64(Strict(cmp), lhs_key, rhs_key);
+                  },
+                  [&]() {
+                    return program_.Call(program_.GetFunction(fn),
+                                         {value_, rhs.Get()});
+                  }));
 }
 
 Bool String::operator<(const String& rhs) const {
-  return Bool(program_, program_.Call(program_.GetFunction(LessThanFnName),
-                                      {value_, rhs.Get()}));
+  return Compare(khir::CompType::LT, LessThanFnName, rhs);
 }
 
 Bool String::operator>(const String& rhs) const {
-  return Bool(program_, program_.Call(program_.GetFunction(GreaterThanFnName),
-                                      {value_, rhs.Get()}));
+  return Compare(khir::CompType::GT, GreaterThanFnName, rhs);
 }
 
 Bool String::operator<=(const String& rhs) const {
-  return Bool(program_,
-              program_.Call(program_.GetFunction(LessThanEqualsFnName),
-                            {value_, rhs.Get()}));
+  return Compare(khir::CompType::LE, LessThanEqualsFnName, rhs);
 }
 
 Bool String::operator>=(const String& rhs) const {
-  return Bool(program_,
-              program_.Call(program_.GetFunction(GreaterThanEqualsFnName),
-                            {value_, rhs.Get()}));
+  return Compare(khir::CompType::GE, GreaterThanEqualsFnName, rhs);
+}
+
+Int32 String::Length() const {
+  auto string_type = program_.GetStructType(StringStructName);
+  return Int32(program_, program_.LoadI32(
+                             program_.StaticGEP(string_type, value_, {0, 0})));
+}
+
+Bool String::IsInlined() const {
+  return Length() <= runtime::String::INLINE_LENGTH;
+}
+
+khir::Value String::Data() const {
+  auto string_type = program_.GetStructType(StringStructName);
+  return Select(
+      program_, IsInlined().Get(),
+      [&]() {
+        return program_.PointerCast(
+            program_.StaticGEP(string_type, value_, {0, 1}),
+            program_.PointerType(program_.I8Type()));
+      },
+      [&]() {
+        return program_.LoadPtr(
+            program_.StaticGEP(string_type, value_, {0, 2}));
+      });
 }
 
 std::unique_ptr<String> String::ToPointer() const {
@@ -112,27 +283,39 @@ khir::Value String::Get() const { return value_; }
 
 khir::Value String::Constant(khir::ProgramBuilder& program,
                              std::string_view value) {
-  auto char_ptr = program.GlobalConstCharArray(value);
-  auto len = program.ConstI32(value.size());
-  return program.ConstantStruct(program.GetStructType(StringStructName),
-                                {char_ptr, len});
+  runtime::String::String str;
+  runtime::String::Init(&str, value.data(), value.size());
+
+  uint32_t prefix;
+  std::memcpy(&prefix, str.prefix, sizeof(prefix));
+
+  // The inlined bytes are stored as the value of the pointer.
+  khir::Value rest;
+  if (runtime::String::IsInlined(&str)) {
+    void* inlined;
+    std::memcpy(&inlined, str.inlined, sizeof(inlined));
+    rest = program.ConstPtr(inlined);
+  } else {
+    rest = program.GlobalConstCharArray(value);
+  }
+
+  return program.ConstantStruct(
+      program.GetStructType(StringStructName),
+      {program.ConstI32(value.size()), program.ConstI32(prefix), rest});
 }
 
 String String::Global(khir::ProgramBuilder& program, std::string_view value) {
-  auto char_ptr = program.GlobalConstCharArray(value);
-  auto len = program.ConstI32(value.size());
-  auto str_struct = program.Global(
-      program.GetStructType(StringStructName),
-      program.ConstantStruct(program.GetStructType(StringStructName),
-                             {char_ptr, len}));
+  auto str_struct = program.Global(program.GetStructType(StringStructName),
+                                   Constant(program, value));
   return String(program, str_struct);
 }
 
 void String::ForwardDeclare(khir::ProgramBuilder& program) {
   auto struct_type = program.StructType(
       {
-          program.PointerType(program.I8Type()),
           program.I32Type(),
+          program.I32Type(),
+          program.PointerType(program.I8Type()),
       },
       StringStructName);
   auto struct_ptr = program.PointerType(struct_type);
@@ -147,6 +330,10 @@ void String::ForwardDeclare(khir::ProgramBuilder& program) {
       LikeFnName, program.I1Type(),
       {struct_ptr, program.PointerType(program.I8Type())},
       reinterpret_cast<void*>(runtime::String::Like));
+  program.DeclareExternalFunction(
+      MatchSequenceFnName, program.I1Type(),
+      {struct_ptr, program.PointerType(program.I8Type())},
+      reinterpret_cast<void*>(runtime::Like::MatchSequence));
   program.DeclareExternalFunction(
       EndsWithFnName, program.I1Type(), {struct_ptr, struct_ptr},
       reinterpret_cast<void*>(runtime::String::EndsWith));
@@ -156,9 +343,6 @@ void String::ForwardDeclare(khir::ProgramBuilder& program) {
   program.DeclareExternalFunction(
       EqualsFnName, program.I1Type(), {struct_ptr, struct_ptr},
       reinterpret_cast<void*>(runtime::String::Equals));
-  program.DeclareExternalFunction(
-      NotEqualsFnName, program.I1Type(), {struct_ptr, struct_ptr},
-      reinterpret_cast<void*>(runtime::String::NotEquals));
   program.DeclareExternalFunction(
       LessThanFnName, program.I1Type(), {struct_ptr, struct_ptr},
       reinterpret_cast<void*>(runtime::String::LessThan));
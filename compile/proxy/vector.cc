@@ -1,5 +1,6 @@
 #include "compile/proxy/vector.h"
 
+#include "compile/proxy/control_flow/if.h"
 #include "compile/proxy/struct.h"
 #include "compile/proxy/value/ir_value.h"
 #include "execution/query_state.h"
@@ -11,6 +12,7 @@ namespace kush::compile::proxy {
 namespace {
 constexpr std::string_view CreateFnName("kush::runtime::Vector::Create");
 constexpr std::string_view PushBackFnName("kush::runtime::Vector::PushBack");
+constexpr std::string_view GrowFnName("kush::runtime::Vector::Grow");
 constexpr std::string_view GetFnName("kush::runtime::Vector::Get");
 constexpr std::string_view SizeFnName("kush::runtime::Vector::Size");
 constexpr std::string_view FreeFnName("kush::runtime::Vector::Free");
@@ -47,17 +49,54 @@ void Vector::Reset() {
 
 khir::Value Vector::Get() const { return value_; }
 
+khir::Value Vector::ElementPtr(khir::Value data, const Int32& idx) {
+  // GEP only scales by 1/2/4/8 so index in the largest unit dividing the
+  // element size.
+  int32_t element_size = program_.GetTypeManager().GetTypeSize(content_type_);
+  int32_t scale = 8;
+  while (element_size % scale != 0) {
+    scale /= 2;
+  }
+
+  auto unit_type = scale == 8   ? program_.I64Type()
+                   : scale == 4 ? program_.I32Type()
+                   : scale == 2 ? program_.I16Type()
+                                : program_.I8Type();
+
+  // Scale the index in 64 bits like runtime::Vector::Get so that large
+  // vectors do not overflow.
+  auto units = program_.I64SextI32(idx.Get());
+  if (element_size != scale) {
+    units = program_.MulI64(units, program_.ConstI64(element_size / scale));
+  }
+
+  auto ptr = program_.DynamicGEP(
+      unit_type, program_.PointerCast(data, program_.PointerType(unit_type)),
+      units, {});
+  return program_.PointerCast(ptr, program_.PointerType(content_type_));
+}
+
 Struct Vector::operator[](const Int32& idx) {
-  auto ptr =
-      program_.Call(program_.GetFunction(GetFnName), {value_, idx.Get()});
-  auto ptr_type = program_.PointerType(content_type_);
-  return Struct(program_, content_, program_.PointerCast(ptr, ptr_type));
+  auto st = program_.GetStructType(VectorStructName);
+  auto data = program_.LoadPtr(program_.StaticGEP(st, value_, {0, 3}));
+  return Struct(program_, content_, ElementPtr(data, idx));
 }
 
 Struct Vector::PushBack() {
-  auto ptr = program_.Call(program_.GetFunction(PushBackFnName), {value_});
-  auto ptr_type = program_.PointerType(content_type_);
-  return Struct(program_, content_, program_.PointerCast(ptr, ptr_type));
+  auto st = program_.GetStructType(VectorStructName);
+  auto size_ptr = program_.StaticGEP(st, value_, {0, 1});
+  Int32 size(program_, program_.LoadI32(size_ptr));
+  Int32 capacity(program_,
+                 program_.LoadI32(program_.StaticGEP(st, value_, {0, 2})));
+
+  If(program_, size == capacity, [&]() {
+    program_.Call(program_.GetFunction(GrowFnName),
+                  {value_, (capacity + capacity).Get()});
+  });
+
+  auto data = program_.LoadPtr(program_.StaticGEP(st, value_, {0, 3}));
+  program_.StoreI32(size_ptr, (size + 1).Get());
+  return Struct(program_, content_, ElementPtr(data, size));
 }
 
 void Vector::Sort(const khir::FunctionRef& comp) {
@@ -66,8 +105,15 @@ void Vector::Sort(const khir::FunctionRef& comp) {
 }
 
 Int32 Vector::Size() {
-  return Int32(program_,
-               program_.Call(program_.GetFunction(SizeFnName), {value_}));
+  // Buckets returned by a hash table lookup are null for missing keys.
+  return Ternary(
+      program_, Bool(program_, program_.IsNullPtr(value_)),
+      [&]() { return Int32(program_, 0); },
+      [&]() {
+        auto st = program_.GetStructType(VectorStructName);
+        return Int32(program_,
+                     program_.LoadI32(program_.StaticGEP(st, value_, {0, 1})));
+      });
 }
 
 void Vector::ForwardDeclare(khir::ProgramBuilder& program) {
@@ -90,6 +136,10 @@ void Vector::ForwardDeclare(khir::ProgramBuilder& program) {
       PushBackFnName, program.PointerType(program.I8Type()), {struct_ptr},
       reinterpret_cast<void*>(&kush::runtime::Vector::PushBack));
 
+  program.DeclareExternalFunction(
+      GrowFnName, program.VoidType(), {struct_ptr, program.I32Type()},
+      reinterpret_cast<void*>(&kush::runtime::Vector::Grow));
+
   program.DeclareExternalFunction(
       GetFnName, program.PointerType(program.I8Type()),
       {struct_ptr, program.I32Type()},
@@ -28,6 +28,8 @@ class Vector {
       "kush::runtime::Vector::Vector";
 
  private:
+  khir::Value ElementPtr(khir::Value data, const Int32& idx);
+
   khir::ProgramBuilder& program_;
   StructBuilder& content_;
   khir::Type content_type_;
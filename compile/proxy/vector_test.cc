@@ -0,0 +1,129 @@
+#include "compile/proxy/vector.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "catalog/sql_type.h"
+#include "compile/proxy/struct.h"
+#include "khir/asm/asm_backend.h"
+#include "khir/backend.h"
+#include "khir/llvm/llvm_backend.h"
+#include "khir/program_builder.h"
+#include "runtime/vector.h"
+
+using namespace kush;
+using namespace kush::khir;
+using namespace kush::compile::proxy;
+
+std::unique_ptr<Backend> Compile(
+    const std::pair<BackendType, khir::RegAllocImpl>& params,
+    khir::Program& program) {
+  std::unique_ptr<Backend> backend;
+  switch (params.first) {
+    case BackendType::ASM: {
+      auto b = std::make_unique<khir::ASMBackend>(program, params.second);
+      b->Compile();
+      backend = std::move(b);
+      break;
+    }
+
+    case BackendType::LLVM: {
+      auto b = std::make_unique<khir::LLVMBackend>(program);
+      backend = std::move(b);
+      break;
+    }
+  }
+  return backend;
+}
+
+class VectorTest : public testing::TestWithParam<
+                       std::pair<BackendType, khir::RegAllocImpl>> {};
+
+TEST_P(VectorTest, PushBackGetSize) {
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  std::uniform_int_distribution<int32_t> distrib(INT32_MIN, INT32_MAX);
+
+  ProgramBuilder program;
+  Vector::ForwardDeclare(program);
+  auto vector_ptr_type =
+      program.PointerType(program.GetStructType(Vector::VectorStructName));
+
+  // An odd sized element so indexing cannot use a single scaled load.
+  StructBuilder content(program);
+  content.Add(catalog::Type::Int(), false);
+  content.Add(catalog::Type::SmallInt(), false);
+  content.Build();
+  auto element_size = program.GetTypeManager().GetTypeSize(content.Type());
+
+  {
+    auto func = program.CreateNamedFunction(
+        program.VoidType(), {vector_ptr_type, program.I32Type()}, "push");
+    auto args = program.GetFunctionArguments(func);
+    Vector vec(program, content, args[0]);
+    Int32 v(program, args[1]);
+    Int16 w(program, program.I16TruncI64(program.I64ZextI32(args[1])));
+    vec.PushBack().Pack(
+        {SQLValue(v, Bool(program, false)), SQLValue(w, Bool(program, false))});
+    program.Return();
+  }
+
+  {
+    auto func = program.CreateNamedFunction(
+        program.I32Type(), {vector_ptr_type, program.I32Type()}, "get");
+    auto args = program.GetFunctionArguments(func);
+    Vector vec(program, content, args[0]);
+    auto value = vec[Int32(program, args[1])].Get(0);
+    program.Return(value.Get().Get());
+  }
+
+  {
+    auto func = program.CreateNamedFunction(program.I32Type(),
+                                            {vector_ptr_type}, "size");
+    auto args = program.GetFunctionArguments(func);
+    Vector vec(program, content, args[0]);
+    program.Return(vec.Size().Get());
+  }
+
+  auto built = program.Build();
+  auto backend = Compile(GetParam(), *built);
+
+  using push_fn =
+      std::add_pointer<void(runtime::Vector::Vector*, int32_t)>::type;
+  using get_fn =
+      std::add_pointer<int32_t(runtime::Vector::Vector*, int32_t)>::type;
+  using size_fn = std::add_pointer<int32_t(runtime::Vector::Vector*)>::type;
+  auto push = reinterpret_cast<push_fn>(backend->GetFunction("push"));
+  auto get = reinterpret_cast<get_fn>(backend->GetFunction("get"));
+  auto size = reinterpret_cast<size_fn>(backend->GetFunction("size"));
+
+  runtime::Vector::Vector vec;
+  runtime::Vector::Create(&vec, element_size, 2);
+
+  std::vector<int32_t> expected;
+  for (int i = 0; i < 1000; i++) {
+    expected.push_back(distrib(gen));
+    push(&vec, expected.back());
+  }
+
+  EXPECT_EQ(expected.size(), size(&vec));
+  EXPECT_EQ(0, size(nullptr));
+  for (int i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(expected[i], get(&vec, i));
+  }
+
+  runtime::Vector::Free(&vec);
+}
+
+INSTANTIATE_TEST_SUITE_P(LLVMBackendTest, VectorTest,
+                         testing::Values(std::make_pair(
+                             BackendType::LLVM, RegAllocImpl::STACK_SPILL)));
+
+INSTANTIATE_TEST_SUITE_P(ASMBackendTest_StackSpill, VectorTest,
+                         testing::Values(std::make_pair(
+                             BackendType::ASM, RegAllocImpl::STACK_SPILL)));
+
+INSTANTIATE_TEST_SUITE_P(ASMBackendTest_LinearScan, VectorTest,
+                         testing::Values(std::make_pair(
+                             BackendType::ASM, RegAllocImpl::LINEAR_SCAN)));
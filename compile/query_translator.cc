@@ -10,6 +10,7 @@
 #include "khir/program_builder.h"
 #include "khir/program_printer.h"
 #include "plan/operator/operator.h"
+#include "util/query_stats.h"
 
 namespace kush::compile {
 
@@ -18,19 +19,29 @@ execution::ExecutableQuery TranslateQuery(const plan::Operator& op) {
   execution::PipelineBuilder pipeline_builder;
   execution::QueryState state;
 
-  ForwardDeclare(program_builder);
-
-  // Generate code for operator
-  TranslatorFactory factory(program_builder, pipeline_builder, state);
-  auto translator = factory.Compute(op);
-
-  proxy::Pipeline output_pipeline(program_builder, pipeline_builder);
-  translator->Produce(output_pipeline);
-  output_pipeline.Build();
-
-  return execution::ExecutableQuery(
-      std::move(translator), program_builder.Build(),
-      std::move(pipeline_builder), std::move(state));
+  std::unique_ptr<OperatorTranslator> translator;
+  {
+    util::PhaseTimer timer("translate");
+    ForwardDeclare(program_builder);
+
+    // Generate code for operator
+    TranslatorFactory factory(program_builder, pipeline_builder, state);
+    translator = factory.Compute(op);
+
+    proxy::Pipeline output_pipeline(program_builder, pipeline_builder);
+    translator->Produce(output_pipeline);
+    output_pipeline.Build();
+  }
+
+  std::unique_ptr<khir::Program> program;
+  {
+    util::PhaseTimer timer("khir_build");
+    program = program_builder.Build();
+  }
+
+  return execution::ExecutableQuery(std::move(translator), std::move(program),
+                                    std::move(pipeline_builder),
+                                    std::move(state));
 }
 
 }  // namespace kush::compile
\ No newline at end of file
@@ -1,9 +1,16 @@
 #include "compile/translators/expression_translator.h"
 
+#include <functional>
 #include <memory>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include "re2/re2.h"
+
+#include "catalog/sql_type.h"
 #include "compile/proxy/control_flow/if.h"
 #include "compile/proxy/evaluate.h"
 #include "compile/proxy/value/ir_value.h"
@@ -19,6 +26,9 @@
 #include "plan/expression/literal_expression.h"
 #include "plan/expression/virtual_column_ref_expression.h"
 #include "runtime/date.h"
+#include "runtime/enum.h"
+#include "runtime/like.h"
+#include "runtime/string.h"
 
 namespace kush::compile {
 
@@ -36,6 +46,166 @@ void ExpressionTranslator::ForwardDeclare(khir::ProgramBuilder& program) {
       reinterpret_cast<void*>(&runtime::Date::ExtractYear));
 }
 
+proxy::Bool GenerateValues(khir::ProgramBuilder& program,
+                           const proxy::Enum& lhs_v,
+                           const std::vector<int>& values, int curr) {
+  auto num_remaining = values.size() - curr;
+  if (num_remaining > 8) {
+    std::array<int, 8> constants;
+    for (int i = 0; i < 8; i++) {
+      constants[i] = values[curr + i];
+    }
+    proxy::Bool eq(program, program.CmpEqConstI32(lhs_v.Get(), constants));
+
+    return proxy::Ternary(
+        program, eq, [&]() { return proxy::Bool(program, true); },
+        [&]() { return GenerateValues(program, lhs_v, values, curr + 8); });
+  }
+
+  // for anything 5 and above
+  if (num_remaining >= 5) {
+    std::array<int, 8> constants;
+    for (int i = 0; i < num_remaining; i++) {
+      constants[i] = values[curr + i];
+    }
+    for (int i = num_remaining; i < 8; i++) {
+      constants[i] = -1;
+    }
+    return proxy::Bool(program, program.CmpEqConstI32(lhs_v.Get(), constants));
+  }
+
+  // for anything 2-4
+  if (num_remaining >= 2) {
+    std::array<int, 4> constants;
+    for (int i = 0; i < num_remaining; i++) {
+      constants[i] = values[curr + i];
+    }
+    for (int i = num_remaining; i < 4; i++) {
+      constants[i] = -1;
+    }
+    return proxy::Bool(program, program.CmpEqConstI32(lhs_v.Get(), constants));
+  }
+
+  return proxy::Bool(program, program.CmpI32(khir::CompType::EQ, lhs_v.Get(),
+                                             program.ConstI32(values[curr])));
+}
+
+// Evaluates pred once over the dictionary of lhs_v while generating code so
+// that each row only tests its code against the qualifying codes.
+proxy::Bool FilterDictionary(
+    khir::ProgramBuilder& program, const proxy::Enum& lhs_v,
+    const std::function<bool(std::string_view)>& pred) {
+  auto size = runtime::Enum::Size(lhs_v.EnumId());
+
+  std::vector<int> values;
+  std::string qualifies(size, 0);
+  for (int32_t i = 0; i < size; i++) {
+    runtime::String::String key;
+    runtime::Enum::GetKey(lhs_v.EnumId(), i, &key);
+    if (pred(runtime::String::View(&key))) {
+      values.push_back(i);
+      qualifies[i] = 1;
+    }
+  }
+
+  if (values.empty()) {
+    return proxy::Bool(program, false);
+  }
+
+  if (values.size() == static_cast<size_t>(size)) {
+    return proxy::Bool(program, true);
+  }
+
+  // Ranges and prefixes qualify a range of codes in sorted dictionaries.
+  if (values.size() > 1 &&
+      values.back() - values.front() + 1 == static_cast<int>(values.size())) {
+    auto code = proxy::Int32(program, lhs_v.Get());
+    return code >= values.front() && code <= values.back();
+  }
+
+  if (values.size() <= 16) {
+    return GenerateValues(program, lhs_v, values, 0);
+  }
+
+  // khir has no variable shifts so store a byte rather than a bit per code.
+  auto qualifies_ptr = program.DynamicGEP(
+      program.I8Type(), program.GlobalConstCharArray(qualifies), lhs_v.Get(),
+      {});
+  return proxy::Bool(program, program.CmpI8(khir::CompType::NE,
+                                            program.LoadI8(qualifies_ptr),
+                                            program.ConstI8(0)));
+}
+
+// Returns the predicate on the dictionary keys that arith is equivalent to
+// when it compares an enum with a non-null constant string.
+std::optional<std::function<bool(std::string_view)>> DictionaryPredicate(
+    const plan::BinaryArithmeticExpression& arith) {
+  using OpType = plan::BinaryArithmeticExpressionType;
+  if (arith.LeftChild().Type().type_id != catalog::TypeId::ENUM) {
+    return std::nullopt;
+  }
+
+  auto literal =
+      dynamic_cast<const plan::LiteralExpression*>(&arith.RightChild());
+  if (literal == nullptr) {
+    return std::nullopt;
+  }
+
+  std::optional<std::string> rhs;
+  auto ignore = [](auto...) {};
+  literal->Visit(ignore, ignore, ignore, ignore,
+                 [&](std::string v, bool null) {
+                   if (!null) {
+                     rhs = v;
+                   }
+                 },
+                 ignore, ignore,
+                 [&](int32_t v, int32_t enum_id, bool null) {
+                   if (!null) {
+                     runtime::String::String key;
+                     runtime::Enum::GetKey(enum_id, v, &key);
+                     rhs = std::string(runtime::String::View(&key));
+                   }
+                 });
+  if (!rhs.has_value()) {
+    return std::nullopt;
+  }
+
+  auto value = std::move(rhs.value());
+  switch (arith.OpType()) {
+    case OpType::LT:
+      return [value](std::string_view key) { return key < value; };
+
+    case OpType::LEQ:
+      return [value](std::string_view key) { return key <= value; };
+
+    case OpType::GT:
+      return [value](std::string_view key) { return key > value; };
+
+    case OpType::GEQ:
+      return [value](std::string_view key) { return key >= value; };
+
+    case OpType::STARTS_WITH:
+      return [value](std::string_view key) {
+        return key.substr(0, value.size()) == value;
+      };
+
+    case OpType::ENDS_WITH:
+      return [value](std::string_view key) {
+        return key.size() >= value.size() &&
+               key.substr(key.size() - value.size()) == value;
+      };
+
+    case OpType::CONTAINS:
+      return [value](std::string_view key) {
+        return key.find(value) != std::string_view::npos;
+      };
+
+    default:
+      return std::nullopt;
+  }
+}
+
 ExpressionTranslator::ExpressionTranslator(khir::ProgramBuilder& program,
                                            OperatorTranslator& source)
     : program_(program), source_(source) {}
@@ -68,6 +238,22 @@ void ExpressionTranslator::Visit(const plan::UnaryArithmeticExpression& arith) {
 
 void ExpressionTranslator::Visit(
     const plan::BinaryArithmeticExpression& arith) {
+  if (auto pred = DictionaryPredicate(arith)) {
+    auto lhs = Compute(arith.LeftChild());
+    Return(proxy::NullableTernary<proxy::Bool>(
+        program_, lhs.IsNull(),
+        [&]() {
+          return proxy::SQLValue(proxy::Bool(program_, false),
+                                 proxy::Bool(program_, true));
+        },
+        [&]() {
+          const auto& lhs_v = dynamic_cast<const proxy::Enum&>(lhs.Get());
+          return proxy::SQLValue(FilterDictionary(program_, lhs_v, *pred),
+                                 proxy::Bool(program_, false));
+        }));
+    return;
+  }
+
   using OpType = plan::BinaryArithmeticExpressionType;
   switch (arith.OpType()) {
     // Special handling for AND/OR for short circuiting
@@ -285,8 +471,14 @@ void ExpressionTranslator::Visit(
       },
       [&]() {
         if (auto lhs_v = dynamic_cast<proxy::Enum*>(&lhs.Get())) {
-          return proxy::SQLValue(lhs_v->ToString().Like(match_expr.Regex()),
-                                 proxy::Bool(program_, false));
+          auto regex = match_expr.Regex();
+          return proxy::SQLValue(
+              FilterDictionary(program_, *lhs_v,
+                               [regex](std::string_view key) {
+                                 re2::StringPiece sp(key.data(), key.size());
+                                 return RE2::FullMatch(sp, *regex);
+                               }),
+              proxy::Bool(program_, false));
         }
 
         const proxy::String& lhs_v =
@@ -296,48 +488,33 @@ void ExpressionTranslator::Visit(
       }));
 }
 
-proxy::Bool GenerateValues(khir::ProgramBuilder& program,
-                           const proxy::Enum& lhs_v,
-                           const std::vector<int>& values, int curr) {
-  auto num_remaining = values.size() - curr;
-  if (num_remaining > 8) {
-    std::array<int, 8> constants;
-    for (int i = 0; i < 8; i++) {
-      constants[i] = values[curr + i];
-    }
-    proxy::Bool eq(program, program.CmpEqConstI32(lhs_v.Get(), constants));
-
-    return proxy::Ternary(
-        program, eq, [&]() { return proxy::Bool(program, true); },
-        [&]() { return GenerateValues(program, lhs_v, values, curr + 8); });
-  }
-
-  // for anything 5 and above
-  if (num_remaining >= 5) {
-    std::array<int, 8> constants;
-    for (int i = 0; i < num_remaining; i++) {
-      constants[i] = values[curr + i];
-    }
-    for (int i = num_remaining; i < 8; i++) {
-      constants[i] = -1;
-    }
-    return proxy::Bool(program, program.CmpEqConstI32(lhs_v.Get(), constants));
-  }
-
-  // for anything 2-4
-  if (num_remaining >= 2) {
-    std::array<int, 4> constants;
-    for (int i = 0; i < num_remaining; i++) {
-      constants[i] = values[curr + i];
-    }
-    for (int i = num_remaining; i < 4; i++) {
-      constants[i] = -1;
-    }
-    return proxy::Bool(program, program.CmpEqConstI32(lhs_v.Get(), constants));
-  }
+void ExpressionTranslator::Visit(const plan::LikeExpression& like_expr) {
+  auto lhs = Compute(like_expr.Child());
+  Return(proxy::NullableTernary<proxy::Bool>(
+      program_, lhs.IsNull(),
+      [&]() {
+        return proxy::SQLValue(proxy::Bool(program_, false),
+                               proxy::Bool(program_, false));
+      },
+      [&]() {
+        if (auto lhs_v = dynamic_cast<proxy::Enum*>(&lhs.Get())) {
+          auto pattern = like_expr.Pattern();
+          return proxy::SQLValue(
+              FilterDictionary(program_, *lhs_v,
+                               [pattern](std::string_view key) {
+                                 runtime::String::String s;
+                                 runtime::String::Init(&s, key.data(),
+                                                       key.size());
+                                 return runtime::Like::Match(&s, pattern);
+                               }),
+              proxy::Bool(program_, false));
+        }
 
-  return proxy::Bool(program, program.CmpI32(khir::CompType::EQ, lhs_v.Get(),
-                                             program.ConstI32(values[curr])));
+        const proxy::String& lhs_v =
+            dynamic_cast<const proxy::String&>(lhs.Get());
+        return proxy::SQLValue(lhs_v.Like(like_expr.Pattern()),
+                               proxy::Bool(program_, false));
+      }));
 }
 
 void ExpressionTranslator::Visit(const plan::EnumInExpression& expr) {
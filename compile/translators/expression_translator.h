@@ -31,6 +31,7 @@ class ExpressionTranslator
   void Visit(const plan::IntToFloatConversionExpression& conv_expr) override;
   void Visit(const plan::ExtractExpression& extract_expr) override;
   void Visit(const plan::RegexpMatchingExpression& match_expr) override;
+  void Visit(const plan::LikeExpression& like_expr) override;
   void Visit(const plan::EnumInExpression& match_expr) override;
 
   static void ForwardDeclare(khir::ProgramBuilder& program);
@@ -120,8 +120,16 @@ void HashJoinTranslator::Consume(OperatorTranslator& src) {
       [&](auto& loop) {
         auto i = loop.template GetLoopVariable<proxy::Int32>(0);
 
+        // Only load the fields of the entry that are used, so that payload
+        // columns are not read for entries whose keys do not match.
         auto left_tuple = bucket[i];
-        left_translator.SchemaValues().SetValues(left_tuple.Unpack());
+        auto& left_values = left_translator.SchemaValues();
+        left_values.ResetValues();
+        for (int c = 0; c < hash_join_.LeftChild().Schema().Columns().size();
+             c++) {
+          left_values.AddDeferred(
+              [left_tuple, c]() mutable { return left_tuple.Get(c); });
+        }
 
         CheckEquality(program_, expr_translator_, left_keys, right_keys, [&]() {
           this->values_.ResetValues();
@@ -963,7 +963,8 @@ void PermutableSkinnerJoinTranslator::Produce(proxy::Pipeline& output) {
         program_.StaticGEP(idx_array_type, idx_array, {0, 0}),
         program_.StaticGEP(num_result_tuples_type, num_result_tuples_ptr,
                            {0, 0}),
-        program_.StaticGEP(offset_array_type, offset_array, {0, 0}));
+        program_.StaticGEP(offset_array_type, offset_array, {0, 0}),
+        tuple_idx_table.Get());
 
     tuple_idx_table.Reset();
   });
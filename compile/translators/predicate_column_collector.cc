@@ -76,6 +76,10 @@ void PredicateColumnCollector::Visit(
   VisitChildren(match);
 }
 
+void PredicateColumnCollector::Visit(const plan::LikeExpression& like) {
+  VisitChildren(like);
+}
+
 void PredicateColumnCollector::Visit(const plan::EnumInExpression& match) {
   VisitChildren(match);
 }
@@ -154,6 +158,11 @@ void ScanSelectPredicateColumnCollector::Visit(
   VisitChildren(match);
 }
 
+void ScanSelectPredicateColumnCollector::Visit(
+    const plan::LikeExpression& like) {
+  VisitChildren(like);
+}
+
 void ScanSelectPredicateColumnCollector::Visit(
     const plan::LiteralExpression& literal) {}
 
@@ -33,6 +33,7 @@ class PredicateColumnCollector : public plan::ImmutableExpressionVisitor {
   void Visit(const plan::AggregateExpression& agg) override;
   void Visit(const plan::VirtualColumnRefExpression& virtual_col_ref) override;
   void Visit(const plan::RegexpMatchingExpression& match) override;
+  void Visit(const plan::LikeExpression& like) override;
   void Visit(const plan::EnumInExpression& match) override;
 
  private:
@@ -60,6 +61,7 @@ class ScanSelectPredicateColumnCollector
   void Visit(const plan::AggregateExpression& agg) override;
   void Visit(const plan::VirtualColumnRefExpression& virtual_col_ref) override;
   void Visit(const plan::RegexpMatchingExpression& match) override;
+  void Visit(const plan::LikeExpression& like) override;
   void Visit(const plan::EnumInExpression& match) override;
 
  private:
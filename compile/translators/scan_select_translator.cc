@@ -3,9 +3,11 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 
+#include "catalog/sql_type.h"
 #include "compile/proxy/column_data.h"
 #include "compile/proxy/control_flow/if.h"
 #include "compile/proxy/control_flow/loop.h"
+#include "compile/proxy/predicate_order.h"
 #include "compile/translators/expression_translator.h"
 #include "compile/translators/operator_translator.h"
 #include "compile/translators/predicate_column_collector.h"
@@ -89,8 +91,48 @@ ScanSelectTranslator::GenerateBuffer() {
       program_, std::move(column_data), std::move(null_data));
 }
 
+std::vector<int32_t> ScanSelectTranslator::PredicateCosts() {
+  // Rough cost of each predicate by the columns it reads. Strings are
+  // compared character by character so weigh them higher.
+  std::vector<int32_t> costs;
+  for (auto condition : scan_select_.Filters()) {
+    ScanSelectPredicateColumnCollector collector;
+    condition.get().Accept(collector);
+
+    int32_t cost = 1;
+    for (auto col : collector.PredicateColumns()) {
+      cost += col.get().Type().type_id == catalog::TypeId::TEXT ? 4 : 1;
+    }
+    costs.push_back(cost);
+  }
+  return costs;
+}
+
+void ScanSelectTranslator::LoadPredicateColumns(
+    const plan::Expression& condition, proxy::Int32& i,
+    proxy::DiskMaterializedBuffer& materialized_buffer,
+    absl::flat_hash_set<int>& loaded_cols) {
+  ScanSelectPredicateColumnCollector collector;
+  condition.Accept(collector);
+  for (auto col : collector.PredicateColumns()) {
+    auto col_idx = col.get().GetColumnIdx();
+    if (!loaded_cols.contains(col_idx)) {
+      loaded_cols.insert(col_idx);
+      this->virtual_values_.SetValue(col_idx,
+                                     materialized_buffer.Get(i, col_idx));
+    }
+  }
+}
+
 void ScanSelectTranslator::Produce(proxy::Pipeline& output) {
   auto materialized_buffer = GenerateBuffer();
+  auto filters = scan_select_.Filters();
+
+  std::unique_ptr<proxy::PredicateOrder> order;
+  if (filters.size() > 1 && proxy::GetPredicateOrderMode() ==
+                                proxy::PredicateOrderMode::ADAPTIVE) {
+    order = std::make_unique<proxy::PredicateOrder>(program_, PredicateCosts());
+  }
 
   // Create a dummy pipeline for the input
   proxy::Pipeline input(program_, pipeline_builder_);
@@ -100,6 +142,12 @@ void ScanSelectTranslator::Produce(proxy::Pipeline& output) {
   input.Build();
 
   output.Body(input, [&](proxy::Int32 start, proxy::Int32 end) {
+    // Each morsel evaluates the predicates in the order measured best on the
+    // samples of the previous morsels.
+    if (order != nullptr) {
+      order->Reorder();
+    }
+
     proxy::Loop loop(
         program_, [&](auto& loop) { loop.AddLoopVariable(start); },
         [&](auto& loop) {
@@ -114,28 +162,69 @@ void ScanSelectTranslator::Produce(proxy::Pipeline& output) {
 
           absl::flat_hash_set<int> loaded_cols;
 
-          for (auto condition : scan_select_.Filters()) {
-            ScanSelectPredicateColumnCollector collector;
-            condition.get().Accept(collector);
-            for (auto col : collector.PredicateColumns()) {
-              auto col_idx = col.get().GetColumnIdx();
-              if (!loaded_cols.contains(col_idx)) {
-                loaded_cols.insert(col_idx);
-                this->virtual_values_.SetValue(
-                    col_idx, materialized_buffer->Get(i, col_idx));
-              }
-            }
+          if (order != nullptr) {
+            // Dispatch on the predicate at each position of the order. Each
+            // predicate loads its own columns since the branches do not
+            // dominate each other.
+            auto sampled = order->Sampled(i);
+            proxy::Loop predicate_loop(
+                program_,
+                [&](auto& predicate_loop) {
+                  predicate_loop.AddLoopVariable(proxy::Int32(program_, 0));
+                },
+                [&](auto& predicate_loop) {
+                  auto position =
+                      predicate_loop.template GetLoopVariable<proxy::Int32>(0);
+                  return position < order->Size();
+                },
+                [&](auto& predicate_loop) {
+                  auto position =
+                      predicate_loop.template GetLoopVariable<proxy::Int32>(0);
+                  order->Switch(order->Get(position), [&](int j) {
+                    absl::flat_hash_set<int> predicate_cols;
+                    LoadPredicateColumns(filters[j].get(), i,
+                                         *materialized_buffer, predicate_cols);
+
+                    order->Evaluated(sampled, j);
+                    auto value = expr_translator_.Compute(filters[j].get());
+                    proxy::If(program_, value.IsNull(),
+                              [&]() { loop.Continue(i + 1); });
+                    proxy::If(program_, NOT,
+                              static_cast<proxy::Bool&>(value.Get()),
+                              [&]() { loop.Continue(i + 1); });
+                    order->Passed(sampled, j);
+                  });
 
-            auto value = expr_translator_.Compute(condition.get());
-            proxy::If(program_, value.IsNull(),
-                      [&]() { loop.Continue(i + 1); });
-            proxy::If(program_, NOT, static_cast<proxy::Bool&>(value.Get()),
-                      [&]() { loop.Continue(i + 1); });
+                  return predicate_loop.Continue(position + 1);
+                });
+          } else {
+            for (auto condition : filters) {
+              LoadPredicateColumns(condition.get(), i, *materialized_buffer,
+                                   loaded_cols);
+
+              auto value = expr_translator_.Compute(condition.get());
+              proxy::If(program_, value.IsNull(),
+                        [&]() { loop.Continue(i + 1); });
+              proxy::If(program_, NOT, static_cast<proxy::Bool&>(value.Get()),
+                        [&]() { loop.Continue(i + 1); });
+            }
           }
 
-          auto num_cols = scan_select_.ScanSchema().Columns().size();
-          for (int col_idx = 0; col_idx < num_cols; col_idx++) {
-            if (!loaded_cols.contains(col_idx)) {
+          // TEXT columns are loaded through a runtime call so only load them
+          // where the parent uses them.
+          const auto& scan_cols = scan_select_.ScanSchema().Columns();
+          for (int col_idx = 0; col_idx < scan_cols.size(); col_idx++) {
+            if (loaded_cols.contains(col_idx)) {
+              continue;
+            }
+
+            if (scan_cols[col_idx].Expr().Type().type_id ==
+                catalog::TypeId::TEXT) {
+              this->virtual_values_.SetDeferred(
+                  col_idx, [buffer = materialized_buffer.get(), i, col_idx]() {
+                    return buffer->Get(i, col_idx);
+                  });
+            } else {
               this->virtual_values_.SetValue(
                   col_idx, materialized_buffer->Get(i, col_idx));
             }
@@ -143,7 +232,14 @@ void ScanSelectTranslator::Produce(proxy::Pipeline& output) {
 
           this->values_.ResetValues();
           for (const auto& column : scan_select_.Schema().Columns()) {
-            this->values_.AddVariable(expr_translator_.Compute(column.Expr()));
+            if (column.Expr().Type().type_id == catalog::TypeId::TEXT) {
+              this->values_.AddDeferred([this, &column]() {
+                return expr_translator_.Compute(column.Expr());
+              });
+            } else {
+              this->values_.AddVariable(
+                  expr_translator_.Compute(column.Expr()));
+            }
           }
 
           if (auto parent = this->Parent()) {
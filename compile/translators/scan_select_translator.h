@@ -1,6 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
 
 #include "compile/proxy/column_data.h"
 #include "compile/proxy/column_index.h"
@@ -26,6 +30,10 @@ class ScanSelectTranslator : public OperatorTranslator {
 
  private:
   std::unique_ptr<proxy::DiskMaterializedBuffer> GenerateBuffer();
+  std::vector<int32_t> PredicateCosts();
+  void LoadPredicateColumns(const plan::Expression& condition, proxy::Int32& i,
+                            proxy::DiskMaterializedBuffer& materialized_buffer,
+                            absl::flat_hash_set<int>& loaded_cols);
 
   const plan::ScanSelectOperator& scan_select_;
   khir::ProgramBuilder& program_;
@@ -156,7 +156,21 @@ void ScanTranslator::Produce(proxy::Pipeline& output) {
         },
         [&](auto& loop) {
           auto i = loop.template GetLoopVariable<proxy::Int32>(0);
-          this->values_.SetValues((*materialized_buffer)[i]);
+
+          // TEXT columns are loaded through a runtime call so only load them
+          // where the parent uses them.
+          this->values_.ResetValues();
+          const auto& columns = scan_.Schema().Columns();
+          for (int c = 0; c < columns.size(); c++) {
+            if (columns[c].Expr().Type().type_id == catalog::TypeId::TEXT) {
+              this->values_.AddDeferred(
+                  [buffer = materialized_buffer.get(), i, c]() {
+                    return buffer->Get(i, c);
+                  });
+            } else {
+              this->values_.AddVariable(materialized_buffer->Get(i, c));
+            }
+          }
 
           if (auto parent = this->Parent()) {
             parent->get().Consume(*this);
@@ -1,5 +1,6 @@
 #include "compile/translators/schema_values.h"
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -102,25 +103,60 @@ void SchemaValues::PopulateWithNotNull(khir::ProgramBuilder& program,
 void SchemaValues::ResetValues() { values_.clear(); }
 
 void SchemaValues::AddVariable(proxy::SQLValue value) {
-  values_.push_back(std::move(value));
+  values_.push_back(Deferred{nullptr, value, khir::BasicBlockRef()});
 }
 
-const proxy::SQLValue& SchemaValues::Value(int idx) const {
-  return values_[idx];
+void SchemaValues::AddDeferred(std::function<proxy::SQLValue()> compute) {
+  values_.push_back(Deferred{std::move(compute), std::nullopt,
+                             khir::BasicBlockRef()});
 }
 
-const std::vector<proxy::SQLValue>& SchemaValues::Values() const {
-  return values_;
+void SchemaValues::SetDeferred(int idx,
+                               std::function<proxy::SQLValue()> compute) {
+  values_[idx] =
+      Deferred{std::move(compute), std::nullopt, khir::BasicBlockRef()};
 }
 
-std::vector<proxy::SQLValue>& SchemaValues::Values() { return values_; }
+proxy::SQLValue SchemaValues::Value(int idx) const {
+  auto& v = values_[idx];
+  if (v.compute == nullptr) {
+    return v.cached.value();
+  }
+
+  if (v.cached.has_value()) {
+    auto& program = v.cached->ProgramBuilder();
+    if (program.Dominates(v.cached_block, program.CurrentBlock())) {
+      return v.cached.value();
+    }
+    // Not reachable from the cached definition, so generate it here without
+    // replacing the cache for the uses it does dominate.
+    return v.compute();
+  }
+
+  auto value = v.compute();
+  v.cached_block = value.ProgramBuilder().CurrentBlock();
+  v.cached = value;
+  return value;
+}
+
+std::vector<proxy::SQLValue> SchemaValues::Values() const {
+  std::vector<proxy::SQLValue> values;
+  values.reserve(values_.size());
+  for (int i = 0; i < values_.size(); i++) {
+    values.push_back(Value(i));
+  }
+  return values;
+}
 
 void SchemaValues::SetValues(std::vector<proxy::SQLValue> values) {
-  values_ = std::move(values);
+  ResetValues();
+  for (auto& value : values) {
+    AddVariable(std::move(value));
+  }
 }
 
 void SchemaValues::SetValue(int idx, proxy::SQLValue value) {
-  values_[idx] = std::move(value);
+  values_[idx] = Deferred{nullptr, value, khir::BasicBlockRef()};
 }
 
 }  // namespace kush::compile
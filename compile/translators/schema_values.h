@@ -1,6 +1,8 @@
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -20,15 +22,27 @@ class SchemaValues {
   void ResetValues();
   void AddVariable(proxy::SQLValue value);
 
-  const proxy::SQLValue& Value(int idx) const;
-  const std::vector<proxy::SQLValue>& Values() const;
-  std::vector<proxy::SQLValue>& Values();
+  // Deferred values are generated by compute at their first use rather than
+  // when they are added, so that e.g. TEXT columns are only loaded for tuples
+  // that reach a use. The result is reused by later uses it dominates; other
+  // uses (e.g. in a sibling branch) generate it again.
+  void AddDeferred(std::function<proxy::SQLValue()> compute);
+  void SetDeferred(int idx, std::function<proxy::SQLValue()> compute);
+
+  proxy::SQLValue Value(int idx) const;
+  std::vector<proxy::SQLValue> Values() const;
 
   void SetValues(std::vector<proxy::SQLValue> values);
   void SetValue(int idx, proxy::SQLValue value);
 
  private:
-  std::vector<proxy::SQLValue> values_;
+  struct Deferred {
+    std::function<proxy::SQLValue()> compute;
+    std::optional<proxy::SQLValue> cached;
+    khir::BasicBlockRef cached_block;
+  };
+
+  mutable std::vector<Deferred> values_;
 };
 
 }  // namespace kush::compile
@@ -2,6 +2,7 @@
 
 #include <memory>
 
+#include "catalog/sql_type.h"
 #include "compile/proxy/column_data.h"
 #include "compile/proxy/control_flow/if.h"
 #include "compile/proxy/control_flow/loop.h"
@@ -510,13 +511,34 @@ void SimdScanSelectTranslator::Produce(proxy::Pipeline& output) {
                 auto ptr = program_.DynamicGEP(program_.I32Type(), buffer,
                                                buffer_idx.Get(), {});
                 proxy::Int32 tuple_idx(program_, program_.LoadI32(ptr));
-                this->virtual_values_.SetValues(
-                    (*materialized_buffer)[tuple_idx]);
+
+                // TEXT columns are loaded through a runtime call so only load
+                // them where the parent uses them.
+                this->virtual_values_.ResetValues();
+                const auto& scan_cols = scan_select_.ScanSchema().Columns();
+                for (int c = 0; c < scan_cols.size(); c++) {
+                  if (scan_cols[c].Expr().Type().type_id ==
+                      catalog::TypeId::TEXT) {
+                    this->virtual_values_.AddDeferred(
+                        [buffer = materialized_buffer.get(), tuple_idx, c]() {
+                          return buffer->Get(tuple_idx, c);
+                        });
+                  } else {
+                    this->virtual_values_.AddVariable(
+                        materialized_buffer->Get(tuple_idx, c));
+                  }
+                }
 
                 this->values_.ResetValues();
                 for (const auto& column : scan_select_.Schema().Columns()) {
-                  this->values_.AddVariable(
-                      expr_translator_.Compute(column.Expr()));
+                  if (column.Expr().Type().type_id == catalog::TypeId::TEXT) {
+                    this->values_.AddDeferred([this, &column]() {
+                      return expr_translator_.Compute(column.Expr());
+                    });
+                  } else {
+                    this->values_.AddVariable(
+                        expr_translator_.Compute(column.Expr()));
+                  }
                 }
 
                 if (auto parent = this->Parent()) {
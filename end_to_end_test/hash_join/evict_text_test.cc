@@ -0,0 +1,107 @@
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "gtest/gtest.h"
+
+#include "catalog/catalog.h"
+#include "catalog/sql_type.h"
+#include "compile/query_translator.h"
+#include "end_to_end_test/parameters.h"
+#include "end_to_end_test/schema.h"
+#include "end_to_end_test/test_macros.h"
+#include "plan/expression/aggregate_expression.h"
+#include "plan/expression/arithmetic_expression.h"
+#include "plan/expression/column_ref_expression.h"
+#include "plan/expression/literal_expression.h"
+#include "plan/expression/virtual_column_ref_expression.h"
+#include "plan/operator/group_by_aggregate_operator.h"
+#include "plan/operator/hash_join_operator.h"
+#include "plan/operator/operator.h"
+#include "plan/operator/operator_schema.h"
+#include "plan/operator/order_by_operator.h"
+#include "plan/operator/output_operator.h"
+#include "plan/operator/scan_operator.h"
+#include "plan/operator/select_operator.h"
+#include "util/builder.h"
+#include "util/test_util.h"
+
+ABSL_DECLARE_FLAG(int64_t, buffer_pool_size_mb);
+ABSL_DECLARE_FLAG(std::string, file_mode);
+
+using namespace kush;
+using namespace kush::util;
+using namespace kush::plan;
+using namespace kush::compile;
+using namespace kush::catalog;
+using namespace std::literals;
+
+class HashJoinTest : public testing::TestWithParam<ParameterValues> {};
+
+TEST_P(HashJoinTest, EvictTextCol) {
+  SetFlags(GetParam());
+
+  // The orders columns do not fit in the budget next to the people columns so
+  // opening them evicts every unpinned file. Evicted mappings are unmapped so
+  // reading a name of the hash tables from an evicted file faults.
+  absl::SetFlag(&FLAGS_buffer_pool_size_mb, 1);
+  absl::SetFlag(&FLAGS_file_mode, "mmap");
+
+  auto db = Schema();
+
+  std::unique_ptr<Operator> query;
+  {
+    std::unique_ptr<Operator> people;
+    {
+      OperatorSchema schema;
+      schema.AddGeneratedColumns(db["people"], {"id", "name"});
+      people = std::make_unique<ScanOperator>(std::move(schema), db["people"]);
+    }
+
+    std::unique_ptr<Operator> orders;
+    {
+      OperatorSchema schema;
+      schema.AddGeneratedColumns(db["orders"], {"o_custkey", "o_comment"});
+      orders = std::make_unique<ScanOperator>(std::move(schema), db["orders"]);
+    }
+
+    auto id = ColRef(people, "id", 0);
+    auto o_custkey = ColRef(orders, "o_custkey", 1);
+
+    OperatorSchema join_schema;
+    join_schema.AddPassthroughColumns(*people, {"name"}, 0);
+    std::unique_ptr<Operator> join = std::make_unique<HashJoinOperator>(
+        std::move(join_schema), std::move(people), std::move(orders),
+        util::MakeVector(std::move(id)),
+        util::MakeVector(std::move(o_custkey)));
+
+    auto name = ColRefE(join, "name");
+    auto count = Count();
+
+    OperatorSchema schema;
+    schema.AddDerivedColumn("name", VirtColRef(name, 0));
+    schema.AddDerivedColumn("count", VirtColRef(count, 1));
+    query = std::make_unique<OutputOperator>(
+        std::make_unique<GroupByAggregateOperator>(
+            std::move(schema), std::move(join),
+            util::MakeVector(std::move(name)),
+            util::MakeVector(std::move(count))));
+  }
+
+  auto expected_file = "end_to_end_test/hash_join/evict_text_expected.tbl";
+  auto output_file = ExecuteAndCapture(*query);
+
+  auto expected = GetFileContents(expected_file);
+  auto output = GetFileContents(output_file);
+  std::sort(expected.begin(), expected.end());
+  std::sort(output.begin(), output.end());
+  EXPECT_EQ(output, expected);
+
+  absl::SetFlag(&FLAGS_file_mode, "read");
+  absl::SetFlag(&FLAGS_buffer_pool_size_mb, 0);
+}
+
+NORMAL_TEST(HashJoinTest)
@@ -8,6 +8,7 @@ ABSL_DECLARE_FLAG(std::string, backend);
 ABSL_DECLARE_FLAG(std::string, reg_alloc);
 ABSL_DECLARE_FLAG(std::string, skinner_join);
 ABSL_DECLARE_FLAG(std::string, pipeline_mode);
+ABSL_DECLARE_FLAG(std::string, predicate_order);
 ABSL_DECLARE_FLAG(int32_t, budget_per_episode);
 
 void SetFlags(const ParameterValues& params) {
@@ -27,6 +28,10 @@ void SetFlags(const ParameterValues& params) {
     absl::SetFlag(&FLAGS_skinner_join, params.skinner);
   }
 
+  if (!params.predicate_order.empty()) {
+    absl::SetFlag(&FLAGS_predicate_order, params.predicate_order);
+  }
+
   if (params.budget_per_episode > 0) {
     absl::SetFlag(&FLAGS_budget_per_episode, params.budget_per_episode);
   }
@@ -7,6 +7,7 @@ struct ParameterValues {
   std::string backend;
   std::string reg_alloc;
   std::string skinner;
+  std::string predicate_order;
   int32_t budget_per_episode = 0;
   bool asc = false;
 };
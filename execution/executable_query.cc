@@ -1,6 +1,12 @@
 #include "execution/executable_query.h"
 
+#include <chrono>
 #include <iostream>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "absl/flags/flag.h"
 
@@ -9,10 +15,23 @@
 #include "khir/asm/asm_backend.h"
 #include "khir/asm/reg_alloc_impl.h"
 #include "khir/backend.h"
+#include "khir/branch_profile.h"
 #include "khir/llvm/llvm_backend.h"
+#include "runtime/allocator.h"
+#include "runtime/file_manager.h"
+#include "util/perf_counters.h"
+#include "util/query_stats.h"
 
 ABSL_FLAG(std::string, pipeline_mode, "adaptive",
           "Pipeline Mode: static/adaptive.");
+ABSL_FLAG(double, llvm_fast_speedup, 1.2,
+          "Estimated speedup of FAST LLVM code over the ASM backend.");
+ABSL_FLAG(double, llvm_fast_compilation_ms, 10,
+          "Estimated FAST LLVM compilation time of a pipeline in ms.");
+ABSL_FLAG(double, llvm_o3_speedup, 1.5,
+          "Estimated speedup of O3 LLVM code over the ASM backend.");
+ABSL_FLAG(double, llvm_o3_compilation_ms, 40,
+          "Estimated O3 LLVM compilation time of a pipeline in ms.");
 
 constexpr int32_t CHUNK_SIZE = 1 << 13;
 
@@ -27,7 +46,17 @@ ExecutableQuery::ExecutableQuery(
     : translator_(std::move(translator)),
       program_(std::move(program)),
       pipelines_(std::move(pipelines)),
-      state_(std::move(state)) {}
+      state_(std::move(state)),
+      asm_compilation_time_(0),
+      asm_optimization_time_(0) {}
+
+double ExecutableQuery::ASMCompilationTime() const {
+  return asm_compilation_time_;
+}
+
+double ExecutableQuery::ASMOptimizationTime() const {
+  return asm_optimization_time_;
+}
 
 void TopSortVisit(
     int curr, std::vector<bool>& visited,
@@ -94,11 +123,69 @@ void CleanUpPredecessors(
   }
 }
 
+// Accumulates the hardware counters of the body calls of a pipeline by the
+// backend tier that executed them.
+class TierCounters {
+ public:
+  explicit TierCounters(const util::PerfCounters* counters)
+      : counters_(counters) {}
+
+  template <typename F>
+  void Measure(std::string_view tier, F body) {
+    if (counters_ == nullptr) {
+      body();
+      return;
+    }
+
+    auto start = counters_->Read();
+    body();
+    auto end = counters_->Read();
+    values_[std::string(tier)] += end - start;
+  }
+
+  std::map<std::string, util::PerfCounterValues> Values() const {
+    return values_;
+  }
+
+ private:
+  const util::PerfCounters* counters_;
+  std::map<std::string, util::PerfCounterValues> values_;
+};
+
+std::string_view BackendTierName() {
+  switch (khir::GetBackendType()) {
+    case khir::BackendType::ASM:
+      return "asm";
+
+    case khir::BackendType::LLVM:
+      return "llvm";
+  }
+  throw std::runtime_error("Unknown backend.");
+}
+
+std::string_view LLVMTierName(khir::LLVMOptLevel level) {
+  switch (level) {
+    case khir::LLVMOptLevel::FAST:
+      return "llvm_fast";
+
+    case khir::LLVMOptLevel::O1:
+      return "llvm_O1";
+
+    case khir::LLVMOptLevel::O2:
+      return "llvm_O2";
+
+    case khir::LLVMOptLevel::O3:
+      return "llvm_O3";
+  }
+  throw std::runtime_error("Unknown LLVM optimization level.");
+}
+
 void ExecuteNonSplitPipeline(
     int i,
     std::vector<std::reference_wrapper<const kush::execution::Pipeline>>
         pipelines,
-    khir::Backend& asm_backend, khir::Backend& llvm_backend) {
+    khir::Backend& asm_backend, khir::Backend& llvm_backend,
+    TierCounters& counters) {
   body_fn body;
   switch (khir::GetBackendType()) {
     case khir::BackendType::ASM:
@@ -112,14 +199,16 @@ void ExecuteNonSplitPipeline(
       break;
   }
 
-  body();
+  counters.Measure(BackendTierName(), [&]() { body(); });
 }
 
-void ExecuteSplitPipelineStatic(
+// Returns the number of input tuples.
+int32_t ExecuteSplitPipelineStatic(
     int i,
     std::vector<std::reference_wrapper<const kush::execution::Pipeline>>
         pipelines,
-    khir::Backend& asm_backend, khir::Backend& llvm_backend) {
+    khir::Backend& asm_backend, khir::Backend& llvm_backend,
+    TierCounters& counters) {
   auto input_size = GetInputSize(i, pipelines, asm_backend);
   split_body_fn body;
   switch (khir::GetBackendType()) {
@@ -138,16 +227,44 @@ void ExecuteSplitPipelineStatic(
   while (next_tuple < input_size) {
     auto start = next_tuple;
     auto end = std::min(next_tuple + CHUNK_SIZE - 1, input_size - 1);
-    body(start, end);
+    counters.Measure(BackendTierName(), [&]() { body(start, end); });
     next_tuple = end + 1;
   }
+  return input_size;
 }
 
-void ExecuteSplitPipelineAdaptive(
+struct LLVMTier {
+  khir::LLVMOptLevel level;
+  double speedup;
+  double compilation_time;
+};
+
+// Estimated speedup over the ASM backend and compilation time in ms of each
+// LLVM optimization level the executor may pick.
+std::vector<LLVMTier> GetLLVMTiers() {
+  LLVMTier fast{khir::LLVMOptLevel::FAST, FLAGS_llvm_fast_speedup.Get(),
+                FLAGS_llvm_fast_compilation_ms.Get()};
+  LLVMTier o3{khir::LLVMOptLevel::O3, FLAGS_llvm_o3_speedup.Get(),
+              FLAGS_llvm_o3_compilation_ms.Get()};
+
+  if (auto level = khir::GetLLVMOptLevel()) {
+    if (level.value() == khir::LLVMOptLevel::FAST) {
+      return {fast};
+    }
+    o3.level = level.value();
+    return {o3};
+  }
+
+  return {fast, o3};
+}
+
+// Returns the number of input tuples.
+int32_t ExecuteSplitPipelineAdaptive(
     int i,
     std::vector<std::reference_wrapper<const kush::execution::Pipeline>>
         pipelines,
-    khir::Backend& asm_backend, khir::Backend& llvm_backend) {
+    khir::Backend& asm_backend, khir::LLVMBackend& llvm_backend,
+    TierCounters& counters) {
   auto input_size = GetInputSize(i, pipelines, asm_backend);
   auto body = reinterpret_cast<split_body_fn>(
       asm_backend.GetFunction(pipelines[i].get().BodyName()));
@@ -164,7 +281,7 @@ void ExecuteSplitPipelineAdaptive(
     next_tuple = end + 1;
 
     auto t1 = std::chrono::high_resolution_clock::now();
-    body(start, end);
+    counters.Measure("asm", [&]() { body(start, end); });
     auto t2 = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double, std::milli> fp_ms = t2 - t1;
     tot += fp_ms.count();
@@ -173,27 +290,38 @@ void ExecuteSplitPipelineAdaptive(
 
   if (next_tuple < input_size) {
     auto time_per_morsel = tot / THRESHOLD;
-    // estimate a 1.2x speedup
-    // estimate comp time at 10ms?
-    auto opt_time_per_morsel = time_per_morsel / 1.2;
     auto num_morsels_left = (input_size - next_tuple) / CHUNK_SIZE;
 
+    // pick the optimization level with the lowest estimated total duration
     auto duration_unoptimized = time_per_morsel * num_morsels_left;
-    auto duration_optimized = opt_time_per_morsel * num_morsels_left + 10;
+    auto best_duration = duration_unoptimized;
+    std::optional<khir::LLVMOptLevel> best_level;
+    for (const auto& tier : GetLLVMTiers()) {
+      auto opt_time_per_morsel = time_per_morsel / tier.speedup;
+      auto duration_optimized =
+          opt_time_per_morsel * num_morsels_left + tier.compilation_time;
+      if (duration_optimized < best_duration) {
+        best_duration = duration_optimized;
+        best_level = tier.level;
+      }
+    }
 
     auto exec = body;
-    if (duration_optimized < duration_unoptimized) {
-      exec = reinterpret_cast<split_body_fn>(
-          llvm_backend.GetFunction(pipelines[i].get().BodyName()));
+    std::string_view tier = "asm";
+    if (best_level.has_value()) {
+      exec = reinterpret_cast<split_body_fn>(llvm_backend.GetFunction(
+          pipelines[i].get().BodyName(), best_level.value()));
+      tier = LLVMTierName(best_level.value());
     }
 
     while (next_tuple < input_size) {
       auto start = next_tuple;
       auto end = std::min(next_tuple + CHUNK_SIZE - 1, input_size - 1);
-      exec(start, end);
+      counters.Measure(tier, [&]() { exec(start, end); });
       next_tuple = end + 1;
     }
   }
+  return input_size;
 }
 
 void ExecutableQuery::Execute() {
@@ -206,10 +334,26 @@ void ExecutableQuery::Execute() {
     throw std::runtime_error("Unknown pipeline mode.");
   }
 
+  // Read the columns and indexes in the background while compiling.
+  runtime::FileManager::Get().Prefetch(state_.Files());
+
+  // Runtime structures allocate from the arena of the query so that they are
+  // released together with it.
+  runtime::AllocatorScope allocator_scope(state_.Arena());
+
+  // The ASM backend counts branch edges while executing the first morsels
+  // which LLVM then uses as branch weights.
+  std::unique_ptr<khir::BranchProfile> profile;
+  if (mode == PipelineMode::ADAPTIVE && khir::BranchProfilingEnabled()) {
+    profile = std::make_unique<khir::BranchProfile>(*program_);
+  }
+
   auto asm_backend =
       std::make_unique<khir::ASMBackend>(*program_, khir::GetRegAllocImpl());
+  asm_backend->SetBranchProfile(profile.get());
   asm_backend->Compile();
   auto llvm_backend = std::make_unique<khir::LLVMBackend>(*program_);
+  llvm_backend->SetBranchProfile(profile.get());
 
   auto pipelines = pipelines_.Pipelines();
 
@@ -226,21 +370,45 @@ void ExecutableQuery::Execute() {
   std::vector<int> users(pipelines.size(), 0);
 
   // execute each pipeline in topological order
+  auto& stats = util::QueryStats::Get();
+  auto stats_enabled = stats.Enabled();
+  std::unique_ptr<util::PerfCounters> perf_counters;
+  if (stats_enabled && util::PerfCountersEnabled()) {
+    perf_counters = std::make_unique<util::PerfCounters>();
+    if (!perf_counters->Valid()) {
+      std::cerr << "Unable to open hardware performance counters."
+                << std::endl;
+      perf_counters.reset();
+    }
+  }
+
   for (int i : order) {
+    auto t1 = std::chrono::steady_clock::now();
     InitializeOutput(i, pipelines, *asm_backend);
 
+    TierCounters counters(perf_counters.get());
+    int64_t num_tuples = -1;
     const auto& pipeline = pipelines[i].get();
     if (pipeline.Split()) {
       if (mode == PipelineMode::ADAPTIVE) {
-        ExecuteSplitPipelineAdaptive(i, pipelines, *asm_backend, *llvm_backend);
+        num_tuples = ExecuteSplitPipelineAdaptive(
+            i, pipelines, *asm_backend, *llvm_backend, counters);
       } else {
-        ExecuteSplitPipelineStatic(i, pipelines, *asm_backend, *llvm_backend);
+        num_tuples = ExecuteSplitPipelineStatic(i, pipelines, *asm_backend,
+                                                *llvm_backend, counters);
       }
     } else {
-      ExecuteNonSplitPipeline(i, pipelines, *asm_backend, *llvm_backend);
+      ExecuteNonSplitPipeline(i, pipelines, *asm_backend, *llvm_backend,
+                              counters);
     }
 
     CleanUpPredecessors(i, pipelines, users, *asm_backend);
+
+    if (stats_enabled) {
+      auto t2 = std::chrono::steady_clock::now();
+      std::chrono::duration<double, std::milli> fp_ms = t2 - t1;
+      stats.AddPipeline(i, fp_ms.count(), num_tuples, counters.Values());
+    }
   }
 
   {  // Clean up the final buffer
@@ -252,6 +420,11 @@ void ExecutableQuery::Execute() {
         asm_backend->GetFunction(pipelines[final].get().ResetName()));
     reset();
   }
+
+  runtime::FileManager::Get().EndQuery();
+
+  asm_compilation_time_ = asm_backend->CompilationTime();
+  asm_optimization_time_ = asm_backend->OptimizationTime();
 }
 
 }  // namespace kush::execution
\ No newline at end of file
@@ -14,11 +14,17 @@ class ExecutableQuery {
                   PipelineBuilder pipelines, QueryState state);
   void Execute();
 
+  // Milliseconds spent in the ASM backend during the last Execute.
+  double ASMCompilationTime() const;
+  double ASMOptimizationTime() const;
+
  private:
   std::unique_ptr<compile::OperatorTranslator> translator_;
   std::unique_ptr<khir::Program> program_;
   PipelineBuilder pipelines_;
   QueryState state_;
+  double asm_compilation_time_;
+  double asm_optimization_time_;
 };
 
 }  // namespace kush::execution
\ No newline at end of file
@@ -3,41 +3,45 @@
 #include <memory>
 #include <stack>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "runtime/allocator.h"
+
 namespace kush::execution {
 
 class QueryState {
  public:
-  QueryState() = default;
+  QueryState() : allocator_(std::make_unique<runtime::Allocator>()) {}
   QueryState(const QueryState&) = delete;
-  QueryState(QueryState&& st) : values_(std::move(st.values_)) {}
-  virtual ~QueryState() {
-    for (auto v : values_) {
-      free(v);
-    }
-  }
+  QueryState(QueryState&& st)
+      : allocator_(std::move(st.allocator_)), files_(std::move(st.files_)) {}
+  virtual ~QueryState() = default;
   QueryState& operator=(const QueryState&) = delete;
   QueryState& operator=(QueryState&& st) {
-    values_ = std::move(st.values_);
+    allocator_ = std::move(st.allocator_);
+    files_ = std::move(st.files_);
     return *this;
   }
 
   template <typename T>
   void* Allocate() {
-    auto dest = malloc(sizeof(T));
-    values_.push_back(dest);
-    return dest;
+    return allocator_->Allocate(sizeof(T));
   }
 
-  void* Allocate(uint64_t size) {
-    auto dest = malloc(size);
-    values_.push_back(dest);
-    return dest;
-  }
+  void* Allocate(uint64_t size) { return allocator_->Allocate(size); }
+
+  // Arena of the query. Globals are allocated from it and runtime structures
+  // while the query executes. Everything is released with the query state.
+  runtime::Allocator& Arena() { return *allocator_; }
+
+  // Files opened by the query, read ahead of execution.
+  void AddFile(std::string_view path) { files_.emplace_back(path); }
+  const std::vector<std::string>& Files() const { return files_; }
 
  private:
-  std::vector<void*> values_;
+  std::unique_ptr<runtime::Allocator> allocator_;
+  std::vector<std::string> files_;
 };
 
 }  // namespace kush::execution
\ No newline at end of file
@@ -1,24 +1,33 @@
 #include "khir/asm/asm_backend.h"
 
+#include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <cstdlib>
 #include <iostream>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
 
 #include "absl/types/span.h"
 
 #include "asmjit/x86.h"
 
+#include "khir/asm/dead_code_elimination.h"
 #include "khir/asm/dfs_label.h"
+#include "khir/asm/licm.h"
 #include "khir/asm/linear_scan_reg_alloc.h"
 #include "khir/asm/materialize_gep.h"
 #include "khir/asm/register_assignment.h"
 #include "khir/asm/stack_spill_reg_alloc.h"
+#include "khir/asm/value_numbering.h"
 #include "khir/backend.h"
 #include "khir/instruction.h"
 #include "khir/opcode.h"
 #include "khir/type_manager.h"
 #include "util/permute.h"
 #include "util/profile_map_generator.h"
+#include "util/query_stats.h"
 
 namespace kush::khir {
 
@@ -56,10 +65,35 @@ class ErrorPrinter : public ErrorHandler {
   }
 };
 
-double ASMBackend::compilation_time_ = 0;
-
 ASMBackend::ASMBackend(const Program& program, RegAllocImpl impl)
-    : program_(program), reg_alloc_impl_(impl), logger_(stderr) {}
+    : program_(program),
+      reg_alloc_impl_(impl),
+      profile_(nullptr),
+      next_func_(0),
+      stop_(false),
+      compilation_time_(0),
+      optimization_time_(0) {}
+
+ASMBackend::~ASMBackend() {
+  stop_ = true;
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+ASMFunctionTranslator::ASMFunctionTranslator(
+    const Program& program, RegAllocImpl impl, const ASMSymbols& symbols,
+    const asmjit::Environment& environment, BranchProfile* profile)
+    : program_(program),
+      reg_alloc_impl_(impl),
+      symbols_(symbols),
+      environment_(environment),
+      profile_(profile),
+      func_idx_(-1),
+      logger_(stderr),
+      optimization_time_(0) {}
+
+asmjit::CodeHolder& ASMFunctionTranslator::Code() { return code_; }
 
 uint64_t ASMBackend::OutputConstant(uint64_t instr) {
   auto opcode = ConstantOpcodeFrom(GenericInstructionReader(instr).Opcode());
@@ -127,8 +161,9 @@ uint64_t ASMBackend::OutputConstant(uint64_t instr) {
     }
 
     case ConstantOpcode::FUNC_PTR: {
-      asm_->embedLabel(
-          internal_func_labels_[Type3InstructionReader(instr).Arg()]);
+      auto func_idx = Type3InstructionReader(instr).Arg();
+      asm_->embedUInt64(
+          reinterpret_cast<uint64_t>(symbols_.functions[func_idx]));
       return 8;
     }
 
@@ -186,24 +221,94 @@ uint64_t ASMBackend::OutputConstant(uint64_t instr) {
   }
 }
 
-void ASMBackend::Translate() {
-  code_.init(rt_.environment());
-  // ErrorPrinter handler;
-  // code_.setErrorHandler(&handler);
-  // code_.setLogger(&logger_);
-  asm_ = std::make_unique<x86::Assembler>(&code_);
+void ASMBackend::TranslateStubs() {
+  const auto& functions = program_.Functions();
+
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(functions.size());
+  symbols_.functions.resize(functions.size());
+
+  CodeHolder code;
+  code.init(rt_.environment());
+  x86::Assembler assembler(&code);
+
+  // Stubs of functions that are not compiled yet jump here with the function
+  // index in r11. Save the argument registers, compile the function and then
+  // tail call into it with the original arguments.
+  const std::vector<x86::Gpq> arg_regs = {x86::rdi, x86::rsi, x86::rdx,
+                                          x86::rcx, x86::r8,  x86::r9};
+  const std::vector<x86::Xmm> fp_arg_regs = {x86::xmm0, x86::xmm1, x86::xmm2,
+                                             x86::xmm3, x86::xmm4, x86::xmm5,
+                                             x86::xmm6, x86::xmm7};
+  auto lazy = assembler.newLabel();
+  assembler.bind(lazy);
+  assembler.push(x86::rbp);
+  assembler.mov(x86::rbp, x86::rsp);
+  for (auto reg : arg_regs) {
+    assembler.push(reg);
+  }
+  assembler.sub(x86::rsp, 16 * fp_arg_regs.size());
+  for (int i = 0; i < fp_arg_regs.size(); i++) {
+    assembler.movdqu(x86::xmmword_ptr(x86::rsp, 16 * i), fp_arg_regs[i]);
+  }
 
-  text_section_ = code_.textSection();
-  code_.newSection(&data_section_, ".data", SIZE_MAX, 0, 32, 0);
+  assembler.mov(x86::rdi, reinterpret_cast<uint64_t>(this));
+  assembler.mov(x86::esi, x86::r11d);
+  assembler.call(reinterpret_cast<void*>(&ASMBackend::LazyCompile));
 
-  asm_->section(data_section_);
+  for (int i = 0; i < fp_arg_regs.size(); i++) {
+    assembler.movdqu(fp_arg_regs[i], x86::xmmword_ptr(x86::rsp, 16 * i));
+  }
+  assembler.lea(x86::rsp, x86::ptr(x86::rbp, -8 * int32_t(arg_regs.size())));
+  for (int i = arg_regs.size() - 1; i >= 0; i--) {
+    assembler.pop(arg_regs[i]);
+  }
+  assembler.pop(x86::rbp);
+  assembler.jmp(x86::rax);
+
+  std::vector<Label> stubs(functions.size());
+  for (int func_idx = 0; func_idx < functions.size(); func_idx++) {
+    if (functions[func_idx].External()) {
+      continue;
+    }
+
+    stubs[func_idx] = assembler.newLabel();
+    assembler.bind(stubs[func_idx]);
+    assembler.mov(x86::r11d, func_idx);
+    assembler.mov(x86::r10, reinterpret_cast<uint64_t>(&slots_[func_idx]));
+    assembler.jmp(x86::qword_ptr(x86::r10));
+  }
+
+  void* buffer;
+  if (rt_.add(&buffer, &code) != kErrorOk) {
+    throw std::runtime_error("Unable to add stubs to the runtime.");
+  }
+  auto base = reinterpret_cast<uint64_t>(buffer);
+
+  for (int func_idx = 0; func_idx < functions.size(); func_idx++) {
+    if (functions[func_idx].External()) {
+      symbols_.functions[func_idx] = functions[func_idx].Addr();
+      continue;
+    }
+
+    slots_[func_idx] = base + code.labelOffsetFromBase(lazy);
+    symbols_.functions[func_idx] = reinterpret_cast<void*>(
+        base + code.labelOffsetFromBase(stubs[func_idx]));
+  }
+}
 
-  // Declare all functions
-  for (const auto& function : program_.Functions()) {
-    external_func_addr_.push_back(function.Addr());
-    internal_func_labels_.push_back(asm_->newLabel());
+void ASMBackend::TranslateData() {
+  if (program_.CharArrayConstants().empty() && program_.Globals().empty()) {
+    return;
   }
 
+  CodeHolder code;
+  code.init(rt_.environment());
+  asm_ = std::make_unique<x86::Assembler>(&code);
+
+  Section* data_section;
+  code.newSection(&data_section, ".data", SIZE_MAX, 0, 32, 0);
+  asm_->section(data_section);
+
   // Write out all string constants
   for (const auto& str : program_.CharArrayConstants()) {
     char_array_constants_.push_back(asm_->newLabel());
@@ -214,6 +319,53 @@ void ASMBackend::Translate() {
     asm_->embedUInt8(0);
   }
 
+  // Write out all global variables
+  for (const auto& global : program_.Globals()) {
+    globals_.push_back(asm_->newLabel());
+    asm_->bind(globals_.back());
+    auto v = global.InitialValue();
+    OutputConstant(program_.ConstantInstrs()[v.GetIdx()]);
+  }
+
+  void* buffer;
+  if (rt_.add(&buffer, &code) != kErrorOk) {
+    throw std::runtime_error("Unable to add globals to the runtime.");
+  }
+  auto base = reinterpret_cast<uint64_t>(buffer);
+
+  for (auto label : char_array_constants_) {
+    symbols_.char_arrays.push_back(base + code.labelOffsetFromBase(label));
+  }
+  for (auto label : globals_) {
+    symbols_.globals.push_back(base + code.labelOffsetFromBase(label));
+  }
+  asm_.reset();
+}
+
+Function ASMFunctionTranslator::Optimize(const Function& func) {
+  auto instrs = func.Instrs();
+  auto basic_blocks = func.BasicBlocks();
+  ValueNumbering(program_, instrs, basic_blocks);
+  LoopInvariantCodeMotion(program_, instrs, basic_blocks);
+  DeadCodeElimination(instrs, basic_blocks);
+  return Function(std::string(func.Name()), func.Type(), std::move(instrs),
+                  std::move(basic_blocks));
+}
+
+double ASMFunctionTranslator::OptimizationTime() { return optimization_time_; }
+
+std::pair<Label, Label> ASMFunctionTranslator::Translate(int func_idx) {
+  code_.init(environment_);
+  // ErrorPrinter handler;
+  // code_.setErrorHandler(&handler);
+  // code_.setLogger(&logger_);
+  asm_ = std::make_unique<x86::Assembler>(&code_);
+
+  text_section_ = code_.textSection();
+  code_.newSection(&data_section_, ".data", SIZE_MAX, 0, 32, 0);
+
+  asm_->section(data_section_);
+
   asm_->align(kAlignZero, 32);
   ones_ = asm_->newLabel();
   asm_->bind(ones_);
@@ -240,142 +392,151 @@ void ASMBackend::Translate() {
   asm_->bind(masks_);
   asm_->embedLabel(masks);
 
-  // Write out all global variables
-  for (const auto& global : program_.Globals()) {
-    globals_.push_back(asm_->newLabel());
-    asm_->bind(globals_.back());
-    auto v = global.InitialValue();
-    OutputConstant(program_.ConstantInstrs()[v.GetIdx()]);
-  }
-
   asm_->section(text_section_);
 
   const std::vector<x86::Gpq> callee_saved_registers = {
       x86::rbx, x86::r12, x86::r13, x86::r14, x86::r15};
 
-  // Translate all function bodies
-  for (int func_idx = 0; func_idx < program_.Functions().size(); func_idx++) {
-    const auto& func = program_.Functions()[func_idx];
-    if (func.External()) {
-      continue;
-    }
-    const auto& instructions = func.Instrs();
-    const auto& basic_blocks = func.BasicBlocks();
-
-    num_floating_point_args_ = 0;
-    num_regular_args_ = 0;
-    num_stack_args_ = 0;
-
-    asm_->bind(internal_func_labels_[func_idx]);
-    auto func_end_label = asm_->newLabel();
-    function_start_end_[func.Name()] =
-        std::make_pair(internal_func_labels_[func_idx], func_end_label);
+  if (program_.Functions()[func_idx].External()) {
+    throw std::runtime_error("Cannot translate an external function.");
+  }
+  func_idx_ = func_idx;
 
-    auto order_analysis = DFSLabel(basic_blocks);
+#ifdef COMP_TIME
+  auto t1 = std::chrono::high_resolution_clock::now();
+#endif
 
-    std::vector<int> order(basic_blocks.size());
-    for (int i = 0; i < basic_blocks.size(); i++) {
-      order[i] = i;
-    }
-    std::sort(order.begin(), order.end(), [&](int bb1, int bb2) -> bool {
-      return order_analysis.postorder_label[bb2] <
-             order_analysis.postorder_label[bb1];
-    });
+  auto func = [&]() {
+    util::PhaseTimer timer("asm_optimize");
+    return Optimize(program_.Functions()[func_idx]);
+  }();
 
-    // Determine if GEPs should be materialized
-    auto gep_materialize = ComputeGEPMaterialize(func);
+#ifdef COMP_TIME
+  auto t2 = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::milli> fp_ms = t2 - t1;
+  optimization_time_ = fp_ms.count();
+#endif
 
-    std::vector<RegisterAssignment> register_assign;
-    switch (reg_alloc_impl_) {
-      case RegAllocImpl::STACK_SPILL:
-        register_assign = StackSpillingRegisterAlloc(instructions);
-        break;
+  const auto& instructions = func.Instrs();
+  const auto& basic_blocks = func.BasicBlocks();
 
-      case RegAllocImpl::LINEAR_SCAN:
-        register_assign = LinearScanRegisterAlloc(func, gep_materialize,
-                                                  program_.TypeManager());
-        break;
-    }
+  num_floating_point_args_ = 0;
+  num_regular_args_ = 0;
+  num_stack_args_ = 0;
 
-    // Prologue ================================================================
-    // - Save RBP and Store RSP in RBP
-    asm_->push(x86::rbp);
-    asm_->mov(x86::rbp, x86::rsp);
-    asm_->and_(x86::rsp, -32);
+  auto func_start_label = asm_->newLabel();
+  auto func_end_label = asm_->newLabel();
+  asm_->bind(func_start_label);
 
-    // - Save all callee saved registers
-    for (auto reg : callee_saved_registers) {
-      asm_->push(reg);
-    }
+  auto order_analysis = DFSLabel(basic_blocks);
 
-    // - Allocate placeholder stack space.
-    auto stack_alloc_offset = asm_->offset();
-    asm_->long_().sub(x86::rsp, 0);
-    // =========================================================================
+  std::vector<int> order(basic_blocks.size());
+  for (int i = 0; i < basic_blocks.size(); i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](int bb1, int bb2) -> bool {
+    return order_analysis.postorder_label[bb2] <
+           order_analysis.postorder_label[bb1];
+  });
+
+  // Determine if GEPs should be materialized
+  auto gep_materialize = ComputeGEPMaterialize(func);
+
+  std::vector<RegisterAssignment> register_assign;
+  switch (reg_alloc_impl_) {
+    case RegAllocImpl::STACK_SPILL: {
+      util::PhaseTimer timer("register_allocation");
+      register_assign = StackSpillingRegisterAlloc(instructions);
+      break;
+    }
+
+    case RegAllocImpl::LINEAR_SCAN:
+      register_assign = LinearScanRegisterAlloc(func, gep_materialize,
+                                                program_.TypeManager());
+      break;
+  }
 
-    std::vector<Label> basic_blocks_impl;
-    Label epilogue = asm_->newLabel();
-    for (int i = 0; i < basic_blocks.size(); i++) {
-      basic_blocks_impl.push_back(asm_->newLabel());
-    }
+  util::PhaseTimer emit_timer("asm_emit");
 
-    std::vector<int32_t> value_offsets(instructions.size(), INT32_MAX);
+  // Prologue ==================================================================
+  // - Save RBP and Store RSP in RBP
+  asm_->push(x86::rbp);
+  asm_->mov(x86::rbp, x86::rsp);
+  asm_->and_(x86::rsp, -32);
 
-    // initially, after rbp is all callee saved registers
-    StackSlotAllocator static_stack_allocator;
-    for (int k = 0; k < order.size(); k++) {
-      int bb = order[k];
-      int next_bb = k + 1 < order.size() ? order[k + 1] : -1;
+  // - Save all callee saved registers
+  for (auto reg : callee_saved_registers) {
+    asm_->push(reg);
+  }
 
-      asm_->bind(basic_blocks_impl[bb]);
+  // - Allocate placeholder stack space.
+  auto stack_alloc_offset = asm_->offset();
+  asm_->long_().sub(x86::rsp, 0);
+  // ===========================================================================
 
-      for (const auto& [seg_start, seg_end] : basic_blocks[bb].Segments()) {
-        for (int instr_idx = seg_start; instr_idx <= seg_end; instr_idx++) {
-          TranslateInstr(instr_idx, instructions, basic_blocks_impl, epilogue,
-                         value_offsets, static_stack_allocator, register_assign,
-                         gep_materialize, next_bb);
-        }
-      }
-    }
+  std::vector<Label> basic_blocks_impl;
+  Label epilogue = asm_->newLabel();
+  for (int i = 0; i < basic_blocks.size(); i++) {
+    basic_blocks_impl.push_back(asm_->newLabel());
+  }
 
-    // we need to ensure that it is aligned to 32 bytes
-    auto stack_frame_size =
-        static_stack_allocator.GetSize() + 8 * callee_saved_registers.size();
-    if (stack_frame_size % 32 != 0) {
-      stack_frame_size += 32 - (stack_frame_size % 32);
-    }
-    assert(stack_frame_size % 32 == 0);
+  std::vector<int32_t> value_offsets(instructions.size(), INT32_MAX);
 
-    // Update prologue to contain stack_size
-    // Already pushed callee saved registers so don't double allocate space
-    int64_t stack_alloc_size =
-        stack_frame_size - 8 * callee_saved_registers.size();
-    auto epilogue_offset = asm_->offset();
-    asm_->setOffset(stack_alloc_offset);
-    asm_->long_().sub(x86::rsp, stack_alloc_size);
-    asm_->setOffset(epilogue_offset);
+  // initially, after rbp is all callee saved registers
+  StackSlotAllocator static_stack_allocator;
+  for (int k = 0; k < order.size(); k++) {
+    int bb = order[k];
+    int next_bb = k + 1 < order.size() ? order[k + 1] : -1;
 
-    // Epilogue ================================================================
-    asm_->bind(epilogue);
+    asm_->bind(basic_blocks_impl[bb]);
 
-    // - Restore callee saved registers
-    asm_->long_().add(x86::rsp, stack_alloc_size);
-    for (int i = callee_saved_registers.size() - 1; i >= 0; i--) {
-      asm_->pop(callee_saved_registers[i]);
+    for (const auto& [seg_start, seg_end] : basic_blocks[bb].Segments()) {
+      for (int instr_idx = seg_start; instr_idx <= seg_end; instr_idx++) {
+        TranslateInstr(instr_idx, instructions, basic_blocks_impl, epilogue,
+                       value_offsets, static_stack_allocator, register_assign,
+                       gep_materialize, next_bb);
+      }
     }
+  }
 
-    // - Restore RSP into RBP and Restore RBP and Store RSP in RBP
-    asm_->mov(x86::rsp, x86::rbp);
-    asm_->pop(x86::rbp);
-
-    // - Return
-    asm_->ret();
-    // =========================================================================
-    asm_->bind(func_end_label);
+  // we need to ensure that it is aligned to 32 bytes
+  auto stack_frame_size =
+      static_stack_allocator.GetSize() + 8 * callee_saved_registers.size();
+  if (stack_frame_size % 32 != 0) {
+    stack_frame_size += 32 - (stack_frame_size % 32);
   }
+  assert(stack_frame_size % 32 == 0);
+
+  // Update prologue to contain stack_size
+  // Already pushed callee saved registers so don't double allocate space
+  int64_t stack_alloc_size =
+      stack_frame_size - 8 * callee_saved_registers.size();
+  auto epilogue_offset = asm_->offset();
+  asm_->setOffset(stack_alloc_offset);
+  asm_->long_().sub(x86::rsp, stack_alloc_size);
+  asm_->setOffset(epilogue_offset);
+
+  // Epilogue ==================================================================
+  asm_->bind(epilogue);
+
+  // - Restore callee saved registers
+  asm_->long_().add(x86::rsp, stack_alloc_size);
+  for (int i = callee_saved_registers.size() - 1; i >= 0; i--) {
+    asm_->pop(callee_saved_registers[i]);
+  }
+
+  // - Restore RSP into RBP and Restore RBP and Store RSP in RBP
+  asm_->mov(x86::rsp, x86::rbp);
+  asm_->pop(x86::rbp);
+
+  // - Return
+  asm_->ret();
+  // ===========================================================================
+  asm_->bind(func_end_label);
+  return {func_start_label, func_end_label};
 }
 
-uint8_t ASMBackend::GetByteConstant(Value v) {
+uint8_t ASMFunctionTranslator::GetByteConstant(Value v) {
   if (!v.IsConstantGlobal()) {
     throw std::runtime_error("Not a constant/global.");
   }
@@ -392,7 +553,7 @@ uint8_t ASMBackend::GetByteConstant(Value v) {
   }
 }
 
-uint16_t ASMBackend::GetWordConstant(Value v) {
+uint16_t ASMFunctionTranslator::GetWordConstant(Value v) {
   if (!v.IsConstantGlobal()) {
     throw std::runtime_error("Not a constant/global.");
   }
@@ -406,7 +567,7 @@ uint16_t ASMBackend::GetWordConstant(Value v) {
   return reader.Constant();
 }
 
-uint32_t ASMBackend::GetDwordConstant(Value v) {
+uint32_t ASMFunctionTranslator::GetDwordConstant(Value v) {
   if (!v.IsConstantGlobal()) {
     throw std::runtime_error("Not a constant/global.");
   }
@@ -420,7 +581,7 @@ uint32_t ASMBackend::GetDwordConstant(Value v) {
   return reader.Constant();
 }
 
-uint64_t ASMBackend::GetQwordConstant(Value v) {
+uint64_t ASMFunctionTranslator::GetQwordConstant(Value v) {
   if (!v.IsConstantGlobal()) {
     throw std::runtime_error("Not a constant/global.");
   }
@@ -435,7 +596,7 @@ uint64_t ASMBackend::GetQwordConstant(Value v) {
   return i64_constants[reader.Constant()];
 }
 
-uint64_t ASMBackend::GetPtrConstant(Value v) {
+uint64_t ASMFunctionTranslator::GetPtrConstant(Value v) {
   if (!v.IsConstantGlobal()) {
     throw std::runtime_error("Not a constant/global.");
   }
@@ -450,7 +611,7 @@ uint64_t ASMBackend::GetPtrConstant(Value v) {
   return reinterpret_cast<uint64_t>(ptr_constants[reader.Constant()]);
 }
 
-double ASMBackend::GetF64Constant(Value v) {
+double ASMFunctionTranslator::GetF64Constant(Value v) {
   if (!v.IsConstantGlobal()) {
     throw std::runtime_error("Not a constant/global.");
   }
@@ -465,7 +626,7 @@ double ASMBackend::GetF64Constant(Value v) {
   return f64_constants[reader.Constant()];
 }
 
-asmjit::Label ASMBackend::GetGlobalPointer(Value v) {
+uint64_t ASMFunctionTranslator::GetGlobalPointer(Value v) {
   if (!v.IsConstantGlobal()) {
     throw std::runtime_error("Not a constant/global.");
   }
@@ -476,17 +637,17 @@ asmjit::Label ASMBackend::GetGlobalPointer(Value v) {
   switch (opcode) {
     case ConstantOpcode::GLOBAL_CHAR_ARRAY_CONST: {
       auto id = Type1InstructionReader(instr).Constant();
-      return char_array_constants_[id];
+      return symbols_.char_arrays[id];
     }
 
     case ConstantOpcode::GLOBAL_REF: {
       auto id = Type1InstructionReader(instr).Constant();
-      return globals_[id];
+      return symbols_.globals[id];
     }
 
     case ConstantOpcode::FUNC_PTR: {
       auto id = Type3InstructionReader(instr).Arg();
-      return internal_func_labels_[id];
+      return reinterpret_cast<uint64_t>(symbols_.functions[id]);
     }
 
     default:
@@ -494,7 +655,7 @@ asmjit::Label ASMBackend::GetGlobalPointer(Value v) {
   }
 }
 
-bool ASMBackend::IsNullPtr(Value v) {
+bool ASMFunctionTranslator::IsNullPtr(Value v) {
   if (!v.IsConstantGlobal()) {
     return false;
   }
@@ -505,7 +666,7 @@ bool ASMBackend::IsNullPtr(Value v) {
          ConstantOpcode::NULLPTR;
 }
 
-bool ASMBackend::IsConstantPtr(Value v) {
+bool ASMFunctionTranslator::IsConstantPtr(Value v) {
   if (!v.IsConstantGlobal()) {
     return false;
   }
@@ -516,7 +677,7 @@ bool ASMBackend::IsConstantPtr(Value v) {
          ConstantOpcode::PTR_CONST;
 }
 
-Value ASMBackend::GetConstantCastedPtr(Value v) {
+Value ASMFunctionTranslator::GetConstantCastedPtr(Value v) {
   if (!v.IsConstantGlobal()) {
     throw std::runtime_error("Invalid constant casted ptr.");
   }
@@ -524,7 +685,7 @@ Value ASMBackend::GetConstantCastedPtr(Value v) {
   return Value(Type3InstructionReader(constant_instrs[v.GetIdx()]).Arg());
 }
 
-bool ASMBackend::IsConstantCastedPtr(Value v) {
+bool ASMFunctionTranslator::IsConstantCastedPtr(Value v) {
   if (!v.IsConstantGlobal()) {
     return false;
   }
@@ -553,7 +714,7 @@ bool IsDynamicGEP(Value v, const std::vector<uint64_t>& instructions) {
          Opcode::GEP_DYNAMIC;
 }
 
-GEPStaticInfo ASMBackend::StaticGEP(Value v,
+GEPStaticInfo ASMFunctionTranslator::StaticGEP(Value v,
                                     const std::vector<uint64_t>& instrs) {
   if (v.IsConstantGlobal() ||
       OpcodeFrom(GenericInstructionReader(instrs[v.GetIdx()]).Opcode()) !=
@@ -577,7 +738,7 @@ GEPStaticInfo ASMBackend::StaticGEP(Value v,
   };
 }
 
-GEPDynamicInfo ASMBackend::DynamicGEP(Value v,
+GEPDynamicInfo ASMFunctionTranslator::DynamicGEP(Value v,
                                       const std::vector<uint64_t>& instrs) {
   if (v.IsConstantGlobal() ||
       OpcodeFrom(GenericInstructionReader(instrs[v.GetIdx()]).Opcode()) !=
@@ -603,6 +764,7 @@ GEPDynamicInfo ASMBackend::DynamicGEP(Value v,
       .index = index,
       .offset = offset,
       .type_size = type_size,
+      .i64_index = reader2.Metadata() == GEP_I64_INDEX,
   };
 }
 
@@ -615,7 +777,7 @@ int32_t GetOffset(const std::vector<int32_t>& offsets, int i) {
   return offset;
 }
 
-asmjit::Label ASMBackend::EmbedF64(double c) {
+asmjit::Label ASMFunctionTranslator::EmbedF64(double c) {
   auto label = asm_->newLabel();
   asm_->section(data_section_);
   asm_->bind(label);
@@ -624,7 +786,7 @@ asmjit::Label ASMBackend::EmbedF64(double c) {
   return label;
 }
 
-asmjit::Label ASMBackend::EmbedI8(int8_t c) {
+asmjit::Label ASMFunctionTranslator::EmbedI8(int8_t c) {
   auto label = asm_->newLabel();
   asm_->section(data_section_);
   asm_->bind(label);
@@ -633,7 +795,7 @@ asmjit::Label ASMBackend::EmbedI8(int8_t c) {
   return label;
 }
 
-asmjit::Label ASMBackend::EmbedI64(int64_t c) {
+asmjit::Label ASMFunctionTranslator::EmbedI64(int64_t c) {
   auto label = asm_->newLabel();
   asm_->section(data_section_);
   asm_->bind(label);
@@ -642,7 +804,7 @@ asmjit::Label ASMBackend::EmbedI64(int64_t c) {
   return label;
 }
 
-asmjit::Label ASMBackend::EmbedI32(int32_t c) {
+asmjit::Label ASMFunctionTranslator::EmbedI32(int32_t c) {
   auto label = asm_->newLabel();
   asm_->section(data_section_);
   asm_->bind(label);
@@ -651,7 +813,7 @@ asmjit::Label ASMBackend::EmbedI32(int32_t c) {
   return label;
 }
 
-asmjit::Label ASMBackend::EmbedI32Vec8(int32_t v) {
+asmjit::Label ASMFunctionTranslator::EmbedI32Vec8(int32_t v) {
   auto label = asm_->newLabel();
   asm_->section(data_section_);
   asm_->align(AlignMode::kAlignZero, 32);
@@ -663,7 +825,7 @@ asmjit::Label ASMBackend::EmbedI32Vec8(int32_t v) {
   return label;
 }
 
-asmjit::Label ASMBackend::EmbedI32Vec8(std::array<int32_t, 8> vec8) {
+asmjit::Label ASMFunctionTranslator::EmbedI32Vec8(std::array<int32_t, 8> vec8) {
   auto label = asm_->newLabel();
   asm_->section(data_section_);
   asm_->align(AlignMode::kAlignZero, 32);
@@ -684,7 +846,7 @@ bool IsFFlag(const RegisterAssignment& reg) {
 }
 
 template <typename Dest>
-void ASMBackend::StoreCmpFlags(Opcode opcode, Dest d) {
+void ASMFunctionTranslator::StoreCmpFlags(Opcode opcode, Dest d) {
   switch (opcode) {
     case Opcode::PTR_CMP_NULLPTR:
     case Opcode::I1_CMP_EQ:
@@ -745,7 +907,7 @@ void ASMBackend::StoreCmpFlags(Opcode opcode, Dest d) {
 }
 
 template <typename T>
-void ASMBackend::MoveByteValue(
+void ASMFunctionTranslator::MoveByteValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign,
     int32_t dynamic_offset) {
@@ -773,7 +935,7 @@ void ASMBackend::MoveByteValue(
 }
 
 template <typename T>
-void ASMBackend::AndByteValue(
+void ASMFunctionTranslator::AndByteValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -794,7 +956,7 @@ void ASMBackend::AndByteValue(
 }
 
 template <typename T>
-void ASMBackend::OrByteValue(
+void ASMFunctionTranslator::OrByteValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -815,7 +977,7 @@ void ASMBackend::OrByteValue(
 }
 
 template <typename T>
-void ASMBackend::AddByteValue(
+void ASMFunctionTranslator::AddByteValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -836,7 +998,7 @@ void ASMBackend::AddByteValue(
 }
 
 template <typename T>
-void ASMBackend::SubByteValue(
+void ASMFunctionTranslator::SubByteValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -856,7 +1018,7 @@ void ASMBackend::SubByteValue(
   }
 }
 
-void ASMBackend::MulByteValue(
+void ASMFunctionTranslator::MulByteValue(
     Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -871,7 +1033,7 @@ void ASMBackend::MulByteValue(
   }
 }
 
-x86::GpbLo ASMBackend::GetByteValue(
+x86::GpbLo ASMFunctionTranslator::GetByteValue(
     Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -888,7 +1050,7 @@ x86::GpbLo ASMBackend::GetByteValue(
   }
 }
 
-void ASMBackend::CmpByteValue(
+void ASMFunctionTranslator::CmpByteValue(
     x86::GpbLo src, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -902,7 +1064,7 @@ void ASMBackend::CmpByteValue(
   }
 }
 
-void ASMBackend::ZextByteValue(
+void ASMFunctionTranslator::ZextByteValue(
     x86::Gpq dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -917,7 +1079,7 @@ void ASMBackend::ZextByteValue(
   }
 }
 
-void ASMBackend::SextByteValue(
+void ASMFunctionTranslator::SextByteValue(
     x86::Gpq dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -958,10 +1120,18 @@ uint8_t GetShift(int32_t type_size) {
   }
 }
 
-x86::Mem ASMBackend::GetDynamicGEPPtrValue(
+x86::Mem ASMFunctionTranslator::GetDynamicGEPPtrValue(
     GEPDynamicInfo info, int32_t size, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   bool index_is_reg = register_assign[info.index.GetIdx()].IsRegister();
+  auto load_index = [&](GPRegister dest) {
+    auto index_offset = GetOffset(offsets, info.index.GetIdx());
+    if (info.i64_index) {
+      asm_->mov(dest.GetQ(), x86::qword_ptr(x86::rsp, index_offset));
+    } else {
+      asm_->mov(dest.GetD(), x86::dword_ptr(x86::rsp, index_offset));
+    }
+  };
 
   if (info.ptr.IsConstantGlobal()) {
     while (IsConstantCastedPtr(info.ptr)) {
@@ -975,9 +1145,7 @@ x86::Mem ASMBackend::GetDynamicGEPPtrValue(
               .GetQ();
     } else {
       index_reg = GPRegister::RAX.GetQ();
-      asm_->mov(
-          GPRegister::RAX.GetD(),
-          x86::dword_ptr(x86::rsp, GetOffset(offsets, info.index.GetIdx())));
+      load_index(GPRegister::RAX);
     }
 
     if (IsNullPtr(info.ptr)) {
@@ -993,8 +1161,21 @@ x86::Mem ASMBackend::GetDynamicGEPPtrValue(
                       size);
     }
 
-    auto label = GetGlobalPointer(info.ptr);
-    return x86::ptr(label, index_reg, GetShift(info.type_size), info.offset,
+    uint64_t addr = GetGlobalPointer(info.ptr);
+    auto ptr_reg = GPRegister::RAX.GetQ();
+    if (index_reg == ptr_reg) {
+      // The spilled index is already in RAX so scale it in place and add the
+      // address of the global to it.
+      auto shift = GetShift(info.type_size);
+      if (shift > 0) {
+        asm_->shl(ptr_reg, shift);
+      }
+      asm_->add(ptr_reg, x86::qword_ptr(EmbedI64(addr)));
+      return x86::ptr(ptr_reg, info.offset, size);
+    }
+
+    asm_->mov(ptr_reg, addr);
+    return x86::ptr(ptr_reg, index_reg, GetShift(info.type_size), info.offset,
                     size);
   }
 
@@ -1012,9 +1193,7 @@ x86::Mem ASMBackend::GetDynamicGEPPtrValue(
               .GetQ();
     } else {
       index_reg = GPRegister::RAX.GetQ();
-      asm_->mov(
-          GPRegister::RAX.GetD(),
-          x86::dword_ptr(x86::rsp, GetOffset(offsets, info.index.GetIdx())));
+      load_index(GPRegister::RAX);
     }
 
     return x86::ptr(ptr_reg, index_reg, GetShift(info.type_size), info.offset,
@@ -1040,8 +1219,7 @@ x86::Mem ASMBackend::GetDynamicGEPPtrValue(
 
   // load index
   auto reg = GPRegister::RAX;
-  asm_->mov(reg.GetD(),
-            x86::dword_ptr(x86::rsp, GetOffset(offsets, info.index.GetIdx())));
+  load_index(reg);
   // shift by type_size, add offset
   asm_->shl(reg.GetQ(), GetShift(info.type_size));
   // add to ptr
@@ -1050,7 +1228,7 @@ x86::Mem ASMBackend::GetDynamicGEPPtrValue(
   return x86::ptr(reg.GetQ(), info.offset, size);
 }
 
-x86::Mem ASMBackend::GetStaticGEPPtrValue(
+x86::Mem ASMFunctionTranslator::GetStaticGEPPtrValue(
     GEPStaticInfo info, int32_t size, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (info.ptr.IsConstantGlobal()) {
@@ -1069,8 +1247,10 @@ x86::Mem ASMBackend::GetStaticGEPPtrValue(
       return x86::ptr(ptr_reg, info.offset, size);
     }
 
-    auto label = GetGlobalPointer(info.ptr);
-    return x86::ptr(label, info.offset, size);
+    uint64_t addr = GetGlobalPointer(info.ptr);
+    auto ptr_reg = GPRegister::RAX.GetQ();
+    asm_->mov(ptr_reg, addr);
+    return x86::ptr(ptr_reg, info.offset, size);
   }
 
   if (register_assign[info.ptr.GetIdx()].IsRegister()) {
@@ -1086,7 +1266,7 @@ x86::Mem ASMBackend::GetStaticGEPPtrValue(
   return x86::ptr(ptr_reg, info.offset, size);
 }
 
-x86::Mem ASMBackend::GetBytePtrValue(
+x86::Mem ASMFunctionTranslator::GetBytePtrValue(
     Value v, std::vector<int32_t>& offsets, const std::vector<uint64_t>& instrs,
     const std::vector<RegisterAssignment>& register_assign) {
   if (IsDynamicGEP(v, instrs)) {
@@ -1105,7 +1285,7 @@ x86::Mem ASMBackend::GetBytePtrValue(
 }
 
 template <typename T>
-void ASMBackend::MoveWordValue(
+void ASMFunctionTranslator::MoveWordValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign,
     int32_t dynamic_offset) {
@@ -1133,7 +1313,7 @@ void ASMBackend::MoveWordValue(
 }
 
 template <typename T>
-void ASMBackend::AddWordValue(
+void ASMFunctionTranslator::AddWordValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1154,7 +1334,7 @@ void ASMBackend::AddWordValue(
 }
 
 template <typename T>
-void ASMBackend::SubWordValue(
+void ASMFunctionTranslator::SubWordValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1174,7 +1354,7 @@ void ASMBackend::SubWordValue(
   }
 }
 
-void ASMBackend::MulWordValue(
+void ASMFunctionTranslator::MulWordValue(
     x86::Gpw dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1188,7 +1368,7 @@ void ASMBackend::MulWordValue(
   }
 }
 
-x86::Gpw ASMBackend::GetWordValue(
+x86::Gpw ASMFunctionTranslator::GetWordValue(
     Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1205,7 +1385,7 @@ x86::Gpw ASMBackend::GetWordValue(
   }
 }
 
-void ASMBackend::CmpWordValue(
+void ASMFunctionTranslator::CmpWordValue(
     x86::Gpw src, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1219,7 +1399,7 @@ void ASMBackend::CmpWordValue(
   }
 }
 
-void ASMBackend::ZextWordValue(
+void ASMFunctionTranslator::ZextWordValue(
     x86::Gpq dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1234,7 +1414,7 @@ void ASMBackend::ZextWordValue(
   }
 }
 
-void ASMBackend::SextWordValue(
+void ASMFunctionTranslator::SextWordValue(
     x86::Gpq dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1249,7 +1429,7 @@ void ASMBackend::SextWordValue(
   }
 }
 
-x86::Mem ASMBackend::GetWordPtrValue(
+x86::Mem ASMFunctionTranslator::GetWordPtrValue(
     Value v, std::vector<int32_t>& offsets, const std::vector<uint64_t>& instrs,
     const std::vector<RegisterAssignment>& register_assign) {
   if (IsDynamicGEP(v, instrs)) {
@@ -1268,7 +1448,7 @@ x86::Mem ASMBackend::GetWordPtrValue(
 }
 
 template <typename T>
-void ASMBackend::MoveDWordValue(
+void ASMFunctionTranslator::MoveDWordValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign,
     int32_t dynamic_offset) {
@@ -1296,7 +1476,7 @@ void ASMBackend::MoveDWordValue(
 }
 
 template <typename T>
-void ASMBackend::AddDWordValue(
+void ASMFunctionTranslator::AddDWordValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1317,7 +1497,7 @@ void ASMBackend::AddDWordValue(
 }
 
 template <typename T>
-void ASMBackend::SubDWordValue(
+void ASMFunctionTranslator::SubDWordValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1337,7 +1517,7 @@ void ASMBackend::SubDWordValue(
   }
 }
 
-void ASMBackend::MulDWordValue(
+void ASMFunctionTranslator::MulDWordValue(
     x86::Gpd dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1351,7 +1531,7 @@ void ASMBackend::MulDWordValue(
   }
 }
 
-x86::Gpd ASMBackend::GetDWordValue(
+x86::Gpd ASMFunctionTranslator::GetDWordValue(
     Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1367,7 +1547,7 @@ x86::Gpd ASMBackend::GetDWordValue(
   }
 }
 
-void ASMBackend::CmpDWordValue(
+void ASMFunctionTranslator::CmpDWordValue(
     x86::Gpd src, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1381,7 +1561,7 @@ void ASMBackend::CmpDWordValue(
   }
 }
 
-void ASMBackend::ZextDWordValue(
+void ASMFunctionTranslator::ZextDWordValue(
     GPRegister dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1397,7 +1577,23 @@ void ASMBackend::ZextDWordValue(
   }
 }
 
-x86::Mem ASMBackend::GetDWordPtrValue(
+void ASMFunctionTranslator::SextDWordValue(
+    GPRegister dest, Value v, std::vector<int32_t>& offsets,
+    const std::vector<RegisterAssignment>& register_assign) {
+  if (v.IsConstantGlobal()) {
+    int32_t c32 = GetDwordConstant(v);
+    int64_t c64 = c32;
+    asm_->mov(dest.GetQ(), c64);
+  } else if (register_assign[v.GetIdx()].IsRegister()) {
+    auto v_reg = GPRegister::FromId(register_assign[v.GetIdx()].Register());
+    asm_->movsxd(dest.GetQ(), v_reg.GetD());
+  } else {
+    asm_->movsxd(dest.GetQ(),
+                 x86::dword_ptr(x86::rsp, GetOffset(offsets, v.GetIdx())));
+  }
+}
+
+x86::Mem ASMFunctionTranslator::GetDWordPtrValue(
     Value v, std::vector<int32_t>& offsets, const std::vector<uint64_t>& instrs,
     const std::vector<RegisterAssignment>& register_assign) {
   if (IsDynamicGEP(v, instrs)) {
@@ -1416,7 +1612,7 @@ x86::Mem ASMBackend::GetDWordPtrValue(
   return GetStaticGEPPtrValue(info, DWORD_PTR_SIZE, offsets, register_assign);
 }
 
-x86::Mem ASMBackend::GetYMMWordPtrValue(
+x86::Mem ASMFunctionTranslator::GetYMMWordPtrValue(
     Value v, std::vector<int32_t>& offsets, const std::vector<uint64_t>& instrs,
     const std::vector<RegisterAssignment>& register_assign) {
   if (IsDynamicGEP(v, instrs)) {
@@ -1436,7 +1632,7 @@ x86::Mem ASMBackend::GetYMMWordPtrValue(
 }
 
 template <typename T>
-void ASMBackend::MovePtrValue(
+void ASMFunctionTranslator::MovePtrValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign,
     int32_t dynamic_stack_alloc) {
@@ -1459,8 +1655,8 @@ void ASMBackend::MovePtrValue(
       return;
     }
 
-    auto label = GetGlobalPointer(v);
-    asm_->lea(GPRegister::RAX.GetQ(), x86::ptr(label));
+    uint64_t addr = GetGlobalPointer(v);
+    asm_->mov(GPRegister::RAX.GetQ(), addr);
     asm_->mov(dest, GPRegister::RAX.GetQ());
   } else if (register_assign[v.GetIdx()].IsRegister()) {
     auto v_reg = GPRegister::FromId(register_assign[v.GetIdx()].Register());
@@ -1483,7 +1679,7 @@ void ASMBackend::MovePtrValue(
 }
 
 template <typename T>
-void ASMBackend::MoveQWordValue(
+void ASMFunctionTranslator::MoveQWordValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign,
     int32_t dynamic_offset) {
@@ -1516,7 +1712,7 @@ void ASMBackend::MoveQWordValue(
 }
 
 template <typename T>
-void ASMBackend::AddQWordValue(
+void ASMFunctionTranslator::AddQWordValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1548,7 +1744,7 @@ void ASMBackend::AddQWordValue(
 }
 
 template <typename T>
-void ASMBackend::SubQWordValue(
+void ASMFunctionTranslator::SubQWordValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1580,7 +1776,7 @@ void ASMBackend::SubQWordValue(
 }
 
 template <typename T>
-void ASMBackend::AndQWordValue(
+void ASMFunctionTranslator::AndQWordValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1608,7 +1804,7 @@ void ASMBackend::AndQWordValue(
 }
 
 template <typename T>
-void ASMBackend::XorQWordValue(
+void ASMFunctionTranslator::XorQWordValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1636,7 +1832,7 @@ void ASMBackend::XorQWordValue(
 }
 
 template <typename T>
-void ASMBackend::OrQWordValue(
+void ASMFunctionTranslator::OrQWordValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1663,7 +1859,7 @@ void ASMBackend::OrQWordValue(
 }
 
 template <typename T>
-void ASMBackend::LShiftQWordValue(
+void ASMFunctionTranslator::LShiftQWordValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (!v.IsConstantGlobal()) {
@@ -1685,7 +1881,7 @@ void ASMBackend::LShiftQWordValue(
 }
 
 template <typename T>
-void ASMBackend::RShiftQWordValue(
+void ASMFunctionTranslator::RShiftQWordValue(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (!v.IsConstantGlobal()) {
@@ -1707,7 +1903,7 @@ void ASMBackend::RShiftQWordValue(
   }
 }
 
-void ASMBackend::MulQWordValue(
+void ASMFunctionTranslator::MulQWordValue(
     x86::Gpq dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1727,7 +1923,22 @@ void ASMBackend::MulQWordValue(
   }
 }
 
-x86::Gpq ASMBackend::GetQWordValue(
+void ASMFunctionTranslator::Crc32QWordValue(
+    x86::Gpq dest, Value v, std::vector<int32_t>& offsets,
+    const std::vector<RegisterAssignment>& register_assign) {
+  if (v.IsConstantGlobal()) {
+    int64_t c64 = GetQwordConstant(v);
+    asm_->crc32(dest, x86::qword_ptr(EmbedI64(c64)));
+  } else if (register_assign[v.GetIdx()].IsRegister()) {
+    auto v_reg = GPRegister::FromId(register_assign[v.GetIdx()].Register());
+    asm_->crc32(dest, v_reg.GetQ());
+  } else {
+    asm_->crc32(dest,
+                x86::qword_ptr(x86::rsp, GetOffset(offsets, v.GetIdx())));
+  }
+}
+
+x86::Gpq ASMFunctionTranslator::GetQWordValue(
     Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1743,7 +1954,7 @@ x86::Gpq ASMBackend::GetQWordValue(
   }
 }
 
-void ASMBackend::CmpQWordValue(
+void ASMFunctionTranslator::CmpQWordValue(
     x86::Gpq src, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1762,7 +1973,7 @@ void ASMBackend::CmpQWordValue(
   }
 }
 
-x86::Mem ASMBackend::GetQWordPtrValue(
+x86::Mem ASMFunctionTranslator::GetQWordPtrValue(
     Value v, std::vector<int32_t>& offsets, const std::vector<uint64_t>& instrs,
     const std::vector<RegisterAssignment>& register_assign) {
   if (IsDynamicGEP(v, instrs)) {
@@ -1781,7 +1992,7 @@ x86::Mem ASMBackend::GetQWordPtrValue(
   return GetStaticGEPPtrValue(info, QWORD_PTR_SIZE, offsets, register_assign);
 }
 
-void ASMBackend::MaterializeGep(
+void ASMFunctionTranslator::MaterializeGep(
     x86::Mem dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<uint64_t>& instrs,
     const std::vector<RegisterAssignment>& register_assign) {
@@ -1790,7 +2001,7 @@ void ASMBackend::MaterializeGep(
   asm_->mov(dest, reg);
 }
 
-void ASMBackend::MaterializeGep(
+void ASMFunctionTranslator::MaterializeGep(
     x86::Gpq dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<uint64_t>& instrs,
     const std::vector<RegisterAssignment>& register_assign) {
@@ -1798,7 +2009,7 @@ void ASMBackend::MaterializeGep(
 }
 
 template <typename T>
-void ASMBackend::MoveF64Value(
+void ASMFunctionTranslator::MoveF64Value(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1825,7 +2036,7 @@ void ASMBackend::MoveF64Value(
   }
 }
 
-void ASMBackend::AddF64Value(
+void ASMFunctionTranslator::AddF64Value(
     x86::Xmm dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1840,7 +2051,7 @@ void ASMBackend::AddF64Value(
   }
 }
 
-void ASMBackend::SubF64Value(
+void ASMFunctionTranslator::SubF64Value(
     x86::Xmm dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1855,7 +2066,7 @@ void ASMBackend::SubF64Value(
   }
 }
 
-void ASMBackend::MulF64Value(
+void ASMFunctionTranslator::MulF64Value(
     x86::Xmm dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1870,7 +2081,7 @@ void ASMBackend::MulF64Value(
   }
 }
 
-void ASMBackend::DivF64Value(
+void ASMFunctionTranslator::DivF64Value(
     x86::Xmm dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1886,7 +2097,7 @@ void ASMBackend::DivF64Value(
 }
 
 template <typename Dest>
-void ASMBackend::StoreF64CmpFlags(Opcode opcode, Dest dest) {
+void ASMFunctionTranslator::StoreF64CmpFlags(Opcode opcode, Dest dest) {
   switch (opcode) {
     case Opcode::F64_CMP_EQ: {
       asm_->setnp(dest);
@@ -1919,7 +2130,7 @@ void ASMBackend::StoreF64CmpFlags(Opcode opcode, Dest dest) {
   }
 }
 
-x86::Xmm ASMBackend::GetF64Value(
+x86::Xmm ASMFunctionTranslator::GetF64Value(
     Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1936,7 +2147,7 @@ x86::Xmm ASMBackend::GetF64Value(
   }
 }
 
-void ASMBackend::CmpF64Value(
+void ASMFunctionTranslator::CmpF64Value(
     asmjit::x86::Xmm src, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1953,7 +2164,7 @@ void ASMBackend::CmpF64Value(
 }
 
 template <typename T>
-void ASMBackend::F64ConvI64Value(
+void ASMFunctionTranslator::F64ConvI64Value(
     T dest, Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   if (v.IsConstantGlobal()) {
@@ -1994,7 +2205,7 @@ void ASMBackend::F64ConvI64Value(
   }
 }
 
-x86::Ymm ASMBackend::GetYMMWordValue(
+x86::Ymm ASMFunctionTranslator::GetYMMWordValue(
     Value v, std::vector<int32_t>& offsets,
     const std::vector<RegisterAssignment>& register_assign) {
   const auto& constant_instrs = program_.ConstantInstrs();
@@ -2029,7 +2240,47 @@ x86::Ymm ASMBackend::GetYMMWordValue(
   }
 }
 
-void ASMBackend::CondBrFlag(
+void ASMFunctionTranslator::CondBr(
+    Value v, int true_bb, int false_bb,
+    const std::vector<uint64_t>& instructions, std::vector<int32_t>& offsets,
+    const std::vector<RegisterAssignment>& register_assign,
+    const std::vector<Label>& basic_blocks, int next_bb) {
+  if (IsIFlag(register_assign[v.GetIdx()])) {
+    CondBrFlag(v, true_bb, false_bb, instructions, register_assign,
+               basic_blocks, next_bb);
+  } else if (IsFFlag(register_assign[v.GetIdx()])) {
+    CondBrF64Flag(v, true_bb, false_bb, instructions, register_assign,
+                  basic_blocks, next_bb);
+  } else if (register_assign[v.GetIdx()].IsRegister()) {
+    asm_->cmp(
+        GPRegister::FromId(register_assign[v.GetIdx()].Register()).GetB(), 0);
+
+    if (next_bb == true_bb) {
+      asm_->je(basic_blocks[false_bb]);
+      // fall through to the true_bb
+    } else if (next_bb == false_bb) {
+      asm_->jne(basic_blocks[true_bb]);
+      // fall through to the false
+    } else {
+      asm_->jne(basic_blocks[true_bb]);
+      asm_->jmp(basic_blocks[false_bb]);
+    }
+  } else {
+    asm_->cmp(x86::byte_ptr(x86::rsp, GetOffset(offsets, v.GetIdx())), 0);
+    if (next_bb == true_bb) {
+      asm_->je(basic_blocks[false_bb]);
+      // fall through to the true_bb
+    } else if (next_bb == false_bb) {
+      asm_->jne(basic_blocks[true_bb]);
+      // fall through to the false
+    } else {
+      asm_->jne(basic_blocks[true_bb]);
+      asm_->jmp(basic_blocks[false_bb]);
+    }
+  }
+}
+
+void ASMFunctionTranslator::CondBrFlag(
     Value v, int true_bb, int false_bb,
     const std::vector<uint64_t>& instructions,
     const std::vector<RegisterAssignment>& register_assign,
@@ -2153,7 +2404,7 @@ void ASMBackend::CondBrFlag(
   }
 }
 
-void ASMBackend::CondBrF64Flag(
+void ASMFunctionTranslator::CondBrF64Flag(
     Value v, int true_bb, int false_bb,
     const std::vector<uint64_t>& instructions,
     const std::vector<RegisterAssignment>& register_assign,
@@ -2199,7 +2450,7 @@ void ASMBackend::CondBrF64Flag(
   }
 }
 
-void ASMBackend::TranslateInstr(
+void ASMFunctionTranslator::TranslateInstr(
     int instr_idx, const std::vector<uint64_t>& instructions,
     const std::vector<asmjit::Label>& basic_blocks,
     const asmjit::Label& epilogue, std::vector<int32_t>& offsets,
@@ -3339,6 +3590,23 @@ void ASMBackend::TranslateInstr(
       return;
     }
 
+    case Opcode::I32_SEXT_I64: {
+      Type2InstructionReader reader(instr);
+      Value v(reader.Arg0());
+
+      auto dest = dest_assign.IsRegister()
+                      ? GPRegister::FromId(dest_assign.Register())
+                      : GPRegister::RAX;
+      SextDWordValue(dest, v, offsets, register_assign);
+
+      if (!dest_assign.IsRegister()) {
+        auto offset = stack_allocator.AllocateSlot();
+        offsets[instr_idx] = offset;
+        asm_->mov(x86::qword_ptr(x86::rsp, offset), dest.GetQ());
+      }
+      return;
+    }
+
     case Opcode::I32_CONV_F64: {
       Type2InstructionReader reader(instr);
       Value v(reader.Arg0());
@@ -3564,6 +3832,26 @@ void ASMBackend::TranslateInstr(
       return;
     }
 
+    case Opcode::I64_CRC32: {
+      Type2InstructionReader reader(instr);
+      Value v0(reader.Arg0());
+      Value v1(reader.Arg1());
+
+      if (dest_assign.IsRegister()) {
+        auto dest = GPRegister::FromId(dest_assign.Register()).GetQ();
+        MoveQWordValue(dest, v0, offsets, register_assign);
+        Crc32QWordValue(dest, v1, offsets, register_assign);
+      } else {
+        auto offset = stack_allocator.AllocateSlot();
+        offsets[instr_idx] = offset;
+        auto dest = GPRegister::RAX.GetQ();
+        MoveQWordValue(dest, v0, offsets, register_assign);
+        Crc32QWordValue(dest, v1, offsets, register_assign);
+        asm_->mov(x86::qword_ptr(x86::rsp, offset), dest);
+      }
+      return;
+    }
+
     case Opcode::PTR_CMP_NULLPTR: {
       Type2InstructionReader reader(instr);
       Value v(reader.Arg0());
@@ -3866,9 +4154,9 @@ void ASMBackend::TranslateInstr(
           return;
         }
 
-        auto label = GetGlobalPointer(v1);
+        uint64_t addr = GetGlobalPointer(v1);
         auto dest = GPRegister::FromId(dest_assign.Register());
-        asm_->lea(dest.GetQ(), x86::ptr(label));
+        asm_->mov(dest.GetQ(), addr);
         asm_->mov(loc, dest.GetQ());
       } else if (register_assign[v1.GetIdx()].IsRegister()) {
         auto v1_reg = register_assign[v1.GetIdx()].Register();
@@ -4087,39 +4375,28 @@ void ASMBackend::TranslateInstr(
       int true_bb = reader.Marg0();
       int false_bb = reader.Marg1();
 
-      if (IsIFlag(register_assign[v.GetIdx()])) {
-        CondBrFlag(v, true_bb, false_bb, instructions, register_assign,
-                   basic_blocks, next_bb);
-      } else if (IsFFlag(register_assign[v.GetIdx()])) {
-        CondBrF64Flag(v, true_bb, false_bb, instructions, register_assign,
-                      basic_blocks, next_bb);
-      } else if (register_assign[v.GetIdx()].IsRegister()) {
-        asm_->cmp(
-            GPRegister::FromId(register_assign[v.GetIdx()].Register()).GetB(),
-            0);
-
-        if (next_bb == true_bb) {
-          asm_->je(basic_blocks[false_bb]);
-          // fall through to the true_bb
-        } else if (next_bb == false_bb) {
-          asm_->jne(basic_blocks[true_bb]);
-          // fall through to the false
-        } else {
-          asm_->jne(basic_blocks[true_bb]);
-          asm_->jmp(basic_blocks[false_bb]);
-        }
-      } else {
-        asm_->cmp(x86::byte_ptr(x86::rsp, GetOffset(offsets, v.GetIdx())), 0);
-        if (next_bb == true_bb) {
-          asm_->je(basic_blocks[false_bb]);
-          // fall through to the true_bb
-        } else if (next_bb == false_bb) {
-          asm_->jne(basic_blocks[true_bb]);
-          // fall through to the false
-        } else {
-          asm_->jne(basic_blocks[true_bb]);
-          asm_->jmp(basic_blocks[false_bb]);
-        }
+      if (profile_ == nullptr) {
+        CondBr(v, true_bb, false_bb, instructions, offsets, register_assign,
+               basic_blocks, next_bb);
+        return;
+      }
+
+      // Branch to an edge that bumps its counter and then jumps to the
+      // successor. Flags are no longer live at that point and RAX is scratch.
+      auto counters = profile_->Counters(func_idx_, instr_idx);
+      std::vector<Label> edges = {asm_->newLabel(), asm_->newLabel()};
+      CondBr(v, 0, 1, instructions, offsets, register_assign, edges, 1);
+
+      asm_->bind(edges[1]);
+      asm_->mov(x86::rax, reinterpret_cast<uint64_t>(counters + 1));
+      asm_->add(x86::qword_ptr(x86::rax), 1);
+      asm_->jmp(basic_blocks[false_bb]);
+
+      asm_->bind(edges[0]);
+      asm_->mov(x86::rax, reinterpret_cast<uint64_t>(counters));
+      asm_->add(x86::qword_ptr(x86::rax), 1);
+      if (next_bb != true_bb) {
+        asm_->jmp(basic_blocks[true_bb]);
       }
       return;
     }
@@ -4447,7 +4724,7 @@ void ASMBackend::TranslateInstr(
         if (func.External()) {
           asm_->call(func.Addr());
         } else {
-          asm_->call(internal_func_labels_[reader.Arg()]);
+          asm_->call(symbols_.functions[reader.Arg()]);
         }
         return_type = type_manager.GetFunctionReturnType(func.Type());
 
@@ -4514,44 +4791,188 @@ void ASMBackend::TranslateInstr(
   }
 }
 
-double ASMBackend::CompilationTime() { return compilation_time_; }
+double ASMBackend::CompilationTime() {
+  std::lock_guard<std::mutex> lock(time_mutex_);
+  return compilation_time_;
+}
 
-void ASMBackend::ResetCompilationTime() { compilation_time_ = 0; }
+double ASMBackend::OptimizationTime() {
+  std::lock_guard<std::mutex> lock(time_mutex_);
+  return optimization_time_;
+}
+
+void ASMBackend::AddCompilationTime(double ms) {
+  std::lock_guard<std::mutex> lock(time_mutex_);
+  compilation_time_ += ms;
+}
+
+void ASMBackend::SetBranchProfile(BranchProfile* profile) {
+  profile_ = profile;
+}
 
 void ASMBackend::Compile() {
 #ifdef COMP_TIME
   auto t1 = std::chrono::high_resolution_clock::now();
 #endif
 
-  Translate();
-  rt_.add(&buffer_start_, &code_);
+  const auto& functions = program_.Functions();
+  states_ = std::make_unique<std::atomic<FunctionState>[]>(functions.size());
+  compiled_.assign(functions.size(), nullptr);
+  errors_.assign(functions.size(), nullptr);
+  for (int func_idx = 0; func_idx < functions.size(); func_idx++) {
+    states_[func_idx] = FunctionState::NOT_STARTED;
+    if (!functions[func_idx].External()) {
+      function_idx_[functions[func_idx].Name()] = func_idx;
+    }
+  }
+
+  TranslateStubs();
+  TranslateData();
+
+  // The calling thread compiles whatever it needs on demand so leave it a
+  // core.
+  int num_workers =
+      std::min<int>(std::thread::hardware_concurrency(), functions.size()) - 1;
+  for (int i = 0; i < num_workers; i++) {
+    workers_.emplace_back([this]() { CompileInBackground(); });
+  }
 
 #ifdef COMP_TIME
   auto t2 = std::chrono::high_resolution_clock::now();
   std::chrono::duration<double, std::milli> fp_ms = t2 - t1;
-  compilation_time_ += fp_ms.count();
+  AddCompilationTime(fp_ms.count());
+#endif
+}
+
+void ASMBackend::CompileFunction(int func_idx) {
+  // Timed here rather than by the callers so that functions compiled by the
+  // background workers are counted and time spent waiting for them is not.
+#ifdef COMP_TIME
+  auto t1 = std::chrono::high_resolution_clock::now();
 #endif
 
+  void* result = nullptr;
+  std::exception_ptr error = nullptr;
+  try {
+    ASMFunctionTranslator translator(program_, reg_alloc_impl_, symbols_,
+                                     rt_.environment(), profile_);
+    auto [begin_label, end_label] = translator.Translate(func_idx);
+    auto& code = translator.Code();
+
+    void* buffer;
+    {
+      std::lock_guard<std::mutex> lock(rt_mutex_);
+      if (rt_.add(&buffer, &code) != kErrorOk) {
+        throw std::runtime_error("Unable to add function to the runtime.");
+      }
+
 #ifdef PROFILE_ENABLED
-  for (const auto& [name, labels] : function_start_end_) {
-    auto [begin_label, end_label] = labels;
+      auto begin_offset = code.labelOffsetFromBase(begin_label);
+      auto end_offset = code.labelOffsetFromBase(end_label);
+      util::ProfileMapGenerator::Get().AddEntry(
+          reinterpret_cast<void*>(reinterpret_cast<uint64_t>(buffer) +
+                                  begin_offset),
+          end_offset - begin_offset, program_.Functions()[func_idx].Name());
+#endif
+    }
+
+    auto addr = reinterpret_cast<uint64_t>(buffer) +
+                code.labelOffsetFromBase(begin_label);
+    slots_[func_idx] = addr;
+    result = reinterpret_cast<void*>(addr);
 
-    auto begin_offset = code_.labelOffsetFromBase(begin_label);
-    auto end_offset = code_.labelOffsetFromBase(end_label);
-    auto begin_addr = reinterpret_cast<void*>(
-        reinterpret_cast<uint64_t>(buffer_start_) + begin_offset);
-    auto code_size = end_offset - begin_offset;
+    auto& stats = util::QueryStats::Get();
+    if (stats.Enabled()) {
+      auto name = program_.Functions()[func_idx].Name();
+      stats.SetInstructionCount(
+          "asm", name, program_.Functions()[func_idx].Instrs().size());
+      stats.SetCodeSize("asm", name,
+                        code.labelOffsetFromBase(end_label) -
+                            code.labelOffsetFromBase(begin_label));
+    }
 
-    util::ProfileMapGenerator::Get().AddEntry(begin_addr, code_size, name);
+#ifdef COMP_TIME
+    std::lock_guard<std::mutex> time_lock(time_mutex_);
+    optimization_time_ += translator.OptimizationTime();
+#endif
+  } catch (...) {
+    error = std::current_exception();
   }
+
+#ifdef COMP_TIME
+  auto t2 = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::milli> fp_ms = t2 - t1;
+  AddCompilationTime(fp_ms.count());
 #endif
+
+  {
+    std::lock_guard<std::mutex> lock(compiled_mutex_);
+    compiled_[func_idx] = result;
+    errors_[func_idx] = error;
+    states_[func_idx] = FunctionState::DONE;
+  }
+  compiled_cv_.notify_all();
+}
+
+void ASMBackend::CompileInBackground() {
+  const auto& functions = program_.Functions();
+  while (!stop_) {
+    int func_idx = next_func_++;
+    if (func_idx >= functions.size()) {
+      return;
+    }
+
+    if (functions[func_idx].External()) {
+      continue;
+    }
+
+    auto expected = FunctionState::NOT_STARTED;
+    if (states_[func_idx].compare_exchange_strong(expected,
+                                                  FunctionState::IN_PROGRESS)) {
+      CompileFunction(func_idx);
+    }
+  }
+}
+
+void* ASMBackend::EnsureCompiled(int func_idx) {
+  auto expected = FunctionState::NOT_STARTED;
+  if (states_[func_idx].compare_exchange_strong(expected,
+                                                FunctionState::IN_PROGRESS)) {
+    CompileFunction(func_idx);
+  }
+
+  std::unique_lock<std::mutex> lock(compiled_mutex_);
+  compiled_cv_.wait(lock, [&]() {
+    return states_[func_idx] == FunctionState::DONE;
+  });
+  if (errors_[func_idx] != nullptr) {
+    std::rethrow_exception(errors_[func_idx]);
+  }
+  return compiled_[func_idx];
+}
+
+void* ASMBackend::LazyCompile(ASMBackend* backend, int32_t func_idx) {
+  // Called from the trampoline of generated code which has no unwind
+  // information, so an exception cannot propagate out of here.
+  void* result;
+  try {
+    result = backend->EnsureCompiled(func_idx);
+  } catch (const std::exception& e) {
+    std::cerr << "Unable to compile "
+              << backend->program_.Functions()[func_idx].Name() << ": "
+              << e.what() << std::endl;
+    std::abort();
+  } catch (...) {
+    std::cerr << "Unable to compile "
+              << backend->program_.Functions()[func_idx].Name() << std::endl;
+    std::abort();
+  }
+
+  return result;
 }
 
 void* ASMBackend::GetFunction(std::string_view name) {
-  auto [begin_label, end_label] = function_start_end_.at(name);
-  auto offset = code_.labelOffsetFromBase(begin_label);
-  return reinterpret_cast<void*>(reinterpret_cast<uint64_t>(buffer_start_) +
-                                 offset);
+  return EnsureCompiled(function_idx_.at(name));
 }
 
 }  // namespace kush::khir
\ No newline at end of file
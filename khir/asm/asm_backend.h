@@ -1,6 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdio>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
 
 #include "asmjit/x86.h"
 
@@ -8,6 +17,7 @@
 #include "khir/asm/register.h"
 #include "khir/asm/register_assignment.h"
 #include "khir/backend.h"
+#include "khir/branch_profile.h"
 #include "khir/opcode.h"
 #include "khir/program.h"
 #include "khir/type_manager.h"
@@ -36,6 +46,7 @@ struct GEPDynamicInfo {
   Value index;
   int32_t offset;
   int32_t type_size;
+  bool i64_index;
 };
 
 struct GEPStaticInfo {
@@ -43,20 +54,35 @@ struct GEPStaticInfo {
   int32_t offset;
 };
 
-class ASMBackend : public Backend {
+// Addresses of everything that is shared between the separately assembled
+// functions of a program.
+struct ASMSymbols {
+  // Entry stub of each internal function and the address of each external one.
+  std::vector<void*> functions;
+  std::vector<uint64_t> char_arrays;
+  std::vector<uint64_t> globals;
+};
+
+// Assembles a single function of the program into its own code buffer.
+class ASMFunctionTranslator {
  public:
-  ASMBackend(const Program& program, RegAllocImpl impl);
-  virtual ~ASMBackend() = default;
+  ASMFunctionTranslator(const Program& program, RegAllocImpl impl,
+                        const ASMSymbols& symbols,
+                        const asmjit::Environment& environment,
+                        BranchProfile* profile);
 
-  // Backend
-  void Compile();
-  void* GetFunction(std::string_view name) override;
+  // Returns the labels of the start and end of the function in Code().
+  std::pair<asmjit::Label, asmjit::Label> Translate(int func_idx);
+  asmjit::CodeHolder& Code();
 
-  static double CompilationTime();
-  static void ResetCompilationTime();
+  // Time spent in the khir optimization passes of the last Translate.
+  double OptimizationTime();
 
  private:
-  void Translate();
+  // Runs value numbering, loop invariant code motion and dead code
+  // elimination over a copy of func.
+  Function Optimize(const Function& func);
+
   bool IsNullPtr(Value v);
   bool IsConstantPtr(Value v);
   bool IsConstantCastedPtr(Value v);
@@ -67,12 +93,10 @@ class ASMBackend : public Backend {
   uint64_t GetQwordConstant(Value v);
   uint64_t GetPtrConstant(Value v);
   double GetF64Constant(Value v);
-  asmjit::Label GetGlobalPointer(Value v);
+  uint64_t GetGlobalPointer(Value v);
   GEPStaticInfo StaticGEP(Value v, const std::vector<uint64_t>& instrs);
   GEPDynamicInfo DynamicGEP(Value v, const std::vector<uint64_t>& instrs);
 
-  uint64_t OutputConstant(uint64_t instr);
-
   void TranslateInstr(int instr_idx, const std::vector<uint64_t>& instructions,
                       const std::vector<asmjit::Label>& basic_blocks,
                       const asmjit::Label& epilogue,
@@ -178,6 +202,8 @@ class ASMBackend : public Backend {
                      const std::vector<RegisterAssignment>& register_assign);
   void ZextDWordValue(GPRegister dest, Value v, std::vector<int32_t>& offsets,
                       const std::vector<RegisterAssignment>& register_assign);
+  void SextDWordValue(GPRegister dest, Value v, std::vector<int32_t>& offsets,
+                      const std::vector<RegisterAssignment>& register_assign);
   asmjit::x86::Mem GetDWordPtrValue(
       Value v, std::vector<int32_t>& offsets,
       const std::vector<uint64_t>& instrs,
@@ -215,6 +241,9 @@ class ASMBackend : public Backend {
   void MulQWordValue(asmjit::x86::Gpq dest, Value v,
                      std::vector<int32_t>& offsets,
                      const std::vector<RegisterAssignment>& register_assign);
+  void Crc32QWordValue(asmjit::x86::Gpq dest, Value v,
+                       std::vector<int32_t>& offsets,
+                       const std::vector<RegisterAssignment>& register_assign);
   asmjit::x86::Gpq GetQWordValue(
       Value v, std::vector<int32_t>& offsets,
       const std::vector<RegisterAssignment>& register_assign);
@@ -261,6 +290,11 @@ class ASMBackend : public Backend {
   template <typename T>
   void F64ConvI64Value(T dest, Value v, std::vector<int32_t>& offsets,
                        const std::vector<RegisterAssignment>& register_assign);
+  void CondBr(Value v, int true_bb, int false_bb,
+              const std::vector<uint64_t>& instructions,
+              std::vector<int32_t>& offsets,
+              const std::vector<RegisterAssignment>& register_assign,
+              const std::vector<asmjit::Label>& basic_blocks, int next_bb);
   void CondBrFlag(Value v, int true_bb, int false_bb,
                   const std::vector<uint64_t>& instructions,
                   const std::vector<RegisterAssignment>& register_assign,
@@ -284,9 +318,12 @@ class ASMBackend : public Backend {
   asmjit::Label EmbedI32Vec8(std::array<int32_t, 8> c);
 
   const Program& program_;
-
   RegAllocImpl reg_alloc_impl_;
-  asmjit::JitRuntime rt_;
+  const ASMSymbols& symbols_;
+  asmjit::Environment environment_;
+  BranchProfile* profile_;
+  int func_idx_;
+
   asmjit::FileLogger logger_;
   asmjit::CodeHolder code_;
   asmjit::Section* text_section_;
@@ -295,26 +332,82 @@ class ASMBackend : public Backend {
   ExceptionErrorHandler err_handler_;
   std::unique_ptr<asmjit::x86::Assembler> asm_;
 
-  std::vector<asmjit::Label> char_array_constants_;
-  std::vector<asmjit::Label> globals_;
-
-  std::vector<void*> external_func_addr_;
-  std::vector<asmjit::Label> internal_func_labels_;
   asmjit::Label ones_;
   asmjit::Label masks_;
   asmjit::Label permute_;
   int num_floating_point_args_;
   int num_regular_args_;
   int num_stack_args_;
-  void* buffer_start_;
 
   std::vector<std::pair<Value, Type>> regular_call_args_;
   std::vector<Value> floating_point_call_args_;
 
-  absl::flat_hash_map<std::string, std::pair<asmjit::Label, asmjit::Label>>
-      function_start_end_;
+  double optimization_time_;
+};
+
+// Compiles functions lazily. Every internal function is reached through an
+// entry stub that jumps through a slot. The slot initially points at a
+// trampoline that compiles the function on first call and then patches the
+// slot with the compiled code. Background threads compile the remaining
+// functions in program order so that most calls never hit the trampoline.
+class ASMBackend : public Backend {
+ public:
+  ASMBackend(const Program& program, RegAllocImpl impl);
+  virtual ~ASMBackend();
+
+  // Backend
+  void Compile();
+  void* GetFunction(std::string_view name) override;
+
+  // Counts the edges taken by every conditional branch into profile. Must be
+  // called before Compile.
+  void SetBranchProfile(BranchProfile* profile);
+
+  // Milliseconds spent compiling and in the khir optimization passes, summed
+  // over the calling thread and the background workers.
+  double CompilationTime();
+  double OptimizationTime();
+
+ private:
+  enum class FunctionState : int8_t { NOT_STARTED, IN_PROGRESS, DONE };
+
+  void TranslateStubs();
+  void TranslateData();
+  uint64_t OutputConstant(uint64_t instr);
+
+  void* EnsureCompiled(int func_idx);
+  void CompileFunction(int func_idx);
+  void CompileInBackground();
+  void AddCompilationTime(double ms);
+  static void* LazyCompile(ASMBackend* backend, int32_t func_idx);
+
+  const Program& program_;
+  RegAllocImpl reg_alloc_impl_;
+  BranchProfile* profile_;
+  asmjit::JitRuntime rt_;
+  std::mutex rt_mutex_;
+
+  std::unique_ptr<asmjit::x86::Assembler> asm_;
+  std::vector<asmjit::Label> char_array_constants_;
+  std::vector<asmjit::Label> globals_;
+
+  ASMSymbols symbols_;
+  absl::flat_hash_map<std::string, int> function_idx_;
+
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+  std::unique_ptr<std::atomic<FunctionState>[]> states_;
+  std::vector<void*> compiled_;
+  std::vector<std::exception_ptr> errors_;
+  std::mutex compiled_mutex_;
+  std::condition_variable compiled_cv_;
+
+  std::atomic<int> next_func_;
+  std::atomic<bool> stop_;
+  std::vector<std::thread> workers_;
 
-  static double compilation_time_;
+  std::mutex time_mutex_;
+  double compilation_time_;
+  double optimization_time_;
 };
 
 }  // namespace kush::khir
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "khir/asm/dead_code_elimination.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+
+#include "khir/asm/pass_utils.h"
+#include "khir/instruction.h"
+#include "khir/opcode.h"
+#include "khir/program.h"
+
+namespace kush::khir {
+
+bool HasSideEffects(Opcode opcode) {
+  switch (opcode) {
+    case Opcode::I8_STORE:
+    case Opcode::I16_STORE:
+    case Opcode::I32_STORE:
+    case Opcode::I64_STORE:
+    case Opcode::F64_STORE:
+    case Opcode::PTR_STORE:
+    case Opcode::I32_VEC8_MASK_STORE:
+    case Opcode::I32_VEC8_MASK_STORE_INFO:
+    case Opcode::CALL:
+    case Opcode::CALL_INDIRECT:
+    case Opcode::CALL_ARG:
+    case Opcode::FUNC_ARG:
+    case Opcode::BR:
+    case Opcode::CONDBR:
+    case Opcode::RETURN:
+    case Opcode::RETURN_VALUE:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+void DeadCodeElimination(const std::vector<uint64_t>& instrs,
+                         std::vector<BasicBlock>& basic_blocks) {
+  std::vector<bool> live(instrs.size(), false);
+  std::vector<int> worklist;
+  absl::flat_hash_map<int, std::vector<int>> phi_members;
+
+  auto mark = [&](int idx) {
+    if (!live[idx]) {
+      live[idx] = true;
+      worklist.push_back(idx);
+    }
+  };
+
+  for (const auto& bb : basic_blocks) {
+    for (int idx : FlattenSegments(bb)) {
+      auto opcode = OpcodeFrom(GenericInstructionReader(instrs[idx]).Opcode());
+      if (opcode == Opcode::PHI_MEMBER) {
+        Type2InstructionReader reader(instrs[idx]);
+        phi_members[Value(reader.Arg0()).GetIdx()].push_back(idx);
+      }
+
+      if (HasSideEffects(opcode)) {
+        mark(idx);
+      }
+    }
+  }
+
+  while (!worklist.empty()) {
+    int idx = worklist.back();
+    worklist.pop_back();
+
+    auto opcode = OpcodeFrom(GenericInstructionReader(instrs[idx]).Opcode());
+    switch (opcode) {
+      // A phi is live iff it is used and then all of its members are.
+      case Opcode::PHI: {
+        auto it = phi_members.find(idx);
+        if (it != phi_members.end()) {
+          for (int member : it->second) {
+            mark(member);
+          }
+        }
+        break;
+      }
+
+      // The offset of a GEP and the info of a mask store live right before
+      // the instruction.
+      case Opcode::GEP_STATIC:
+      case Opcode::GEP_DYNAMIC:
+      case Opcode::I32_VEC8_MASK_STORE:
+        mark(idx - 1);
+        break;
+
+      default:
+        break;
+    }
+
+    ForEachOperand(instrs[idx], [&](Value v) {
+      if (!v.IsConstantGlobal()) {
+        mark(v.GetIdx());
+      }
+    });
+  }
+
+  for (auto& bb : basic_blocks) {
+    std::vector<int> remaining;
+    for (int idx : FlattenSegments(bb)) {
+      if (live[idx]) {
+        remaining.push_back(idx);
+      }
+    }
+    bb.Segments() = BuildSegments(remaining);
+  }
+}
+
+}  // namespace kush::khir
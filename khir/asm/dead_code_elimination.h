@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "khir/program.h"
+
+namespace kush::khir {
+
+// Removes instructions whose results are never used and that have no side
+// effects from the segments of each basic block.
+void DeadCodeElimination(const std::vector<uint64_t>& instrs,
+                         std::vector<BasicBlock>& basic_blocks);
+
+}  // namespace kush::khir
@@ -0,0 +1,73 @@
+#include "khir/asm/dead_code_elimination.h"
+
+#include "gtest/gtest.h"
+
+#include "khir/asm/pass_utils.h"
+#include "khir/asm/value_numbering.h"
+#include "khir/instruction.h"
+#include "khir/program_builder.h"
+
+using namespace kush;
+using namespace kush::khir;
+
+int CountInstrs(const std::vector<uint64_t>& instrs,
+                const std::vector<BasicBlock>& basic_blocks, Opcode opcode) {
+  int count = 0;
+  for (const auto& bb : basic_blocks) {
+    for (int idx : FlattenSegments(bb)) {
+      if (OpcodeFrom(GenericInstructionReader(instrs[idx]).Opcode()) ==
+          opcode) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+TEST(DeadCodeEliminationTest, RemovesUnusedValues) {
+  ProgramBuilder program;
+
+  auto type = program.I32Type();
+  auto st = program.StructType({type, type});
+  auto func = program.CreateNamedFunction(
+      type, {program.PointerType(st), type}, "compute");
+  auto args = program.GetFunctionArguments(func);
+  program.LoadI32(program.StaticGEP(st, args[0], {0, 1}));
+  program.MulI32(args[1], args[1]);
+  program.StoreI32(program.StaticGEP(st, args[0], {0, 0}), args[1]);
+  program.Return(args[1]);
+
+  auto built = program.Build();
+  const auto& function = built->Functions()[0];
+  const auto& instrs = function.Instrs();
+  auto basic_blocks = function.BasicBlocks();
+  DeadCodeElimination(instrs, basic_blocks);
+
+  EXPECT_EQ(CountInstrs(instrs, basic_blocks, Opcode::I32_LOAD), 0);
+  EXPECT_EQ(CountInstrs(instrs, basic_blocks, Opcode::I32_MUL), 0);
+  EXPECT_EQ(CountInstrs(instrs, basic_blocks, Opcode::I32_STORE), 1);
+  EXPECT_EQ(CountInstrs(instrs, basic_blocks, Opcode::GEP_STATIC), 1);
+  EXPECT_EQ(CountInstrs(instrs, basic_blocks, Opcode::GEP_STATIC_OFFSET), 1);
+  EXPECT_EQ(CountInstrs(instrs, basic_blocks, Opcode::FUNC_ARG), 2);
+}
+
+TEST(DeadCodeEliminationTest, RemovesReplacedValues) {
+  ProgramBuilder program;
+
+  auto type = program.I32Type();
+  auto func = program.CreateNamedFunction(type, {type, type}, "compute");
+  auto args = program.GetFunctionArguments(func);
+  auto x1 = program.AddI32(args[0], args[1]);
+  auto x2 = program.AddI32(args[0], args[1]);
+  program.Return(program.MulI32(x1, x2));
+
+  auto built = program.Build();
+  const auto& function = built->Functions()[0];
+  auto instrs = function.Instrs();
+  auto basic_blocks = function.BasicBlocks();
+  ValueNumbering(*built, instrs, basic_blocks);
+  DeadCodeElimination(instrs, basic_blocks);
+
+  EXPECT_EQ(CountInstrs(instrs, basic_blocks, Opcode::I32_ADD), 1);
+  EXPECT_EQ(CountInstrs(instrs, basic_blocks, Opcode::I32_MUL), 1);
+}
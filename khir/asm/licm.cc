@@ -0,0 +1,255 @@
+#include "khir/asm/licm.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "khir/asm/dfs_label.h"
+#include "khir/asm/loops.h"
+#include "khir/asm/pass_utils.h"
+#include "khir/instruction.h"
+#include "khir/opcode.h"
+#include "khir/program.h"
+
+namespace kush::khir {
+
+void CollectLoopBlocks(const std::vector<std::vector<int>>& loop_tree,
+                       int curr, std::vector<int>& result) {
+  result.push_back(curr);
+  for (int x : loop_tree[curr]) {
+    CollectLoopBlocks(loop_tree, x, result);
+  }
+}
+
+// Returns true if loading from v can never fault, i.e. v is an address within
+// a global or a constant pointer.
+bool IsDereferenceable(const Program& program,
+                       const std::vector<uint64_t>& instrs, Value v) {
+  if (v.IsConstantGlobal()) {
+    auto instr = program.ConstantInstrs()[v.GetIdx()];
+    switch (ConstantOpcodeFrom(GenericInstructionReader(instr).Opcode())) {
+      case ConstantOpcode::GLOBAL_REF:
+        return true;
+
+      case ConstantOpcode::PTR_CONST: {
+        auto id = Type1InstructionReader(instr).Constant();
+        return program.PtrConstants()[id] != nullptr;
+      }
+
+      case ConstantOpcode::PTR_CAST:
+        return IsDereferenceable(program, instrs,
+                                 Value(Type3InstructionReader(instr).Arg()));
+
+      default:
+        return false;
+    }
+  }
+
+  auto instr = instrs[v.GetIdx()];
+  switch (OpcodeFrom(GenericInstructionReader(instr).Opcode())) {
+    case Opcode::PTR_CAST:
+      return IsDereferenceable(program, instrs,
+                               Value(Type3InstructionReader(instr).Arg()));
+
+    case Opcode::GEP_STATIC: {
+      Type2InstructionReader offset_reader(instrs[v.GetIdx() - 1]);
+      return IsDereferenceable(program, instrs, Value(offset_reader.Arg0()));
+    }
+
+    default:
+      return false;
+  }
+}
+
+class LoopInvariantCodeMover {
+ public:
+  LoopInvariantCodeMover(const Program& program, std::vector<uint64_t>& instrs,
+                         std::vector<BasicBlock>& basic_blocks)
+      : program_(program),
+        instrs_(instrs),
+        basic_blocks_(basic_blocks),
+        block_of_(instrs.size(), -1) {
+    for (int bb = 0; bb < basic_blocks_.size(); bb++) {
+      for (int idx : FlattenSegments(basic_blocks_[bb])) {
+        block_of_[idx] = bb;
+      }
+    }
+
+    auto order_analysis = DFSLabel(basic_blocks_);
+    rpo_ = order_analysis.postorder_label;
+  }
+
+  void Run() {
+    auto loop_tree = FindLoops(basic_blocks_);
+
+    std::vector<std::vector<int>> loops;
+    for (int bb = 0; bb < basic_blocks_.size(); bb++) {
+      const auto& succ = basic_blocks_[bb].Successors();
+      bool self_loop = std::find(succ.begin(), succ.end(), bb) != succ.end();
+      if (loop_tree[bb].empty() && !self_loop) {
+        continue;
+      }
+
+      std::vector<int> loop;
+      CollectLoopBlocks(loop_tree, bb, loop);
+      loops.push_back(std::move(loop));
+    }
+
+    // Process inner loops first so that invariants bubble outwards.
+    std::sort(loops.begin(), loops.end(),
+              [](const auto& l1, const auto& l2) {
+                return l1.size() < l2.size();
+              });
+    for (const auto& loop : loops) {
+      HoistLoop(loop);
+    }
+  }
+
+ private:
+  void HoistLoop(const std::vector<int>& loop) {
+    int header = loop.front();
+    std::vector<bool> in_loop(basic_blocks_.size(), false);
+    for (int bb : loop) {
+      in_loop[bb] = true;
+    }
+
+    // Require a preheader: the unique outside predecessor of the header that
+    // only branches to the header.
+    int preheader = -1;
+    for (int pred : basic_blocks_[header].Predecessors()) {
+      if (in_loop[pred]) {
+        continue;
+      }
+
+      if (preheader >= 0) {
+        return;
+      }
+      preheader = pred;
+    }
+    if (preheader < 0 || basic_blocks_[preheader].Successors().size() != 1) {
+      return;
+    }
+
+    bool has_call = false;
+    std::vector<MemoryAccess> stores;
+    for (int bb : loop) {
+      for (int idx : FlattenSegments(basic_blocks_[bb])) {
+        auto opcode =
+            OpcodeFrom(GenericInstructionReader(instrs_[idx]).Opcode());
+        if (opcode == Opcode::CALL || opcode == Opcode::CALL_INDIRECT) {
+          has_call = true;
+        } else if (IsStore(opcode)) {
+          stores.push_back(GetMemoryAccess(program_, instrs_, idx));
+        }
+      }
+    }
+
+    auto is_invariant = [&](Value v) {
+      return v.IsConstantGlobal() || !in_loop[block_of_[v.GetIdx()]];
+    };
+
+    auto is_clobbered = [&](const MemoryAccess& load) {
+      return has_call || std::any_of(stores.begin(), stores.end(),
+                                     [&](const MemoryAccess& store) {
+                                       return MayAlias(store, load);
+                                     });
+    };
+
+    // Visit blocks in reverse postorder so that definitions are seen before
+    // their uses.
+    auto order = loop;
+    std::sort(order.begin(), order.end(),
+              [&](int bb1, int bb2) { return rpo_[bb2] < rpo_[bb1]; });
+
+    std::vector<int> hoisted;
+    for (int bb : order) {
+      for (int idx : FlattenSegments(basic_blocks_[bb])) {
+        auto opcode =
+            OpcodeFrom(GenericInstructionReader(instrs_[idx]).Opcode());
+
+        bool invariant = true;
+        ForEachOperand(instrs_[idx], [&](Value v) {
+          invariant = invariant && is_invariant(v);
+        });
+        if (!invariant) {
+          continue;
+        }
+
+        bool is_gep =
+            opcode == Opcode::GEP_STATIC || opcode == Opcode::GEP_DYNAMIC;
+        if (is_gep) {
+          ForEachOperand(instrs_[idx - 1], [&](Value v) {
+            invariant = invariant && is_invariant(v);
+          });
+          if (!invariant) {
+            continue;
+          }
+        } else if (IsLoad(opcode)) {
+          if (is_clobbered(GetMemoryAccess(program_, instrs_, idx))) {
+            continue;
+          }
+
+          // The header always executes once the loop is entered so its loads
+          // can be executed early. Other loads are speculated only when they
+          // cannot fault.
+          Value addr(opcode == Opcode::PTR_LOAD
+                         ? Type3InstructionReader(instrs_[idx]).Arg()
+                         : Type2InstructionReader(instrs_[idx]).Arg0());
+          if (bb != header && !IsDereferenceable(program_, instrs_, addr)) {
+            continue;
+          }
+        } else if (!IsPureInstr(opcode)) {
+          continue;
+        }
+
+        if (is_gep) {
+          hoisted.push_back(idx - 1);
+          block_of_[idx - 1] = preheader;
+        }
+        hoisted.push_back(idx);
+        block_of_[idx] = preheader;
+      }
+    }
+
+    if (hoisted.empty()) {
+      return;
+    }
+
+    for (int bb : loop) {
+      std::vector<int> remaining;
+      for (int idx : FlattenSegments(basic_blocks_[bb])) {
+        if (block_of_[idx] == bb) {
+          remaining.push_back(idx);
+        }
+      }
+      basic_blocks_[bb].Segments() = BuildSegments(remaining);
+    }
+
+    // Insert before the trailing phi members and the terminator.
+    auto preheader_instrs = FlattenSegments(basic_blocks_[preheader]);
+    int insert_pos = preheader_instrs.size() - 1;
+    while (insert_pos > 0 &&
+           OpcodeFrom(GenericInstructionReader(
+                          instrs_[preheader_instrs[insert_pos - 1]])
+                          .Opcode()) == Opcode::PHI_MEMBER) {
+      insert_pos--;
+    }
+    preheader_instrs.insert(preheader_instrs.begin() + insert_pos,
+                            hoisted.begin(), hoisted.end());
+    basic_blocks_[preheader].Segments() = BuildSegments(preheader_instrs);
+  }
+
+  const Program& program_;
+  std::vector<uint64_t>& instrs_;
+  std::vector<BasicBlock>& basic_blocks_;
+  std::vector<int> block_of_;
+  std::vector<int> rpo_;
+};
+
+void LoopInvariantCodeMotion(const Program& program,
+                             std::vector<uint64_t>& instrs,
+                             std::vector<BasicBlock>& basic_blocks) {
+  LoopInvariantCodeMover(program, instrs, basic_blocks).Run();
+}
+
+}  // namespace kush::khir
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "khir/program.h"
+
+namespace kush::khir {
+
+// Hoists loop invariant instructions into the preheader of each loop. Loads
+// are only hoisted out of loops that contain neither calls nor stores that may
+// alias them and only if hoisting them cannot introduce a fault.
+void LoopInvariantCodeMotion(const Program& program,
+                             std::vector<uint64_t>& instrs,
+                             std::vector<BasicBlock>& basic_blocks);
+
+}  // namespace kush::khir
@@ -0,0 +1,126 @@
+#include "khir/asm/licm.h"
+
+#include <functional>
+
+#include "gtest/gtest.h"
+
+#include "khir/asm/pass_utils.h"
+#include "khir/instruction.h"
+#include "khir/program_builder.h"
+
+using namespace kush;
+using namespace kush::khir;
+
+int FindBlock(const std::vector<uint64_t>& instrs,
+              const std::vector<BasicBlock>& basic_blocks, Opcode opcode) {
+  for (int bb = 0; bb < basic_blocks.size(); bb++) {
+    for (int idx : FlattenSegments(basic_blocks[bb])) {
+      if (OpcodeFrom(GenericInstructionReader(instrs[idx]).Opcode()) ==
+          opcode) {
+        return bb;
+      }
+    }
+  }
+  return -1;
+}
+
+// for (int i = 0; i < bound(); i++) { body(i) }
+void BuildLoop(ProgramBuilder& program, const std::function<Value()>& bound,
+               const std::function<void(Value)>& body) {
+  auto type = program.I32Type();
+  auto header = program.GenerateBlock();
+  auto loop_body = program.GenerateBlock();
+  auto exit = program.GenerateBlock();
+
+  auto init = program.PhiMember(program.ConstI32(0));
+  program.Branch(header);
+
+  program.SetCurrentBlock(header);
+  auto i = program.Phi(type);
+  program.UpdatePhiMember(i, init);
+  program.Branch(program.CmpI32(CompType::LT, i, bound()), loop_body, exit);
+
+  program.SetCurrentBlock(loop_body);
+  body(i);
+  auto next = program.PhiMember(program.AddI32(i, program.ConstI32(1)));
+  program.UpdatePhiMember(i, next);
+  program.Branch(header);
+
+  program.SetCurrentBlock(exit);
+  program.Return();
+}
+
+TEST(LICMTest, HoistsInvariantArithmetic) {
+  ProgramBuilder program;
+
+  auto type = program.I32Type();
+  auto func = program.CreateNamedFunction(
+      program.VoidType(), {program.PointerType(type), type, type}, "compute");
+  auto args = program.GetFunctionArguments(func);
+  BuildLoop(
+      program, [&]() { return args[1]; },
+      [&](Value i) {
+        auto x = program.MulI32(args[1], args[2]);
+        program.StoreI32(program.DynamicGEP(type, args[0], i, {}),
+                         program.SubI32(x, i));
+      });
+
+  auto built = program.Build();
+  const auto& function = built->Functions()[0];
+  auto instrs = function.Instrs();
+  auto basic_blocks = function.BasicBlocks();
+  auto store_block = FindBlock(instrs, basic_blocks, Opcode::I32_STORE);
+  LoopInvariantCodeMotion(*built, instrs, basic_blocks);
+
+  EXPECT_EQ(FindBlock(instrs, basic_blocks, Opcode::I32_MUL), 0);
+  EXPECT_EQ(FindBlock(instrs, basic_blocks, Opcode::I32_SUB), store_block);
+  EXPECT_EQ(FindBlock(instrs, basic_blocks, Opcode::GEP_DYNAMIC), store_block);
+}
+
+TEST(LICMTest, HoistsHeaderLoad) {
+  ProgramBuilder program;
+
+  auto type = program.I32Type();
+  auto st = program.StructType({type, type});
+  auto func = program.CreateNamedFunction(
+      program.VoidType(), {program.PointerType(st)}, "compute");
+  auto args = program.GetFunctionArguments(func);
+  BuildLoop(
+      program,
+      [&]() { return program.LoadI32(program.StaticGEP(st, args[0], {0, 0})); },
+      [&](Value i) {});
+
+  auto built = program.Build();
+  const auto& function = built->Functions()[0];
+  auto instrs = function.Instrs();
+  auto basic_blocks = function.BasicBlocks();
+  LoopInvariantCodeMotion(*built, instrs, basic_blocks);
+
+  EXPECT_EQ(FindBlock(instrs, basic_blocks, Opcode::I32_LOAD), 0);
+}
+
+TEST(LICMTest, KeepsLoadWithAliasingStore) {
+  ProgramBuilder program;
+
+  auto type = program.I32Type();
+  auto st = program.StructType({type, type});
+  auto func = program.CreateNamedFunction(
+      program.VoidType(), {program.PointerType(st)}, "compute");
+  auto args = program.GetFunctionArguments(func);
+  BuildLoop(
+      program, [&]() { return program.ConstI32(10); },
+      [&](Value i) {
+        auto ptr = program.StaticGEP(st, args[0], {0, 1});
+        program.StoreI32(ptr, program.AddI32(program.LoadI32(ptr), i));
+      });
+
+  auto built = program.Build();
+  const auto& function = built->Functions()[0];
+  auto instrs = function.Instrs();
+  auto basic_blocks = function.BasicBlocks();
+  auto load_block = FindBlock(instrs, basic_blocks, Opcode::I32_LOAD);
+  LoopInvariantCodeMotion(*built, instrs, basic_blocks);
+
+  EXPECT_EQ(FindBlock(instrs, basic_blocks, Opcode::I32_LOAD), load_block);
+  EXPECT_EQ(FindBlock(instrs, basic_blocks, Opcode::GEP_STATIC), 0);
+}
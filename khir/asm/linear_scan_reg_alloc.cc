@@ -1,6 +1,9 @@
 #include "khir/asm/linear_scan_reg_alloc.h"
 
+#include <algorithm>
 #include <iostream>
+#include <set>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -10,6 +13,7 @@
 #include "khir/asm/register_assignment.h"
 #include "khir/instruction.h"
 #include "khir/opcode.h"
+#include "util/query_stats.h"
 
 namespace kush::khir {
 
@@ -18,6 +22,148 @@ bool IsVector(const TypeManager& manager, khir::Type t) {
          manager.IsI1Vec8Type(t);
 }
 
+// Positions of precolored intervals and call arguments used to steer the
+// choice of register away from ones that are about to be clobbered.
+class RegisterHints {
+ public:
+  RegisterHints(const Function& func,
+                const std::vector<LiveInterval>& live_intervals,
+                const TypeManager& manager) {
+    for (const auto& interval : live_intervals) {
+      if (interval.IsPrecolored()) {
+        precolored_starts_[interval.PrecoloredRegister()].push_back(
+            interval.Start());
+      }
+    }
+    for (auto& [reg, starts] : precolored_starts_) {
+      std::sort(starts.begin(), starts.end());
+    }
+
+    // Mirror the position numbering and the argument register assignment of
+    // ComputeLiveIntervals.
+    const std::vector<int> normal_arg_reg{
+        GPRegister::RDI.Id(), GPRegister::RSI.Id(), GPRegister::RDX.Id(),
+        GPRegister::RCX.Id(), GPRegister::R8.Id(),  GPRegister::R9.Id(),
+    };
+    const std::vector<int> fp_arg_reg{
+        VRegister::M0.Id(), VRegister::M1.Id(), VRegister::M2.Id(),
+        VRegister::M3.Id(), VRegister::M4.Id(), VRegister::M5.Id(),
+        VRegister::M6.Id(), VRegister::M7.Id(),
+    };
+
+    const auto& instrs = func.Instrs();
+    int pos = 0;
+    int normal_arg_ctr = 0;
+    int fp_arg_ctr = 0;
+    for (const auto& bb : func.BasicBlocks()) {
+      for (const auto& [seg_start, seg_end] : bb.Segments()) {
+        for (int i = seg_start; i <= seg_end; i++, pos++) {
+          auto opcode =
+              OpcodeFrom(GenericInstructionReader(instrs[i]).Opcode());
+          if (opcode == Opcode::CALL || opcode == Opcode::CALL_INDIRECT) {
+            normal_arg_ctr = 0;
+            fp_arg_ctr = 0;
+            continue;
+          }
+
+          if (opcode != Opcode::CALL_ARG) {
+            continue;
+          }
+
+          Type3InstructionReader reader(instrs[i]);
+          int reg = -1;
+          if (manager.IsF64Type(static_cast<Type>(reader.TypeID()))) {
+            if (fp_arg_ctr < fp_arg_reg.size()) {
+              reg = fp_arg_reg[fp_arg_ctr];
+            }
+            fp_arg_ctr++;
+          } else {
+            if (normal_arg_ctr < normal_arg_reg.size()) {
+              reg = normal_arg_reg[normal_arg_ctr];
+            }
+            normal_arg_ctr++;
+          }
+
+          Value v(reader.Arg());
+          if (reg >= 0 && !v.IsConstantGlobal()) {
+            call_args_[pos] = {static_cast<int>(v.GetIdx()), reg};
+          }
+        }
+      }
+    }
+  }
+
+  // Returns the start of the first precolored interval of reg at or after pos.
+  int NextPrecolored(int reg, int pos) const {
+    auto it = precolored_starts_.find(reg);
+    if (it == precolored_starts_.end()) {
+      return INT32_MAX;
+    }
+    auto start = std::lower_bound(it->second.begin(), it->second.end(), pos);
+    return start == it->second.end() ? INT32_MAX : *start;
+  }
+
+  // Returns the argument register that the interval is passed in if its last
+  // use is a call argument, -1 otherwise.
+  int ArgRegister(const LiveInterval& interval) const {
+    auto it = call_args_.find(interval.End());
+    if (it == call_args_.end() ||
+        it->second.first != interval.Value().GetIdx()) {
+      return -1;
+    }
+    return it->second.second;
+  }
+
+  // Returns true if the interval only ends at pos because it is moved into the
+  // argument register that starts there.
+  bool IsCallArgOperand(const LiveInterval& interval, int pos) const {
+    return interval.End() == pos && ArgRegister(interval) >= 0;
+  }
+
+ private:
+  std::unordered_map<int, std::vector<int>> precolored_starts_;
+  std::unordered_map<int, std::pair<int, int>> call_args_;
+};
+
+// Picks a free register for the interval. Prefers the argument register the
+// value is passed in, then registers that stay free until the end of the
+// interval (the tightest fit first) so that values live across calls land in
+// callee saved registers instead of being spilled at the call.
+int ChooseRegister(const LiveInterval& interval,
+                   const std::unordered_set<int>& free,
+                   const RegisterHints& hints) {
+  int hint = hints.ArgRegister(interval);
+  if (hint >= 0 && free.find(hint) != free.end() &&
+      hints.NextPrecolored(hint, interval.Start()) >= interval.End()) {
+    return hint;
+  }
+
+  int best = -1;
+  int best_next = -1;
+  for (int reg : free) {
+    int next = hints.NextPrecolored(reg, interval.Start());
+    bool fits = next > interval.End();
+    bool best_fits = best_next > interval.End();
+
+    bool better;
+    if (best < 0) {
+      better = true;
+    } else if (fits != best_fits) {
+      better = fits;
+    } else if (next != best_next) {
+      better = fits ? next < best_next : next > best_next;
+    } else {
+      better = reg < best;
+    }
+
+    if (better) {
+      best = reg;
+      best_next = next;
+    }
+  }
+  return best;
+}
+
 template <typename ActiveSet>
 std::unordered_set<int> Union(ActiveSet& active, std::unordered_set<int>& free,
                               std::vector<RegisterAssignment>& assignments) {
@@ -107,7 +253,8 @@ int MaybeSpillMinCost(ActiveSet& active, std::unordered_set<int>& free,
 template <typename ActiveSet>
 void AddPrecoloredInterval(LiveInterval& to_add,
                            std::vector<RegisterAssignment>& assignments,
-                           std::unordered_set<int>& free, ActiveSet& active) {
+                           std::unordered_set<int>& free, ActiveSet& active,
+                           const RegisterHints& hints) {
   // Constraint on the register
   if (to_add.IsPrecolored()) {
     auto reg = to_add.PrecoloredRegister();
@@ -129,6 +276,13 @@ void AddPrecoloredInterval(LiveInterval& to_add,
         throw std::runtime_error("Two precolored intervals conflicting.");
       }
 
+      // The value already sits in the argument register it is passed in.
+      if (hints.IsCallArgOperand(j, to_add.Start())) {
+        active.erase(it);
+        active.insert(to_add);
+        return;
+      }
+
       auto j_idx = j.Value().GetIdx();
 
       assignments[j_idx].Spill();
@@ -144,7 +298,7 @@ void AddPrecoloredInterval(LiveInterval& to_add,
   // No constraint on the register, pick any register
   if (!free.empty()) {
     // Free register available
-    int reg = *free.begin();
+    int reg = ChooseRegister(to_add, free, hints);
 
     to_add.ChangeToPrecolored(reg);
     active.insert(to_add);
@@ -186,15 +340,36 @@ void ExpireOldIntervals(LiveInterval& current,
   }
 }
 
+// The result of a call is only written once the call returns so it does not
+// conflict with the registers clobbered by the call itself.
+template <typename ActiveSet>
+void ReleaseCallClobbers(LiveInterval& current, std::unordered_set<int>& free,
+                         ActiveSet& active) {
+  for (auto it = active.begin(); it != active.end();) {
+    const auto& j = *it;
+    if (j.End() > current.Start()) {
+      break;
+    }
+
+    if (j.IsPrecolored() && j.Start() == current.Start()) {
+      free.insert(j.PrecoloredRegister());
+      it = active.erase(it);
+    } else {
+      it++;
+    }
+  }
+}
+
 template <typename ActiveSet>
 void SpillAtInterval(LiveInterval& curr,
                      std::vector<RegisterAssignment>& assignments,
-                     std::unordered_set<int>& free, ActiveSet& active) {
+                     std::unordered_set<int>& free, ActiveSet& active,
+                     const RegisterHints& hints) {
   auto curr_idx = curr.Value().GetIdx();
 
   if (!free.empty()) {
     // Free register available
-    int reg = *free.begin();
+    int reg = ChooseRegister(curr, free, hints);
     free.erase(reg);
     active.insert(curr);
     assignments[curr_idx].SetRegister(reg);
@@ -217,12 +392,23 @@ std::vector<RegisterAssignment> LinearScanRegisterAlloc(
     const Function& func, const std::vector<bool>& materialize_gep,
     const TypeManager& manager) {
   auto instrs = func.Instrs();
-  auto live_intervals = ComputeLiveIntervals(func, materialize_gep, manager);
+  std::vector<LiveInterval> live_intervals;
+  {
+    util::PhaseTimer timer("live_intervals");
+    live_intervals = ComputeLiveIntervals(func, materialize_gep, manager);
+  }
+
+  util::PhaseTimer timer("register_allocation");
+  RegisterHints hints(func, live_intervals, manager);
 
-  // Handle intervals by increasing start point order
+  // Handle intervals by increasing start point order, precolored intervals
+  // first so that clobbers are seen before the values defined at a call.
   std::sort(live_intervals.begin(), live_intervals.end(),
             [](const LiveInterval& a, const LiveInterval& b) -> bool {
-              return a.Start() < b.Start();
+              if (a.Start() != b.Start()) {
+                return a.Start() < b.Start();
+              }
+              return a.IsPrecolored() && !b.IsPrecolored();
             });
 
   std::vector<RegisterAssignment> assignments(instrs.size());
@@ -289,9 +475,11 @@ std::vector<RegisterAssignment> LinearScanRegisterAlloc(
 
     if (i.IsPrecolored()) {
       if (VRegister::IsVRegister(i.PrecoloredRegister())) {
-        AddPrecoloredInterval(i, assignments, free_vector, active_vector);
+        AddPrecoloredInterval(i, assignments, free_vector, active_vector,
+                              hints);
       } else if (GPRegister::IsGPRegister(i.PrecoloredRegister())) {
-        AddPrecoloredInterval(i, assignments, free_normal, active_normal);
+        AddPrecoloredInterval(i, assignments, free_normal, active_normal,
+                              hints);
       } else {
         throw std::runtime_error("Invalid precolored register");
       }
@@ -354,7 +542,8 @@ std::vector<RegisterAssignment> LinearScanRegisterAlloc(
       }
 
       case Opcode::I32_VEC8_MASK_STORE: {
-        AddPrecoloredInterval(i, assignments, free_vector, active_vector);
+        AddPrecoloredInterval(i, assignments, free_vector, active_vector,
+                              hints);
         assert(i.IsPrecolored());
         assignments[i_instr].SetRegister(i.PrecoloredRegister());
         break;
@@ -365,17 +554,30 @@ std::vector<RegisterAssignment> LinearScanRegisterAlloc(
       case Opcode::I32_STORE:
       case Opcode::I64_STORE:
       case Opcode::PTR_STORE: {
-        AddPrecoloredInterval(i, assignments, free_normal, active_normal);
+        AddPrecoloredInterval(i, assignments, free_normal, active_normal,
+                              hints);
         assert(i.IsPrecolored());
         assignments[i_instr].SetRegister(i.PrecoloredRegister());
         break;
       }
 
+      case Opcode::CALL:
+      case Opcode::CALL_INDIRECT: {
+        ReleaseCallClobbers(i, free_normal, active_normal);
+        ReleaseCallClobbers(i, free_vector, active_vector);
+        if (IsVector(manager, i.Type())) {
+          SpillAtInterval(i, assignments, free_vector, active_vector, hints);
+        } else {
+          SpillAtInterval(i, assignments, free_normal, active_normal, hints);
+        }
+        break;
+      }
+
       default: {
         if (IsVector(manager, i.Type())) {
-          SpillAtInterval(i, assignments, free_vector, active_vector);
+          SpillAtInterval(i, assignments, free_vector, active_vector, hints);
         } else {
-          SpillAtInterval(i, assignments, free_normal, active_normal);
+          SpillAtInterval(i, assignments, free_normal, active_normal, hints);
         }
         break;
       }
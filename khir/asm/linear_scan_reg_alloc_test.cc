@@ -2,35 +2,32 @@
 
 #include "gtest/gtest.h"
 
-#include "catalog/catalog.h"
-#include "catalog/sql_type.h"
-#include "compile/forward_declare.h"
-#include "compile/query_translator.h"
-#include "compile/translators/translator_factory.h"
-#include "end_to_end_test/schema.h"
-#include "khir/asm/live_intervals.h"
+#include "khir/asm/materialize_gep.h"
+#include "khir/asm/register.h"
 #include "khir/program_builder.h"
-#include "khir/program_printer.h"
-#include "plan/expression/aggregate_expression.h"
-#include "plan/expression/arithmetic_expression.h"
-#include "plan/expression/column_ref_expression.h"
-#include "plan/expression/literal_expression.h"
-#include "plan/expression/virtual_column_ref_expression.h"
-#include "plan/operator/group_by_aggregate_operator.h"
-#include "plan/operator/hash_join_operator.h"
-#include "plan/operator/operator.h"
-#include "plan/operator/operator_schema.h"
-#include "plan/operator/order_by_operator.h"
-#include "plan/operator/output_operator.h"
-#include "plan/operator/scan_operator.h"
-#include "plan/operator/select_operator.h"
-#include "util/builder.h"
 
 using namespace kush;
 using namespace kush::khir;
-using namespace kush::compile;
-using namespace kush::plan;
-using namespace kush::util;
+
+std::vector<RegisterAssignment> Allocate(ProgramBuilder& program) {
+  auto built = program.Build();
+  const auto& func = built->Functions().back();
+  return LinearScanRegisterAlloc(func, ComputeGEPMaterialize(func),
+                                 built->TypeManager());
+}
+
+bool IsCalleeSaved(const RegisterAssignment& assignment) {
+  if (!assignment.IsRegister()) {
+    return false;
+  }
+  for (auto reg : {GPRegister::RBX, GPRegister::R12, GPRegister::R13,
+                   GPRegister::R14, GPRegister::R15}) {
+    if (assignment.Register() == reg.Id()) {
+      return true;
+    }
+  }
+  return false;
+}
 
 TEST(LiveIntervalsTest, StoreInstructionForcedIntoRegister) {
   for (auto type_func : {&ProgramBuilder::I8Type, &ProgramBuilder::I16Type,
@@ -44,8 +41,7 @@ TEST(LiveIntervalsTest, StoreInstructionForcedIntoRegister) {
     program.StoreI32(args[0], args[1]);
     program.Return();
 
-    auto result = LinearScanRegisterAlloc(program.GetFunction(func),
-                                          program.GetTypeManager());
+    auto result = Allocate(program);
     EXPECT_EQ(result.size(), 4);
     EXPECT_TRUE(result[2].IsRegister());
   }
@@ -67,8 +63,7 @@ TEST(LiveIntervalsTest, I8FlagRegIntoBranch) {
     program.SetCurrentBlock(bb2);
     program.Return(program.ConstI32(6));
 
-    auto result = LinearScanRegisterAlloc(program.GetFunction(func),
-                                          program.GetTypeManager());
+    auto result = Allocate(program);
     EXPECT_TRUE(result[cond.GetIdx()].IsRegister());
     EXPECT_EQ(result[cond.GetIdx()].Register(), 100);
   }
@@ -90,8 +85,7 @@ TEST(LiveIntervalsTest, I16FlagRegIntoBranch) {
     program.SetCurrentBlock(bb2);
     program.Return(program.ConstI32(6));
 
-    auto result = LinearScanRegisterAlloc(program.GetFunction(func),
-                                          program.GetTypeManager());
+    auto result = Allocate(program);
     EXPECT_TRUE(result[cond.GetIdx()].IsRegister());
     EXPECT_EQ(result[cond.GetIdx()].Register(), 100);
   }
@@ -113,8 +107,7 @@ TEST(LiveIntervalsTest, I32FlagRegIntoBranch) {
     program.SetCurrentBlock(bb2);
     program.Return(program.ConstI32(6));
 
-    auto result = LinearScanRegisterAlloc(program.GetFunction(func),
-                                          program.GetTypeManager());
+    auto result = Allocate(program);
     EXPECT_TRUE(result[cond.GetIdx()].IsRegister());
     EXPECT_EQ(result[cond.GetIdx()].Register(), 100);
   }
@@ -136,8 +129,7 @@ TEST(LiveIntervalsTest, I64FlagRegIntoBranch) {
     program.SetCurrentBlock(bb2);
     program.Return(program.ConstI32(6));
 
-    auto result = LinearScanRegisterAlloc(program.GetFunction(func),
-                                          program.GetTypeManager());
+    auto result = Allocate(program);
     EXPECT_TRUE(result[cond.GetIdx()].IsRegister());
     EXPECT_EQ(result[cond.GetIdx()].Register(), 100);
   }
@@ -159,13 +151,91 @@ TEST(LiveIntervalsTest, F64FlagRegIntoBranch) {
     program.SetCurrentBlock(bb2);
     program.Return(program.ConstI32(6));
 
-    auto result = LinearScanRegisterAlloc(program.GetFunction(func),
-                                          program.GetTypeManager());
+    auto result = Allocate(program);
     EXPECT_TRUE(result[cond.GetIdx()].IsRegister());
     EXPECT_EQ(result[cond.GetIdx()].Register(), 101);
   }
 }
 
+TEST(LinearScanRegAllocTest, CallArgumentInArgumentRegister) {
+  ProgramBuilder program;
+
+  auto type = program.I64Type();
+  auto ex = program.DeclareExternalFunction("test", program.VoidType(), {type},
+                                            nullptr);
+  auto func = program.CreateNamedFunction(program.VoidType(), {type, type},
+                                          "compute");
+  auto args = program.GetFunctionArguments(func);
+  auto x = program.AddI64(args[0], args[1]);
+  program.Call(ex, {x});
+  program.Return();
+
+  auto result = Allocate(program);
+  EXPECT_TRUE(result[x.GetIdx()].IsRegister());
+  EXPECT_EQ(result[x.GetIdx()].Register(), GPRegister::RDI.Id());
+}
+
+TEST(LinearScanRegAllocTest, LiveAcrossCallInCalleeSavedRegister) {
+  ProgramBuilder program;
+
+  auto type = program.I64Type();
+  auto ex = program.DeclareExternalFunction("test", program.VoidType(), {},
+                                            nullptr);
+  auto func = program.CreateNamedFunction(type, {type, type}, "compute");
+  auto args = program.GetFunctionArguments(func);
+  auto x = program.MulI64(args[0], args[1]);
+  auto y = program.SubI64(args[0], args[1]);
+  program.Call(ex);
+  program.Return(program.AddI64(x, y));
+
+  auto result = Allocate(program);
+  EXPECT_TRUE(IsCalleeSaved(result[x.GetIdx()]));
+  EXPECT_TRUE(IsCalleeSaved(result[y.GetIdx()]));
+}
+
+TEST(LinearScanRegAllocTest, NoSpillsAcrossCallInLoop) {
+  ProgramBuilder program;
+
+  auto type = program.I64Type();
+  auto ex = program.DeclareExternalFunction("test", program.VoidType(), {},
+                                            nullptr);
+  auto func = program.CreateNamedFunction(
+      program.VoidType(), {program.PointerType(type), type, type}, "compute");
+  auto args = program.GetFunctionArguments(func);
+  auto x = program.MulI64(args[1], args[2]);
+  auto y = program.SubI64(args[1], args[2]);
+
+  // for (i = 0; i < args[1]; i++) { test(); args[0][i] = x + y; }
+  auto header = program.GenerateBlock();
+  auto body = program.GenerateBlock();
+  auto exit = program.GenerateBlock();
+  auto init = program.PhiMember(program.ConstI64(0));
+  program.Branch(header);
+
+  program.SetCurrentBlock(header);
+  auto i = program.Phi(type);
+  program.UpdatePhiMember(i, init);
+  program.Branch(program.CmpI64(CompType::LT, i, args[1]), body, exit);
+
+  program.SetCurrentBlock(body);
+  program.Call(ex);
+  program.StoreI64(program.DynamicGEP(type, args[0], i, {}),
+                   program.AddI64(x, y));
+  auto next = program.PhiMember(program.AddI64(i, program.ConstI64(1)));
+  program.UpdatePhiMember(i, next);
+  program.Branch(header);
+
+  program.SetCurrentBlock(exit);
+  program.Return();
+
+  // Five values are live across the call which all fit in callee saved
+  // registers.
+  auto result = Allocate(program);
+  for (auto v : {args[0], args[1], x, y, i}) {
+    EXPECT_TRUE(IsCalleeSaved(result[v.GetIdx()]));
+  }
+}
+
 // TODO: reenable test when the pipeline refactor is complete
 /*
 TEST(LiveIntervalsTest, NoOverlappingLiveIntervals) {
@@ -276,6 +276,7 @@ Type TypeOf(uint64_t instr, const std::vector<uint64_t>& instrs,
     case Opcode::I64_RSHIFT:
     case Opcode::I64_AND:
     case Opcode::I64_XOR:
+    case Opcode::I64_CRC32:
     case Opcode::I64_OR:
     case Opcode::I64_ADD:
     case Opcode::I64_MUL:
@@ -284,6 +285,7 @@ Type TypeOf(uint64_t instr, const std::vector<uint64_t>& instrs,
     case Opcode::I8_ZEXT_I64:
     case Opcode::I16_ZEXT_I64:
     case Opcode::I32_ZEXT_I64:
+    case Opcode::I32_SEXT_I64:
     case Opcode::F64_CONV_I64:
     case Opcode::I64_LOAD:
       return manager.I64Type();
@@ -394,6 +396,7 @@ std::optional<Value> GetWrittenValue(int instr_idx,
     case Opcode::I64_AND:
     case Opcode::I64_OR:
     case Opcode::I64_XOR:
+    case Opcode::I64_CRC32:
     case Opcode::I64_CMP_EQ:
     case Opcode::I64_CMP_NE:
     case Opcode::I64_CMP_LT:
@@ -418,6 +421,7 @@ std::optional<Value> GetWrittenValue(int instr_idx,
     case Opcode::I16_ZEXT_I64:
     case Opcode::I16_CONV_F64:
     case Opcode::I32_ZEXT_I64:
+    case Opcode::I32_SEXT_I64:
     case Opcode::I32_CONV_F64:
     case Opcode::I32_CONV_I32_VEC8:
     case Opcode::I64_CONV_F64:
@@ -539,6 +543,7 @@ std::vector<Value> GetReadValues(int instr_idx, int seg_start, int seg_end,
     case Opcode::I64_AND:
     case Opcode::I64_OR:
     case Opcode::I64_XOR:
+    case Opcode::I64_CRC32:
     case Opcode::I64_CMP_EQ:
     case Opcode::I64_CMP_NE:
     case Opcode::I64_CMP_LT:
@@ -602,6 +607,7 @@ std::vector<Value> GetReadValues(int instr_idx, int seg_start, int seg_end,
     case Opcode::I16_ZEXT_I64:
     case Opcode::I16_CONV_F64:
     case Opcode::I32_ZEXT_I64:
+    case Opcode::I32_SEXT_I64:
     case Opcode::I32_CONV_F64:
     case Opcode::I32_CONV_I32_VEC8:
     case Opcode::I64_CONV_F64:
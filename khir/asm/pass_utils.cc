@@ -0,0 +1,422 @@
+#include "khir/asm/pass_utils.h"
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "khir/instruction.h"
+#include "khir/opcode.h"
+#include "khir/program.h"
+
+namespace kush::khir {
+
+uint32_t RewriteValue(uint32_t v, const std::function<uint32_t(uint32_t)>& f) {
+  if (Value(v).IsConstantGlobal()) {
+    return v;
+  }
+  return f(v);
+}
+
+void RewriteOperands(uint64_t& instr,
+                     const std::function<uint32_t(uint32_t)>& f) {
+  auto opcode = OpcodeFrom(GenericInstructionReader(instr).Opcode());
+
+  switch (opcode) {
+    case Opcode::I1_AND:
+    case Opcode::I1_OR:
+    case Opcode::I1_CMP_EQ:
+    case Opcode::I1_CMP_NE:
+    case Opcode::I8_ADD:
+    case Opcode::I8_MUL:
+    case Opcode::I8_SUB:
+    case Opcode::I8_CMP_EQ:
+    case Opcode::I8_CMP_NE:
+    case Opcode::I8_CMP_LT:
+    case Opcode::I8_CMP_LE:
+    case Opcode::I8_CMP_GT:
+    case Opcode::I8_CMP_GE:
+    case Opcode::I16_ADD:
+    case Opcode::I16_MUL:
+    case Opcode::I16_SUB:
+    case Opcode::I16_CMP_EQ:
+    case Opcode::I16_CMP_NE:
+    case Opcode::I16_CMP_LT:
+    case Opcode::I16_CMP_LE:
+    case Opcode::I16_CMP_GT:
+    case Opcode::I16_CMP_GE:
+    case Opcode::I32_ADD:
+    case Opcode::I32_MUL:
+    case Opcode::I32_SUB:
+    case Opcode::I32_CMP_EQ:
+    case Opcode::I32_CMP_NE:
+    case Opcode::I32_CMP_LT:
+    case Opcode::I32_CMP_LE:
+    case Opcode::I32_CMP_GT:
+    case Opcode::I32_CMP_GE:
+    case Opcode::I32_VEC8_CMP_EQ:
+    case Opcode::I32_VEC8_CMP_NE:
+    case Opcode::I32_VEC8_CMP_GT:
+    case Opcode::I32_VEC8_CMP_GE:
+    case Opcode::I32_VEC8_CMP_LT:
+    case Opcode::I32_VEC8_CMP_LE:
+    case Opcode::I32_VEC8_ADD:
+    case Opcode::I1_VEC8_AND:
+    case Opcode::I32_VEC8_PERMUTE:
+    case Opcode::I1_VEC8_OR:
+    case Opcode::I64_ADD:
+    case Opcode::I64_MUL:
+    case Opcode::I64_SUB:
+    case Opcode::I64_LSHIFT:
+    case Opcode::I64_RSHIFT:
+    case Opcode::I64_AND:
+    case Opcode::I64_OR:
+    case Opcode::I64_XOR:
+    case Opcode::I64_CRC32:
+    case Opcode::I64_CMP_EQ:
+    case Opcode::I64_CMP_NE:
+    case Opcode::I64_CMP_LT:
+    case Opcode::I64_CMP_LE:
+    case Opcode::I64_CMP_GT:
+    case Opcode::I64_CMP_GE:
+    case Opcode::F64_ADD:
+    case Opcode::F64_MUL:
+    case Opcode::F64_SUB:
+    case Opcode::F64_DIV:
+    case Opcode::F64_CMP_EQ:
+    case Opcode::F64_CMP_NE:
+    case Opcode::F64_CMP_LT:
+    case Opcode::F64_CMP_LE:
+    case Opcode::F64_CMP_GT:
+    case Opcode::F64_CMP_GE:
+    case Opcode::I8_STORE:
+    case Opcode::I16_STORE:
+    case Opcode::I32_STORE:
+    case Opcode::I64_STORE:
+    case Opcode::F64_STORE:
+    case Opcode::PTR_STORE:
+    case Opcode::I32_VEC8_MASK_STORE:
+    case Opcode::GEP_STATIC_OFFSET:
+    case Opcode::GEP_DYNAMIC_OFFSET:
+    case Opcode::I32_CMP_EQ_ANY_CONST_VEC4:
+    case Opcode::I32_CMP_EQ_ANY_CONST_VEC8: {
+      Type2InstructionReader reader(instr);
+      instr = Type2InstructionBuilder(instr)
+                  .SetArg0(RewriteValue(reader.Arg0(), f))
+                  .SetArg1(RewriteValue(reader.Arg1(), f))
+                  .Build();
+      return;
+    }
+
+    case Opcode::I1_VEC8_NOT:
+    case Opcode::I1_VEC8_MASK_EXTRACT:
+    case Opcode::I64_POPCOUNT:
+    case Opcode::MASK_TO_PERMUTE:
+    case Opcode::I1_LNOT:
+    case Opcode::I1_ZEXT_I8:
+    case Opcode::I1_ZEXT_I64:
+    case Opcode::I8_ZEXT_I64:
+    case Opcode::I8_CONV_F64:
+    case Opcode::I16_ZEXT_I64:
+    case Opcode::I16_CONV_F64:
+    case Opcode::I32_ZEXT_I64:
+    case Opcode::I32_SEXT_I64:
+    case Opcode::I32_CONV_I32_VEC8:
+    case Opcode::I32_CONV_F64:
+    case Opcode::I64_CONV_F64:
+    case Opcode::I64_TRUNC_I16:
+    case Opcode::I64_TRUNC_I32:
+    case Opcode::F64_CONV_I64:
+    case Opcode::PTR_CMP_NULLPTR:
+    case Opcode::I1_LOAD:
+    case Opcode::I8_LOAD:
+    case Opcode::I16_LOAD:
+    case Opcode::I32_LOAD:
+    case Opcode::I32_VEC8_LOAD:
+    case Opcode::I64_LOAD:
+    case Opcode::F64_LOAD:
+    case Opcode::I32_VEC8_MASK_STORE_INFO: {
+      Type2InstructionReader reader(instr);
+      instr = Type2InstructionBuilder(instr)
+                  .SetArg0(RewriteValue(reader.Arg0(), f))
+                  .Build();
+      return;
+    }
+
+    case Opcode::PHI_MEMBER: {
+      Type2InstructionReader reader(instr);
+      instr = Type2InstructionBuilder(instr)
+                  .SetArg1(RewriteValue(reader.Arg1(), f))
+                  .Build();
+      return;
+    }
+
+    case Opcode::GEP_DYNAMIC:
+    case Opcode::PTR_CAST:
+    case Opcode::PTR_LOAD:
+    case Opcode::RETURN_VALUE:
+    case Opcode::CALL_ARG:
+    case Opcode::CALL_INDIRECT: {
+      Type3InstructionReader reader(instr);
+      instr = Type3InstructionBuilder(instr)
+                  .SetArg(RewriteValue(reader.Arg(), f))
+                  .Build();
+      return;
+    }
+
+    case Opcode::CONDBR: {
+      Type5InstructionReader reader(instr);
+      instr = Type5InstructionBuilder(instr)
+                  .SetArg(RewriteValue(reader.Arg(), f))
+                  .Build();
+      return;
+    }
+
+    case Opcode::CALL:
+    case Opcode::RETURN:
+    case Opcode::BR:
+    case Opcode::FUNC_ARG:
+    case Opcode::GEP_STATIC:
+    case Opcode::PHI:
+      return;
+  }
+}
+
+void ForEachOperand(uint64_t instr, const std::function<void(Value)>& f) {
+  RewriteOperands(instr, [&](uint32_t v) {
+    f(Value(v));
+    return v;
+  });
+}
+
+bool IsPureInstr(Opcode opcode) {
+  switch (opcode) {
+    case Opcode::I1_AND:
+    case Opcode::I1_OR:
+    case Opcode::I1_CMP_EQ:
+    case Opcode::I1_CMP_NE:
+    case Opcode::I1_LNOT:
+    case Opcode::I1_ZEXT_I8:
+    case Opcode::I1_ZEXT_I64:
+    case Opcode::I8_ADD:
+    case Opcode::I8_MUL:
+    case Opcode::I8_SUB:
+    case Opcode::I8_CMP_EQ:
+    case Opcode::I8_CMP_NE:
+    case Opcode::I8_CMP_LT:
+    case Opcode::I8_CMP_LE:
+    case Opcode::I8_CMP_GT:
+    case Opcode::I8_CMP_GE:
+    case Opcode::I8_ZEXT_I64:
+    case Opcode::I8_CONV_F64:
+    case Opcode::I16_ADD:
+    case Opcode::I16_MUL:
+    case Opcode::I16_SUB:
+    case Opcode::I16_CMP_EQ:
+    case Opcode::I16_CMP_NE:
+    case Opcode::I16_CMP_LT:
+    case Opcode::I16_CMP_LE:
+    case Opcode::I16_CMP_GT:
+    case Opcode::I16_CMP_GE:
+    case Opcode::I16_ZEXT_I64:
+    case Opcode::I16_CONV_F64:
+    case Opcode::I32_ADD:
+    case Opcode::I32_MUL:
+    case Opcode::I32_SUB:
+    case Opcode::I32_CMP_EQ_ANY_CONST_VEC4:
+    case Opcode::I32_CMP_EQ_ANY_CONST_VEC8:
+    case Opcode::I32_CMP_EQ:
+    case Opcode::I32_CMP_NE:
+    case Opcode::I32_CMP_LT:
+    case Opcode::I32_CMP_LE:
+    case Opcode::I32_CMP_GT:
+    case Opcode::I32_CMP_GE:
+    case Opcode::I32_VEC8_CMP_EQ:
+    case Opcode::I32_VEC8_CMP_NE:
+    case Opcode::I32_VEC8_CMP_LT:
+    case Opcode::I32_VEC8_CMP_LE:
+    case Opcode::I32_VEC8_CMP_GT:
+    case Opcode::I32_VEC8_CMP_GE:
+    case Opcode::I1_VEC8_NOT:
+    case Opcode::I1_VEC8_AND:
+    case Opcode::I1_VEC8_OR:
+    case Opcode::I1_VEC8_MASK_EXTRACT:
+    case Opcode::I64_POPCOUNT:
+    case Opcode::MASK_TO_PERMUTE:
+    case Opcode::I32_VEC8_PERMUTE:
+    case Opcode::I32_ZEXT_I64:
+    case Opcode::I32_SEXT_I64:
+    case Opcode::I32_CONV_F64:
+    case Opcode::I32_CONV_I32_VEC8:
+    case Opcode::I32_VEC8_ADD:
+    case Opcode::I64_ADD:
+    case Opcode::I64_MUL:
+    case Opcode::I64_SUB:
+    case Opcode::I64_LSHIFT:
+    case Opcode::I64_RSHIFT:
+    case Opcode::I64_AND:
+    case Opcode::I64_XOR:
+    case Opcode::I64_OR:
+    case Opcode::I64_CRC32:
+    case Opcode::I64_TRUNC_I16:
+    case Opcode::I64_TRUNC_I32:
+    case Opcode::I64_CMP_EQ:
+    case Opcode::I64_CMP_NE:
+    case Opcode::I64_CMP_LT:
+    case Opcode::I64_CMP_LE:
+    case Opcode::I64_CMP_GT:
+    case Opcode::I64_CMP_GE:
+    case Opcode::I64_CONV_F64:
+    case Opcode::F64_ADD:
+    case Opcode::F64_MUL:
+    case Opcode::F64_SUB:
+    case Opcode::F64_DIV:
+    case Opcode::F64_CMP_EQ:
+    case Opcode::F64_CMP_NE:
+    case Opcode::F64_CMP_LT:
+    case Opcode::F64_CMP_LE:
+    case Opcode::F64_CMP_GT:
+    case Opcode::F64_CMP_GE:
+    case Opcode::F64_CONV_I64:
+    case Opcode::PTR_CAST:
+    case Opcode::PTR_CMP_NULLPTR:
+    case Opcode::GEP_STATIC:
+    case Opcode::GEP_DYNAMIC:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+bool IsLoad(Opcode opcode) {
+  switch (opcode) {
+    case Opcode::I1_LOAD:
+    case Opcode::I8_LOAD:
+    case Opcode::I16_LOAD:
+    case Opcode::I32_LOAD:
+    case Opcode::I32_VEC8_LOAD:
+    case Opcode::I64_LOAD:
+    case Opcode::PTR_LOAD:
+    case Opcode::F64_LOAD:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+bool IsStore(Opcode opcode) {
+  switch (opcode) {
+    case Opcode::I8_STORE:
+    case Opcode::I16_STORE:
+    case Opcode::I32_STORE:
+    case Opcode::I32_VEC8_MASK_STORE:
+    case Opcode::I64_STORE:
+    case Opcode::PTR_STORE:
+    case Opcode::F64_STORE:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+int32_t AccessWidth(Opcode opcode) {
+  switch (opcode) {
+    case Opcode::I1_LOAD:
+    case Opcode::I8_LOAD:
+    case Opcode::I8_STORE:
+      return 1;
+
+    case Opcode::I16_LOAD:
+    case Opcode::I16_STORE:
+      return 2;
+
+    case Opcode::I32_LOAD:
+    case Opcode::I32_STORE:
+      return 4;
+
+    case Opcode::I64_LOAD:
+    case Opcode::PTR_LOAD:
+    case Opcode::F64_LOAD:
+    case Opcode::I64_STORE:
+    case Opcode::PTR_STORE:
+    case Opcode::F64_STORE:
+      return 8;
+
+    case Opcode::I32_VEC8_LOAD:
+    case Opcode::I32_VEC8_MASK_STORE:
+      return 32;
+
+    default:
+      throw std::runtime_error("Not a load or store.");
+  }
+}
+
+MemoryAccess GetMemoryAccess(const Program& program,
+                             const std::vector<uint64_t>& instrs, int idx) {
+  auto opcode = OpcodeFrom(GenericInstructionReader(instrs[idx]).Opcode());
+  Value addr(opcode == Opcode::PTR_LOAD
+                 ? Type3InstructionReader(instrs[idx]).Arg()
+                 : Type2InstructionReader(instrs[idx]).Arg0());
+
+  int64_t offset = 0;
+  while (!addr.IsConstantGlobal()) {
+    auto instr = instrs[addr.GetIdx()];
+    auto addr_opcode = OpcodeFrom(GenericInstructionReader(instr).Opcode());
+    if (addr_opcode == Opcode::PTR_CAST) {
+      addr = Value(Type3InstructionReader(instr).Arg());
+      continue;
+    }
+
+    if (addr_opcode == Opcode::GEP_STATIC) {
+      // The constant offset is an I32 constant, whose value is stored in the
+      // constant instruction itself.
+      Type2InstructionReader offset_reader(instrs[addr.GetIdx() - 1]);
+      Value offset_v(offset_reader.Arg1());
+      offset += static_cast<int32_t>(
+          Type1InstructionReader(program.ConstantInstrs()[offset_v.GetIdx()])
+              .Constant());
+      addr = Value(offset_reader.Arg0());
+      continue;
+    }
+
+    break;
+  }
+
+  return MemoryAccess{addr, offset, AccessWidth(opcode)};
+}
+
+bool MayAlias(const MemoryAccess& store, const MemoryAccess& load) {
+  if (!(store.base == load.base)) {
+    return true;
+  }
+  return store.offset < load.offset + load.width &&
+         load.offset < store.offset + store.width;
+}
+
+std::vector<int> FlattenSegments(const BasicBlock& bb) {
+  std::vector<int> result;
+  for (auto [seg_start, seg_end] : bb.Segments()) {
+    for (int i = seg_start; i <= seg_end; i++) {
+      result.push_back(i);
+    }
+  }
+  return result;
+}
+
+std::vector<std::pair<int, int>> BuildSegments(const std::vector<int>& idxs) {
+  std::vector<std::pair<int, int>> segments;
+  for (int i : idxs) {
+    if (!segments.empty() && segments.back().second + 1 == i) {
+      segments.back().second = i;
+    } else {
+      segments.emplace_back(i, i);
+    }
+  }
+  return segments;
+}
+
+}  // namespace kush::khir
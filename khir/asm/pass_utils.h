@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "khir/opcode.h"
+#include "khir/program.h"
+
+namespace kush::khir {
+
+// Bytes [offset, offset + width) from base read or written by a load or
+// store. Static GEPs and pointer casts are folded into the offset so that
+// accesses off the same pointer can be compared.
+struct MemoryAccess {
+  Value base;
+  int64_t offset;
+  int32_t width;
+};
+
+MemoryAccess GetMemoryAccess(const Program& program,
+                             const std::vector<uint64_t>& instrs, int idx);
+
+// khir has no type-based aliasing rule, so accesses are only known to be
+// disjoint if they are off the same base and their bytes do not overlap.
+bool MayAlias(const MemoryAccess& store, const MemoryAccess& load);
+bool IsLoad(Opcode opcode);
+bool IsStore(Opcode opcode);
+
+// Returns true if the instruction has no side effects and its result only
+// depends on its operands.
+bool IsPureInstr(Opcode opcode);
+
+// Replaces every value read by instr with f(value). Branch targets, type ids
+// and the phi referenced by a PHI_MEMBER are left untouched.
+void RewriteOperands(uint64_t& instr,
+                     const std::function<uint32_t(uint32_t)>& f);
+
+// Invokes f on every value read by instr.
+void ForEachOperand(uint64_t instr, const std::function<void(Value)>& f);
+
+// Returns the instruction indices of bb in execution order.
+std::vector<int> FlattenSegments(const BasicBlock& bb);
+
+// Compresses an ordered list of instruction indices into segments.
+std::vector<std::pair<int, int>> BuildSegments(const std::vector<int>& idxs);
+
+}  // namespace kush::khir
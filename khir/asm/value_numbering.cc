@@ -0,0 +1,117 @@
+#include "khir/asm/value_numbering.h"
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+
+#include "khir/asm/dominators.h"
+#include "khir/asm/pass_utils.h"
+#include "khir/instruction.h"
+#include "khir/opcode.h"
+#include "khir/program.h"
+
+namespace kush::khir {
+
+class ValueNumberer {
+ public:
+  ValueNumberer(const Program& program, std::vector<uint64_t>& instrs,
+                const std::vector<BasicBlock>& basic_blocks)
+      : program_(program),
+        instrs_(instrs),
+        basic_blocks_(basic_blocks),
+        dom_tree_(ComputeDominatorTree(basic_blocks)) {}
+
+  void Run() { Visit(0); }
+
+ private:
+  using Key = std::pair<uint64_t, uint64_t>;
+
+  uint32_t Lookup(uint32_t v) {
+    auto it = replacement_.find(v);
+    return it == replacement_.end() ? v : it->second;
+  }
+
+  Key GetKey(int idx, Opcode opcode) {
+    // GEPs are defined by the offset instruction that precedes them.
+    if (opcode == Opcode::GEP_STATIC || opcode == Opcode::GEP_DYNAMIC) {
+      return {instrs_[idx - 1], instrs_[idx]};
+    }
+    return {instrs_[idx], 0};
+  }
+
+  void Visit(int bb) {
+    std::vector<Key> added;
+    absl::flat_hash_map<Key, std::pair<uint32_t, MemoryAccess>> loads;
+
+    for (int idx : FlattenSegments(basic_blocks_[bb])) {
+      RewriteOperands(instrs_[idx], [&](uint32_t v) { return Lookup(v); });
+      auto opcode = OpcodeFrom(GenericInstructionReader(instrs_[idx]).Opcode());
+
+      if (IsLoad(opcode)) {
+        auto key = GetKey(idx, opcode);
+        auto it = loads.find(key);
+        if (it != loads.end()) {
+          replacement_[idx] = it->second.first;
+        } else {
+          loads[key] = {idx, GetMemoryAccess(program_, instrs_, idx)};
+        }
+        continue;
+      }
+
+      if (IsStore(opcode)) {
+        auto store = GetMemoryAccess(program_, instrs_, idx);
+        for (auto it = loads.begin(); it != loads.end();) {
+          if (MayAlias(store, it->second.second)) {
+            loads.erase(it++);
+          } else {
+            ++it;
+          }
+        }
+        continue;
+      }
+
+      if (opcode == Opcode::CALL || opcode == Opcode::CALL_INDIRECT) {
+        loads.clear();
+        continue;
+      }
+
+      if (!IsPureInstr(opcode)) {
+        continue;
+      }
+
+      auto key = GetKey(idx, opcode);
+      auto it = available_.find(key);
+      if (it != available_.end()) {
+        replacement_[idx] = it->second;
+      } else {
+        available_[key] = idx;
+        added.push_back(key);
+      }
+    }
+
+    for (int child : dom_tree_[bb]) {
+      Visit(child);
+    }
+
+    for (const auto& key : added) {
+      available_.erase(key);
+    }
+  }
+
+  const Program& program_;
+  std::vector<uint64_t>& instrs_;
+  const std::vector<BasicBlock>& basic_blocks_;
+  std::vector<std::vector<int>> dom_tree_;
+  absl::flat_hash_map<Key, uint32_t> available_;
+  absl::flat_hash_map<uint32_t, uint32_t> replacement_;
+};
+
+void ValueNumbering(const Program& program, std::vector<uint64_t>& instrs,
+                    const std::vector<BasicBlock>& basic_blocks) {
+  ValueNumberer(program, instrs, basic_blocks).Run();
+}
+
+}  // namespace kush::khir
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "khir/program.h"
+
+namespace kush::khir {
+
+// Removes redundant computations. Pure instructions are numbered over the
+// dominator tree so that a value computed in a dominating block is reused.
+// Loads are only reused within a basic block and only until a call or a store
+// that may alias them.
+void ValueNumbering(const Program& program, std::vector<uint64_t>& instrs,
+                    const std::vector<BasicBlock>& basic_blocks);
+
+}  // namespace kush::khir
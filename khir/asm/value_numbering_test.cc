@@ -0,0 +1,161 @@
+#include "khir/asm/value_numbering.h"
+
+#include "gtest/gtest.h"
+
+#include "khir/asm/pass_utils.h"
+#include "khir/instruction.h"
+#include "khir/program_builder.h"
+
+using namespace kush;
+using namespace kush::khir;
+
+Type2InstructionReader FindInstr(const Function& func,
+                                 const std::vector<uint64_t>& instrs,
+                                 Opcode opcode) {
+  for (const auto& bb : func.BasicBlocks()) {
+    for (int idx : FlattenSegments(bb)) {
+      if (OpcodeFrom(GenericInstructionReader(instrs[idx]).Opcode()) ==
+          opcode) {
+        return Type2InstructionReader(instrs[idx]);
+      }
+    }
+  }
+  throw std::runtime_error("Instruction not found.");
+}
+
+TEST(ValueNumberingTest, RedundantLoad) {
+  ProgramBuilder program;
+
+  auto type = program.I32Type();
+  auto st = program.StructType({type, type});
+  auto func = program.CreateNamedFunction(type, {program.PointerType(st)},
+                                          "compute");
+  auto arg = program.GetFunctionArguments(func)[0];
+  auto x1 = program.LoadI32(program.StaticGEP(st, arg, {0, 1}));
+  auto x2 = program.LoadI32(program.StaticGEP(st, arg, {0, 1}));
+  program.Return(program.AddI32(x1, x2));
+
+  auto built = program.Build();
+  const auto& function = built->Functions()[0];
+  auto instrs = function.Instrs();
+  ValueNumbering(*built, instrs, function.BasicBlocks());
+
+  auto add = FindInstr(function, instrs, Opcode::I32_ADD);
+  EXPECT_EQ(add.Arg0(), add.Arg1());
+}
+
+TEST(ValueNumberingTest, LoadClobberedByStore) {
+  ProgramBuilder program;
+
+  auto type = program.I32Type();
+  auto st = program.StructType({type, type});
+  auto func = program.CreateNamedFunction(type, {program.PointerType(st)},
+                                          "compute");
+  auto arg = program.GetFunctionArguments(func)[0];
+  auto x1 = program.LoadI32(program.StaticGEP(st, arg, {0, 1}));
+  program.StoreI32(program.StaticGEP(st, arg, {0, 1}), program.ConstI32(5));
+  auto x2 = program.LoadI32(program.StaticGEP(st, arg, {0, 1}));
+  program.Return(program.AddI32(x1, x2));
+
+  auto built = program.Build();
+  const auto& function = built->Functions()[0];
+  auto instrs = function.Instrs();
+  ValueNumbering(*built, instrs, function.BasicBlocks());
+
+  auto add = FindInstr(function, instrs, Opcode::I32_ADD);
+  EXPECT_NE(add.Arg0(), add.Arg1());
+}
+
+TEST(ValueNumberingTest, LoadNotClobberedByDisjointStore) {
+  ProgramBuilder program;
+
+  auto type = program.I32Type();
+  auto st = program.StructType({type, type});
+  auto func = program.CreateNamedFunction(type, {program.PointerType(st)},
+                                          "compute");
+  auto arg = program.GetFunctionArguments(func)[0];
+  auto x1 = program.LoadI32(program.StaticGEP(st, arg, {0, 1}));
+  program.StoreI32(program.StaticGEP(st, arg, {0, 0}), program.ConstI32(5));
+  auto x2 = program.LoadI32(program.StaticGEP(st, arg, {0, 1}));
+  program.Return(program.AddI32(x1, x2));
+
+  auto built = program.Build();
+  const auto& function = built->Functions()[0];
+  auto instrs = function.Instrs();
+  ValueNumbering(*built, instrs, function.BasicBlocks());
+
+  auto add = FindInstr(function, instrs, Opcode::I32_ADD);
+  EXPECT_EQ(add.Arg0(), add.Arg1());
+}
+
+TEST(ValueNumberingTest, LoadClobberedByStoreOfOtherType) {
+  ProgramBuilder program;
+
+  auto func = program.CreateNamedFunction(
+      program.I64Type(), {program.PointerType(program.I64Type())}, "compute");
+  auto arg = program.GetFunctionArguments(func)[0];
+  auto x1 = program.LoadI64(arg);
+  program.StoreF64(
+      program.PointerCast(arg, program.PointerType(program.F64Type())),
+      program.ConstF64(1.5));
+  auto x2 = program.LoadI64(arg);
+  program.Return(program.AddI64(x1, x2));
+
+  auto built = program.Build();
+  const auto& function = built->Functions()[0];
+  auto instrs = function.Instrs();
+  ValueNumbering(*built, instrs, function.BasicBlocks());
+
+  auto add = FindInstr(function, instrs, Opcode::I64_ADD);
+  EXPECT_NE(add.Arg0(), add.Arg1());
+}
+
+TEST(ValueNumberingTest, LoadClobberedByNarrowerStore) {
+  ProgramBuilder program;
+
+  auto func = program.CreateNamedFunction(
+      program.I64Type(), {program.PointerType(program.I64Type())}, "compute");
+  auto arg = program.GetFunctionArguments(func)[0];
+  auto x1 = program.LoadI64(arg);
+  program.StoreI32(
+      program.PointerCast(arg, program.PointerType(program.I32Type())),
+      program.ConstI32(5));
+  auto x2 = program.LoadI64(arg);
+  program.Return(program.AddI64(x1, x2));
+
+  auto built = program.Build();
+  const auto& function = built->Functions()[0];
+  auto instrs = function.Instrs();
+  ValueNumbering(*built, instrs, function.BasicBlocks());
+
+  auto add = FindInstr(function, instrs, Opcode::I64_ADD);
+  EXPECT_NE(add.Arg0(), add.Arg1());
+}
+
+TEST(ValueNumberingTest, DominatingExpression) {
+  ProgramBuilder program;
+
+  auto type = program.I32Type();
+  auto func = program.CreateNamedFunction(type, {type, type}, "compute");
+  auto args = program.GetFunctionArguments(func);
+  auto x1 = program.MulI32(args[0], args[1]);
+
+  auto bb1 = program.GenerateBlock();
+  auto bb2 = program.GenerateBlock();
+  program.Branch(program.CmpI32(CompType::LT, x1, args[0]), bb1, bb2);
+
+  program.SetCurrentBlock(bb1);
+  auto x2 = program.MulI32(args[0], args[1]);
+  program.Return(program.SubI32(x1, x2));
+
+  program.SetCurrentBlock(bb2);
+  program.Return(args[0]);
+
+  auto built = program.Build();
+  const auto& function = built->Functions()[0];
+  auto instrs = function.Instrs();
+  ValueNumbering(*built, instrs, function.BasicBlocks());
+
+  auto sub = FindInstr(function, instrs, Opcode::I32_SUB);
+  EXPECT_EQ(sub.Arg0(), sub.Arg1());
+}
@@ -5,6 +5,8 @@
 #include "gtest/gtest.h"
 
 #include "khir/asm/asm_backend.h"
+#include "khir/branch_profile.h"
+#include "khir/instruction.h"
 #include "khir/llvm/llvm_backend.h"
 #include "khir/program_builder.h"
 #include "khir/program_printer.h"
@@ -3354,6 +3356,52 @@ TEST_P(BackendTest, I32_ZEXT_I64Const) {
   }
 }
 
+TEST_P(BackendTest, I32_SEXT_I64) {
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  std::uniform_int_distribution<int32_t> distrib(INT32_MIN, INT32_MAX);
+  for (int i = 0; i < 10; i++) {
+    ProgramBuilder program;
+    auto func = program.CreateNamedFunction(program.I64Type(),
+                                            {program.I32Type()}, "compute");
+    auto args = program.GetFunctionArguments(func);
+    program.Return(program.I64SextI32(args[0]));
+
+    auto built = program.Build();
+    auto backend = Compile(GetParam(), *built);
+
+    using compute_fn = std::add_pointer<int64_t(int32_t)>::type;
+    auto compute =
+        reinterpret_cast<compute_fn>(backend->GetFunction("compute"));
+
+    int32_t c = distrib(gen);
+    EXPECT_EQ(int64_t(c), compute(c));
+  }
+}
+
+TEST_P(BackendTest, I32_SEXT_I64Const) {
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  std::uniform_int_distribution<int32_t> distrib(INT32_MIN, INT32_MAX);
+  for (int i = 0; i < 10; i++) {
+    int32_t c = distrib(gen);
+
+    ProgramBuilder program;
+    program.CreateNamedFunction(program.I64Type(), {program.I32Type()},
+                                "compute");
+    program.Return(program.I64SextI32(program.ConstI32(c)));
+
+    auto built = program.Build();
+    auto backend = Compile(GetParam(), *built);
+
+    using compute_fn = std::add_pointer<int64_t(int32_t)>::type;
+    auto compute =
+        reinterpret_cast<compute_fn>(backend->GetFunction("compute"));
+
+    EXPECT_EQ(int64_t(c), compute(c));
+  }
+}
+
 TEST_P(BackendTest, I32_CONV_F64) {
   std::random_device rd;
   std::mt19937 gen(rd());
@@ -4373,6 +4421,97 @@ TEST_P(BackendTest, I64_XORConstArg1) {
   }
 }
 
+uint64_t Crc32(uint64_t crc, uint64_t v) {
+  uint32_t result = crc;
+  for (int i = 0; i < 64; i++) {
+    bool bit = (result ^ (v >> i)) & 1;
+    result = (result >> 1) ^ (bit ? 0x82F63B78 : 0);
+  }
+  return result;
+}
+
+TEST_P(BackendTest, I64_CRC32) {
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  std::uniform_int_distribution<int64_t> distrib(INT64_MIN, INT64_MAX);
+
+  ProgramBuilder program;
+  auto func = program.CreateNamedFunction(
+      program.I64Type(), {program.I64Type(), program.I64Type()}, "compute");
+  auto args = program.GetFunctionArguments(func);
+  auto crc = program.Crc32I64(args[0], args[1]);
+  program.Return(crc);
+
+  auto built = program.Build();
+  auto backend = Compile(GetParam(), *built);
+
+  using compute_fn = std::add_pointer<int64_t(int64_t, int64_t)>::type;
+  auto compute = reinterpret_cast<compute_fn>(backend->GetFunction("compute"));
+
+  for (int i = 0; i < 10; i++) {
+    int64_t a0 = distrib(gen);
+    int64_t a1 = distrib(gen);
+    int64_t res = Crc32(a0, a1);
+    EXPECT_EQ(res, compute(a0, a1));
+  }
+}
+
+TEST_P(BackendTest, I64_CRC32ConstArg0) {
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  std::uniform_int_distribution<int64_t> distrib(INT64_MIN, INT64_MAX);
+
+  for (int i = 0; i < 10; i++) {
+    int64_t a0 = distrib(gen);
+    int64_t a1 = distrib(gen);
+
+    ProgramBuilder program;
+    auto func = program.CreateNamedFunction(program.I64Type(),
+                                            {program.I64Type()}, "compute");
+    auto args = program.GetFunctionArguments(func);
+    auto crc = program.Crc32I64(program.ConstI64(a0), args[0]);
+    program.Return(crc);
+
+    auto built = program.Build();
+    auto backend = Compile(GetParam(), *built);
+
+    using compute_fn = std::add_pointer<int64_t(int64_t)>::type;
+    auto compute =
+        reinterpret_cast<compute_fn>(backend->GetFunction("compute"));
+
+    int64_t res = Crc32(a0, a1);
+    EXPECT_EQ(res, compute(a1));
+  }
+}
+
+TEST_P(BackendTest, I64_CRC32ConstArg1) {
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  std::uniform_int_distribution<int64_t> distrib(INT64_MIN, INT64_MAX);
+
+  for (int i = 0; i < 10; i++) {
+    int64_t a0 = distrib(gen);
+    int64_t a1 = distrib(gen);
+
+    ProgramBuilder program;
+    auto func = program.CreateNamedFunction(program.I64Type(),
+                                            {program.I64Type()}, "compute");
+    auto args = program.GetFunctionArguments(func);
+    auto crc = program.Crc32I64(args[0], program.ConstI64(a1));
+    program.Return(crc);
+
+    auto built = program.Build();
+    auto backend = Compile(GetParam(), *built);
+
+    using compute_fn = std::add_pointer<int64_t(int64_t)>::type;
+    auto compute =
+        reinterpret_cast<compute_fn>(backend->GetFunction("compute"));
+
+    int64_t res = Crc32(a0, a1);
+    EXPECT_EQ(res, compute(a0));
+  }
+}
+
 TEST_P(BackendTest, I64_OR) {
   std::random_device rd;
   std::mt19937 gen(rd());
@@ -6603,6 +6742,31 @@ TEST_P(BackendTest, DynamicGEPColumnData) {
   EXPECT_EQ(compute(&col, 1 << 16), &array[1 << 16]);
 }
 
+TEST_P(BackendTest, DynamicGEPI64Index) {
+  ProgramBuilder program;
+  auto func = program.CreateNamedFunction(
+      program.PointerType(program.I64Type()),
+      {program.PointerType(program.I64Type()), program.I32Type()}, "compute");
+
+  // Scaled past the range of an I32 index.
+  auto args = program.GetFunctionArguments(func);
+  auto idx = program.MulI64(program.I64SextI32(args[1]),
+                            program.ConstI64(int64_t(1) << 32));
+  program.Return(program.DynamicGEP(program.I64Type(), args[0], idx, {}));
+
+  auto built = program.Build();
+  auto backend = Compile(GetParam(), *built);
+
+  using compute_fn = std::add_pointer<int64_t*(int64_t*, int32_t)>::type;
+  auto compute = reinterpret_cast<compute_fn>(backend->GetFunction("compute"));
+
+  auto base = reinterpret_cast<int64_t*>(0x10000000000);
+  EXPECT_EQ(reinterpret_cast<uint64_t>(compute(base, 3)),
+            0x10000000000 + (uint64_t(3) << 35));
+  EXPECT_EQ(reinterpret_cast<uint64_t>(compute(base, -1)),
+            0x10000000000 - (uint64_t(1) << 35));
+}
+
 TEST_P(BackendTest, I32Vec8CmpEQ) {
   alignas(32) int32_t values[8]{1, 2, 3, 4, 5, 6, 7, 8};
 
@@ -6952,6 +7116,83 @@ TEST_P(BackendTest, I32ConvI32Vec8) {
   }
 }
 
+TEST(ASMBackendTest, BranchProfileCountsEdges) {
+  for (auto impl : {RegAllocImpl::STACK_SPILL, RegAllocImpl::LINEAR_SCAN}) {
+    ProgramBuilder program;
+    auto func = program.CreateNamedFunction(program.I32Type(),
+                                            {program.I32Type()}, "compute");
+    auto args = program.GetFunctionArguments(func);
+    auto bb1 = program.GenerateBlock();
+    auto bb2 = program.GenerateBlock();
+    program.Branch(
+        program.CmpI32(CompType::LT, args[0], program.ConstI32(10)), bb1, bb2);
+    program.SetCurrentBlock(bb1);
+    program.Return(program.ConstI32(1));
+    program.SetCurrentBlock(bb2);
+    program.Return(program.ConstI32(0));
+
+    auto built = program.Build();
+    BranchProfile profile(*built);
+    ASMBackend backend(*built, impl);
+    backend.SetBranchProfile(&profile);
+    backend.Compile();
+
+    using compute_fn = std::add_pointer<int32_t(int32_t)>::type;
+    auto compute = reinterpret_cast<compute_fn>(backend.GetFunction("compute"));
+    for (int i = 0; i < 3; i++) {
+      EXPECT_EQ(1, compute(5));
+    }
+    for (int i = 0; i < 2; i++) {
+      EXPECT_EQ(0, compute(20));
+    }
+
+    const auto& instrs = built->Functions()[0].Instrs();
+    int condbr = -1;
+    for (int i = 0; i < instrs.size(); i++) {
+      if (OpcodeFrom(GenericInstructionReader(instrs[i]).Opcode()) ==
+          Opcode::CONDBR) {
+        condbr = i;
+      }
+    }
+    ASSERT_NE(condbr, -1);
+
+    auto weights = profile.Weights(0, condbr);
+    ASSERT_TRUE(weights.has_value());
+    EXPECT_EQ(weights->first, 3);
+    EXPECT_EQ(weights->second, 2);
+  }
+}
+
+TEST(LLVMBackendTest, TierUpCompilesDistinctFunction) {
+  ProgramBuilder program;
+  auto global = program.Global(program.I64Type(), program.ConstI64(5));
+  auto add = program.CreateNamedFunction(program.I64Type(),
+                                         {program.I64Type()}, "add");
+  program.Return(program.AddI64(program.GetFunctionArguments(add)[0],
+                                program.LoadI64(global)));
+  auto func = program.CreateNamedFunction(program.I64Type(),
+                                          {program.I64Type()}, "compute");
+  program.Return(program.Call(add, {program.GetFunctionArguments(func)[0]}));
+
+  auto built = program.Build();
+  LLVMBackend backend(*built);
+
+  using compute_fn = std::add_pointer<int64_t(int64_t)>::type;
+  auto fast = reinterpret_cast<compute_fn>(
+      backend.GetFunction("compute", LLVMOptLevel::FAST));
+  EXPECT_EQ(fast, reinterpret_cast<compute_fn>(backend.GetFunction("compute")));
+  EXPECT_EQ(12, fast(7));
+
+  auto o3 = reinterpret_cast<compute_fn>(
+      backend.GetFunction("compute", LLVMOptLevel::O3));
+  EXPECT_NE(fast, o3);
+  EXPECT_EQ(12, o3(7));
+  EXPECT_EQ(o3, reinterpret_cast<compute_fn>(
+                    backend.GetFunction("compute", LLVMOptLevel::O3)));
+  EXPECT_EQ(fast, reinterpret_cast<compute_fn>(
+                      backend.GetFunction("compute", LLVMOptLevel::FAST)));
+}
+
 INSTANTIATE_TEST_SUITE_P(LLVMBackendTest, BackendTest,
                          testing::Values(std::make_pair(
                              BackendType::LLVM, RegAllocImpl::STACK_SPILL)));
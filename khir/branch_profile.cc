@@ -0,0 +1,55 @@
+#include "khir/branch_profile.h"
+
+#include "absl/flags/flag.h"
+
+#include "khir/instruction.h"
+#include "khir/opcode.h"
+
+ABSL_FLAG(bool, profile_branches, false,
+          "Count branch edges in the ASM backend and pass them to LLVM.");
+
+namespace kush::khir {
+
+BranchProfile::BranchProfile(const Program& program)
+    : slots_(program.Functions().size()),
+      counters_(program.Functions().size()) {
+  const auto& funcs = program.Functions();
+  for (int func_idx = 0; func_idx < funcs.size(); func_idx++) {
+    if (funcs[func_idx].External()) {
+      continue;
+    }
+
+    const auto& instrs = funcs[func_idx].Instrs();
+    for (int i = 0; i < instrs.size(); i++) {
+      if (OpcodeFrom(GenericInstructionReader(instrs[i]).Opcode()) ==
+          Opcode::CONDBR) {
+        slots_[func_idx][i] = counters_[func_idx].size();
+        counters_[func_idx].push_back(0);
+        counters_[func_idx].push_back(0);
+      }
+    }
+  }
+}
+
+uint64_t* BranchProfile::Counters(int func_idx, int instr_idx) {
+  return counters_[func_idx].data() + slots_[func_idx].at(instr_idx);
+}
+
+std::optional<std::pair<uint64_t, uint64_t>> BranchProfile::Weights(
+    int func_idx, int instr_idx) const {
+  auto it = slots_[func_idx].find(instr_idx);
+  if (it == slots_[func_idx].end()) {
+    return std::nullopt;
+  }
+
+  auto taken = counters_[func_idx][it->second];
+  auto not_taken = counters_[func_idx][it->second + 1];
+  if (taken == 0 && not_taken == 0) {
+    return std::nullopt;
+  }
+  return std::make_pair(taken, not_taken);
+}
+
+bool BranchProfilingEnabled() { return FLAGS_profile_branches.Get(); }
+
+}  // namespace kush::khir
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+
+#include "khir/program.h"
+
+namespace kush::khir {
+
+// Number of times the true and false edge of each conditional branch of a
+// program was taken. Collected by the instrumented ASM tier and attached as
+// branch weights by the LLVM tier.
+class BranchProfile {
+ public:
+  BranchProfile(const Program& program);
+
+  // Returns the true and false edge counters of the CONDBR at instr_idx.
+  uint64_t* Counters(int func_idx, int instr_idx);
+
+  // Returns the true and false edge counts or std::nullopt if the branch was
+  // never reached.
+  std::optional<std::pair<uint64_t, uint64_t>> Weights(int func_idx,
+                                                       int instr_idx) const;
+
+ private:
+  std::vector<absl::flat_hash_map<int, int>> slots_;
+  std::vector<std::vector<uint64_t>> counters_;
+};
+
+bool BranchProfilingEnabled();
+
+}  // namespace kush::khir
@@ -105,6 +105,7 @@ void RewriteInstr(uint64_t& instr,
     case Opcode::I64_AND:
     case Opcode::I64_OR:
     case Opcode::I64_XOR:
+    case Opcode::I64_CRC32:
     case Opcode::I64_CMP_EQ:
     case Opcode::I64_CMP_NE:
     case Opcode::I64_CMP_LT:
@@ -130,6 +131,7 @@ void RewriteInstr(uint64_t& instr,
     case Opcode::I16_ZEXT_I64:
     case Opcode::I16_CONV_F64:
     case Opcode::I32_ZEXT_I64:
+    case Opcode::I32_SEXT_I64:
     case Opcode::I32_CONV_I32_VEC8:
     case Opcode::I32_CONV_F64:
     case Opcode::I64_CONV_F64:
@@ -115,6 +115,7 @@ class Type1InstructionReader {
 // [MD] [ARG0] [ARG1] I32_CMP_EQ_ANY_CONST_VEC4
 // [MD] [ARG0] [ARG1] I32_CMP_EQ_ANY_CONST_VEC8
 // [MD] [ARG0] [0]    I32_ZEXT_I64
+// [MD] [ARG0] [0]    I32_SEXT_I64
 // [MD] [ARG0] [0]    I32_CONV_F64
 // [MD] [ARG0] [0]    I32_CONV_I32_VEC8
 // [MD] [ARG0] [ARG1] I64_ADD
@@ -123,6 +124,7 @@ class Type1InstructionReader {
 // [MD] [ARG0] [ARG1] I64_AND
 // [MD] [ARG0] [ARG1] I64_XOR
 // [MD] [ARG0] [ARG1] I64_OR
+// [MD] [ARG0] [ARG1] I64_CRC32
 // [MD] [ARG0] [ARG1] I64_LSHIFT
 // [MD] [ARG0] [ARG1] I64_RSHIFT
 // [MD] [ARG0] [ARG1] I64_CMP_EQ
@@ -163,6 +165,10 @@ class Type1InstructionReader {
 // [MD] [ARG0] [ARG1] PHI_MEMBER
 // [MD] [ARG0] [ARG1] GEP_STATIC_OFFSET
 // [MD] [ARG0] [ARG1] GEP_DYNAMIC_OFFSET
+//
+// The metadata of GEP_DYNAMIC_OFFSET is GEP_I64_INDEX if ARG0 is an I64
+// rather than an I32 index.
+constexpr uint8_t GEP_I64_INDEX = 1;
 
 class Type2InstructionBuilder {
  public:
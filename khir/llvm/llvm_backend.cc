@@ -1,5 +1,6 @@
 #include "khir/llvm/llvm_backend.h"
 
+#include <algorithm>
 #include <chrono>
 #include <dlfcn.h>
 #include <iostream>
@@ -19,27 +20,55 @@
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/IntrinsicsX86.h"
 #include "llvm/IR/LLVMContext.h"
-#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/IR/Module.h"
+#include "llvm/IR/PassManager.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/MC/SubtargetFeature.h"
 #include "llvm/MC/TargetRegistry.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Object/SymbolSize.h"
+#include "llvm/Passes/OptimizationLevel.h"
+#include "llvm/Passes/PassBuilder.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Host.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
 #include "llvm/Transforms/InstCombine/InstCombine.h"
-#include "llvm/Transforms/Scalar.h"
+#include "llvm/Transforms/Scalar/ADCE.h"
 #include "llvm/Transforms/Scalar/GVN.h"
+#include "llvm/Transforms/Scalar/Reassociate.h"
+#include "llvm/Transforms/Scalar/SimplifyCFG.h"
 
 #include "khir/backend.h"
 #include "khir/instruction.h"
 #include "khir/llvm/perf_jit_event_listener.h"
 #include "khir/type_manager.h"
 #include "util/permute.h"
+#include "util/query_stats.h"
+
+ABSL_FLAG(std::string, llvm_opt_level, "adaptive",
+          "LLVM Optimization Level: fast, O1, O2, O3 or adaptive");
 
 namespace kush::khir {
 
+std::optional<LLVMOptLevel> GetLLVMOptLevel() {
+  if (FLAGS_llvm_opt_level.CurrentValue() == "adaptive") {
+    return std::nullopt;
+  } else if (FLAGS_llvm_opt_level.CurrentValue() == "fast") {
+    return LLVMOptLevel::FAST;
+  } else if (FLAGS_llvm_opt_level.CurrentValue() == "O1") {
+    return LLVMOptLevel::O1;
+  } else if (FLAGS_llvm_opt_level.CurrentValue() == "O2") {
+    return LLVMOptLevel::O2;
+  } else if (FLAGS_llvm_opt_level.CurrentValue() == "O3") {
+    return LLVMOptLevel::O3;
+  } else {
+    throw std::runtime_error("Unknown LLVM optimization level.");
+  }
+}
+
 LLVMTypeManager::LLVMTypeManager(llvm::LLVMContext* c, llvm::IRBuilder<>* b)
     : context_(c), builder_(b) {}
 
@@ -126,7 +155,9 @@ llvm::Function* DeclareFunction(const Function& func, llvm::Module* mod,
 double LLVMBackend::compilation_time_ = 0;
 
 LLVMBackend::LLVMBackend(const khir::Program& program)
-    : program_(program), functions_(program_.Functions().size(), nullptr) {
+    : program_(program),
+      profile_(nullptr),
+      functions_(program_.Functions().size(), nullptr) {
 #ifdef COMP_TIME
   auto t1 = std::chrono::high_resolution_clock::now();
 #endif
@@ -137,18 +168,33 @@ LLVMBackend::LLVMBackend(const khir::Program& program)
     throw std::runtime_error("Target not found: " + error);
   }
 
-  auto cpu = "x86-64";
-  auto features = "+avx2";
+  // Tune for the host CPU (-mcpu=native). AVX2 is required by the vector
+  // instructions.
+  auto cpu = llvm::sys::getHostCPUName();
+  llvm::SubtargetFeatures features;
+  llvm::StringMap<bool> host_features;
+  if (llvm::sys::getHostCPUFeatures(host_features)) {
+    for (const auto& feature : host_features) {
+      features.AddFeature(feature.getKey(), feature.getValue());
+    }
+  }
+  features.AddFeature("avx2");
 
   llvm::TargetOptions opt;
   auto reloc_model =
       llvm::Optional<llvm::Reloc::Model>(llvm::Reloc::Model::PIC_);
-  auto target_machine = target->createTargetMachine(target_triple, cpu,
-                                                    features, opt, reloc_model);
+  target_machine_.reset(target->createTargetMachine(
+      target_triple, cpu, features.getString(), opt, reloc_model));
+
+  llvm::orc::JITTargetMachineBuilder jtmb((llvm::Triple(target_triple)));
+  jtmb.setCPU(cpu.str())
+      .addFeatures(features.getFeatures())
+      .setRelocationModel(reloc_model);
 
   jit_ = cantFail(
       llvm::orc::LLJITBuilder()
-          .setDataLayout(target_machine->createDataLayout())
+          .setJITTargetMachineBuilder(std::move(jtmb))
+          .setDataLayout(target_machine_->createDataLayout())
           .setNumCompileThreads(0)
           .setObjectLinkingLayerCreator([&](llvm::orc::ExecutionSession& es,
                                             const llvm::Triple& tt) {
@@ -165,6 +211,42 @@ LLVMBackend::LLVMBackend(const khir::Program& program)
           })
           .create());
 
+  // Record the machine code size of each function from the emitted objects.
+  jit_->getObjTransformLayer().setTransform(
+      [](std::unique_ptr<llvm::MemoryBuffer> buffer)
+          -> llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> {
+        auto& stats = util::QueryStats::Get();
+        if (!stats.Enabled()) {
+          return std::move(buffer);
+        }
+
+        auto obj = llvm::object::ObjectFile::createObjectFile(
+            buffer->getMemBufferRef());
+        if (!obj) {
+          return obj.takeError();
+        }
+
+        for (const auto& [symbol, size] :
+             llvm::object::computeSymbolSizes(**obj)) {
+          auto type = symbol.getType();
+          if (!type) {
+            return type.takeError();
+          }
+          if (type.get() != llvm::object::SymbolRef::ST_Function) {
+            continue;
+          }
+
+          auto name = symbol.getName();
+          if (!name) {
+            return name.takeError();
+          }
+          stats.SetCodeSize("llvm",
+                            std::string_view(name->data(), name->size()),
+                            size);
+        }
+        return std::move(buffer);
+      });
+
   llvm::orc::SymbolMap symbol_map;
   for (const auto& func : program_.Functions()) {
     if (func.External()) {
@@ -218,11 +300,12 @@ LLVMBackend::LLVMBackend(const khir::Program& program)
 
       to_add.push_back(funcs[curr].Name());
 
-      TranslateFunction(funcs[curr], mod.get(), context.get(), builder.get(),
-                        types, constant_values);
+      TranslateFunction(curr, mod.get(), context.get(), builder.get(), types,
+                        constant_values);
     }
 
-    CompileAndLink(std::move(mod), std::move(context), to_add);
+    CompileAndLink(std::move(mod), std::move(context), to_add,
+                   LLVMOptLevel::FAST);
   }
 #ifdef COMP_TIME
   auto t2 = std::chrono::high_resolution_clock::now();
@@ -405,9 +488,10 @@ llvm::Constant* LLVMBackend::GetConstant(
 }
 
 void LLVMBackend::TranslateFunction(
-    const Function& func, llvm::Module* mod, llvm::LLVMContext* context,
+    int func_idx, llvm::Module* mod, llvm::LLVMContext* context,
     llvm::IRBuilder<>* builder, const std::vector<llvm::Type*>& types,
     std::vector<llvm::Constant*>& constant_values) {
+  const auto& func = program_.Functions()[func_idx];
   llvm::Function* function = mod->getFunction(func.Name());
   std::vector<llvm::Value*> args;
   for (auto& a : function->args()) {
@@ -439,13 +523,47 @@ void LLVMBackend::TranslateFunction(
       }
     }
   }
+
+  if (profile_ != nullptr) {
+    AddBranchWeights(func_idx, instructions, values, context);
+  }
+}
+
+void LLVMBackend::SetBranchProfile(const BranchProfile* profile) {
+  profile_ = profile;
+}
+
+void LLVMBackend::AddBranchWeights(int func_idx,
+                                   const std::vector<uint64_t>& instructions,
+                                   const std::vector<llvm::Value*>& values,
+                                   llvm::LLVMContext* context) {
+  llvm::MDBuilder md_builder(*context);
+  for (int instr_idx = 0; instr_idx < instructions.size(); instr_idx++) {
+    auto branch = llvm::dyn_cast_or_null<llvm::BranchInst>(values[instr_idx]);
+    if (branch == nullptr || !branch->isConditional()) {
+      continue;
+    }
+
+    auto weights = profile_->Weights(func_idx, instr_idx);
+    if (!weights.has_value()) {
+      continue;
+    }
+
+    // Scale the counts down to fit the 32 bit weights.
+    auto [taken, not_taken] = weights.value();
+    auto scale = std::max(taken, not_taken) / UINT32_MAX + 1;
+    branch->setMetadata(
+        llvm::LLVMContext::MD_prof,
+        md_builder.createBranchWeights(taken / scale, not_taken / scale));
+  }
 }
 
 double LLVMBackend::CompilationTime() { return compilation_time_; }
 
 void LLVMBackend::ResetCompilationTime() { compilation_time_ = 0; }
 
-void LLVMBackend::Translate(std::string_view name) {
+void LLVMBackend::Translate(std::string_view name, LLVMOptLevel level) {
+  util::PhaseTimer timer("llvm_translate");
   auto context = std::make_unique<llvm::LLVMContext>();
   auto mod = std::make_unique<llvm::Module>("query", *context);
   auto builder = std::make_unique<llvm::IRBuilder<>>(*context);
@@ -460,7 +578,8 @@ void LLVMBackend::Translate(std::string_view name) {
   int id = -1;
   functions_ = std::vector<llvm::Function*>(funcs.size(), nullptr);
   for (int i = 0; i < funcs.size(); i++) {
-    if (funcs[i].External() || compiled_fn_.contains(funcs[i].Name())) {
+    if (funcs[i].External() ||
+        compiled_fn_.contains({std::string(funcs[i].Name()), level})) {
       functions_[i] = DeclareFunction(funcs[i], mod.get(), types);
     }
 
@@ -481,11 +600,12 @@ void LLVMBackend::Translate(std::string_view name) {
     auto curr = to_translate_.front();
     to_translate_.pop();
     to_add.push_back(funcs[curr].Name());
-    TranslateFunction(funcs[curr], mod.get(), context.get(), builder.get(),
-                      types, constant_values);
+    TranslateFunction(curr, mod.get(), context.get(), builder.get(), types,
+                      constant_values);
   }
+  timer.Stop();
 
-  CompileAndLink(std::move(mod), std::move(context), to_add);
+  CompileAndLink(std::move(mod), std::move(context), to_add, level);
 }
 
 using LLVMCmp = llvm::CmpInst::Predicate;
@@ -620,6 +740,18 @@ void LLVMBackend::TranslateInstr(
       return;
     }
 
+    case Opcode::I64_CRC32: {
+      Type2InstructionReader reader(instr);
+      auto v0 = GetValue(Value(reader.Arg0()), constant_values, values, mod,
+                         context, builder, types);
+      auto v1 = GetValue(Value(reader.Arg1()), constant_values, values, mod,
+                         context, builder, types);
+      auto crc32 = llvm::Intrinsic::getDeclaration(
+          mod, llvm::Intrinsic::x86_sse42_crc32_64_64);
+      values[instr_idx] = builder->CreateCall(crc32, {v0, v1});
+      return;
+    }
+
     case Opcode::I1_CMP_EQ:
     case Opcode::I1_CMP_NE:
     case Opcode::I8_CMP_EQ:
@@ -795,6 +927,14 @@ void LLVMBackend::TranslateInstr(
       return;
     }
 
+    case Opcode::I32_SEXT_I64: {
+      Type2InstructionReader reader(instr);
+      auto v = GetValue(Value(reader.Arg0()), constant_values, values, mod,
+                        context, builder, types);
+      values[instr_idx] = builder->CreateSExt(v, builder->getInt64Ty());
+      return;
+    }
+
     case Opcode::I32_VEC8_PERMUTE: {
       Type2InstructionReader reader(instr);
       auto v0 = GetValue(Value(reader.Arg0()), constant_values, values, mod,
@@ -1124,8 +1264,11 @@ void LLVMBackend::TranslateInstr(
         auto ptr_as_int = builder->CreatePtrToInt(ptr, builder->getInt64Ty());
         auto ptr_offset1 = builder->CreateAdd(
             ptr_as_int,
-            builder->CreateMul(builder->CreateZExt(idx, builder->getInt64Ty()),
-                               builder->getInt64(type_size)));
+            builder->CreateMul(
+                reader.Metadata() == GEP_I64_INDEX
+                    ? idx
+                    : builder->CreateZExt(idx, builder->getInt64Ty()),
+                builder->getInt64(type_size)));
         auto ptr_offset1_offset2 = builder->CreateAdd(
             ptr_offset1, builder->CreateZExt(offset, builder->getInt64Ty()));
         base = builder->CreateIntToPtr(ptr_offset1_offset2,
@@ -1213,19 +1356,82 @@ void LLVMBackend::TranslateInstr(
   }
 }
 
+void LLVMBackend::Optimize(llvm::Module& mod, LLVMOptLevel level) {
+  llvm::LoopAnalysisManager lam;
+  llvm::FunctionAnalysisManager fam;
+  llvm::CGSCCAnalysisManager cgam;
+  llvm::ModuleAnalysisManager mam;
+
+  llvm::PipelineTuningOptions options;
+  options.LoopUnrolling = true;
+  options.LoopVectorization = true;
+  options.SLPVectorization = true;
+
+  llvm::PassBuilder pass_builder(target_machine_.get(), options);
+  pass_builder.registerModuleAnalyses(mam);
+  pass_builder.registerCGSCCAnalyses(cgam);
+  pass_builder.registerFunctionAnalyses(fam);
+  pass_builder.registerLoopAnalyses(lam);
+  pass_builder.crossRegisterProxies(lam, fam, cgam, mam);
+
+  llvm::ModulePassManager pass;
+  switch (level) {
+    case LLVMOptLevel::FAST: {
+      llvm::FunctionPassManager function_pass;
+      function_pass.addPass(llvm::InstCombinePass());
+      function_pass.addPass(llvm::ReassociatePass());
+      function_pass.addPass(llvm::GVNPass());
+      function_pass.addPass(llvm::SimplifyCFGPass());
+      function_pass.addPass(llvm::ADCEPass());
+      function_pass.addPass(llvm::SimplifyCFGPass());
+      pass.addPass(
+          llvm::createModuleToFunctionPassAdaptor(std::move(function_pass)));
+      break;
+    }
+
+    case LLVMOptLevel::O1:
+      pass = pass_builder.buildPerModuleDefaultPipeline(
+          llvm::OptimizationLevel::O1);
+      break;
+
+    case LLVMOptLevel::O2:
+      pass = pass_builder.buildPerModuleDefaultPipeline(
+          llvm::OptimizationLevel::O2);
+      break;
+
+    case LLVMOptLevel::O3:
+      pass = pass_builder.buildPerModuleDefaultPipeline(
+          llvm::OptimizationLevel::O3);
+      break;
+  }
+
+  pass.run(mod, mam);
+}
+
 void LLVMBackend::CompileAndLink(std::unique_ptr<llvm::Module> mod,
                                  std::unique_ptr<llvm::LLVMContext> context,
-                                 const std::vector<std::string_view>& to_add) {
+                                 const std::vector<std::string_view>& to_add,
+                                 LLVMOptLevel level) {
   llvm::verifyModule(*mod, &llvm::errs());
 
-  llvm::legacy::PassManager pass;
-  pass.add(llvm::createInstructionCombiningPass());
-  pass.add(llvm::createReassociatePass());
-  pass.add(llvm::createGVNPass());
-  pass.add(llvm::createCFGSimplificationPass());
-  pass.add(llvm::createAggressiveDCEPass());
-  pass.add(llvm::createCFGSimplificationPass());
-  pass.run(*mod);
+  mod->setDataLayout(target_machine_->createDataLayout());
+  mod->setTargetTriple(target_machine_->getTargetTriple().str());
+  {
+    util::PhaseTimer timer("llvm_optimize");
+    Optimize(*mod, level);
+  }
+
+  auto& stats = util::QueryStats::Get();
+  if (stats.Enabled()) {
+    for (const auto& func : *mod) {
+      if (!func.isDeclaration()) {
+        auto name = func.getName();
+        stats.SetInstructionCount("llvm",
+                                  std::string_view(name.data(), name.size()),
+                                  func.getInstructionCount());
+      }
+    }
+  }
 
 #if PROFILE_ENABLED
   for (auto& func : *mod) {
@@ -1233,27 +1439,56 @@ void LLVMBackend::CompileAndLink(std::unique_ptr<llvm::Module> mod,
   }
 #endif
 
+  // Machine code is generated on the first lookup.
+  util::PhaseTimer timer("llvm_codegen");
+  auto& dylib = GetDylib(level);
   cantFail(jit_->addIRModule(
-      llvm::orc::ThreadSafeModule(std::move(mod), std::move(context))));
+      dylib, llvm::orc::ThreadSafeModule(std::move(mod), std::move(context))));
 
   for (auto name : to_add) {
-    compiled_fn_[name] = (void*)jit_->lookup(name)->getAddress();
+    compiled_fn_[{std::string(name), level}] =
+        (void*)jit_->lookup(dylib, name)->getAddress();
   }
 }
 
+llvm::orc::JITDylib& LLVMBackend::GetDylib(LLVMOptLevel level) {
+  // Functions of each level are defined in their own dylib so that the same
+  // function can exist at several levels. FAST uses the main dylib which also
+  // holds the globals and external functions. LLJIT links every new dylib
+  // against the main one.
+  if (level == LLVMOptLevel::FAST) {
+    return jit_->getMainJITDylib();
+  }
+
+  auto it = dylibs_.find(level);
+  if (it != dylibs_.end()) {
+    return *it->second;
+  }
+
+  auto& dylib = cantFail(
+      jit_->createJITDylib("query_" + std::to_string(static_cast<int>(level))));
+  dylibs_[level] = &dylib;
+  return dylib;
+}
+
 void* LLVMBackend::GetFunction(std::string_view name) {
-  if (!compiled_fn_.contains(name)) {
+  return GetFunction(name, GetLLVMOptLevel().value_or(LLVMOptLevel::FAST));
+}
+
+void* LLVMBackend::GetFunction(std::string_view name, LLVMOptLevel level) {
+  std::pair<std::string, LLVMOptLevel> key(name, level);
+  if (!compiled_fn_.contains(key)) {
 #ifdef COMP_TIME
     auto t1 = std::chrono::high_resolution_clock::now();
 #endif
-    Translate(name);
+    Translate(name, level);
 #ifdef COMP_TIME
     auto t2 = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double, std::milli> fp_ms = t2 - t1;
     compilation_time_ += fp_ms.count();
 #endif
   }
-  return compiled_fn_.at(name);
+  return compiled_fn_.at(key);
 }
 
 }  // namespace kush::khir
\ No newline at end of file
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <optional>
+#include <string>
+#include <utility>
+
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Target/TargetMachine.h"
 
 #include "khir/backend.h"
+#include "khir/branch_profile.h"
 #include "khir/program.h"
 #include "khir/type_manager.h"
 
@@ -40,24 +46,46 @@ class LLVMTypeManager : public TypeTranslator {
   std::vector<llvm::Type*> types_;
 };
 
+// FAST runs a short list of scalar cleanups, O1-O3 the default new pass
+// manager pipelines including loop unrolling and vectorization.
+enum class LLVMOptLevel { FAST, O1, O2, O3 };
+
+// Optimization level set by flag or std::nullopt if the level should be
+// picked per function by the executor.
+std::optional<LLVMOptLevel> GetLLVMOptLevel();
+
 class LLVMBackend : public Backend {
  public:
   LLVMBackend(const khir::Program& program);
   virtual ~LLVMBackend() = default;
 
+  // Compiles at the flag's level, or FAST if the level is adaptive.
   void* GetFunction(std::string_view name) override;
+  // Each level is compiled separately so a function can be tiered up to a
+  // higher level after it was compiled at a lower one.
+  void* GetFunction(std::string_view name, LLVMOptLevel level);
+
+  // Attaches the branch counts of profile as branch weights to every function
+  // translated from now on.
+  void SetBranchProfile(const BranchProfile* profile);
   static double CompilationTime();
   static void ResetCompilationTime();
 
  private:
-  void Translate(std::string_view name);
-  void TranslateFunction(const Function& func, llvm::Module* mod,
+  void Translate(std::string_view name, LLVMOptLevel level);
+  void TranslateFunction(int func_idx, llvm::Module* mod,
                          llvm::LLVMContext* context, llvm::IRBuilder<>* builder,
                          const std::vector<llvm::Type*>& types,
                          std::vector<llvm::Constant*>& constant_values);
+  void AddBranchWeights(int func_idx, const std::vector<uint64_t>& instructions,
+                        const std::vector<llvm::Value*>& values,
+                        llvm::LLVMContext* context);
+  void Optimize(llvm::Module& mod, LLVMOptLevel level);
+  llvm::orc::JITDylib& GetDylib(LLVMOptLevel level);
   void CompileAndLink(std::unique_ptr<llvm::Module> mod,
                       std::unique_ptr<llvm::LLVMContext> context,
-                      const std::vector<std::string_view>& to_add);
+                      const std::vector<std::string_view>& to_add,
+                      LLVMOptLevel level);
   llvm::Constant* GetConstant(Value v, llvm::Module* mod,
                               llvm::LLVMContext* context,
                               llvm::IRBuilder<>* builder,
@@ -83,8 +111,12 @@ class LLVMBackend : public Backend {
           phi_member_list);
 
   const khir::Program& program_;
+  const BranchProfile* profile_;
+  std::unique_ptr<llvm::TargetMachine> target_machine_;
   std::unique_ptr<llvm::orc::LLJIT> jit_;
-  absl::flat_hash_map<std::string, void*> compiled_fn_;
+  absl::flat_hash_map<LLVMOptLevel, llvm::orc::JITDylib*> dylibs_;
+  absl::flat_hash_map<std::pair<std::string, LLVMOptLevel>, void*>
+      compiled_fn_;
   std::queue<int> to_translate_;
   std::vector<llvm::Function*> functions_;
 
@@ -83,6 +83,7 @@ enum class Opcode : uint8_t {
   MASK_TO_PERMUTE,
   I32_VEC8_PERMUTE,
   I32_ZEXT_I64,
+  I32_SEXT_I64,
   I32_CONV_F64,
   I32_CONV_I32_VEC8,
   I32_VEC8_ADD,
@@ -97,6 +98,7 @@ enum class Opcode : uint8_t {
   I64_AND,
   I64_XOR,
   I64_OR,
+  I64_CRC32,
   I64_TRUNC_I16,
   I64_TRUNC_I32,
   I64_CMP_EQ,
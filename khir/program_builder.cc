@@ -242,6 +242,37 @@ bool ProgramBuilder::IsTerminated(BasicBlockRef b) {
   return functions_[b.GetFunctionID()].IsTerminated(b.GetBasicBlockID());
 }
 
+bool ProgramBuilder::Dominates(BasicBlockRef a, BasicBlockRef b) {
+  if (a.GetFunctionID() != b.GetFunctionID()) {
+    return false;
+  }
+
+  const auto& pred = functions_[b.GetFunctionID()].BasicBlockPredecessors();
+  std::vector<bool> visited(pred.size(), false);
+  visited[a.GetBasicBlockID()] = true;
+
+  // Search backward from b without passing through a. Reaching the entry
+  // block, or a block with no known predecessors, means a may be bypassed.
+  std::vector<int> stack{b.GetBasicBlockID()};
+  while (!stack.empty()) {
+    int curr = stack.back();
+    stack.pop_back();
+    if (visited[curr]) {
+      continue;
+    }
+    visited[curr] = true;
+
+    if (curr == 0 || pred[curr].empty()) {
+      return false;
+    }
+
+    for (int p : pred[curr]) {
+      stack.push_back(p);
+    }
+  }
+  return true;
+}
+
 void ProgramBuilder::SetCurrentBlock(BasicBlockRef b) {
   // Switching within a function, not allowed unless terminated
   // Switching between functions is fine
@@ -660,10 +691,12 @@ Type ProgramBuilder::TypeOf(Value value) const {
     case Opcode::I64_AND:
     case Opcode::I64_XOR:
     case Opcode::I64_OR:
+    case Opcode::I64_CRC32:
     case Opcode::I1_ZEXT_I64:
     case Opcode::I8_ZEXT_I64:
     case Opcode::I16_ZEXT_I64:
     case Opcode::I32_ZEXT_I64:
+    case Opcode::I32_SEXT_I64:
     case Opcode::F64_CONV_I64:
     case Opcode::I64_LOAD:
       return type_manager_.I64Type();
@@ -1771,6 +1804,21 @@ Value ProgramBuilder::I64ZextI32(Value v) {
           .Build());
 }
 
+Value ProgramBuilder::I64SextI32(Value v) {
+  if (v.IsConstantGlobal()) {
+    int32_t value =
+        Type1InstructionReader(constant_instrs_[v.GetIdx()]).Constant();
+    int64_t value_sext = value;
+    return ConstI64(value_sext);
+  }
+
+  return GetCurrentFunction().Append(
+      Type2InstructionBuilder()
+          .SetOpcode(OpcodeTo(Opcode::I32_SEXT_I64))
+          .SetArg0(v.Serialize())
+          .Build());
+}
+
 Value ProgramBuilder::F64ConvI32(Value v) {
   if (v.IsConstantGlobal()) {
     int32_t value =
@@ -1989,6 +2037,14 @@ Value ProgramBuilder::OrI64(Value v1, Value v2) {
                                          .Build());
 }
 
+Value ProgramBuilder::Crc32I64(Value crc, Value v) {
+  return GetCurrentFunction().Append(Type2InstructionBuilder()
+                                         .SetOpcode(OpcodeTo(Opcode::I64_CRC32))
+                                         .SetArg0(crc.Serialize())
+                                         .SetArg1(v.Serialize())
+                                         .Build());
+}
+
 Value ProgramBuilder::CmpI64(CompType cmp, Value v1, Value v2) {
   if (v1.IsConstantGlobal() && v2.IsConstantGlobal()) {
     int64_t value1 =
@@ -2435,11 +2491,22 @@ Value ProgramBuilder::StaticGEP(Type t, Value v,
 
 Value ProgramBuilder::DynamicGEP(Type t, Value v, Value dynamic_idx,
                                  absl::Span<const int32_t> idx) {
+  bool i64_index = TypeOf(dynamic_idx) == type_manager_.I64Type();
+
   if (dynamic_idx.IsConstantGlobal()) {
-    std::vector<int> idxs;
-    idxs.push_back(
+    auto constant =
         Type1InstructionReader(constant_instrs_[dynamic_idx.GetIdx()])
-            .Constant());
+            .Constant();
+    std::vector<int> idxs;
+    if (i64_index) {
+      int64_t value = i64_constants_[constant];
+      if (value < INT32_MIN || value > INT32_MAX) {
+        throw std::runtime_error("Constant GEP index out of range.");
+      }
+      idxs.push_back(value);
+    } else {
+      idxs.push_back(constant);
+    }
     idxs.insert(idxs.end(), idx.begin(), idx.end());
     return StaticGEP(t, v, idxs);
   }
@@ -2462,6 +2529,7 @@ Value ProgramBuilder::DynamicGEP(Type t, Value v, Value dynamic_idx,
 
   GetCurrentFunction().Append(
       Type2InstructionBuilder()
+          .SetMetadata(i64_index ? GEP_I64_INDEX : 0)
           .SetOpcode(OpcodeTo(Opcode::GEP_DYNAMIC_OFFSET))
           .SetArg0(dynamic_idx.Serialize())
           .SetArg1(offset_v.Serialize())
@@ -137,6 +137,11 @@ class ProgramBuilder {
   BasicBlockRef GenerateBlock();
   BasicBlockRef CurrentBlock();
   bool IsTerminated(BasicBlockRef b);
+  // Whether every path built so far from the entry of b's function to b passes
+  // through a. Edges added later are assumed to be loop back edges, which
+  // leave dominance unchanged; blocks with no predecessors yet are treated as
+  // not dominated.
+  bool Dominates(BasicBlockRef a, BasicBlockRef b);
   void SetCurrentBlock(BasicBlockRef b);
   void Branch(BasicBlockRef b);
   void Branch(Value cond, BasicBlockRef b1, BasicBlockRef b2);
@@ -196,6 +201,7 @@ class ProgramBuilder {
   Value CmpEqConstI32(Value v1, std::array<int32_t, 4> v2);
   Value CmpEqConstI32(Value v1, std::array<int32_t, 8> v2);
   Value I64ZextI32(Value v);
+  Value I64SextI32(Value v);
   Value F64ConvI32(Value v);
   Value I32Vec8ConvI32(Value v);
   Value LoadI32(Value ptr);
@@ -229,6 +235,7 @@ class ProgramBuilder {
   Value AndI64(Value v1, Value v2);
   Value XorI64(Value v1, Value v2);
   Value OrI64(Value v1, Value v2);
+  Value Crc32I64(Value crc, Value v);
   Value I16TruncI64(Value v);
   Value I32TruncI64(Value v);
   Value LoadI64(Value ptr);
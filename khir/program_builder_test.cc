@@ -0,0 +1,87 @@
+#include "khir/program_builder.h"
+
+#include "gtest/gtest.h"
+
+using namespace kush;
+using namespace kush::khir;
+
+TEST(ProgramBuilderTest, DominatesDiamond) {
+  ProgramBuilder program;
+  auto func = program.CreateNamedFunction(program.I64Type(),
+                                          {program.I1Type()}, "compute");
+  auto args = program.GetFunctionArguments(func);
+  auto entry = program.CurrentBlock();
+
+  auto bb1 = program.GenerateBlock();
+  auto bb2 = program.GenerateBlock();
+  auto bb3 = program.GenerateBlock();
+
+  program.Branch(args[0], bb1, bb2);
+
+  program.SetCurrentBlock(bb1);
+  program.Branch(bb3);
+
+  program.SetCurrentBlock(bb2);
+  program.Branch(bb3);
+
+  program.SetCurrentBlock(bb3);
+  program.Return(program.ConstI64(0));
+
+  EXPECT_TRUE(program.Dominates(entry, bb3));
+  EXPECT_TRUE(program.Dominates(bb1, bb1));
+  EXPECT_FALSE(program.Dominates(bb1, bb3));
+  EXPECT_FALSE(program.Dominates(bb1, bb2));
+  EXPECT_FALSE(program.Dominates(bb3, entry));
+}
+
+TEST(ProgramBuilderTest, DominatesLoop) {
+  ProgramBuilder program;
+  auto func = program.CreateNamedFunction(program.I64Type(),
+                                          {program.I1Type()}, "compute");
+  auto args = program.GetFunctionArguments(func);
+
+  auto header = program.GenerateBlock();
+  auto body = program.GenerateBlock();
+  auto exit = program.GenerateBlock();
+
+  program.Branch(header);
+
+  program.SetCurrentBlock(header);
+  program.Branch(args[0], body, exit);
+
+  program.SetCurrentBlock(body);
+  EXPECT_TRUE(program.Dominates(header, body));
+  program.Branch(header);
+  EXPECT_TRUE(program.Dominates(header, body));
+  EXPECT_FALSE(program.Dominates(body, header));
+
+  program.SetCurrentBlock(exit);
+  EXPECT_TRUE(program.Dominates(header, exit));
+  EXPECT_FALSE(program.Dominates(body, exit));
+  program.Return(program.ConstI64(0));
+}
+
+TEST(ProgramBuilderTest, DominatesUnreachedBlock) {
+  ProgramBuilder program;
+  program.CreateNamedFunction(program.I64Type(), {}, "compute");
+  auto entry = program.CurrentBlock();
+  auto bb1 = program.GenerateBlock();
+
+  EXPECT_FALSE(program.Dominates(entry, bb1));
+
+  program.Branch(bb1);
+  EXPECT_TRUE(program.Dominates(entry, bb1));
+}
+
+TEST(ProgramBuilderTest, DominatesAcrossFunctions) {
+  ProgramBuilder program;
+  program.CreateNamedFunction(program.I64Type(), {}, "f1");
+  auto f1_entry = program.CurrentBlock();
+  program.Return(program.ConstI64(0));
+
+  program.CreateNamedFunction(program.I64Type(), {}, "f2");
+  auto f2_entry = program.CurrentBlock();
+  program.Return(program.ConstI64(0));
+
+  EXPECT_FALSE(program.Dominates(f1_entry, f2_entry));
+}
@@ -181,6 +181,7 @@ void ProgramPrinter::OutputInstr(int idx, const Function& func) {
     case Opcode::I64_RSHIFT:
     case Opcode::I64_AND:
     case Opcode::I64_XOR:
+    case Opcode::I64_CRC32:
     case Opcode::I64_OR:
     case Opcode::I64_MUL:
     case Opcode::I64_SUB:
@@ -229,6 +230,7 @@ void ProgramPrinter::OutputInstr(int idx, const Function& func) {
     case Opcode::I16_ZEXT_I64:
     case Opcode::I16_CONV_F64:
     case Opcode::I32_ZEXT_I64:
+    case Opcode::I32_SEXT_I64:
     case Opcode::I32_CONV_I32_VEC8:
     case Opcode::I32_CONV_F64:
     case Opcode::I64_CONV_F64:
@@ -9,6 +9,7 @@
 #include "nlohmann/json.hpp"
 #include "plan/expression/expression.h"
 #include "plan/expression/expression_visitor.h"
+#include "runtime/like.h"
 
 namespace kush::plan {
 
@@ -192,4 +193,29 @@ nlohmann::json RegexpMatchingExpression::ToJson() const {
 
 re2::RE2* RegexpMatchingExpression::Regex() const { return regexp_.get(); }
 
+LikeExpression::LikeExpression(std::unique_ptr<Expression> child,
+                               std::unique_ptr<runtime::Like::Pattern> pattern)
+    : UnaryExpression(CalculateRegexpType(child->Type()), false,
+                      std::move(child)),
+      pattern_(std::move(pattern)) {}
+
+void LikeExpression::Accept(ExpressionVisitor& visitor) {
+  return visitor.Visit(*this);
+}
+
+void LikeExpression::Accept(ImmutableExpressionVisitor& visitor) const {
+  return visitor.Visit(*this);
+}
+
+nlohmann::json LikeExpression::ToJson() const {
+  nlohmann::json j;
+  j["child"] = Child().ToJson();
+  j["pattern"] = pattern_->Text();
+  return j;
+}
+
+runtime::Like::Pattern* LikeExpression::Pattern() const {
+  return pattern_.get();
+}
+
 }  // namespace kush::plan
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "nlohmann/json.hpp"
 #include "plan/expression/expression.h"
 #include "plan/expression/expression_visitor.h"
+#include "runtime/like.h"
 
 namespace kush::plan {
 
@@ -82,4 +83,20 @@ class RegexpMatchingExpression : public UnaryExpression {
   std::unique_ptr<re2::RE2> regexp_;
 };
 
+class LikeExpression : public UnaryExpression {
+ public:
+  LikeExpression(std::unique_ptr<Expression> child,
+                 std::unique_ptr<runtime::Like::Pattern> pattern);
+
+  void Accept(ExpressionVisitor& visitor) override;
+  void Accept(ImmutableExpressionVisitor& visitor) const override;
+
+  runtime::Like::Pattern* Pattern() const;
+
+  nlohmann::json ToJson() const override;
+
+ private:
+  std::unique_ptr<runtime::Like::Pattern> pattern_;
+};
+
 }  // namespace kush::plan
\ No newline at end of file
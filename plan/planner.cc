@@ -5,8 +5,6 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 
-#include "re2/re2.h"
-
 #include "catalog/catalog_manager.h"
 #include "parse/expression/aggregate_expression.h"
 #include "parse/expression/arithmetic_expression.h"
@@ -30,6 +28,7 @@
 #include "plan/operator/select_operator.h"
 #include "plan/operator/skinner_join_operator.h"
 #include "runtime/enum.h"
+#include "runtime/like.h"
 #include "util/vector_util.h"
 
 namespace kush::plan {
@@ -244,84 +243,9 @@ std::unique_ptr<Expression> Planner::Plan(
       const auto& right_parsed = expr.RightChild();
       if (auto literal =
               dynamic_cast<const parse::LiteralExpression*>(&right_parsed)) {
-        auto match = literal->GetValue();
-
-        if (match.size() >= 1 && match.front() == '%') {
-          std::string_view match_info(match);
-          match_info.remove_prefix(1);
-
-          if (match_info.find('%') == std::string::npos) {
-            return std::make_unique<BinaryArithmeticExpression>(
-                BinaryArithmeticExpressionType::STARTS_WITH,
-                Plan(expr.LeftChild()),
-                std::make_unique<LiteralExpression>(match_info));
-          }
-        }
-
-        if (match.size() >= 1 && match.back() == '%') {
-          std::string_view match_info(match);
-          match_info.remove_suffix(1);
-          if (match_info.find('%') == std::string::npos) {
-            return std::make_unique<BinaryArithmeticExpression>(
-                BinaryArithmeticExpressionType::ENDS_WITH,
-                Plan(expr.LeftChild()),
-                std::make_unique<LiteralExpression>(match_info));
-          }
-        }
-
-        if (match.size() >= 2 && match.front() == '%' && match.back() == '%') {
-          std::string_view match_info(match);
-          match_info.remove_prefix(1);
-          match_info.remove_suffix(1);
-          if (match_info.find('%') == std::string::npos) {
-            return std::make_unique<BinaryArithmeticExpression>(
-                BinaryArithmeticExpressionType::CONTAINS,
-                Plan(expr.LeftChild()),
-                std::make_unique<LiteralExpression>(match_info));
-          }
-        }
-
-        // convert each paren into escape
-        std::string regex = "^";
-        for (auto c : match) {
-          switch (c) {
-            case '.':
-            case '+':
-            case '*':
-            case '?':
-            case '^':
-            case '$':
-            case '(':
-            case ')':
-            case '[':
-            case ']':
-            case '{':
-            case '}':
-            case '|':
-            case '\\':
-              regex.push_back('\\');
-              regex.push_back(c);
-              break;
-
-            case '_':
-              regex.push_back('.');
-              break;
-
-            case '%':
-              regex.push_back('.');
-              regex.push_back('*');
-              break;
-
-            default:
-              regex.push_back(c);
-              break;
-          }
-        }
-        regex.push_back('$');
-
-        return std::make_unique<RegexpMatchingExpression>(
-            Plan(expr.LeftChild()), std::make_unique<re2::RE2>(regex));
-
+        return std::make_unique<LikeExpression>(
+            Plan(expr.LeftChild()),
+            std::make_unique<runtime::Like::Pattern>(literal->GetValue()));
       } else {
         throw std::runtime_error("Non const argument to like");
       }
@@ -4,6 +4,8 @@
 #include <cstring>
 #include <iostream>
 
+#include "runtime/allocator.h"
+
 namespace kush::runtime::AggregateHashTable {
 
 void Init(AggregateHashTable* ht, uint16_t payload_size,
@@ -14,31 +16,31 @@ void Init(AggregateHashTable* ht, uint16_t payload_size,
   ht->capacity = 1024;
   ht->mask = ht->capacity - 1;
   ht->size = 0;
-  ht->entries = new uint64_t[ht->capacity];
+  ht->entries = reinterpret_cast<uint64_t*>(
+      runtime::Allocate(sizeof(uint64_t) * ht->capacity));
   memset(ht->entries, 0, sizeof(uint64_t) * ht->capacity);
 
   ht->payload_block_size = 2;
   ht->payload_block_capacity = 4;
-  ht->payload_block = new uint8_t*[ht->payload_block_capacity];
+  ht->payload_block = reinterpret_cast<uint8_t**>(
+      runtime::Allocate(sizeof(uint8_t*) * ht->payload_block_capacity));
   // skip block 0 bc use it as empty slot marker
   ht->payload_block[0] = nullptr;
   // block 1
-  ht->payload_block[1] = new uint8_t[BLOCK_SIZE];
+  ht->payload_block[1] = runtime::Allocate(BLOCK_SIZE);
   ht->last_payload_offset = 0;
 }
 
 void AllocateNewPage(AggregateHashTable* ht) {
   if (ht->payload_block_size == ht->payload_block_capacity) {
     auto new_capacity = ht->payload_block_capacity * 2;
-    auto new_payload_block = new uint8_t*[new_capacity];
-    memcpy(new_payload_block, ht->payload_block,
-           sizeof(uint8_t*) * ht->payload_block_capacity);
-    delete[] ht->payload_block;
-    ht->payload_block = new_payload_block;
+    ht->payload_block = reinterpret_cast<uint8_t**>(runtime::Reallocate(
+        ht->payload_block, sizeof(uint8_t*) * ht->payload_block_capacity,
+        sizeof(uint8_t*) * new_capacity));
     ht->payload_block_capacity = new_capacity;
   }
 
-  ht->payload_block[ht->payload_block_size] = new uint8_t[BLOCK_SIZE];
+  ht->payload_block[ht->payload_block_size] = runtime::Allocate(BLOCK_SIZE);
   ht->payload_block_size++;
   ht->last_payload_offset = 0;
 }
@@ -60,7 +62,8 @@ void Resize(AggregateHashTable* ht) {
   auto capacity = ht->capacity * 2;
   auto mask = capacity - 1;
 
-  auto entries = new uint64_t[capacity];
+  auto entries = reinterpret_cast<uint64_t*>(
+      runtime::Allocate(sizeof(uint64_t) * capacity));
   memset(entries, 0, sizeof(uint64_t) * capacity);
 
   for (uint32_t block_idx = 1; block_idx < ht->payload_block_size;
@@ -84,19 +87,20 @@ void Resize(AggregateHashTable* ht) {
     }
   }
 
-  delete[] ht->entries;
+  runtime::Free(ht->entries, sizeof(uint64_t) * ht->capacity);
   ht->entries = entries;
   ht->capacity = capacity;
   ht->mask = mask;
 }
 
 void Free(AggregateHashTable* ht) {
-  delete[] ht->entries;
+  runtime::Free(ht->entries, sizeof(uint64_t) * ht->capacity);
 
-  for (int i = 0; i < ht->payload_block_size; i++) {
-    delete[] ht->payload_block[i];
+  for (int i = 1; i < ht->payload_block_size; i++) {
+    runtime::Free(ht->payload_block[i], BLOCK_SIZE);
   }
-  delete[] ht->payload_block;
+  runtime::Free(ht->payload_block,
+                sizeof(uint8_t*) * ht->payload_block_capacity);
 }
 
 void* GetPayload(AggregateHashTable* ht, uint32_t block_idx,
@@ -1,34 +1,145 @@
 #include "runtime/allocator.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <vector>
 
 namespace kush::runtime {
 
-constexpr std::size_t PAGE_SIZE = 1 << 16;
+namespace {
 
-Allocator::Allocator() : data_offset_(PAGE_SIZE) {}
+constexpr std::size_t ALIGNMENT = 16;
+
+// Sizes up to this are rounded up to a multiple of ALIGNMENT. Larger sizes are
+// rounded up to a power of 2.
+constexpr std::size_t MAX_SMALL_SIZE = 512;
+constexpr int NUM_SMALL_CLASSES = MAX_SMALL_SIZE / ALIGNMENT;
+
+thread_local Allocator* current = nullptr;
+
+}  // namespace
+
+Allocator::Allocator() : data_offset_(PAGE_SIZE) { free_lists_.fill(nullptr); }
+
+int Allocator::SizeClass(std::size_t s) {
+  if (s <= MAX_SMALL_SIZE) {
+    return s == 0 ? 0 : (s - 1) / ALIGNMENT;
+  }
+
+  // 513-1024 is the first class after the small ones.
+  return NUM_SMALL_CLASSES + (64 - __builtin_clzll(s - 1)) - 10;
+}
+
+std::size_t Allocator::ClassSize(int size_class) {
+  if (size_class < NUM_SMALL_CLASSES) {
+    return (size_class + 1) * ALIGNMENT;
+  }
+  return std::size_t(1) << (size_class - NUM_SMALL_CLASSES + 10);
+}
 
 uint8_t* Allocator::Allocate(std::size_t s) {
   if (s > PAGE_SIZE) {
-    pages_.push_front(new uint8_t[s]);
-    return pages_.front();
+    auto block = static_cast<uint8_t*>(malloc(s));
+    large_.insert(block);
+    return block;
   }
 
-  if (data_offset_ + s > PAGE_SIZE) {
+  auto size_class = SizeClass(s);
+  if (auto block = free_lists_[size_class]) {
+    free_lists_[size_class] = block->next;
+    return reinterpret_cast<uint8_t*>(block);
+  }
+
+  auto size = ClassSize(size_class);
+  if (data_offset_ + size > PAGE_SIZE) {
     pages_.push_back(new uint8_t[PAGE_SIZE]);
     data_offset_ = 0;
   }
 
   auto ret = pages_.back() + data_offset_;
-  data_offset_ += s;
+  data_offset_ += size;
   return ret;
 }
 
+uint8_t* Allocator::Reallocate(void* ptr, std::size_t old_size,
+                               std::size_t new_size) {
+  if (ptr == nullptr) {
+    return Allocate(new_size);
+  }
+
+  if (old_size > PAGE_SIZE && new_size > PAGE_SIZE) {
+    large_.erase(ptr);
+    auto block = static_cast<uint8_t*>(realloc(ptr, new_size));
+    large_.insert(block);
+    return block;
+  }
+
+  if (old_size <= PAGE_SIZE && new_size <= PAGE_SIZE &&
+      SizeClass(old_size) == SizeClass(new_size)) {
+    return static_cast<uint8_t*>(ptr);
+  }
+
+  auto block = Allocate(new_size);
+  memcpy(block, ptr, std::min(old_size, new_size));
+  Free(ptr, old_size);
+  return block;
+}
+
+void Allocator::Free(void* ptr, std::size_t s) {
+  if (ptr == nullptr) {
+    return;
+  }
+
+  if (s > PAGE_SIZE) {
+    large_.erase(ptr);
+    free(ptr);
+    return;
+  }
+
+  auto size_class = SizeClass(s);
+  auto block = static_cast<FreeBlock*>(ptr);
+  block->next = free_lists_[size_class];
+  free_lists_[size_class] = block;
+}
+
 Allocator::~Allocator() {
   for (auto page : pages_) {
     delete[] page;
   }
+
+  for (auto block : large_) {
+    free(block);
+  }
 }
 
-}  // namespace kush::runtime
\ No newline at end of file
+uint8_t* Allocate(std::size_t s) {
+  if (current != nullptr) {
+    return current->Allocate(s);
+  }
+  return static_cast<uint8_t*>(malloc(s));
+}
+
+uint8_t* Reallocate(void* ptr, std::size_t old_size, std::size_t new_size) {
+  if (current != nullptr) {
+    return current->Reallocate(ptr, old_size, new_size);
+  }
+  return static_cast<uint8_t*>(realloc(ptr, new_size));
+}
+
+void Free(void* ptr, std::size_t s) {
+  if (current != nullptr) {
+    current->Free(ptr, s);
+    return;
+  }
+  free(ptr);
+}
+
+AllocatorScope::AllocatorScope(Allocator& allocator) : previous_(current) {
+  current = &allocator;
+}
+
+AllocatorScope::~AllocatorScope() { current = previous_; }
+
+}  // namespace kush::runtime
@@ -1,16 +1,32 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
-#include <deque>
 #include <memory>
+#include <new>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace kush::runtime {
 
+// Arena of 16 byte aligned blocks. Small blocks are bump allocated out of
+// pages and rounded up to a size class. Freed blocks are kept on a free list
+// per size class and reused by later allocations of the same class. Blocks
+// larger than a page are allocated individually. All memory is released when
+// the allocator is destroyed so blocks do not need to be freed.
+//
+// Not thread-safe.
 class Allocator final {
  public:
   Allocator();
-  virtual ~Allocator();
+  Allocator(const Allocator&) = delete;
+  Allocator& operator=(const Allocator&) = delete;
+  ~Allocator();
+
   uint8_t* Allocate(std::size_t s);
+  uint8_t* Reallocate(void* ptr, std::size_t old_size, std::size_t new_size);
+  void Free(void* ptr, std::size_t s);
 
   template <typename T, class... Args>
   T* Allocate(Args&&... args) {
@@ -19,8 +35,39 @@ class Allocator final {
   }
 
  private:
-  std::deque<uint8_t*> pages_;
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  constexpr static std::size_t PAGE_SIZE = 1 << 16;
+  constexpr static int NUM_SIZE_CLASSES = 39;
+
+  static int SizeClass(std::size_t s);
+  static std::size_t ClassSize(int size_class);
+
+  std::vector<uint8_t*> pages_;
   std::size_t data_offset_;
+  std::array<FreeBlock*, NUM_SIZE_CLASSES> free_lists_;
+  std::unordered_set<void*> large_;
+};
+
+// Runtime structures allocate through these, which use the allocator installed
+// on the calling thread by an AllocatorScope or malloc if there is none. A
+// block must be freed under the same allocator it was allocated from.
+uint8_t* Allocate(std::size_t s);
+uint8_t* Reallocate(void* ptr, std::size_t old_size, std::size_t new_size);
+void Free(void* ptr, std::size_t s);
+
+// Installs allocator on the calling thread for the lifetime of the scope.
+class AllocatorScope {
+ public:
+  explicit AllocatorScope(Allocator& allocator);
+  AllocatorScope(const AllocatorScope&) = delete;
+  AllocatorScope& operator=(const AllocatorScope&) = delete;
+  ~AllocatorScope();
+
+ private:
+  Allocator* previous_;
 };
 
-}  // namespace kush::runtime
\ No newline at end of file
+}  // namespace kush::runtime
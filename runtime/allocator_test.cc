@@ -0,0 +1,56 @@
+#include "runtime/allocator.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+using namespace kush::runtime;
+
+TEST(AllocatorTest, Aligned) {
+  Allocator allocator;
+  for (int s : {1, 7, 16, 33, 600, 5000, 1 << 17}) {
+    auto block = allocator.Allocate(s);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % 16, 0);
+    memset(block, 0xFF, s);
+  }
+}
+
+TEST(AllocatorTest, ReusesFreedBlocks) {
+  Allocator allocator;
+  auto a = allocator.Allocate(24);
+  allocator.Free(a, 24);
+  EXPECT_EQ(allocator.Allocate(32), a);
+
+  auto b = allocator.Allocate(700);
+  allocator.Free(b, 700);
+  EXPECT_EQ(allocator.Allocate(1024), b);
+  EXPECT_NE(allocator.Allocate(1025), b);
+}
+
+TEST(AllocatorTest, Reallocate) {
+  Allocator allocator;
+  auto a = allocator.Allocate(16);
+  memcpy(a, "0123456789abcdef", 16);
+
+  auto b = allocator.Reallocate(a, 16, 1 << 17);
+  EXPECT_EQ(memcmp(b, "0123456789abcdef", 16), 0);
+
+  auto c = allocator.Reallocate(b, 1 << 17, 1 << 18);
+  EXPECT_EQ(memcmp(c, "0123456789abcdef", 16), 0);
+
+  auto d = allocator.Reallocate(c, 1 << 18, 8);
+  EXPECT_EQ(memcmp(d, "01234567", 8), 0);
+}
+
+TEST(AllocatorTest, Scope) {
+  Allocator allocator;
+  auto outside = Allocate(16);
+  {
+    AllocatorScope scope(allocator);
+    auto a = Allocate(16);
+    Free(a, 16);
+    EXPECT_EQ(allocator.Allocate(16), a);
+  }
+  Free(outside, 16);
+}
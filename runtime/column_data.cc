@@ -56,7 +56,7 @@ void OpenText(TextColumnData* col, const char* path) {
 
 template <typename T>
 inline void CloseImpl(T* column) {
-  // TODO: update buffer pool manager to close
+  FileManager::Get().Close(column->data);
 }
 
 void CloseInt8(Int8ColumnData* col) { CloseImpl(col); }
@@ -69,7 +69,11 @@ void CloseInt64(Int64ColumnData* col) { CloseImpl(col); }
 
 void CloseFloat64(Float64ColumnData* col) { CloseImpl(col); }
 
-void CloseText(TextColumnData* col) { CloseImpl(col); }
+// Strings point into the file and may be stored in hash tables that outlive
+// the scan so the file stays pinned until the query ends.
+void CloseText(TextColumnData* col) {
+  FileManager::Get().CloseAtQueryEnd(col->data);
+}
 
 // ------ Size --------
 
@@ -111,8 +115,22 @@ double GetFloat64(Float64ColumnData* col, int32_t idx) {
 
 void GetText(TextColumnData* col, int32_t idx, String::String* dest) {
   const auto& slot = col->data->slot[idx];
-  dest->data = reinterpret_cast<const char*>(col->data) + slot.offset;
-  dest->length = slot.length;
+  std::memcpy(dest, &slot, sizeof(String::String));
+  if (!String::IsInlined(dest)) {
+    dest->ptr = reinterpret_cast<const char*>(col->data) + slot.offset;
+  }
+}
+
+void InitStringEntry(StringEntry* entry, std::string_view value,
+                     uint64_t offset) {
+  std::memset(entry, 0, sizeof(StringEntry));
+  entry->length = value.size();
+  if (value.size() <= String::INLINE_LENGTH) {
+    std::memcpy(entry->prefix, value.data(), value.size());
+  } else {
+    std::memcpy(entry->prefix, value.data(), sizeof(entry->prefix));
+    entry->offset = offset;
+  }
 }
 
 // ------ Serialize --------
@@ -186,8 +204,10 @@ void Serialize(std::string_view path,
   // 8 bytes for the metadata cardinality + sizeof(StringEntry) bytes per slot
   uint64_t length = 8 + sizeof(StringEntry) * contents.size();
 
-  // 1 byte per character + 1 null terminator
-  for (auto s : contents) length += s.size() + 1;
+  // 1 byte per character + 1 null terminator for strings not inlined
+  for (const auto& s : contents) {
+    if (s.size() > String::INLINE_LENGTH) length += s.size() + 1;
+  }
 
   if (posix_fallocate(fd, 0, length) != 0) {
     throw std::runtime_error(
@@ -208,11 +228,12 @@ void Serialize(std::string_view path,
   char* string_data_ = reinterpret_cast<char*>(data);
 
   for (int slot = 0; slot < contents.size(); slot++) {
-    int32_t length = contents[slot].size();
-    data->slot[slot].length = length;
-    data->slot[slot].offset = offset;
-    memcpy(string_data_ + offset, contents[slot].c_str(), length + 1);
-    offset += length + 1;
+    const auto& value = contents[slot];
+    InitStringEntry(&data->slot[slot], value, offset);
+    if (value.size() > String::INLINE_LENGTH) {
+      memcpy(string_data_ + offset, value.c_str(), value.size() + 1);
+      offset += value.size() + 1;
+    }
   }
 
   if (munmap(data, length) != 0) {
@@ -6,6 +6,7 @@
 #include <fcntl.h>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -42,10 +43,19 @@ struct Float64ColumnData {
   uint64_t file_length;
 };
 
+// Laid out like String::String so a slot is copied as is. The offset of a
+// string that is not inlined is relative to the start of the file.
 struct StringEntry {
   int32_t length;
-  uint64_t offset;
+  char prefix[4];
+  union {
+    char inlined[8];
+    uint64_t offset;
+  };
 };
+
+static_assert(sizeof(StringEntry) == sizeof(String::String));
+
 struct StringMetadata {
   int32_t cardinality;
   struct StringEntry slot[];
@@ -91,4 +101,9 @@ void GetText(TextColumnData* col, int32_t idx, String::String* dest);
 template <typename T>
 void Serialize(std::string_view path, const std::vector<T>& contents);
 
+// Fills in the slot of value. The offset is only used for strings that are
+// not inlined, which are then stored at that offset with a null terminator.
+void InitStringEntry(StringEntry* entry, std::string_view value,
+                     uint64_t offset);
+
 }  // namespace kush::runtime::ColumnData
\ No newline at end of file
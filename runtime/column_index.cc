@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "runtime/file_manager.h"
+#include "runtime/posting_list.h"
 
 namespace kush::runtime::ColumnIndex {
 
@@ -70,6 +71,33 @@ void Open(ColumnIndex* col, const char* path) {
   col->file_length = fi.file_length;
 }
 
+template <typename T>
+void PopulateBucket(ColumnIndexEntry<T>* entry, ColumnIndexBucket* dest) {
+  dest->size = entry->size;
+  dest->allocator = nullptr;
+  dest->capacity = 0;
+  dest->block = -1;
+
+  // A single tuple id is stored unencoded so it can be read in place.
+  if (entry->size == 1) {
+    dest->data = reinterpret_cast<int32_t*>(entry->values);
+    dest->encoded = nullptr;
+    return;
+  }
+
+  dest->data = nullptr;
+  dest->encoded = entry->values;
+}
+
+void PopulateEmptyBucket(ColumnIndexBucket* dest) {
+  dest->data = nullptr;
+  dest->size = 0;
+  dest->allocator = nullptr;
+  dest->capacity = 0;
+  dest->encoded = nullptr;
+  dest->block = -1;
+}
+
 template <typename T>
 void GetImpl(ColumnIndex* col, T key, ColumnIndexBucket* dest) {
   uint64_t key_as_64 = ToUInt64(key);
@@ -78,20 +106,13 @@ void GetImpl(ColumnIndex* col, T key, ColumnIndexBucket* dest) {
     auto entry = reinterpret_cast<ColumnIndexEntry<T>*>(
         reinterpret_cast<uint8_t*>(col->data) + pos);
     if (entry->key == key) {
-      dest->data = entry->values;
-      dest->size = entry->size;
-      dest->allocator = nullptr;
-      dest->capacity = 0;
+      PopulateBucket(entry, dest);
       return;
     }
     pos = entry->next;
   }
 
-  dest->data = nullptr;
-  dest->size = 0;
-  dest->allocator = nullptr;
-  dest->capacity = 0;
-  return;
+  PopulateEmptyBucket(dest);
 }
 
 void GetInt8(ColumnIndex* col, int8_t key, ColumnIndexBucket* dest) {
@@ -115,7 +136,7 @@ void GetFloat64(ColumnIndex* col, double key, ColumnIndexBucket* dest) {
 }
 
 void GetText(ColumnIndex* col, String::String* key, ColumnIndexBucket* dest) {
-  std::string_view key_as_sv(key->data, key->length);
+  auto key_as_sv = String::View(key);
 
   std::hash<std::string_view> hasher;
   uint64_t pos = col->data->array[hasher(key_as_sv) & col->data->mask];
@@ -127,29 +148,24 @@ void GetText(ColumnIndex* col, String::String* key, ColumnIndexBucket* dest) {
         reinterpret_cast<const char*>(col->data) + entry->str_offset,
         entry->str_len);
     if (entry_key_as_sv == key_as_sv) {
-      dest->data = entry->values;
-      dest->size = entry->size;
-      dest->allocator = nullptr;
-      dest->capacity = 0;
+      PopulateBucket(entry, dest);
       return;
     }
     pos = entry->next;
   }
 
-  dest->data = nullptr;
-  dest->size = 0;
-  dest->allocator = nullptr;
-  dest->capacity = 0;
-  return;
+  PopulateEmptyBucket(dest);
 }
 
 void Close(ColumnIndex* col) {
-  // TODO: Update buffer pool manager to close
+  FileManager::Get().Close(col->data);
 }
 
-template <typename T>
-void Serialize(std::string_view path,
-               std::unordered_map<T, std::vector<int32_t>>& index) {
+// Entries are padded so that the next entry is aligned.
+uint64_t Align(uint64_t size) { return (size + 7) & ~uint64_t(7); }
+
+template <typename T, typename Index>
+void SerializeImpl(std::string_view path, const Index& index) {
   int fd = open(std::string(path).c_str(), O_RDWR | O_CREAT,
                 S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
   if (fd == -1) {
@@ -167,7 +183,8 @@ void Serialize(std::string_view path,
       sizeof(ColumnIndexData) + ((1ull << bits) * sizeof(uint64_t));
   //           + (index entry + number of values for each value)
   for (const auto& [key, values] : index) {
-    length += sizeof(ColumnIndexEntry<T>) + (sizeof(int32_t) * values.size());
+    length += Align(sizeof(ColumnIndexEntry<T>) +
+                    PostingList::EncodedSize(values.data(), values.size()));
   }
 
   if (posix_fallocate(fd, 0, length) != 0) {
@@ -192,8 +209,7 @@ void Serialize(std::string_view path,
   uint64_t offset =
       sizeof(ColumnIndexData) + ((1ull << bits) * sizeof(uint64_t));
 
-  using iterator =
-      typename std::unordered_map<T, std::vector<int32_t>>::iterator;
+  using iterator = typename Index::const_iterator;
   std::unordered_map<uint64_t, std::vector<iterator>> pos_to_entries;
   for (auto it = index.begin(); it != index.end(); it++) {
     auto key = it->first;
@@ -213,11 +229,12 @@ void Serialize(std::string_view path,
       auto entry = reinterpret_cast<ColumnIndexEntry<T>*>(ptr + offset);
       entry->key = key;
       entry->size = values.size();
-      memcpy(entry->values, values.data(), values.size() * sizeof(int32_t));
+      PostingList::Encode(values.data(), values.size(), entry->values);
 
       offsets.push_back(offset);
 
-      offset += sizeof(ColumnIndexEntry<T>) + values.size() * sizeof(int32_t);
+      offset += Align(sizeof(ColumnIndexEntry<T>) +
+                      PostingList::EncodedSize(values.data(), values.size()));
     }
 
     // update linked list of offsets
@@ -244,6 +261,21 @@ void Serialize(std::string_view path,
   }
 }
 
+template <typename Index>
+void SerializeTextImpl(std::string_view path, const Index& index);
+
+template <typename T>
+void Serialize(std::string_view path,
+               std::unordered_map<T, std::vector<int32_t>>& index) {
+  SerializeImpl<T>(path, index);
+}
+
+template <typename T>
+void Serialize(std::string_view path,
+               const std::vector<std::pair<T, std::vector<int32_t>>>& index) {
+  SerializeImpl<T>(path, index);
+}
+
 template void Serialize(
     std::string_view path,
     std::unordered_map<int8_t, std::vector<int32_t>>& index);
@@ -264,9 +296,41 @@ template void Serialize(
     std::string_view path,
     std::unordered_map<double, std::vector<int32_t>>& index);
 
+template void Serialize(
+    std::string_view path,
+    const std::vector<std::pair<int8_t, std::vector<int32_t>>>& index);
+
+template void Serialize(
+    std::string_view path,
+    const std::vector<std::pair<int16_t, std::vector<int32_t>>>& index);
+
+template void Serialize(
+    std::string_view path,
+    const std::vector<std::pair<int32_t, std::vector<int32_t>>>& index);
+
+template void Serialize(
+    std::string_view path,
+    const std::vector<std::pair<int64_t, std::vector<int32_t>>>& index);
+
+template void Serialize(
+    std::string_view path,
+    const std::vector<std::pair<double, std::vector<int32_t>>>& index);
+
 template <>
 void Serialize(std::string_view path,
                std::unordered_map<std::string, std::vector<int32_t>>& index) {
+  SerializeTextImpl(path, index);
+}
+
+void Serialize(
+    std::string_view path,
+    const std::vector<std::pair<std::string_view, std::vector<int32_t>>>&
+        index) {
+  SerializeTextImpl(path, index);
+}
+
+template <typename Index>
+void SerializeTextImpl(std::string_view path, const Index& index) {
   int fd = open(std::string(path).c_str(), O_RDWR | O_CREAT,
                 S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
   if (fd == -1) {
@@ -285,8 +349,9 @@ void Serialize(std::string_view path,
   //           + (index entry + number of values for each value)
   //           + (key.size() + 1 for each key)
   for (const auto& [key, values] : index) {
-    length += sizeof(ColumnIndexEntry<std::string>) +
-              (sizeof(int32_t) * values.size()) + key.size() + 1;
+    length += Align(sizeof(ColumnIndexEntry<std::string>) +
+                    PostingList::EncodedSize(values.data(), values.size()) +
+                    key.size() + 1);
   }
 
   if (posix_fallocate(fd, 0, length) != 0) {
@@ -310,13 +375,12 @@ void Serialize(std::string_view path,
   uint8_t* ptr = reinterpret_cast<uint8_t*>(data);
   uint64_t offset =
       sizeof(ColumnIndexData) + ((1ull << bits) * sizeof(uint64_t));
-  std::hash<std::string> hasher;
+  std::hash<std::string_view> hasher;
 
-  using iterator =
-      typename std::unordered_map<std::string, std::vector<int32_t>>::iterator;
+  using iterator = typename Index::const_iterator;
   std::unordered_map<uint64_t, std::vector<iterator>> pos_to_entries;
   for (auto it = index.begin(); it != index.end(); it++) {
-    uint64_t pos = hasher(it->first) & mask;
+    uint64_t pos = hasher(std::string_view(it->first)) & mask;
     pos_to_entries[pos].push_back(it);
   }
 
@@ -334,15 +398,16 @@ void Serialize(std::string_view path,
           reinterpret_cast<ColumnIndexEntry<std::string>*>(ptr + entry_offset);
       entry->str_len = key.size();
       entry->size = values.size();
-      memcpy(entry->values, values.data(), values.size() * sizeof(int32_t));
+      PostingList::Encode(values.data(), values.size(), entry->values);
       offset += sizeof(ColumnIndexEntry<std::string>) +
-                values.size() * sizeof(int32_t);
+                PostingList::EncodedSize(values.data(), values.size());
 
       // write out string data
       entry->str_offset = offset;
       auto string_entry = reinterpret_cast<char*>(ptr + offset);
-      memcpy(string_entry, key.c_str(), key.size() + 1);
-      offset += key.size() + 1;
+      memcpy(string_entry, key.data(), key.size());
+      string_entry[key.size()] = '\0';
+      offset = Align(offset + key.size() + 1);
 
       offsets.push_back(entry_offset);
     }
@@ -6,11 +6,13 @@
 #include <fcntl.h>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "runtime/column_index_bucket.h"
@@ -23,12 +25,14 @@ struct ColumnIndexData {
   uint64_t array[];
 };
 
+// Each entry holds the number of tuples with the key and the tuple ids
+// encoded as a PostingList. Entries are padded to a multiple of 8 bytes.
 template <typename K>
 struct ColumnIndexEntry {
   K key;
   uint64_t size;
   uint64_t next;
-  int32_t values[];
+  uint8_t values[];
 };
 
 template <>
@@ -37,7 +41,7 @@ struct ColumnIndexEntry<std::string> {
   uint64_t str_len;
   uint64_t size;
   uint64_t next;
-  int32_t values[];
+  uint8_t values[];
 };
 
 struct ColumnIndex {
@@ -47,6 +51,9 @@ struct ColumnIndex {
 
 void Open(ColumnIndex* col, const char* path);
 
+// Buckets of keys with more than one tuple point at the encoded posting list
+// and are decoded lazily into the block_values of dest, which is left as is.
+
 void GetInt8(ColumnIndex* col, int8_t key, ColumnIndexBucket* dest);
 void GetInt16(ColumnIndex* col, int16_t key, ColumnIndexBucket* dest);
 void GetInt32(ColumnIndex* col, int32_t key, ColumnIndexBucket* dest);
@@ -60,4 +67,15 @@ template <typename T>
 void Serialize(std::string_view path,
                std::unordered_map<T, std::vector<int32_t>>& index);
 
+// Same as above for keys that are already grouped, e.g. by a sort. Each key
+// appears once and its tuple ids are in increasing order.
+template <typename T>
+void Serialize(std::string_view path,
+               const std::vector<std::pair<T, std::vector<int32_t>>>& index);
+
+void Serialize(
+    std::string_view path,
+    const std::vector<std::pair<std::string_view, std::vector<int32_t>>>&
+        index);
+
 }  // namespace kush::runtime::ColumnIndex
\ No newline at end of file
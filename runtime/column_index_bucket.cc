@@ -1,5 +1,8 @@
 #include "runtime/column_index_bucket.h"
 
+#include <immintrin.h>
+
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <functional>
@@ -8,17 +11,24 @@
 #include <utility>
 #include <vector>
 
+#include "runtime/posting_list.h"
+
 namespace kush::runtime {
 
-ColumnIndexBucket EMPTY = {
-    .data = nullptr, .size = 0, .capacity = 0, .allocator = nullptr};
+ColumnIndexBucket EMPTY = {.data = nullptr,
+                           .size = 0,
+                           .capacity = 0,
+                           .allocator = nullptr,
+                           .encoded = nullptr,
+                           .block_values = nullptr,
+                           .block = -1};
 
 void BucketPushBack(ColumnIndexBucket* v, int32_t idx) {
   if (v->capacity == v->size) {
+    v->data = (int32_t*)v->allocator->Reallocate(
+        v->data, v->capacity * sizeof(int32_t),
+        2 * v->capacity * sizeof(int32_t));
     v->capacity *= 2;
-    auto old = v->data;
-    v->data = (int32_t*)v->allocator->Allocate(v->capacity * sizeof(int32_t));
-    memcpy(v->data, old, sizeof(int32_t) * v->size);
   }
 
   v->data[v->size++] = idx;
@@ -29,35 +39,252 @@ void BucketInit(ColumnIndexBucket* v, Allocator* allocator) {
   v->size = 0;
   v->data = (int32_t*)allocator->Allocate(v->capacity * sizeof(int32_t));
   v->allocator = allocator;
+  v->encoded = nullptr;
+  v->block_values = nullptr;
+  v->block = -1;
 }
 
-// Get the next tuple that is greater than or equal to from index or cardinality
-int32_t FastForwardBucket(ColumnIndexBucket* bucket, int32_t prev_tuple) {
-  if (bucket->size == 0) {
-    return INT32_MAX;
+namespace {
+
+// Lists whose remaining sizes differ by more than this factor are intersected
+// by galloping through the larger list. Otherwise, a block merge that compares
+// each candidate against 8 elements at a time is used.
+constexpr int32_t GALLOP_RATIO = 32;
+
+// Below this many elements, the remaining range is scanned with SIMD compares
+// instead of being bisected further.
+constexpr int32_t SCAN_THRESHOLD = 32;
+
+// Returns the values of the bucket from idx on, which are contiguous up to
+// end. Encoded buckets first decode the block holding idx if it is not the
+// current one.
+const int32_t* Span(ColumnIndexBucket* bucket, int32_t idx, int32_t* end) {
+  if (bucket->encoded == nullptr) {
+    *end = bucket->size;
+    return bucket->data + idx;
+  }
+
+  const auto block = idx / PostingList::BLOCK_SIZE;
+  if (block != bucket->block) {
+    BucketDecodeBlock(bucket, block);
+  }
+
+  *end = std::min(bucket->size, (block + 1) * PostingList::BLOCK_SIZE);
+  return bucket->block_values + (idx - block * PostingList::BLOCK_SIZE);
+}
+
+int32_t Value(ColumnIndexBucket* bucket, int32_t idx) {
+  if (bucket->encoded == nullptr) {
+    return bucket->data[idx];
   }
 
-  // Binary search for tuple greater than prev_tuple
-  int start = 0;
-  int end = bucket->size - 1;
+  int32_t end;
+  return *Span(bucket, idx, &end);
+}
+
+// A bucket is dense if it holds every tuple between its first and last value.
+// Since buckets are sorted and free of duplicates, the position of any tuple
+// can then be computed directly. Encoded buckets are positioned with their
+// skip pointers instead.
+bool IsDense(const ColumnIndexBucket* bucket) {
+  return bucket->encoded == nullptr && bucket->size > 0 &&
+         bucket->data[bucket->size - 1] - bucket->data[0] == bucket->size - 1;
+}
+
+// Returns the index of the first element in data[start, end) that is greater
+// than or equal to target or end if none exist.
+int32_t SimdScan(const int32_t* data, int32_t start, int32_t end,
+                 int32_t target) {
+  const auto target_vec = _mm256_set1_epi32(target);
+  while (start + 8 <= end) {
+    auto block = _mm256_loadu_si256((const __m256i*)(data + start));
+    auto lt = _mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpgt_epi32(target_vec, block)));
+    if (lt != 0xFF) {
+      return start + __builtin_popcount(lt);
+    }
+    start += 8;
+  }
 
-  int32_t next_greater_idx = INT32_MAX;
-  while (start <= end) {
-    int mid = (start + end) / 2;
+  while (start < end && data[start] < target) {
+    start++;
+  }
+  return start;
+}
 
-    if (bucket->data[mid] < prev_tuple) {
+// Returns the index of the first element in data[start, end) that is greater
+// than or equal to target or end if none exist.
+int32_t LowerBound(const int32_t* data, int32_t start, int32_t end,
+                   int32_t target) {
+  while (end - start > SCAN_THRESHOLD) {
+    int32_t mid = start + (end - start) / 2;
+    if (data[mid] < target) {
       start = mid + 1;
     } else {
-      next_greater_idx = mid;
-      end = mid - 1;
+      end = mid + 1;
     }
   }
+  return SimdScan(data, start, end, target);
+}
+
+// Returns the index of the first element of the bucket at or after start that
+// is greater than or equal to target or the bucket size if none exist.
+int32_t Gallop(ColumnIndexBucket* bucket, int32_t start, int32_t target) {
+  const auto size = bucket->size;
+  if (start >= size) {
+    return size;
+  }
+
+  if (IsDense(bucket)) {
+    int64_t idx = int64_t(target) - bucket->data[0];
+    return std::clamp<int64_t>(idx, start, size);
+  }
+
+  if (bucket->encoded != nullptr) {
+    // Only the last block that starts at or before the target needs to be
+    // decoded since every value in the blocks after it is greater.
+    auto block =
+        std::max(start / PostingList::BLOCK_SIZE,
+                 PostingList::FindBlock(bucket->encoded, size, target));
+    auto block_start = std::max(start, block * PostingList::BLOCK_SIZE);
+    int32_t end;
+    auto values = Span(bucket, block_start, &end);
+    return block_start + LowerBound(values, 0, end - block_start, target);
+  }
+
+  if (bucket->data[start] >= target) {
+    return start;
+  }
+
+  // Exponential search for a range that contains the target
+  int64_t bound = 1;
+  while (bound < size - start && bucket->data[start + bound] < target) {
+    bound *= 2;
+  }
+
+  return LowerBound(bucket->data, start + bound / 2 + 1,
+                    std::min<int64_t>(start + bound + 1, size), target);
+}
 
-  return next_greater_idx;
+int32_t GallopIntersection(ColumnIndexBucket* small, int32_t* small_state,
+                           ColumnIndexBucket* large, int32_t* large_state,
+                           int32_t* result, int32_t result_max_size) {
+  int32_t result_size = 0;
+  while (*small_state < small->size && *large_state < large->size &&
+         result_size < result_max_size) {
+    auto candidate = Value(small, *small_state);
+    *large_state = Gallop(large, *large_state, candidate);
+    if (*large_state >= large->size) {
+      break;
+    }
+
+    auto current = Value(large, *large_state);
+    if (current == candidate) {
+      result[result_size++] = candidate;
+      (*small_state)++;
+      (*large_state)++;
+    } else {
+      *small_state = Gallop(small, *small_state, current);
+    }
+  }
+  return result_size;
+}
+
+int32_t BlockIntersection(ColumnIndexBucket* small, int32_t* small_state,
+                          ColumnIndexBucket* large, int32_t* large_state,
+                          int32_t* result, int32_t result_max_size) {
+  int32_t result_size = 0;
+  int32_t i = *small_state;
+  int32_t j = *large_state;
+  const auto small_size = small->size;
+  const auto large_size = large->size;
+
+  while (i < small_size && j < large_size && result_size < result_max_size) {
+    int32_t end;
+    auto values = Span(large, j, &end);
+    if (j + 8 > end) {
+      if (end == large_size) {
+        break;
+      }
+
+      // The next 8 values cross into the next block of an encoded list.
+      auto candidate = Value(small, i);
+      auto current = values[0];
+      if (current < candidate) {
+        j++;
+        continue;
+      }
+
+      if (current == candidate) {
+        result[result_size++] = candidate;
+        j++;
+      }
+      i++;
+      continue;
+    }
+
+    auto candidate = Value(small, i);
+    auto candidate_vec = _mm256_set1_epi32(candidate);
+    auto block = _mm256_loadu_si256((const __m256i*)values);
+
+    auto lt = _mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpgt_epi32(candidate_vec, block)));
+    if (lt == 0xFF) {
+      // Entire block is smaller than the candidate.
+      j += 8;
+      continue;
+    }
+
+    auto eq = _mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpeq_epi32(candidate_vec, block)));
+    j += __builtin_popcount(lt);
+    if (eq != 0) {
+      result[result_size++] = candidate;
+      j++;
+    }
+    i++;
+  }
+
+  *small_state = i;
+  *large_state = j;
+  if (result_size < result_max_size) {
+    // Finish the tail of the large list that does not fill a block.
+    result_size += GallopIntersection(small, small_state, large, large_state,
+                                      result + result_size,
+                                      result_max_size - result_size);
+  }
+  return result_size;
+}
+
+}  // namespace
+
+// Get the next tuple that is greater than or equal to from index or cardinality
+int32_t FastForwardBucket(ColumnIndexBucket* bucket, int32_t prev_tuple) {
+  if (bucket->size == 0) {
+    return INT32_MAX;
+  }
+
+  int32_t next_greater_idx;
+  if (IsDense(bucket)) {
+    int64_t idx = int64_t(prev_tuple) - bucket->data[0];
+    next_greater_idx = std::clamp<int64_t>(idx, 0, bucket->size);
+  } else if (bucket->encoded != nullptr) {
+    next_greater_idx = Gallop(bucket, 0, prev_tuple);
+  } else {
+    next_greater_idx = LowerBound(bucket->data, 0, bucket->size, prev_tuple);
+  }
+
+  return next_greater_idx == bucket->size ? INT32_MAX : next_greater_idx;
 }
 
 int32_t GetBucketValue(ColumnIndexBucket* bucket, int32_t idx) {
-  return bucket->data[idx];
+  return Value(bucket, idx);
+}
+
+void BucketDecodeBlock(ColumnIndexBucket* bucket, int32_t block) {
+  PostingList::DecodeBlock(bucket->encoded, bucket->size, block,
+                           bucket->block_values);
+  bucket->block = block;
 }
 
 ColumnIndexBucket* BucketListGet(ColumnIndexBucket* bucket, int32_t idx) {
@@ -76,14 +303,35 @@ int32_t BucketListSortedIntersectionPopulateResultFilter(
     ColumnIndexBucket* bucket_list, int32_t* intersection_state,
     int32_t* result, int32_t result_max_size, int* index_filter,
     int index_filter_size) {
-  ColumnIndexBucket* filtered_buckets[index_filter_size];
-  for (int i = 0; i < index_filter_size; i++) {
-    filtered_buckets[i] = &bucket_list[index_filter[i]];
+  // Gather the selected buckets and their intersection state into contiguous
+  // arrays, run the intersection over them and then scatter the state back.
+  ColumnIndexBucket filtered_buckets[index_filter_size];
+  int32_t filtered_state[index_filter_size];
+
+  int i = 0;
+  for (; i + 8 <= index_filter_size; i += 8) {
+    auto idx = _mm256_loadu_si256((const __m256i*)(index_filter + i));
+    _mm256_storeu_si256((__m256i*)(filtered_state + i),
+                        _mm256_i32gather_epi32(intersection_state, idx, 4));
+  }
+  for (; i < index_filter_size; i++) {
+    filtered_state[i] = intersection_state[index_filter[i]];
+  }
+
+  for (i = 0; i < index_filter_size; i++) {
+    filtered_buckets[i] = bucket_list[index_filter[i]];
   }
 
-  return BucketListSortedIntersectionPopulateResult(
-      filtered_buckets[0], index_filter_size, intersection_state, result,
+  auto result_size = BucketListSortedIntersectionPopulateResult(
+      filtered_buckets, index_filter_size, filtered_state, result,
       result_max_size);
+
+  // The copies decode into the same block buffers as the originals.
+  for (i = 0; i < index_filter_size; i++) {
+    intersection_state[index_filter[i]] = filtered_state[i];
+    bucket_list[index_filter[i]].block = filtered_buckets[i].block;
+  }
+  return result_size;
 }
 
 int32_t BucketListSortedIntersectionPopulateResult(
@@ -94,33 +342,45 @@ int32_t BucketListSortedIntersectionPopulateResult(
   }
 
   if (bucket_list_size == 1) {
-    int32_t result_size = 0;
-    while (intersection_state[0] < bucket_list[0].size &&
-           result_size < result_max_size) {
-      result[result_size++] = bucket_list[0].data[intersection_state[0]++];
+    auto start = intersection_state[0];
+    if (start >= bucket_list[0].size) {
+      return 0;
+    }
+
+    int32_t result_size =
+        std::min(bucket_list[0].size - start, result_max_size);
+    for (int32_t copied = 0; copied < result_size;) {
+      int32_t end;
+      auto values = Span(&bucket_list[0], start + copied, &end);
+      auto length = std::min(end - start - copied, result_size - copied);
+      memcpy(result + copied, values, sizeof(int32_t) * length);
+      copied += length;
     }
+    intersection_state[0] += result_size;
     return result_size;
   }
 
   if (bucket_list_size == 2) {
-    int32_t result_size = 0;
-    while (intersection_state[0] < bucket_list[0].size &&
-           intersection_state[1] < bucket_list[1].size &&
-           result_size < result_max_size) {
-      auto left = bucket_list[0].data[intersection_state[0]];
-      auto right = bucket_list[1].data[intersection_state[1]];
-
-      if (left < right) {
-        intersection_state[0] = FastForwardBucket(&bucket_list[0], right);
-      } else if (right < left) {
-        intersection_state[1] = FastForwardBucket(&bucket_list[1], left);
-      } else {
-        result[result_size++] = left;
-        intersection_state[0]++;
-        intersection_state[1]++;
-      }
+    auto left_size = bucket_list[0].size - intersection_state[0];
+    auto right_size = bucket_list[1].size - intersection_state[1];
+    if (left_size <= 0 || right_size <= 0) {
+      return 0;
     }
-    return result_size;
+
+    int small = left_size <= right_size ? 0 : 1;
+    int large = 1 - small;
+    auto small_size = std::min(left_size, right_size);
+    auto large_size = std::max(left_size, right_size);
+
+    if (large_size / small_size > GALLOP_RATIO) {
+      return GallopIntersection(
+          &bucket_list[small], &intersection_state[small], &bucket_list[large],
+          &intersection_state[large], result, result_max_size);
+    }
+
+    return BlockIntersection(&bucket_list[small], &intersection_state[small],
+                             &bucket_list[large], &intersection_state[large],
+                             result, result_max_size);
   }
 
   for (int i = 0; i < bucket_list_size; i++) {
@@ -141,7 +401,7 @@ int32_t BucketListSortedIntersectionPopulateResult(
     }
   }
 
-  // scan over min list
+  // scan over min list, galloping forward in each of the other lists
   int32_t result_size = 0;
   while (intersection_state[min_list] < bucket_list[min_list].size) {
     auto idx = intersection_state[min_list];
@@ -149,7 +409,7 @@ int32_t BucketListSortedIntersectionPopulateResult(
       break;
     }
 
-    int32_t candidate = bucket_list[min_list].data[idx];
+    int32_t candidate = Value(&bucket_list[min_list], idx);
 
     // see if this is contained in side each bucket list
     bool all_equal = true;
@@ -158,16 +418,18 @@ int32_t BucketListSortedIntersectionPopulateResult(
         continue;
       }
 
-      intersection_state[i] = FastForwardBucket(&bucket_list[i], candidate);
+      intersection_state[i] =
+          Gallop(&bucket_list[i], intersection_state[i], candidate);
       if (intersection_state[i] >= bucket_list[i].size) {
         return result_size;
       }
-      auto current = bucket_list[i].data[intersection_state[i]];
+      auto current = Value(&bucket_list[i], intersection_state[i]);
 
       if (current > candidate) {
         all_equal = false;
-        intersection_state[min_list] = FastForwardBucket(
-            &bucket_list[min_list], bucket_list[i].data[intersection_state[i]]);
+        intersection_state[min_list] =
+            Gallop(&bucket_list[min_list], intersection_state[min_list],
+                   current);
         break;
       }
     }
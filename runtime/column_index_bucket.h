@@ -6,11 +6,19 @@
 
 namespace kush::runtime {
 
+// A sorted list of tuple ids. Buckets read from a disk ColumnIndex may instead
+// point at an encoded PostingList. Their values are then decoded a block at a
+// time on access into block_values, which is owned by the holder of the bucket
+// and must fit PostingList::BLOCK_SIZE values.
 struct ColumnIndexBucket {
   int32_t* data;
   int32_t size;
   int32_t capacity;
   Allocator* allocator;
+  const uint8_t* encoded;
+  int32_t* block_values;
+  // Block currently decoded into block_values or -1.
+  int32_t block;
 };
 
 extern ColumnIndexBucket EMPTY;
@@ -23,6 +31,9 @@ int32_t FastForwardBucket(ColumnIndexBucket* bucket, int32_t prev_tuple);
 
 int32_t GetBucketValue(ColumnIndexBucket* bucket, int32_t idx);
 
+// Decodes block of an encoded bucket into its block_values.
+void BucketDecodeBlock(ColumnIndexBucket* bucket, int32_t block);
+
 ColumnIndexBucket* BucketListGet(ColumnIndexBucket* bucket_list, int32_t idx);
 
 void BucketListSortedIntersectionInit(ColumnIndexBucket* bucket_list,
@@ -1,8 +1,14 @@
 
 #include "runtime/column_index_bucket.h"
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include "gtest/gtest.h"
 
+#include "runtime/posting_list.h"
+
 using namespace kush::runtime;
 
 TEST(ColumnIndexTest, FastForwardIndex) {
@@ -24,4 +30,202 @@ TEST(ColumnIndexTest, FastForwardIndex) {
   EXPECT_EQ(FastForwardBucket(&bucket, 9), 4);
   EXPECT_EQ(FastForwardBucket(&bucket, 10), INT32_MAX);
   EXPECT_EQ(FastForwardBucket(&bucket, 11), INT32_MAX);
-}
\ No newline at end of file
+}
+TEST(ColumnIndexTest, FastForwardDenseIndex) {
+  std::vector<int> data{3, 4, 5, 6, 7};
+  ColumnIndexBucket bucket{
+      .data = data.data(),
+      .size = (int)data.size(),
+  };
+
+  EXPECT_EQ(FastForwardBucket(&bucket, 0), 0);
+  EXPECT_EQ(FastForwardBucket(&bucket, 3), 0);
+  EXPECT_EQ(FastForwardBucket(&bucket, 5), 2);
+  EXPECT_EQ(FastForwardBucket(&bucket, 7), 4);
+  EXPECT_EQ(FastForwardBucket(&bucket, 8), INT32_MAX);
+}
+
+TEST(ColumnIndexTest, FastForwardLargeIndex) {
+  std::vector<int> data;
+  for (int i = 0; i < 1000; i++) {
+    data.push_back(3 * i);
+  }
+  ColumnIndexBucket bucket{
+      .data = data.data(),
+      .size = (int)data.size(),
+  };
+
+  for (int i = 0; i <= 2997; i++) {
+    EXPECT_EQ(FastForwardBucket(&bucket, i), (i + 2) / 3);
+  }
+  EXPECT_EQ(FastForwardBucket(&bucket, 2998), INT32_MAX);
+}
+
+// Owns the encoded posting list and block buffer of an encoded bucket.
+struct EncodedList {
+  explicit EncodedList(const std::vector<int32_t>& values)
+      : encoded(PostingList::EncodedSize(values.data(), values.size())),
+        block_values(PostingList::BLOCK_SIZE) {
+    PostingList::Encode(values.data(), values.size(), encoded.data());
+    bucket = ColumnIndexBucket{.data = nullptr,
+                               .size = (int)values.size(),
+                               .encoded = encoded.data(),
+                               .block_values = block_values.data(),
+                               .block = -1};
+  }
+
+  std::vector<uint8_t> encoded;
+  std::vector<int32_t> block_values;
+  ColumnIndexBucket bucket;
+};
+
+TEST(ColumnIndexTest, FastForwardEncodedIndex) {
+  std::vector<int> data;
+  for (int i = 0; i < 1000; i++) {
+    data.push_back(3 * i);
+  }
+  EncodedList list(data);
+
+  for (int i = 0; i <= 2997; i++) {
+    EXPECT_EQ(FastForwardBucket(&list.bucket, i), (i + 2) / 3);
+  }
+  EXPECT_EQ(FastForwardBucket(&list.bucket, 2998), INT32_MAX);
+
+  for (int i = 999; i >= 0; i -= 7) {
+    EXPECT_EQ(GetBucketValue(&list.bucket, i), 3 * i);
+  }
+}
+
+TEST(ColumnIndexTest, DecodeBlock) {
+  std::vector<int> data;
+  for (int i = 0; i < 1000; i++) {
+    data.push_back(5 * i + 1);
+  }
+  EncodedList list(data);
+
+  BucketDecodeBlock(&list.bucket, 2);
+  EXPECT_EQ(list.bucket.block, 2);
+  for (int i = 0; i < PostingList::BLOCK_SIZE; i++) {
+    EXPECT_EQ(list.bucket.block_values[i],
+              data[2 * PostingList::BLOCK_SIZE + i]);
+  }
+}
+
+std::vector<int32_t> Intersect(std::vector<std::vector<int32_t>>& lists,
+                               int32_t batch_size, int32_t next_tuple,
+                               bool encoded = false) {
+  std::vector<std::unique_ptr<EncodedList>> encoded_lists;
+  std::vector<ColumnIndexBucket> buckets;
+  for (auto& l : lists) {
+    if (encoded) {
+      encoded_lists.push_back(std::make_unique<EncodedList>(l));
+      buckets.push_back(encoded_lists.back()->bucket);
+    } else {
+      buckets.push_back(ColumnIndexBucket{
+          .data = l.data(),
+          .size = (int)l.size(),
+      });
+    }
+  }
+
+  std::vector<int32_t> state(lists.size());
+  BucketListSortedIntersectionInit(buckets.data(), buckets.size(),
+                                   state.data(), next_tuple);
+
+  std::vector<int32_t> output;
+  std::vector<int32_t> result(batch_size);
+  while (true) {
+    auto size = BucketListSortedIntersectionPopulateResult(
+        buckets.data(), buckets.size(), state.data(), result.data(),
+        batch_size);
+    if (size == 0) {
+      break;
+    }
+    output.insert(output.end(), result.begin(), result.begin() + size);
+  }
+  return output;
+}
+
+std::vector<int32_t> Multiples(int32_t step, int32_t max) {
+  std::vector<int32_t> output;
+  for (int i = 0; i < max; i += step) {
+    output.push_back(i);
+  }
+  return output;
+}
+
+TEST(ColumnIndexTest, SortedIntersectionBlock) {
+  std::vector<std::vector<int32_t>> lists{Multiples(2, 1000),
+                                          Multiples(3, 1000)};
+  EXPECT_EQ(Intersect(lists, 7, 0), Multiples(6, 1000));
+}
+
+TEST(ColumnIndexTest, SortedIntersectionGallop) {
+  std::vector<std::vector<int32_t>> lists{Multiples(1, 10000),
+                                          Multiples(500, 10000)};
+  EXPECT_EQ(Intersect(lists, 3, 0), Multiples(500, 10000));
+}
+
+TEST(ColumnIndexTest, SortedIntersectionNextTuple) {
+  std::vector<std::vector<int32_t>> lists{Multiples(2, 1000),
+                                          Multiples(5, 1000)};
+  std::vector<int32_t> expected;
+  for (int i = 500; i < 1000; i += 10) {
+    expected.push_back(i);
+  }
+  EXPECT_EQ(Intersect(lists, 16, 491), expected);
+}
+
+TEST(ColumnIndexTest, SortedIntersectionMultiple) {
+  std::vector<std::vector<int32_t>> lists{
+      Multiples(2, 5000), Multiples(3, 5000), Multiples(5, 5000)};
+  EXPECT_EQ(Intersect(lists, 4, 0), Multiples(30, 5000));
+}
+
+TEST(ColumnIndexTest, SortedIntersectionFilter) {
+  std::vector<std::vector<int32_t>> lists{
+      Multiples(2, 1000), Multiples(7, 1000), Multiples(3, 1000)};
+  std::vector<ColumnIndexBucket> buckets;
+  for (auto& l : lists) {
+    buckets.push_back(ColumnIndexBucket{
+        .data = l.data(),
+        .size = (int)l.size(),
+    });
+  }
+
+  std::vector<int32_t> state(lists.size());
+  BucketListSortedIntersectionInit(buckets.data(), buckets.size(),
+                                   state.data(), 0);
+
+  std::vector<int> filter{0, 2};
+  std::vector<int32_t> output;
+  std::vector<int32_t> result(5);
+  while (true) {
+    auto size = BucketListSortedIntersectionPopulateResultFilter(
+        buckets.data(), state.data(), result.data(), result.size(),
+        filter.data(), filter.size());
+    if (size == 0) {
+      break;
+    }
+    output.insert(output.end(), result.begin(), result.begin() + size);
+  }
+  EXPECT_EQ(output, Multiples(6, 1000));
+  EXPECT_EQ(state[1], 0);
+}
+
+TEST(ColumnIndexTest, SortedIntersectionEncoded) {
+  std::vector<std::vector<int32_t>> single{Multiples(3, 1000)};
+  EXPECT_EQ(Intersect(single, 100, 10, true), Intersect(single, 100, 10));
+
+  std::vector<std::vector<int32_t>> block{Multiples(2, 5000),
+                                          Multiples(3, 5000)};
+  EXPECT_EQ(Intersect(block, 7, 0, true), Multiples(6, 5000));
+
+  std::vector<std::vector<int32_t>> gallop{Multiples(1, 10000),
+                                           Multiples(500, 10000)};
+  EXPECT_EQ(Intersect(gallop, 3, 0, true), Multiples(500, 10000));
+
+  std::vector<std::vector<int32_t>> multiple{
+      Multiples(2, 5000), Multiples(3, 5000), Multiples(5, 5000)};
+  EXPECT_EQ(Intersect(multiple, 4, 0, true), Multiples(30, 5000));
+}
@@ -130,23 +130,25 @@ void Serialize(std::string_view path,
   }
 }
 
-void EnumManager::GetKey(int32_t id, int32_t value, String::String* dest) {
+FileInformation& EnumManager::File(int32_t id) {
   if (!file_.contains(id)) {
-    file_[id] = FileManager::Get().Open(info_.at(id)).data;
+    file_[id] = FileManager::Get().Open(info_.at(id));
   }
-  auto data = reinterpret_cast<uint8_t*>(file_.at(id));
+  return file_.at(id);
+}
+
+void EnumManager::GetKey(int32_t id, int32_t value, String::String* dest) {
+  auto data = reinterpret_cast<uint8_t*>(File(id).data);
   auto enum_data = reinterpret_cast<EnumData*>(data);
   auto enum_array_ptr =
       reinterpret_cast<EnumEntry*>(data + enum_data->entry_offset);
-  dest->length = enum_array_ptr[value].str_len;
-  dest->data = reinterpret_cast<char*>(data + enum_array_ptr[value].str_offset);
+  String::Init(
+      dest, reinterpret_cast<char*>(data + enum_array_ptr[value].str_offset),
+      enum_array_ptr[value].str_len);
 }
 
 int32_t EnumManager::GetValue(int32_t id, std::string value) {
-  if (!file_.contains(id)) {
-    file_[id] = FileManager::Get().Open(info_.at(id)).data;
-  }
-  auto data = reinterpret_cast<uint8_t*>(file_.at(id));
+  auto data = reinterpret_cast<uint8_t*>(File(id).data);
   auto enum_data = reinterpret_cast<EnumData*>(data);
 
   std::hash<std::string> hasher;
@@ -167,6 +169,43 @@ int32_t EnumManager::GetValue(int32_t id, std::string value) {
   return -1;
 }
 
+int32_t EnumManager::Size(int32_t id) {
+  const auto& file = File(id);
+  auto data = reinterpret_cast<uint8_t*>(file.data);
+  auto enum_data = reinterpret_cast<EnumData*>(data);
+  if (file.file_length == enum_data->entry_offset) {
+    return 0;
+  }
+
+  // The keys are written right after the last entry.
+  auto enum_array_ptr =
+      reinterpret_cast<EnumEntry*>(data + enum_data->entry_offset);
+  return (enum_array_ptr[0].str_offset - enum_data->entry_offset) /
+         sizeof(EnumEntry);
+}
+
+bool EnumManager::Sorted(int32_t id) {
+  if (!sorted_.contains(id)) {
+    auto data = reinterpret_cast<uint8_t*>(File(id).data);
+    auto enum_data = reinterpret_cast<EnumData*>(data);
+    auto enum_array_ptr =
+        reinterpret_cast<EnumEntry*>(data + enum_data->entry_offset);
+    auto key = [&](int32_t value) {
+      return std::string_view(
+          reinterpret_cast<char*>(data + enum_array_ptr[value].str_offset),
+          enum_array_ptr[value].str_len);
+    };
+
+    bool sorted = true;
+    auto size = Size(id);
+    for (int32_t i = 1; i < size && sorted; i++) {
+      sorted = key(i - 1) < key(i);
+    }
+    sorted_[id] = sorted;
+  }
+  return sorted_.at(id);
+}
+
 int32_t EnumManager::Register(std::string_view enum_path) {
   int32_t id = info_.size();
   info_[id] = enum_path;
@@ -181,4 +220,8 @@ int32_t GetValue(int32_t id, std::string_view value) {
   return EnumManager::Get().GetValue(id, std::string(value));
 }
 
+int32_t Size(int32_t id) { return EnumManager::Get().Size(id); }
+
+bool Sorted(int32_t id) { return EnumManager::Get().Sorted(id); }
+
 }  // namespace kush::runtime::Enum
\ No newline at end of file
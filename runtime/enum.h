@@ -34,12 +34,24 @@ class EnumManager {
   void GetKey(int32_t id, int32_t value, String::String* dest);
   int32_t GetValue(int32_t id, std::string value);
 
+  // Number of keys in the dictionary. Keys are numbered from 0.
+  int32_t Size(int32_t id);
+
+  // Whether the codes are numbered in sorted order of the keys so that they
+  // can be compared instead of the keys.
+  bool Sorted(int32_t id);
+
  private:
+  FileInformation& File(int32_t id);
+
   absl::flat_hash_map<int32_t, std::string> info_;
-  absl::flat_hash_map<int32_t, void*> file_;
+  absl::flat_hash_map<int32_t, FileInformation> file_;
+  absl::flat_hash_map<int32_t, bool> sorted_;
 };
 
 void GetKey(int32_t id, int32_t value, String::String* dest);
 int32_t GetValue(int32_t id, std::string_view value);
+int32_t Size(int32_t id);
+bool Sorted(int32_t id);
 
 }  // namespace kush::runtime::Enum
\ No newline at end of file
@@ -29,15 +29,38 @@ TEST(EnumTest, asdf) {
 
   kush::runtime::String::String s;
   GetKey(id, 0, &s);
-  EXPECT_EQ(std::string_view(s.data, s.length), "a");
+  EXPECT_EQ(kush::runtime::String::View(&s), "a");
   GetKey(id, 1, &s);
-  EXPECT_EQ(std::string_view(s.data, s.length), "asdf");
+  EXPECT_EQ(kush::runtime::String::View(&s), "asdf");
   GetKey(id, 2, &s);
-  EXPECT_EQ(std::string_view(s.data, s.length), "qwer");
+  EXPECT_EQ(kush::runtime::String::View(&s), "qwer");
   GetKey(id, 3, &s);
-  EXPECT_EQ(std::string_view(s.data, s.length), "zxcv");
+  EXPECT_EQ(kush::runtime::String::View(&s), "zxcv");
   GetKey(id, 4, &s);
-  EXPECT_EQ(std::string_view(s.data, s.length), "b");
+  EXPECT_EQ(kush::runtime::String::View(&s), "b");
   GetKey(id, 5, &s);
-  EXPECT_EQ(std::string_view(s.data, s.length), "c");
+  EXPECT_EQ(kush::runtime::String::View(&s), "c");
+
+  EXPECT_EQ(Size(id), 6);
+  EXPECT_FALSE(Sorted(id));
+}
+
+TEST(EnumTest, Sorted) {
+  std::unordered_map<std::string, int32_t> map;
+  map["a"] = 0;
+  map["ab"] = 1;
+  map["b"] = 2;
+
+  Serialize("/tmp/sorted.kdbenum", map);
+  auto id = EnumManager::Get().Register("/tmp/sorted.kdbenum");
+  EXPECT_TRUE(Sorted(id));
+}
+
+TEST(EnumTest, Empty) {
+  std::unordered_map<std::string, int32_t> map;
+  Serialize("/tmp/empty.kdbenum", map);
+  auto id = EnumManager::Get().Register("/tmp/empty.kdbenum");
+  EXPECT_EQ(Size(id), 0);
+  EXPECT_TRUE(Sorted(id));
+  EXPECT_EQ(GetValue(id, "a"), -1);
 }
@@ -1,66 +1,429 @@
 #include "runtime/file_manager.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <exception>
 #include <fcntl.h>
+#include <fstream>
 #include <iostream>
+#include <linux/mempolicy.h>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <system_error>
+#include <thread>
 #include <unistd.h>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/flags/flag.h"
+
+ABSL_FLAG(int64_t, buffer_pool_size_mb, 0,
+          "Memory budget of the buffer pool in MiB. Unlimited if 0.");
+ABSL_FLAG(std::string, file_mode, "read",
+          "How files are made resident: read/mmap/huge_pages.");
+ABSL_FLAG(std::string, numa_placement, "none",
+          "NUMA placement of huge page copies: none/interleave/local.");
 
 namespace kush::runtime {
 
-FileInformation FileManager::Open(std::string_view path) {
-  if (!info_.contains(path)) {
-    int fd = open(std::string(path).c_str(), O_RDONLY);
-    if (fd == -1) {
-      std::cerr << path << std::endl;
-      throw std::system_error(
-          errno, std::generic_category(),
-          std::string(__FILE__) + ":" + std::to_string(__LINE__));
+constexpr uint64_t CHUNK_SIZE = 8 << 20;
+constexpr int MAX_IO_THREADS = 8;
+
+// line is the caller's __LINE__ so that the error points at the failed call.
+std::system_error FileError(int line) {
+  return std::system_error(errno, std::generic_category(),
+                           std::string(__FILE__) + ":" + std::to_string(line));
+}
+
+constexpr uint64_t HUGE_PAGE_SIZE = 2 << 20;
+
+uint64_t Budget() {
+  return static_cast<uint64_t>(FLAGS_buffer_pool_size_mb.Get()) << 20;
+}
+
+enum class FileMode { READ, MMAP, HUGE_PAGES };
+
+FileMode GetFileMode() {
+  if (FLAGS_file_mode.CurrentValue() == "read") {
+    return FileMode::READ;
+  } else if (FLAGS_file_mode.CurrentValue() == "mmap") {
+    return FileMode::MMAP;
+  } else if (FLAGS_file_mode.CurrentValue() == "huge_pages") {
+    return FileMode::HUGE_PAGES;
+  } else {
+    throw std::runtime_error("Unknown file mode.");
+  }
+}
+
+// Mask of the online NUMA nodes, e.g. "0-1,3" in sysfs.
+unsigned long OnlineNodes() {
+  std::ifstream fin("/sys/devices/system/node/online");
+  std::string ranges;
+  if (!(fin >> ranges)) {
+    return 1;
+  }
+
+  unsigned long mask = 0;
+  std::stringstream ss(ranges);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    auto dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last =
+        dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+    for (int node = first; node <= last && node < 64; node++) {
+      mask |= 1ul << node;
+    }
+  }
+  return mask == 0 ? 1 : mask;
+}
+
+// Sets the NUMA policy of an untouched mapping so that its pages are placed
+// where the data is scanned rather than where the I/O threads first write it.
+// Scans run on the thread that opens the file.
+void PlaceOnNodes(void* data, uint64_t length) {
+  unsigned long mask;
+  int mode;
+  if (FLAGS_numa_placement.CurrentValue() == "none") {
+    return;
+  } else if (FLAGS_numa_placement.CurrentValue() == "interleave") {
+    mode = MPOL_INTERLEAVE;
+    mask = OnlineNodes();
+  } else if (FLAGS_numa_placement.CurrentValue() == "local") {
+    unsigned int cpu, node;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0 || node >= 64) {
+      return;
+    }
+    mode = MPOL_BIND;
+    mask = 1ul << node;
+  } else {
+    throw std::runtime_error("Unknown NUMA placement.");
+  }
+
+  // Placement is best effort, e.g. mbind is not permitted in containers.
+  syscall(SYS_mbind, data, length, mode, &mask, 64, 0);
+}
+
+bool FileManager::Allocate(File& file) {
+  auto length = file.info.file_length;
+  auto mode = GetFileMode();
+
+  if (length > 0 && mode == FileMode::MMAP) {
+    auto data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE | MAP_POPULATE,
+                     file.fd, 0);
+    if (data == MAP_FAILED) {
+      throw FileError(__LINE__);
+    }
+    madvise(data, length, MADV_HUGEPAGE);
+    madvise(data, length, MADV_SEQUENTIAL);
+    file.info.data = data;
+    file.mapped_length = length;
+    return false;
+  }
+
+  if (length > 0 && mode == FileMode::HUGE_PAGES) {
+    auto mapped_length =
+        (length + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    auto data = mmap(nullptr, mapped_length, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data == MAP_FAILED) {
+      // No reserved huge pages so fall back to transparent huge pages.
+      data = mmap(nullptr, mapped_length, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (data == MAP_FAILED) {
+        throw FileError(__LINE__);
+      }
+      madvise(data, mapped_length, MADV_HUGEPAGE);
+    }
+    PlaceOnNodes(data, mapped_length);
+    file.info.data = data;
+    file.mapped_length = mapped_length;
+    return true;
+  }
+
+  // aligned_alloc requires the size to be a multiple of the alignment.
+  file.info.data = aligned_alloc(64, (length + 63) / 64 * 64);
+  if (file.info.data == nullptr) {
+    throw std::bad_alloc();
+  }
+  file.mapped_length = 0;
+  return true;
+}
+
+void FileManager::Release(File& file) {
+  if (file.info.data == nullptr) {
+    return;
+  }
+
+  if (file.mapped_length > 0) {
+    munmap(file.info.data, file.mapped_length);
+  } else {
+    free(file.info.data);
+  }
+  file.info.data = nullptr;
+}
+
+bool FileManager::Evictable(const File& file) {
+  return file.pins == 0 && file.pending_chunks == 0;
+}
+
+void FileManager::Evict(std::size_t clock_idx) {
+  auto file = clock_[clock_idx];
+  if (file->info.data != nullptr) {
+    by_data_.erase(file->info.data);
+    resident_bytes_ -= file->info.file_length;
+    Release(*file);
+  }
+
+  clock_.erase(clock_.begin() + clock_idx);
+  if (clock_hand_ >= clock_.size()) {
+    clock_hand_ = 0;
+  }
+  files_.erase(file->path);
+}
+
+bool FileManager::MakeRoom(uint64_t bytes) {
+  auto budget = Budget();
+  if (budget == 0) {
+    return true;
+  }
+
+  // CLOCK: referenced files get a second chance. Two sweeps clear every
+  // reference bit so stop if nothing was evictable by then.
+  std::size_t steps = 0;
+  while (resident_bytes_ + bytes > budget && !clock_.empty() &&
+         steps < 2 * clock_.size()) {
+    auto file = clock_[clock_hand_];
+    if (Evictable(*file)) {
+      if (file->referenced) {
+        file->referenced = false;
+      } else {
+        Evict(clock_hand_);
+        steps = 0;
+        continue;
+      }
+    }
+    clock_hand_ = (clock_hand_ + 1) % clock_.size();
+    steps++;
+  }
+
+  return resident_bytes_ + bytes <= budget;
+}
+
+FileManager::File* FileManager::Enqueue(std::string_view path, bool prefetch) {
+  auto it = files_.find(path);
+  if (it != files_.end()) {
+    return it->second.get();
+  }
+
+  auto file = std::make_unique<File>();
+  file->path = std::string(path);
+  file->info = FileInformation{.data = nullptr, .file_length = 0};
+  file->mapped_length = 0;
+  file->fd = -1;
+  file->pending_chunks = 0;
+  file->pins = 0;
+  file->referenced = false;
+
+  bool needs_read = true;
+  try {
+    file->fd = open(file->path.c_str(), O_RDONLY);
+    if (file->fd == -1) {
+      throw FileError(__LINE__);
     }
 
     struct stat sb;
-    if (fstat(fd, &sb) == -1) {
-      std::cerr << path << std::endl;
-      throw std::system_error(
-          errno, std::generic_category(),
-          std::string(__FILE__) + ":" + std::to_string(__LINE__));
+    if (fstat(file->fd, &sb) == -1) {
+      throw FileError(__LINE__);
+    }
+    file->info.file_length = sb.st_size;
+
+    if (!MakeRoom(file->info.file_length) && prefetch) {
+      close(file->fd);
+      return nullptr;
+    }
+
+    needs_read = Allocate(*file);
+    resident_bytes_ += file->info.file_length;
+    by_data_[file->info.data] = file.get();
+  } catch (...) {
+    file->error = std::current_exception();
+    if (file->fd != -1) {
+      close(file->fd);
+      file->fd = -1;
+    }
+  }
+
+  auto result = file.get();
+  clock_.push_back(result);
+  files_[path] = std::move(file);
+
+  if (result->error != nullptr) {
+    return result;
+  }
+
+  if (result->info.file_length == 0 || !needs_read) {
+    close(result->fd);
+    result->fd = -1;
+    return result;
+  }
+
+  for (uint64_t offset = 0; offset < result->info.file_length;
+       offset += CHUNK_SIZE) {
+    auto length = std::min(CHUNK_SIZE, result->info.file_length - offset);
+    chunks_.push_back(Chunk{result, offset, length});
+    result->pending_chunks++;
+  }
+
+  if (workers_.empty()) {
+    int num_workers = std::clamp<int>(std::thread::hardware_concurrency(), 1,
+                                      MAX_IO_THREADS);
+    for (int i = 0; i < num_workers; i++) {
+      workers_.emplace_back([this]() { Work(); });
+    }
+  }
+  chunk_cv_.notify_all();
+
+  return result;
+}
+
+void FileManager::ReadChunk(const Chunk& chunk) {
+  auto dest = reinterpret_cast<char*>(chunk.file->info.data) + chunk.offset;
+  uint64_t read = 0;
+  while (read < chunk.length) {
+    auto result = pread(chunk.file->fd, dest + read, chunk.length - read,
+                        chunk.offset + read);
+    if (result < 0) {
+      throw FileError(__LINE__);
+    }
+    if (result == 0) {
+      throw std::runtime_error("Unexpected end of file.");
+    }
+    read += result;
+  }
+}
+
+void FileManager::Finish(File* file) {
+  if (--file->pending_chunks == 0) {
+    if (close(file->fd) != 0 && file->error == nullptr) {
+      file->error = std::make_exception_ptr(FileError(__LINE__));
+    }
+    file->fd = -1;
+    done_cv_.notify_all();
+  }
+}
+
+void FileManager::Work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    chunk_cv_.wait(lock, [&]() { return stop_ || !chunks_.empty(); });
+    if (stop_) {
+      return;
     }
-    uint64_t file_length = sb.st_size;
 
-    void* data = aligned_alloc(64, file_length);
-    if (pread(fd, data, file_length, 0) < 0) {
-      std::cerr << path << std::endl;
-      throw std::system_error(
-          errno, std::generic_category(),
-          std::string(__FILE__) + ":" + std::to_string(__LINE__));
+    auto chunk = chunks_.front();
+    chunks_.pop_front();
+
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+      ReadChunk(chunk);
+    } catch (...) {
+      error = std::current_exception();
     }
+    lock.lock();
 
-    if (close(fd) != 0) {
-      std::cerr << path << std::endl;
-      throw std::system_error(
-          errno, std::generic_category(),
-          std::string(__FILE__) + ":" + std::to_string(__LINE__));
+    if (error != nullptr && chunk.file->error == nullptr) {
+      chunk.file->error = error;
     }
+    Finish(chunk.file);
+  }
+}
+
+void FileManager::Prefetch(const std::vector<std::string>& paths) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& path : paths) {
+    Enqueue(path, true);
+  }
+}
+
+FileInformation FileManager::Open(std::string_view path) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto file = Enqueue(path, false);
+  file->pins++;
+  file->referenced = true;
 
-    info_[path] = FileInformation{.data = data, .file_length = file_length};
+  if (file->pending_chunks > 0) {
+    // Move the remaining chunks of this file ahead of other prefetches.
+    std::stable_partition(chunks_.begin(), chunks_.end(),
+                          [&](const Chunk& c) { return c.file == file; });
+    done_cv_.wait(lock, [&]() { return file->pending_chunks == 0; });
   }
 
-  return info_[path];
+  if (file->error != nullptr) {
+    // Drop the failed file so that a later Open retries it.
+    auto error = file->error;
+    if (--file->pins == 0) {
+      Evict(std::find(clock_.begin(), clock_.end(), file) - clock_.begin());
+    }
+    std::cerr << path << std::endl;
+    std::rethrow_exception(error);
+  }
+  return file->info;
+}
+
+void FileManager::Close(const void* data) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = by_data_.find(data);
+  if (it != by_data_.end() && it->second->pins > 0) {
+    it->second->pins--;
+  }
+}
+
+void FileManager::CloseAtQueryEnd(const void* data) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = by_data_.find(data);
+  if (it != by_data_.end() && it->second->pins > 0) {
+    closed_at_query_end_.push_back(it->second);
+  }
+}
+
+void FileManager::EndQuery() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto file : closed_at_query_end_) {
+    file->pins--;
+  }
+  closed_at_query_end_.clear();
+}
+
+uint64_t FileManager::ResidentBytes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return resident_bytes_;
 }
 
 FileManager::~FileManager() {
-  // TODO: clear files
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  chunk_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+
+  for (auto file : clock_) {
+    Release(*file);
+  }
 }
 
 }  // namespace kush::runtime
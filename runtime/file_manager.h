@@ -1,7 +1,16 @@
 #pragma once
 
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 
@@ -12,6 +21,17 @@ struct FileInformation {
   uint64_t file_length;
 };
 
+// Buffer pool of whole files. Files are split into chunks that are read in
+// parallel by a pool of I/O threads. Open pins a file and Close unpins it.
+// When loading a file would exceed --buffer_pool_size_mb, unpinned files are
+// evicted in CLOCK order. Pinned files are never evicted so the budget is
+// exceeded if every resident file is pinned.
+//
+// --file_mode selects how a file is made resident:
+//  - read: copy into heap memory.
+//  - mmap: map the file read-only, sharing pages with the page cache.
+//  - huge_pages: copy into an anonymous mapping backed by 2 MiB pages and
+//    placed on NUMA nodes according to --numa_placement.
 class FileManager {
  public:
   static FileManager& Get() {
@@ -28,10 +48,67 @@ class FileManager {
   FileManager(FileManager const&) = delete;
   void operator=(FileManager const&) = delete;
 
+  // Starts reading the files in the background. Files that do not fit in the
+  // budget are skipped.
+  void Prefetch(const std::vector<std::string>& paths);
+
+  // Pins the file, reading it first if it is not resident, and waits until it
+  // is read.
   FileInformation Open(std::string_view path);
 
+  // Unpins the file with the data returned by Open.
+  void Close(const void* data);
+
+  // Unpins the file with the data returned by Open at the next EndQuery.
+  // Used for files that values point into, e.g. strings stored in a hash
+  // table, which may be read after the file is closed.
+  void CloseAtQueryEnd(const void* data);
+
+  // Unpins the files closed with CloseAtQueryEnd.
+  void EndQuery();
+
+  uint64_t ResidentBytes();
+
  private:
-  absl::flat_hash_map<std::string, FileInformation> info_;
+  struct File {
+    std::string path;
+    FileInformation info;
+    uint64_t mapped_length;
+    int fd;
+    int pending_chunks;
+    int pins;
+    bool referenced;
+    std::exception_ptr error;
+  };
+
+  struct Chunk {
+    File* file;
+    uint64_t offset;
+    uint64_t length;
+  };
+
+  File* Enqueue(std::string_view path, bool prefetch);
+  bool Allocate(File& file);
+  void Release(File& file);
+  bool MakeRoom(uint64_t bytes);
+  bool Evictable(const File& file);
+  void Evict(std::size_t clock_idx);
+  void ReadChunk(const Chunk& chunk);
+  void Finish(File* file);
+  void Work();
+
+  std::mutex mutex_;
+  std::condition_variable chunk_cv_;
+  std::condition_variable done_cv_;
+  absl::flat_hash_map<std::string, std::unique_ptr<File>> files_;
+  absl::flat_hash_map<const void*, File*> by_data_;
+  std::vector<File*> clock_;
+  std::vector<File*> closed_at_query_end_;
+  std::size_t clock_hand_ = 0;
+  uint64_t resident_bytes_ = 0;
+  std::deque<Chunk> chunks_;
+  std::vector<std::thread> workers_;
+  bool stop_ = false;
 };
 
 }  // namespace kush::runtime
@@ -0,0 +1,200 @@
+#include "runtime/file_manager.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "absl/flags/declare.h"
+#include "absl/flags/flag.h"
+#include "gtest/gtest.h"
+
+ABSL_DECLARE_FLAG(int64_t, buffer_pool_size_mb);
+ABSL_DECLARE_FLAG(std::string, file_mode);
+ABSL_DECLARE_FLAG(std::string, numa_placement);
+
+using namespace kush::runtime;
+
+std::string WriteFile(const std::string& name, const std::vector<int32_t>& v) {
+  auto path = testing::TempDir() + name;
+  std::ofstream fout(path, std::ios::binary | std::ios::trunc);
+  fout.write(reinterpret_cast<const char*>(v.data()),
+             v.size() * sizeof(int32_t));
+  return path;
+}
+
+void ExpectContents(FileInformation info, const std::vector<int32_t>& v) {
+  ASSERT_EQ(info.file_length, v.size() * sizeof(int32_t));
+  auto data = reinterpret_cast<int32_t*>(info.data);
+  for (std::size_t i = 0; i < v.size(); i++) {
+    ASSERT_EQ(data[i], v[i]);
+  }
+}
+
+std::vector<int32_t> Sequence(int size, int start) {
+  std::vector<int32_t> v(size);
+  for (int i = 0; i < size; i++) {
+    v[i] = start + i;
+  }
+  return v;
+}
+
+TEST(FileManagerTest, OpenWithoutPrefetch) {
+  std::vector<int32_t> v{1, 2, 3, 4, 5};
+  auto path = WriteFile("file_manager_open.kdb", v);
+
+  auto info = FileManager::Get().Open(path);
+  ExpectContents(info, v);
+  FileManager::Get().Close(info.data);
+}
+
+TEST(FileManagerTest, PrefetchMultiChunkFiles) {
+  std::vector<std::string> paths;
+  std::vector<std::vector<int32_t>> contents;
+  for (int f = 0; f < 4; f++) {
+    // Larger than a chunk and not a multiple of it.
+    std::vector<int32_t> v(5 << 20);
+    for (std::size_t i = 0; i < v.size(); i++) {
+      v[i] = i * (f + 1);
+    }
+    paths.push_back(
+        WriteFile("file_manager_prefetch" + std::to_string(f) + ".kdb", v));
+    contents.push_back(std::move(v));
+  }
+
+  FileManager::Get().Prefetch(paths);
+  for (int f = 3; f >= 0; f--) {
+    auto info = FileManager::Get().Open(paths[f]);
+    ExpectContents(info, contents[f]);
+    FileManager::Get().Close(info.data);
+  }
+}
+
+TEST(FileManagerTest, EmptyFile) {
+  auto path = WriteFile("file_manager_empty.kdb", {});
+  FileManager::Get().Prefetch({path});
+  auto info = FileManager::Get().Open(path);
+  EXPECT_EQ(info.file_length, 0);
+  FileManager::Get().Close(info.data);
+}
+
+TEST(FileManagerTest, MissingFileThrowsOnOpen) {
+  auto path = testing::TempDir() + "file_manager_missing.kdb";
+  std::remove(path.c_str());
+
+  FileManager::Get().Prefetch({path});
+  EXPECT_THROW(FileManager::Get().Open(path), std::system_error);
+}
+
+TEST(FileManagerTest, EvictsUnpinnedFiles) {
+  absl::SetFlag(&FLAGS_buffer_pool_size_mb, 1);
+  auto a = Sequence(150000, 0);
+  auto b = Sequence(150000, 1000000);
+  auto path_a = WriteFile("file_manager_evict_a.kdb", a);
+  auto path_b = WriteFile("file_manager_evict_b.kdb", b);
+
+  auto info_a = FileManager::Get().Open(path_a);
+  ExpectContents(info_a, a);
+  FileManager::Get().Close(info_a.data);
+
+  auto info_b = FileManager::Get().Open(path_b);
+  ExpectContents(info_b, b);
+  EXPECT_EQ(FileManager::Get().ResidentBytes(), info_b.file_length);
+  FileManager::Get().Close(info_b.data);
+
+  // Evicted files are read again.
+  info_a = FileManager::Get().Open(path_a);
+  ExpectContents(info_a, a);
+  EXPECT_EQ(FileManager::Get().ResidentBytes(), info_a.file_length);
+  FileManager::Get().Close(info_a.data);
+  absl::SetFlag(&FLAGS_buffer_pool_size_mb, 0);
+}
+
+TEST(FileManagerTest, KeepsPinnedFiles) {
+  absl::SetFlag(&FLAGS_buffer_pool_size_mb, 1);
+  auto a = Sequence(150000, 7);
+  auto b = Sequence(150000, 2000000);
+  auto path_a = WriteFile("file_manager_pinned_a.kdb", a);
+  auto path_b = WriteFile("file_manager_pinned_b.kdb", b);
+
+  auto info_a = FileManager::Get().Open(path_a);
+  auto info_b = FileManager::Get().Open(path_b);
+  ExpectContents(info_a, a);
+  ExpectContents(info_b, b);
+  EXPECT_GE(FileManager::Get().ResidentBytes(),
+            info_a.file_length + info_b.file_length);
+
+  FileManager::Get().Close(info_a.data);
+  FileManager::Get().Close(info_b.data);
+  absl::SetFlag(&FLAGS_buffer_pool_size_mb, 0);
+}
+
+TEST(FileManagerTest, CloseAtQueryEndKeepsFileUntilQueryEnds) {
+  absl::SetFlag(&FLAGS_buffer_pool_size_mb, 1);
+  absl::SetFlag(&FLAGS_file_mode, "mmap");
+  auto a = Sequence(150000, 13);
+  auto b = Sequence(150000, 4000000);
+  auto c = Sequence(150000, 5000000);
+  auto path_a = WriteFile("file_manager_query_end_a.kdb", a);
+  auto path_b = WriteFile("file_manager_query_end_b.kdb", b);
+  auto path_c = WriteFile("file_manager_query_end_c.kdb", c);
+
+  // Values of a are still referenced after its scan closed it.
+  auto info_a = FileManager::Get().Open(path_a);
+  FileManager::Get().CloseAtQueryEnd(info_a.data);
+
+  auto info_b = FileManager::Get().Open(path_b);
+  ExpectContents(info_b, b);
+  ExpectContents(info_a, a);
+  EXPECT_GE(FileManager::Get().ResidentBytes(),
+            info_a.file_length + info_b.file_length);
+  FileManager::Get().Close(info_b.data);
+
+  // Both are evicted once the query ended.
+  FileManager::Get().EndQuery();
+  auto info_c = FileManager::Get().Open(path_c);
+  ExpectContents(info_c, c);
+  EXPECT_EQ(FileManager::Get().ResidentBytes(), info_c.file_length);
+  FileManager::Get().Close(info_c.data);
+
+  absl::SetFlag(&FLAGS_file_mode, "read");
+  absl::SetFlag(&FLAGS_buffer_pool_size_mb, 0);
+}
+
+TEST(FileManagerTest, PrefetchSkipsFilesOverBudget) {
+  absl::SetFlag(&FLAGS_buffer_pool_size_mb, 1);
+  auto a = Sequence(150000, 11);
+  auto b = Sequence(150000, 3000000);
+  auto path_a = WriteFile("file_manager_budget_a.kdb", a);
+  auto path_b = WriteFile("file_manager_budget_b.kdb", b);
+
+  auto info_a = FileManager::Get().Open(path_a);
+  FileManager::Get().Prefetch({path_b});
+  EXPECT_EQ(FileManager::Get().ResidentBytes(), info_a.file_length);
+  FileManager::Get().Close(info_a.data);
+
+  auto info_b = FileManager::Get().Open(path_b);
+  ExpectContents(info_b, b);
+  FileManager::Get().Close(info_b.data);
+  absl::SetFlag(&FLAGS_buffer_pool_size_mb, 0);
+}
+
+TEST(FileManagerTest, FileModes) {
+  for (std::string mode : {"mmap", "huge_pages"}) {
+    absl::SetFlag(&FLAGS_file_mode, mode);
+    absl::SetFlag(&FLAGS_numa_placement, "interleave");
+
+    // Larger than a chunk so that huge page copies are read in parallel.
+    auto v = Sequence(3 << 20, 42);
+    auto path = WriteFile("file_manager_" + mode + ".kdb", v);
+    auto info = FileManager::Get().Open(path);
+    ExpectContents(info, v);
+    FileManager::Get().Close(info.data);
+  }
+
+  absl::SetFlag(&FLAGS_file_mode, "read");
+  absl::SetFlag(&FLAGS_numa_placement, "none");
+}
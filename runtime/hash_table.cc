@@ -4,6 +4,7 @@
 #include <cstdlib>
 #include <iostream>
 
+#include "runtime/allocator.h"
 #include "runtime/vector.h"
 
 namespace kush::runtime::HashTable {
@@ -38,7 +39,8 @@ runtime::Vector::Vector* GetBucket(HashTable* ht, int32_t hash) {
 void GetAllBuckets(HashTable* ht, BucketList* list) {
   map_type& bucket_map = *ht->data_;
   list->num_buckets = bucket_map.size();
-  list->buckets = new runtime::Vector::Vector*[list->num_buckets];
+  list->buckets = reinterpret_cast<runtime::Vector::Vector**>(
+      runtime::Allocate(sizeof(runtime::Vector::Vector*) * list->num_buckets));
 
   int i = 0;
   for (auto& [k, v] : bucket_map) {
@@ -60,10 +62,9 @@ void Free(HashTable* ht) {
   delete ht->data_;
 }
 
-void BucketListFree(BucketList* ht) { delete[] ht->buckets; }
-
-void HashCombine(int32_t* hash, int64_t v) {
-  *hash ^= v + 0x9e3779b9 + (*hash << 6) + (*hash >> 2);
+void BucketListFree(BucketList* ht) {
+  runtime::Free(ht->buckets,
+                sizeof(runtime::Vector::Vector*) * ht->num_buckets);
 }
 
 }  // namespace kush::runtime::HashTable
\ No newline at end of file
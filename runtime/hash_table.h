@@ -35,6 +35,4 @@ int32_t BucketListSize(BucketList* l);
 
 void BucketListFree(BucketList* bl);
 
-void HashCombine(int32_t* hash, int64_t v);
-
 }  // namespace kush::runtime::HashTable
\ No newline at end of file
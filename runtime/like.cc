@@ -0,0 +1,158 @@
+#include "runtime/like.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "re2/re2.h"
+
+#include "runtime/string.h"
+
+namespace kush::runtime::Like {
+
+std::string ToRegex(std::string_view pattern) {
+  std::string regex = "^";
+  for (auto c : pattern) {
+    switch (c) {
+      case '.':
+      case '+':
+      case '*':
+      case '?':
+      case '^':
+      case '$':
+      case '(':
+      case ')':
+      case '[':
+      case ']':
+      case '{':
+      case '}':
+      case '|':
+      case '\\':
+        regex.push_back('\\');
+        regex.push_back(c);
+        break;
+
+      case '_':
+        regex.push_back('.');
+        break;
+
+      case '%':
+        regex.push_back('.');
+        regex.push_back('*');
+        break;
+
+      default:
+        regex.push_back(c);
+        break;
+    }
+  }
+  regex.push_back('$');
+  return regex;
+}
+
+Pattern::Pattern(std::string_view pattern)
+    : text_(pattern),
+      anchored_start_(pattern.empty() || pattern.front() != '%'),
+      anchored_end_(pattern.empty() || pattern.back() != '%') {
+  size_t start = 0;
+  while (start <= pattern.size()) {
+    auto end = pattern.find('%', start);
+    if (end == std::string_view::npos) {
+      end = pattern.size();
+    }
+    if (end > start) {
+      segments_.emplace_back(pattern.substr(start, end - start));
+    }
+    start = end + 1;
+  }
+
+  if (segments_.empty()) {
+    segments_.emplace_back();
+  }
+
+  if (pattern.find('_') != std::string_view::npos) {
+    // _ matches a single UTF-8 character rather than a byte so leave these to
+    // RE2.
+    kind_ = PatternKind::WILDCARD;
+    regex_ = std::make_unique<re2::RE2>(ToRegex(pattern));
+  } else if (pattern.find('%') == std::string_view::npos) {
+    kind_ = PatternKind::EXACT;
+  } else if (segments_.size() > 1) {
+    kind_ = PatternKind::SEQUENCE;
+  } else if (anchored_start_) {
+    kind_ = PatternKind::PREFIX;
+  } else if (anchored_end_) {
+    kind_ = PatternKind::SUFFIX;
+  } else {
+    kind_ = PatternKind::SUBSTRING;
+  }
+}
+
+PatternKind Pattern::Kind() const { return kind_; }
+
+const std::string& Pattern::Text() const { return text_; }
+
+const std::vector<std::string>& Pattern::Segments() const { return segments_; }
+
+bool Pattern::AnchoredStart() const { return anchored_start_; }
+
+bool Pattern::AnchoredEnd() const { return anchored_end_; }
+
+re2::RE2* Pattern::Regex() const { return regex_.get(); }
+
+bool MatchSequence(String::String* s, Pattern* pattern) {
+  auto view = String::View(s);
+  const auto& segments = pattern->Segments();
+
+  size_t first = 0;
+  size_t last = segments.size();
+  size_t begin = 0;
+  size_t end = view.size();
+
+  if (pattern->AnchoredStart()) {
+    const auto& segment = segments[first++];
+    if (view.compare(0, segment.size(), segment) != 0) {
+      return false;
+    }
+    begin = segment.size();
+  }
+
+  if (pattern->AnchoredEnd() && first < last) {
+    const auto& segment = segments[--last];
+    if (end - begin < segment.size() ||
+        view.compare(end - segment.size(), segment.size(), segment) != 0) {
+      return false;
+    }
+    end -= segment.size();
+  }
+
+  for (size_t i = first; i < last; i++) {
+    const auto& segment = segments[i];
+    auto found = static_cast<const char*>(
+        memmem(view.data() + begin, end - begin, segment.data(),
+               segment.size()));
+    if (found == nullptr) {
+      return false;
+    }
+    begin = found - view.data() + segment.size();
+  }
+
+  return true;
+}
+
+bool Match(String::String* s, Pattern* pattern) {
+  switch (pattern->Kind()) {
+    case PatternKind::EXACT:
+      return String::View(s) == pattern->Segments()[0];
+
+    case PatternKind::WILDCARD:
+      return String::Like(s, pattern->Regex());
+
+    default:
+      return MatchSequence(s, pattern);
+  }
+}
+
+}  // namespace kush::runtime::Like
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "re2/re2.h"
+
+#include "runtime/string.h"
+
+namespace kush::runtime::Like {
+
+enum class PatternKind {
+  // abc
+  EXACT,
+  // abc%
+  PREFIX,
+  // %abc
+  SUFFIX,
+  // %abc%
+  SUBSTRING,
+  // Several literal segments separated by %, e.g. abc%def%
+  SEQUENCE,
+  // Contains _, which matches any single character.
+  WILDCARD,
+};
+
+// A LIKE pattern split on % into its literal segments. Runs of % are
+// collapsed and a pattern of only % has a single empty segment.
+class Pattern {
+ public:
+  explicit Pattern(std::string_view pattern);
+
+  PatternKind Kind() const;
+  const std::string& Text() const;
+  const std::vector<std::string>& Segments() const;
+
+  // Whether the first segment must match at the start of the string and the
+  // last segment at the end.
+  bool AnchoredStart() const;
+  bool AnchoredEnd() const;
+
+  // Only set for WILDCARD patterns.
+  re2::RE2* Regex() const;
+
+ private:
+  std::string text_;
+  std::vector<std::string> segments_;
+  bool anchored_start_;
+  bool anchored_end_;
+  PatternKind kind_;
+  std::unique_ptr<re2::RE2> regex_;
+};
+
+// Matches the segments of a SEQUENCE pattern greedily from the left.
+bool MatchSequence(String::String* s, Pattern* pattern);
+
+// Matches any pattern.
+bool Match(String::String* s, Pattern* pattern);
+
+}  // namespace kush::runtime::Like
@@ -0,0 +1,69 @@
+#include "runtime/like.h"
+
+#include <string_view>
+
+#include "gtest/gtest.h"
+
+#include "runtime/string.h"
+
+using namespace kush::runtime;
+
+bool Matches(std::string_view pattern, std::string_view value) {
+  Like::Pattern p(pattern);
+  String::String s;
+  String::Init(&s, value.data(), value.size());
+  return Like::Match(&s, &p);
+}
+
+TEST(LikeTest, Classifies) {
+  EXPECT_EQ(Like::Pattern("abc").Kind(), Like::PatternKind::EXACT);
+  EXPECT_EQ(Like::Pattern("").Kind(), Like::PatternKind::EXACT);
+  EXPECT_EQ(Like::Pattern("abc%").Kind(), Like::PatternKind::PREFIX);
+  EXPECT_EQ(Like::Pattern("%abc").Kind(), Like::PatternKind::SUFFIX);
+  EXPECT_EQ(Like::Pattern("%abc%").Kind(), Like::PatternKind::SUBSTRING);
+  EXPECT_EQ(Like::Pattern("%%").Kind(), Like::PatternKind::SUBSTRING);
+  EXPECT_EQ(Like::Pattern("%ab%c%").Kind(), Like::PatternKind::SEQUENCE);
+  EXPECT_EQ(Like::Pattern("a%c").Kind(), Like::PatternKind::SEQUENCE);
+  EXPECT_EQ(Like::Pattern("a_c%").Kind(), Like::PatternKind::WILDCARD);
+
+  Like::Pattern p("%%ab%%c%");
+  EXPECT_FALSE(p.AnchoredStart());
+  EXPECT_FALSE(p.AnchoredEnd());
+  EXPECT_EQ(p.Segments(), std::vector<std::string>({"ab", "c"}));
+}
+
+TEST(LikeTest, MatchesSimplePatterns) {
+  EXPECT_TRUE(Matches("abc", "abc"));
+  EXPECT_FALSE(Matches("abc", "abcd"));
+  EXPECT_TRUE(Matches("", ""));
+  EXPECT_TRUE(Matches("abc%", "abcdef"));
+  EXPECT_FALSE(Matches("abc%", "xabc"));
+  EXPECT_TRUE(Matches("%def", "abcdef"));
+  EXPECT_FALSE(Matches("%def", "defx"));
+  EXPECT_TRUE(Matches("%cd%", "abcdef"));
+  EXPECT_FALSE(Matches("%cd%", "acbdef"));
+  EXPECT_TRUE(Matches("%", ""));
+}
+
+TEST(LikeTest, MatchesSequences) {
+  EXPECT_TRUE(Matches("%Downey%Robert%", "Downey Jr., Robert"));
+  EXPECT_FALSE(Matches("%Downey%Robert%", "Robert Downey Jr."));
+  EXPECT_TRUE(Matches("a%c", "abc"));
+  EXPECT_TRUE(Matches("a%c", "ac"));
+  EXPECT_FALSE(Matches("a%c", "a"));
+  EXPECT_FALSE(Matches("ab%bc", "abc"));
+  EXPECT_TRUE(Matches("ab%bc", "abbc"));
+  EXPECT_TRUE(Matches("%a%a%", "banana"));
+  EXPECT_FALSE(Matches("%a%a%a%a%", "banana"));
+  EXPECT_TRUE(Matches("(co%production)%", "(co-production) (as X)"));
+  EXPECT_FALSE(Matches("(co%production)%", "(co) production"));
+}
+
+TEST(LikeTest, MatchesWildcards) {
+  EXPECT_TRUE(Matches("a_c", "abc"));
+  EXPECT_FALSE(Matches("a_c", "abbc"));
+  EXPECT_TRUE(Matches("%a_c%", "xxabcxx"));
+  EXPECT_TRUE(Matches("_", "\xc3\xa9"));
+  EXPECT_TRUE(Matches("a.c_", "a.cd"));
+  EXPECT_FALSE(Matches("a.c_", "abcd"));
+}
@@ -1,5 +1,6 @@
 #include "runtime/memory_column_index.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <exception>
@@ -8,6 +9,7 @@
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <thread>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -66,15 +68,20 @@ uint64_t ConstructEntry(uint16_t salt, uint16_t block_offset,
   return output;
 }
 
-void Resize(MemoryColumnIndex* ht) {
-  auto capacity = ht->capacity * 2;
-  auto mask = capacity - 1;
+namespace {
 
-  auto entries = new uint64_t[capacity];
-  memset(entries, 0, sizeof(uint64_t) * capacity);
+// Tables with fewer entries than this are rebuilt on the calling thread.
+constexpr uint32_t PARALLEL_RESIZE_THRESHOLD = 1 << 16;
 
-  for (uint32_t block_idx = 1; block_idx < ht->payload_block_size;
-       block_idx++) {
+struct PendingEntry {
+  uint32_t entry_idx;
+  uint64_t entry;
+};
+
+template <typename F>
+void ForEachPayload(MemoryColumnIndex* ht, uint32_t start_block,
+                    uint32_t end_block, F f) {
+  for (uint32_t block_idx = start_block; block_idx < end_block; block_idx++) {
     const auto end = block_idx == ht->payload_block_size - 1
                          ? ht->last_payload_offset
                          : BLOCK_SIZE;
@@ -83,16 +90,124 @@ void Resize(MemoryColumnIndex* ht) {
       auto hash_ptr =
           ht->payload_block[block_idx] + block_offset + ht->payload_hash_offset;
       auto hash = *(uint64_t*)(hash_ptr);
-      uint16_t salt = hash >> 48;
+      f(hash, block_offset, block_idx);
+    }
+  }
+}
+
+void InsertEntry(uint64_t* entries, uint64_t mask, uint32_t entry_idx,
+                 uint64_t entry) {
+  while ((entries[entry_idx] & 0xFFFFFFFF) > 0) {
+    entry_idx = (entry_idx + 1) & mask;
+  }
+  entries[entry_idx] = entry;
+}
+
+void SerialResize(MemoryColumnIndex* ht, uint64_t* entries, uint64_t mask) {
+  ForEachPayload(ht, 1, ht->payload_block_size,
+                 [&](uint64_t hash, uint16_t block_offset, uint32_t block_idx) {
+                   uint16_t salt = hash >> 48;
+                   InsertEntry(entries, mask, hash & mask,
+                               ConstructEntry(salt, block_offset, block_idx));
+                 });
+}
+
+// Radix partitions the payloads by the high bits of their slot so that each
+// partition owns a contiguous range of the entry array. Partitions are filled
+// in parallel and entries whose probe sequence runs past the end of their
+// range are inserted serially afterwards. This preserves the linear probing
+// invariant since every slot between an overflowed entry's home slot and the
+// end of its range is occupied.
+void ParallelResize(MemoryColumnIndex* ht, uint64_t* entries, uint64_t mask,
+                    uint32_t capacity, int num_threads) {
+  const int partition_bits = 31 - __builtin_clz(num_threads);
+  const int num_partitions = 1 << partition_bits;
+  const int shift = (63 - __builtin_clzll(capacity)) - partition_bits;
+  const uint32_t partition_capacity = capacity >> partition_bits;
+
+  // Scatter each thread's share of the payload blocks into partitions.
+  std::vector<std::vector<std::vector<PendingEntry>>> scattered(
+      num_partitions,
+      std::vector<std::vector<PendingEntry>>(num_partitions));
+  {
+    const uint32_t num_blocks = ht->payload_block_size - 1;
+    const uint32_t blocks_per_thread =
+        (num_blocks + num_partitions - 1) / num_partitions;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_partitions; t++) {
+      threads.emplace_back([&, t]() {
+        auto start = std::min(num_blocks, t * blocks_per_thread) + 1;
+        auto end = std::min(num_blocks, (t + 1) * blocks_per_thread) + 1;
+        auto& output = scattered[t];
+        ForEachPayload(
+            ht, start, end,
+            [&](uint64_t hash, uint16_t block_offset, uint32_t block_idx) {
+              uint32_t entry_idx = hash & mask;
+              uint16_t salt = hash >> 48;
+              output[entry_idx >> shift].push_back(PendingEntry{
+                  .entry_idx = entry_idx,
+                  .entry = ConstructEntry(salt, block_offset, block_idx)});
+            });
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+  }
 
-      uint32_t entry_idx = hash & mask;
-      while ((entries[entry_idx] & 0xFFFFFFFF) > 0) {
-        entry_idx = (entry_idx + 1) & mask;
-      }
+  // Build each partition within its own range of the entry array.
+  std::vector<std::vector<PendingEntry>> overflow(num_partitions);
+  {
+    std::vector<std::thread> threads;
+    for (int p = 0; p < num_partitions; p++) {
+      threads.emplace_back([&, p]() {
+        const uint32_t end = (p + 1) * partition_capacity;
+        for (int t = 0; t < num_partitions; t++) {
+          for (const auto& pending : scattered[t][p]) {
+            auto entry_idx = pending.entry_idx;
+            while (entry_idx < end && (entries[entry_idx] & 0xFFFFFFFF) > 0) {
+              entry_idx++;
+            }
+
+            if (entry_idx == end) {
+              overflow[p].push_back(pending);
+            } else {
+              entries[entry_idx] = pending.entry;
+            }
+          }
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+  }
 
-      entries[entry_idx] = ConstructEntry(salt, block_offset, block_idx);
+  for (const auto& partition : overflow) {
+    for (const auto& pending : partition) {
+      InsertEntry(entries, mask, pending.entry_idx, pending.entry);
     }
   }
+}
+
+}  // namespace
+
+void Resize(MemoryColumnIndex* ht) {
+  ResizeOnThreads(ht, std::thread::hardware_concurrency());
+}
+
+void ResizeOnThreads(MemoryColumnIndex* ht, int num_threads) {
+  auto capacity = ht->capacity * 2;
+  auto mask = capacity - 1;
+
+  auto entries = new uint64_t[capacity];
+  memset(entries, 0, sizeof(uint64_t) * capacity);
+
+  if (ht->size < PARALLEL_RESIZE_THRESHOLD || num_threads < 2) {
+    SerialResize(ht, entries, mask);
+  } else {
+    ParallelResize(ht, entries, mask, capacity, num_threads);
+  }
 
   delete[] ht->entries;
   ht->entries = entries;
@@ -103,7 +218,7 @@ void Resize(MemoryColumnIndex* ht) {
 void Free(MemoryColumnIndex* ht) {
   delete[] ht->entries;
 
-  for (int i = 0; i < ht->payload_block_size; i++) {
+  for (uint32_t i = 0; i < ht->payload_block_size; i++) {
     delete[] ht->payload_block[i];
   }
   delete[] ht->payload_block;
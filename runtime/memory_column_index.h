@@ -44,6 +44,10 @@ void AllocateNewPage(MemoryColumnIndex* ht);
 
 void Resize(MemoryColumnIndex* ht);
 
+// Resize with an explicit number of worker threads. Resize uses the hardware
+// concurrency.
+void ResizeOnThreads(MemoryColumnIndex* ht, int num_threads);
+
 void Free(MemoryColumnIndex* ht);
 
 uint64_t ConstructEntry(uint16_t salt, uint16_t block_offset,
@@ -0,0 +1,176 @@
+#include "runtime/memory_column_index.h"
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "runtime/column_index_bucket.h"
+
+using kush::runtime::BucketInit;
+using kush::runtime::BucketPushBack;
+using kush::runtime::ColumnIndexBucket;
+using kush::runtime::GetBucketValue;
+using namespace kush::runtime::MemoryColumnIndex;
+
+struct Payload {
+  uint64_t hash;
+  int64_t key;
+};
+
+uint64_t Hash(int64_t key) {
+  return (key * 0x9E3779B97F4A7C15ull) ^ (uint64_t(key) << 48);
+}
+
+// Mirrors the insertion code generated for proxy::MemoryColumnIndex.
+void Insert(MemoryColumnIndex* ht, int64_t key) {
+  auto hash = Hash(key);
+  uint32_t idx = hash & ht->mask;
+  while ((ht->entries[idx] & 0xFFFFFFFF) > 0) {
+    idx = (idx + 1) & ht->mask;
+  }
+
+  ht->size++;
+  if (ht->last_payload_offset + ht->payload_size > BLOCK_SIZE) {
+    AllocateNewPage(ht);
+  }
+  auto block_idx = ht->payload_block_size - 1;
+  auto block_offset = ht->last_payload_offset;
+  ht->last_payload_offset += ht->payload_size;
+
+  auto payload = (Payload*)GetPayload(ht, block_idx, block_offset);
+  payload->hash = hash;
+  payload->key = key;
+  ht->entries[idx] = ConstructEntry(hash >> 48, block_offset, block_idx);
+
+  if (ht->size == ht->capacity || ht->size > ht->capacity / LOAD_FACTOR) {
+    Resize(ht);
+  }
+}
+
+bool Contains(MemoryColumnIndex* ht, int64_t key) {
+  auto hash = Hash(key);
+  uint32_t idx = hash & ht->mask;
+  while ((ht->entries[idx] & 0xFFFFFFFF) > 0) {
+    auto entry = ht->entries[idx];
+    uint32_t block_idx = entry & 0xFFFFFFFF;
+    uint16_t block_offset = entry >> 32;
+    if (((Payload*)GetPayload(ht, block_idx, block_offset))->key == key) {
+      return true;
+    }
+    idx = (idx + 1) & ht->mask;
+  }
+  return false;
+}
+
+TEST(MemoryColumnIndexTest, Resize) {
+  MemoryColumnIndex ht;
+  Init(&ht, sizeof(Payload), 0);
+
+  // Large enough to use the parallel resize for the final doublings.
+  const int64_t num_keys = 1 << 18;
+  for (int64_t i = 0; i < num_keys; i++) {
+    Insert(&ht, i);
+  }
+
+  EXPECT_EQ(ht.size, num_keys);
+  for (int64_t i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(Contains(&ht, i));
+  }
+  EXPECT_FALSE(Contains(&ht, num_keys));
+  EXPECT_FALSE(Contains(&ht, -1));
+
+  Free(&ht);
+}
+
+struct BucketPayload {
+  uint64_t hash;
+  int64_t key;
+  ColumnIndexBucket bucket;
+};
+
+BucketPayload* Find(MemoryColumnIndex* ht, int64_t key) {
+  auto hash = Hash(key);
+  uint32_t idx = hash & ht->mask;
+  while ((ht->entries[idx] & 0xFFFFFFFF) > 0) {
+    auto entry = ht->entries[idx];
+    uint32_t block_idx = entry & 0xFFFFFFFF;
+    uint16_t block_offset = entry >> 32;
+    auto payload = (BucketPayload*)GetPayload(ht, block_idx, block_offset);
+    if (payload->key == key) {
+      return payload;
+    }
+    idx = (idx + 1) & ht->mask;
+  }
+  return nullptr;
+}
+
+// Mirrors the insertion code generated for proxy::MemoryColumnIndex, always
+// rebuilding on num_threads threads.
+void InsertTuple(MemoryColumnIndex* ht, int64_t key, int32_t tuple_idx,
+                 int num_threads) {
+  if (auto payload = Find(ht, key)) {
+    BucketPushBack(&payload->bucket, tuple_idx);
+    return;
+  }
+
+  auto hash = Hash(key);
+  uint32_t idx = hash & ht->mask;
+  while ((ht->entries[idx] & 0xFFFFFFFF) > 0) {
+    idx = (idx + 1) & ht->mask;
+  }
+
+  ht->size++;
+  if (ht->last_payload_offset + ht->payload_size > BLOCK_SIZE) {
+    AllocateNewPage(ht);
+  }
+  auto block_idx = ht->payload_block_size - 1;
+  auto block_offset = ht->last_payload_offset;
+  ht->last_payload_offset += ht->payload_size;
+
+  auto payload = (BucketPayload*)GetPayload(ht, block_idx, block_offset);
+  payload->hash = hash;
+  payload->key = key;
+  BucketInit(&payload->bucket, ht->allocator);
+  BucketPushBack(&payload->bucket, tuple_idx);
+  ht->entries[idx] = ConstructEntry(hash >> 48, block_offset, block_idx);
+
+  if (ht->size == ht->capacity || ht->size > ht->capacity / LOAD_FACTOR) {
+    ResizeOnThreads(ht, num_threads);
+  }
+}
+
+TEST(MemoryColumnIndexTest, ParallelResizeBuckets) {
+  MemoryColumnIndex ht;
+  Init(&ht, sizeof(BucketPayload), 0);
+
+  // Past the parallel resize threshold with several tuples per key.
+  const int64_t num_keys = 3 << 16;
+  const int32_t tuples_per_key = 3;
+  for (int32_t i = 0; i < num_keys * tuples_per_key; i++) {
+    InsertTuple(&ht, i % num_keys, i, 4);
+  }
+  EXPECT_EQ(ht.size, num_keys);
+
+  for (int64_t key = 0; key < num_keys; key++) {
+    auto payload = Find(&ht, key);
+    ASSERT_NE(payload, nullptr);
+    ASSERT_EQ(payload->bucket.size, tuples_per_key);
+    for (int32_t i = 0; i < tuples_per_key; i++) {
+      EXPECT_EQ(GetBucketValue(&payload->bucket, i), key + i * num_keys);
+    }
+  }
+  EXPECT_EQ(Find(&ht, num_keys), nullptr);
+
+  // Every occupied slot refers to a distinct payload.
+  std::unordered_set<uint64_t> occupied;
+  for (uint32_t i = 0; i < ht.capacity; i++) {
+    if ((ht.entries[i] & 0xFFFFFFFF) > 0) {
+      EXPECT_TRUE(occupied.insert(ht.entries[i] & 0xFFFFFFFFFFFF).second);
+    }
+  }
+  EXPECT_EQ(occupied.size(), num_keys);
+
+  Free(&ht);
+}
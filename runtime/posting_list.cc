@@ -0,0 +1,156 @@
+#include "runtime/posting_list.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace kush::runtime::PostingList {
+
+namespace {
+
+// Word loads while unpacking may read up to this many bytes past the last
+// packed byte.
+constexpr uint64_t PADDING = sizeof(uint64_t) - 1;
+
+int32_t NumBlocks(int32_t size) { return (size + BLOCK_SIZE - 1) / BLOCK_SIZE; }
+
+int32_t BlockLength(int32_t size, int32_t block) {
+  return std::min(BLOCK_SIZE, size - block * BLOCK_SIZE);
+}
+
+uint8_t BitWidth(const int32_t* values, int32_t length) {
+  uint32_t max_delta = 0;
+  for (int i = 1; i < length; i++) {
+    max_delta = std::max(max_delta, uint32_t(values[i] - values[i - 1] - 1));
+  }
+  return max_delta == 0 ? 0 : 32 - __builtin_clz(max_delta);
+}
+
+uint64_t PackedSize(uint8_t bit_width, int32_t length) {
+  return (uint64_t(bit_width) * (length - 1) + 7) / 8;
+}
+
+SkipPointer GetSkipPointer(const uint8_t* src, int32_t block) {
+  SkipPointer skip;
+  memcpy(&skip, src + block * sizeof(SkipPointer), sizeof(SkipPointer));
+  return skip;
+}
+
+}  // namespace
+
+uint64_t EncodedSize(const int32_t* values, int32_t size) {
+  // A single tuple id is stored as is.
+  if (size == 1) {
+    return sizeof(int32_t);
+  }
+
+  const auto num_blocks = NumBlocks(size);
+  uint64_t length = num_blocks * sizeof(SkipPointer);
+  bool packed = false;
+  for (int block = 0; block < num_blocks; block++) {
+    auto block_values = values + block * BLOCK_SIZE;
+    auto block_length = BlockLength(size, block);
+    auto packed_size =
+        PackedSize(BitWidth(block_values, block_length), block_length);
+    packed |= packed_size > 0;
+    length += 1 + packed_size;
+  }
+
+  // The word accesses of any packed block may spill past the end of the list
+  // when the blocks after it are shorter than the padding.
+  return packed ? length + PADDING : length;
+}
+
+void Encode(const int32_t* values, int32_t size, uint8_t* dest) {
+  if (size == 1) {
+    memcpy(dest, values, sizeof(int32_t));
+    return;
+  }
+
+  const auto num_blocks = NumBlocks(size);
+  uint64_t offset = num_blocks * sizeof(SkipPointer);
+
+  for (int block = 0; block < num_blocks; block++) {
+    auto block_values = values + block * BLOCK_SIZE;
+    auto block_length = BlockLength(size, block);
+    auto bit_width = BitWidth(block_values, block_length);
+
+    SkipPointer skip{.first = block_values[0], .offset = uint32_t(offset)};
+    memcpy(dest + block * sizeof(SkipPointer), &skip, sizeof(SkipPointer));
+    dest[offset++] = bit_width;
+
+    auto packed_size = PackedSize(bit_width, block_length);
+    if (packed_size == 0) {
+      continue;
+    }
+
+    // Zero the packed bytes and the bytes that the word stores spill into.
+    memset(dest + offset, 0, packed_size + PADDING);
+    uint64_t bit = 0;
+    for (int i = 1; i < block_length; i++, bit += bit_width) {
+      uint64_t delta = uint32_t(block_values[i] - block_values[i - 1] - 1);
+      uint64_t word;
+      memcpy(&word, dest + offset + bit / 8, sizeof(uint64_t));
+      word |= delta << (bit % 8);
+      memcpy(dest + offset + bit / 8, &word, sizeof(uint64_t));
+    }
+    offset += packed_size;
+  }
+}
+
+int32_t DecodeBlock(const uint8_t* src, int32_t size, int32_t block,
+                    int32_t* dest) {
+  if (size == 1) {
+    memcpy(dest, src, sizeof(int32_t));
+    return 1;
+  }
+
+  auto skip = GetSkipPointer(src, block);
+  auto block_length = BlockLength(size, block);
+  auto packed = src + skip.offset;
+  const uint8_t bit_width = *packed++;
+
+  int32_t value = skip.first;
+  dest[0] = value;
+  if (bit_width == 0) {
+    for (int i = 1; i < block_length; i++) {
+      dest[i] = ++value;
+    }
+    return block_length;
+  }
+
+  const uint64_t mask = (1ull << bit_width) - 1;
+  uint64_t bit = 0;
+  for (int i = 1; i < block_length; i++, bit += bit_width) {
+    uint64_t word;
+    memcpy(&word, packed + bit / 8, sizeof(uint64_t));
+    value += ((word >> (bit % 8)) & mask) + 1;
+    dest[i] = value;
+  }
+  return block_length;
+}
+
+void Decode(const uint8_t* src, int32_t size, int32_t* dest) {
+  const auto num_blocks = NumBlocks(size);
+  for (int block = 0; block < num_blocks; block++) {
+    DecodeBlock(src, size, block, dest + block * BLOCK_SIZE);
+  }
+}
+
+int32_t FindBlock(const uint8_t* src, int32_t size, int32_t target) {
+  int32_t start = 0;
+  int32_t end = NumBlocks(size) - 1;
+  int32_t result = 0;
+  while (start <= end) {
+    int32_t mid = (start + end) / 2;
+    if (size > 1 && GetSkipPointer(src, mid).first > target) {
+      end = mid - 1;
+    } else {
+      result = mid;
+      start = mid + 1;
+    }
+  }
+  return result;
+}
+
+}  // namespace kush::runtime::PostingList
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+namespace kush::runtime::PostingList {
+
+// Posting lists are strictly increasing tuple ids stored in blocks of
+// BLOCK_SIZE values. Each block is prefixed by a skip pointer holding its
+// first value and byte offset, followed by the bit width and the bit-packed
+// deltas (minus one) of the remaining values in the block. A block where every
+// tuple id is consecutive is stored with a bit width of zero. A list with a
+// single tuple id stores only that id.
+constexpr int32_t BLOCK_SIZE = 128;
+
+struct SkipPointer {
+  int32_t first;
+  uint32_t offset;
+};
+
+// Number of bytes needed to encode values[0, size).
+uint64_t EncodedSize(const int32_t* values, int32_t size);
+
+void Encode(const int32_t* values, int32_t size, uint8_t* dest);
+
+// Decodes the entire list of size values into dest.
+void Decode(const uint8_t* src, int32_t size, int32_t* dest);
+
+// Decodes block into dest and returns the number of values in it.
+int32_t DecodeBlock(const uint8_t* src, int32_t size, int32_t block,
+                    int32_t* dest);
+
+// Returns the last block whose first value is less than or equal to target
+// or 0 if none exist.
+int32_t FindBlock(const uint8_t* src, int32_t size, int32_t target);
+
+}  // namespace kush::runtime::PostingList
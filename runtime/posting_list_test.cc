@@ -0,0 +1,84 @@
+#include "runtime/posting_list.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace kush::runtime::PostingList;
+
+std::vector<int32_t> RoundTrip(const std::vector<int32_t>& values) {
+  std::vector<uint8_t> encoded(EncodedSize(values.data(), values.size()));
+  Encode(values.data(), values.size(), encoded.data());
+
+  std::vector<int32_t> decoded(values.size());
+  Decode(encoded.data(), values.size(), decoded.data());
+  return decoded;
+}
+
+TEST(PostingListTest, Single) {
+  std::vector<int32_t> values{42};
+  EXPECT_EQ(RoundTrip(values), values);
+  EXPECT_EQ(EncodedSize(values.data(), values.size()), sizeof(int32_t));
+}
+
+TEST(PostingListTest, Dense) {
+  std::vector<int32_t> values;
+  for (int i = 0; i < 1000; i++) {
+    values.push_back(500 + i);
+  }
+  EXPECT_EQ(RoundTrip(values), values);
+
+  // Consecutive ids only need the skip pointers and a bit width per block.
+  auto num_blocks = (values.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  EXPECT_EQ(EncodedSize(values.data(), values.size()),
+            num_blocks * (sizeof(SkipPointer) + 1));
+}
+
+TEST(PostingListTest, Sparse) {
+  std::vector<int32_t> values;
+  int32_t v = 0;
+  for (int i = 0; i < 1000; i++) {
+    v += 1 + (i * 7919) % 1013;
+    values.push_back(v);
+  }
+  values.push_back(INT32_MAX);
+  EXPECT_EQ(RoundTrip(values), values);
+  EXPECT_LT(EncodedSize(values.data(), values.size()),
+            values.size() * sizeof(int32_t));
+}
+
+TEST(PostingListTest, SparseThenDense) {
+  // The word stores of the packed first block spill past the short dense
+  // block that ends the list.
+  std::vector<int32_t> values;
+  for (int i = 0; i < BLOCK_SIZE; i++) {
+    values.push_back(5 * i);
+  }
+  values.push_back(5 * BLOCK_SIZE);
+  values.push_back(5 * BLOCK_SIZE + 1);
+  EXPECT_EQ(RoundTrip(values), values);
+}
+
+TEST(PostingListTest, Blocks) {
+  std::vector<int32_t> values;
+  for (int i = 0; i < 1000; i++) {
+    values.push_back(3 * i);
+  }
+
+  std::vector<uint8_t> encoded(EncodedSize(values.data(), values.size()));
+  Encode(values.data(), values.size(), encoded.data());
+
+  EXPECT_EQ(FindBlock(encoded.data(), values.size(), -1), 0);
+  EXPECT_EQ(FindBlock(encoded.data(), values.size(), 0), 0);
+  EXPECT_EQ(FindBlock(encoded.data(), values.size(), 3 * BLOCK_SIZE - 1), 0);
+  EXPECT_EQ(FindBlock(encoded.data(), values.size(), 3 * BLOCK_SIZE), 1);
+  EXPECT_EQ(FindBlock(encoded.data(), values.size(), 5000), 7);
+
+  std::vector<int32_t> block(BLOCK_SIZE);
+  EXPECT_EQ(DecodeBlock(encoded.data(), values.size(), 7, block.data()),
+            1000 - 7 * BLOCK_SIZE);
+  for (int i = 0; i < 1000 - 7 * BLOCK_SIZE; i++) {
+    EXPECT_EQ(block[i], values[7 * BLOCK_SIZE + i]);
+  }
+}
@@ -0,0 +1,31 @@
+#include "runtime/predicate_order.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace kush::runtime {
+
+void ReorderPredicates(int32_t num_preds, int32_t* order, int32_t* cost,
+                       int64_t* counts, int64_t* samples) {
+  auto evaluated = counts;
+  auto passed = counts + num_preds;
+
+  std::vector<double> rank(num_preds);
+  for (int i = 0; i < num_preds; i++) {
+    evaluated[i] = evaluated[i] / 2 + samples[i];
+    passed[i] = passed[i] / 2 + samples[num_preds + i];
+    samples[i] = 0;
+    samples[num_preds + i] = 0;
+
+    // Smooth the pass rate so that predicates that were never evaluated
+    // still get a finite rank.
+    double pass_rate = (passed[i] + 1.0) / (evaluated[i] + 2.0);
+    rank[i] = cost[i] / (1 - pass_rate);
+  }
+
+  std::stable_sort(order, order + num_preds,
+                   [&](int32_t a, int32_t b) { return rank[a] < rank[b]; });
+}
+
+}  // namespace kush::runtime
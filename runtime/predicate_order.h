@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+namespace kush::runtime {
+
+// Sorts the order of a conjunction of num_preds predicates by increasing
+// cost / (1 - pass rate). counts holds the evaluated counts of each predicate
+// followed by the passed counts and samples the counts taken in the last
+// morsel. The totals are halved before the samples are added so that the
+// order keeps adapting to the data. The samples are reset afterwards.
+void ReorderPredicates(int32_t num_preds, int32_t* order, int32_t* cost,
+                       int64_t* counts, int64_t* samples);
+
+}  // namespace kush::runtime
@@ -0,0 +1,74 @@
+#include "runtime/predicate_order.h"
+
+#include "gtest/gtest.h"
+
+using namespace kush::runtime;
+
+TEST(PredicateOrderTest, SelectiveFirst) {
+  int32_t order[3] = {0, 1, 2};
+  int32_t cost[3] = {1, 1, 1};
+  int64_t counts[6] = {0, 0, 0, 0, 0, 0};
+  int64_t samples[6] = {1000, 1000, 1000, 900, 10, 500};
+
+  ReorderPredicates(3, order, cost, counts, samples);
+  EXPECT_EQ(order[0], 1);
+  EXPECT_EQ(order[1], 2);
+  EXPECT_EQ(order[2], 0);
+}
+
+TEST(PredicateOrderTest, CheapFirst) {
+  int32_t order[2] = {0, 1};
+  int32_t cost[2] = {4, 1};
+  int64_t counts[4] = {1000, 1000, 500, 500};
+  int64_t samples[4] = {0, 0, 0, 0};
+
+  ReorderPredicates(2, order, cost, counts, samples);
+  EXPECT_EQ(order[0], 1);
+  EXPECT_EQ(order[1], 0);
+}
+
+TEST(PredicateOrderTest, KeepsOrderWithoutCounts) {
+  int32_t order[3] = {2, 0, 1};
+  int32_t cost[3] = {1, 1, 1};
+  int64_t counts[6] = {0, 0, 0, 0, 0, 0};
+  int64_t samples[6] = {0, 0, 0, 0, 0, 0};
+
+  ReorderPredicates(3, order, cost, counts, samples);
+  EXPECT_EQ(order[0], 2);
+  EXPECT_EQ(order[1], 0);
+  EXPECT_EQ(order[2], 1);
+}
+
+TEST(PredicateOrderTest, MergesSamples) {
+  int32_t order[1] = {0};
+  int32_t cost[1] = {1};
+  int64_t counts[2] = {100, 40};
+  int64_t samples[2] = {10, 5};
+
+  ReorderPredicates(1, order, cost, counts, samples);
+  EXPECT_EQ(counts[0], 60);
+  EXPECT_EQ(counts[1], 25);
+  EXPECT_EQ(samples[0], 0);
+  EXPECT_EQ(samples[1], 0);
+}
+
+TEST(PredicateOrderTest, SamplesOverrideOldCounts) {
+  int32_t order[2] = {0, 1};
+  int32_t cost[2] = {1, 1};
+  int64_t counts[4] = {100, 100, 10, 90};
+  int64_t samples[4] = {0, 0, 0, 0};
+
+  ReorderPredicates(2, order, cost, counts, samples);
+  EXPECT_EQ(order[0], 0);
+
+  // Predicate 1 turned selective and 0 stopped filtering.
+  for (int i = 0; i < 5; i++) {
+    samples[0] = 100;
+    samples[1] = 100;
+    samples[2] = 100;
+    samples[3] = 0;
+    ReorderPredicates(2, order, cost, counts, samples);
+  }
+  EXPECT_EQ(order[0], 1);
+  EXPECT_EQ(order[1], 0);
+}
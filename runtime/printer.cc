@@ -32,7 +32,7 @@ void PrintFloat64(double v) { std::cout << std::fixed << v << "|"; }
 void PrintNewline() { std::cout << "\n"; }
 
 void PrintString(kush::runtime::String::String* str) {
-  std::cout << std::string_view(str->data, str->length) << "|";
+  std::cout << kush::runtime::String::View(str) << "|";
 }
 
 void PrintBoolDebug(bool v) { std::cerr << (v ? 't' : 'f') << "|"; }
@@ -57,7 +57,7 @@ void PrintFloat64Debug(double v) { std::cerr << std::fixed << v << "|"; }
 void PrintNewlineDebug() { std::cerr << std::endl; }
 
 void PrintStringDebug(kush::runtime::String::String* str) {
-  std::cerr << std::string_view(str->data, str->length) << "|";
+  std::cerr << kush::runtime::String::View(str) << "|";
 }
 
 }  // namespace kush::runtime::Printer
\ No newline at end of file
@@ -16,6 +16,7 @@
 #include "absl/flags/flag.h"
 
 #include "compile/translators/recompiling_join_translator.h"
+#include "runtime/tuple_idx_table/tuple_idx_table.h"
 
 ABSL_FLAG(int32_t, budget_per_episode, 10000, "Budget per episode");
 ABSL_FLAG(bool, forget, false, "Forget learned info periodically.");
@@ -249,6 +250,16 @@ class JoinEnvironment {
     return last_completed_tuple;
   }
 
+  // Every result tuple with some tuple_idx[i] <= offset[i] has already been
+  // pushed to the parent and cannot be produced again, so it no longer needs
+  // to be kept around for deduplication.
+  void EvictCompletedResults(void* tuple_idx_table,
+                             const std::vector<int32_t>& offset) {
+    TupleIdxTable::Evict(
+        static_cast<TupleIdxTable::TupleIdxTable*>(tuple_idx_table),
+        offset.data());
+  }
+
   double Reward(const std::vector<int32_t>& order,
                 const std::vector<int32_t>& offset,
                 const std::vector<int32_t>& initial_last_completed_tuple,
@@ -295,7 +306,7 @@ class PermutableJoinEnvironment : public JoinEnvironment {
           table_functions,
       const std::add_pointer<int32_t(int32_t, int8_t)>::type
           valid_tuple_handler,
-      PermutableExecutionEngineFlags execution_engine)
+      PermutableExecutionEngineFlags execution_engine, void* tuple_idx_table)
       : num_preds_(num_preds),
         num_flags_(num_flags),
         budget_per_episode_(FLAGS_budget_per_episode.Get()),
@@ -305,7 +316,8 @@ class PermutableJoinEnvironment : public JoinEnvironment {
         table_functions_(table_functions),
         valid_tuple_handler_(valid_tuple_handler),
         state_(cardinalities_),
-        execution_engine_(execution_engine) {}
+        execution_engine_(execution_engine),
+        tuple_idx_table_(tuple_idx_table) {}
 
   bool IsConnected(const absl::btree_set<int>& joined_tables,
                    int table) override {
@@ -339,6 +351,9 @@ class PermutableJoinEnvironment : public JoinEnvironment {
         execution_engine_.idx_arr);
 
     state_.Update(order, final_last_completed_tuple);
+    if (!state_.IsComplete()) {
+      EvictCompletedResults(tuple_idx_table_, offset);
+    }
 
     return Reward(order, offset,
                   initial_last_completed_tuple.value_or(
@@ -424,6 +439,7 @@ class PermutableJoinEnvironment : public JoinEnvironment {
   const std::add_pointer<int32_t(int32_t, int8_t)>::type valid_tuple_handler_;
   JoinState state_;
   PermutableExecutionEngineFlags execution_engine_;
+  void* tuple_idx_table_;
 };
 
 struct RecompilationExecutionEngineFlags {
@@ -520,6 +536,9 @@ class RecompilationJoinEnvironment : public JoinEnvironment {
         std::cerr << std::endl;
     */
     state_.Update(order, final_last_completed_tuple);
+    if (!state_.IsComplete()) {
+      EvictCompletedResults(tuple_idx_table_, offset);
+    }
 
     auto reward =
         Reward(order, offset,
@@ -846,7 +865,7 @@ void ExecutePermutableSkinnerJoin(
     std::add_pointer<int32_t(int32_t, int8_t)>::type valid_tuple_handler,
     int32_t num_flags, int8_t* flag_arr, int32_t* progress_arr,
     int32_t* table_ctr, int32_t* idx_arr, int32_t* num_result_tuples,
-    int32_t* offset_arr) {
+    int32_t* offset_arr, void* tuple_idx_table) {
   auto table_functions =
       ReconstructTableFunctions(num_tables, join_handler_fn_arr);
   auto cardinalities = ReconstructCardinalities(num_tables, idx_arr);
@@ -869,7 +888,8 @@ void ExecutePermutableSkinnerJoin(
 
   PermutableJoinEnvironment environment(
       num_preds, num_flags, pred_table_to_flag, table_connections,
-      cardinalities, table_functions, valid_tuple_handler, execution_engine);
+      cardinalities, table_functions, valid_tuple_handler, execution_engine,
+      tuple_idx_table);
 
   UctJoinAgent agent(num_tables, environment, prefix_order);
 
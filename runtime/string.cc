@@ -12,19 +12,18 @@
 namespace kush::runtime::String {
 
 void Copy(String* dest, String* src) {
-  dest->data = src->data;
-  dest->length = src->length;
+  std::memcpy(dest, src, sizeof(String));
 }
 
 bool Contains(String* s1, String* s2) {
-  auto sv1 = std::string_view(s1->data, s1->length);
-  auto sv2 = std::string_view(s2->data, s2->length);
-  return sv1.find(sv2) != std::string_view::npos;
+  auto sv1 = View(s1);
+  auto sv2 = View(s2);
+  return memmem(sv1.data(), sv1.size(), sv2.data(), sv2.size()) != nullptr;
 }
 
 bool EndsWith(String* s1, String* s2) {
-  auto sv1 = std::string_view(s1->data, s1->length);
-  auto sv2 = std::string_view(s2->data, s2->length);
+  auto sv1 = View(s1);
+  auto sv2 = View(s2);
 
   if (sv1.length() >= sv2.length()) {
     return (0 == sv1.compare(sv1.length() - sv2.length(), sv2.length(), sv2));
@@ -34,50 +33,41 @@ bool EndsWith(String* s1, String* s2) {
 }
 
 bool StartsWith(String* s1, String* s2) {
-  auto sv1 = std::string_view(s1->data, s1->length);
-  auto sv2 = std::string_view(s2->data, s2->length);
+  auto sv1 = View(s1);
+  auto sv2 = View(s2);
   return sv1.rfind(sv2, 0) == 0;
 }
 
 bool Equals(String* s1, String* s2) {
-  auto sv1 = std::string_view(s1->data, s1->length);
-  auto sv2 = std::string_view(s2->data, s2->length);
-  return sv1 == sv2;
-}
+  // Compares the length and prefix at once.
+  if (std::memcmp(s1, s2, 8) != 0) {
+    return false;
+  }
 
-bool NotEquals(String* s1, String* s2) {
-  auto sv1 = std::string_view(s1->data, s1->length);
-  auto sv2 = std::string_view(s2->data, s2->length);
-  return sv1 != sv2;
-}
+  if (IsInlined(s1)) {
+    return std::memcmp(s1->inlined, s2->inlined, sizeof(s1->inlined)) == 0;
+  }
 
-bool LessThan(String* s1, String* s2) {
-  return std::string_view(s1->data, s1->length) <
-         std::string_view(s2->data, s2->length);
+  return std::memcmp(s1->ptr + 4, s2->ptr + 4, s1->length - 4) == 0;
 }
 
-bool LessThanEquals(String* s1, String* s2) {
-  return std::string_view(s1->data, s1->length) <=
-         std::string_view(s2->data, s2->length);
-}
+bool NotEquals(String* s1, String* s2) { return !Equals(s1, s2); }
 
-bool GreaterThan(String* s1, String* s2) {
-  return std::string_view(s1->data, s1->length) >
-         std::string_view(s2->data, s2->length);
-}
+bool LessThan(String* s1, String* s2) { return View(s1) < View(s2); }
 
-bool GreaterThanEquals(String* s1, String* s2) {
-  return std::string_view(s1->data, s1->length) >=
-         std::string_view(s2->data, s2->length);
-}
+bool LessThanEquals(String* s1, String* s2) { return View(s1) <= View(s2); }
+
+bool GreaterThan(String* s1, String* s2) { return View(s1) > View(s2); }
+
+bool GreaterThanEquals(String* s1, String* s2) { return View(s1) >= View(s2); }
 
 int64_t Hash(String* s1) {
-  auto sv1 = std::string_view(s1->data, s1->length);
+  auto sv1 = View(s1);
   return std::hash<std::string_view>{}(sv1);
 }
 
 bool Like(String* s1, re2::RE2* matcher) {
-  re2::StringPiece sp1(s1->data, s1->length);
+  re2::StringPiece sp1(Data(s1), s1->length);
   return RE2::FullMatch(sp1, *matcher);
 }
 
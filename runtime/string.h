@@ -10,11 +10,44 @@
 
 namespace kush::runtime::String {
 
+// Strings of up to INLINE_LENGTH bytes are stored in the struct itself,
+// starting at prefix, with the unused bytes zeroed. Longer strings keep their
+// first four bytes in prefix so most comparisons never dereference ptr.
+constexpr int32_t INLINE_LENGTH = 12;
+
 struct String {
-  const char* data;
   int32_t length;
+  char prefix[4];
+  union {
+    char inlined[8];
+    const char* ptr;
+  };
 };
 
+static_assert(sizeof(String) == 16);
+
+inline bool IsInlined(const String* s) { return s->length <= INLINE_LENGTH; }
+
+inline const char* Data(const String* s) {
+  return IsInlined(s) ? s->prefix : s->ptr;
+}
+
+inline std::string_view View(const String* s) {
+  return std::string_view(Data(s), s->length);
+}
+
+// Points dest at data, copying it in when it fits.
+inline void Init(String* dest, const char* data, int32_t length) {
+  std::memset(dest, 0, sizeof(String));
+  dest->length = length;
+  if (length <= INLINE_LENGTH) {
+    std::memcpy(dest->prefix, data, length);
+  } else {
+    std::memcpy(dest->prefix, data, sizeof(dest->prefix));
+    dest->ptr = data;
+  }
+}
+
 void Copy(String* dest, String* src);
 void Free(String* src);
 bool Contains(String* s1, String* s2);
@@ -0,0 +1,53 @@
+#include "runtime/string.h"
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace kush::runtime::String;
+
+String Make(std::string_view value) {
+  String s;
+  Init(&s, value.data(), value.size());
+  return s;
+}
+
+TEST(StringTest, InlinesShortStrings) {
+  std::string_view short_value("twelve bytes");
+  auto s = Make(short_value);
+  EXPECT_TRUE(IsInlined(&s));
+  EXPECT_NE(Data(&s), short_value.data());
+  EXPECT_EQ(View(&s), short_value);
+
+  std::string_view long_value("thirteen byte");
+  auto l = Make(long_value);
+  EXPECT_FALSE(IsInlined(&l));
+  EXPECT_EQ(Data(&l), long_value.data());
+  EXPECT_EQ(std::string_view(l.prefix, 4), "thir");
+}
+
+TEST(StringTest, Compares) {
+  std::vector<String> values{Make(""),
+                             Make("a"),
+                             Make("ab"),
+                             Make("abc"),
+                             Make("abcdefghijkl"),
+                             Make("abcdefghijklm"),
+                             Make("abcdefghijkln"),
+                             Make("b")};
+
+  for (std::size_t i = 0; i < values.size(); i++) {
+    for (std::size_t j = 0; j < values.size(); j++) {
+      EXPECT_EQ(Equals(&values[i], &values[j]), i == j);
+      EXPECT_EQ(NotEquals(&values[i], &values[j]), i != j);
+      EXPECT_EQ(LessThan(&values[i], &values[j]), i < j);
+      EXPECT_EQ(GreaterThanEquals(&values[i], &values[j]), i >= j);
+    }
+  }
+
+  std::string copy("abcdefghijklm");
+  auto s = Make(copy);
+  EXPECT_TRUE(Equals(&s, &values[5]));
+}
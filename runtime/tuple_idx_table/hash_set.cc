@@ -0,0 +1,166 @@
+#include "runtime/tuple_idx_table/hash_set.h"
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace kush::runtime::TupleIdxTable {
+
+namespace {
+
+constexpr uint64_t INITIAL_CAPACITY = 1 << 8;
+
+__m256i LoadMask(int32_t len) {
+  const auto lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  return _mm256_cmpgt_epi32(_mm256_set1_epi32(len), lanes);
+}
+
+}  // namespace
+
+HashSet::HashSet(int32_t len) : len_(len), size_(0) {
+  for (auto& partition : partitions_) {
+    partition.slots.resize(INITIAL_CAPACITY, 0);
+    partition.mask = INITIAL_CAPACITY - 1;
+    partition.size = 0;
+  }
+}
+
+uint64_t HashSet::Hash(const int32_t* tuple_idx) const {
+  uint64_t h = 0x8445d61a4e774912 ^ len_;
+  for (int i = 0; i < len_; i++) {
+    h ^= uint32_t(tuple_idx[i]);
+    h *= 0xc6a4a7935bd1e995;
+    h ^= h >> 47;
+  }
+  return h;
+}
+
+bool HashSet::Equals(const int32_t* a, const int32_t* b) const {
+  int i = 0;
+  for (; i + 8 <= len_; i += 8) {
+    auto eq = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(a + i)),
+                                 _mm256_loadu_si256((const __m256i*)(b + i)));
+    if (_mm256_movemask_epi8(eq) != -1) {
+      return false;
+    }
+  }
+
+  if (i < len_) {
+    const auto mask = LoadMask(len_ - i);
+    auto eq = _mm256_cmpeq_epi32(_mm256_maskload_epi32(a + i, mask),
+                                 _mm256_maskload_epi32(b + i, mask));
+    if (_mm256_movemask_epi8(eq) != -1) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void HashSet::Rehash(Partition& partition, uint64_t capacity) {
+  const uint64_t mask = capacity - 1;
+  std::vector<uint64_t> slots(capacity, 0);
+
+  for (int32_t row = 0; row < partition.size; row++) {
+    auto hash = Hash(partition.rows.data() + row * len_);
+    auto idx = hash & mask;
+    while (slots[idx] != 0) {
+      idx = (idx + 1) & mask;
+    }
+    slots[idx] = (hash & 0xFFFFFFFF00000000) | uint64_t(row + 1);
+  }
+
+  partition.slots = std::move(slots);
+  partition.mask = mask;
+}
+
+bool HashSet::Insert(const int32_t* tuple_idx) {
+  const auto hash = Hash(tuple_idx);
+  const auto tag = hash & 0xFFFFFFFF00000000;
+  auto& partition = partitions_[hash >> (64 - PARTITION_BITS)];
+
+  auto idx = hash & partition.mask;
+  while (partition.slots[idx] != 0) {
+    auto slot = partition.slots[idx];
+    if ((slot & 0xFFFFFFFF00000000) == tag) {
+      auto row = int32_t(slot & 0xFFFFFFFF) - 1;
+      if (Equals(partition.rows.data() + row * len_, tuple_idx)) {
+        return false;
+      }
+    }
+    idx = (idx + 1) & partition.mask;
+  }
+
+  partition.rows.insert(partition.rows.end(), tuple_idx, tuple_idx + len_);
+  partition.slots[idx] = tag | uint64_t(partition.size + 1);
+  partition.size++;
+  size_++;
+
+  // Keep the load factor at most 1/2
+  if (2 * uint64_t(partition.size) > partition.slots.size()) {
+    Rehash(partition, 2 * partition.slots.size());
+  }
+  return true;
+}
+
+void HashSet::Evict(const int32_t* offset) {
+  for (auto& partition : partitions_) {
+    int32_t kept = 0;
+    for (int32_t row = 0; row < partition.size; row++) {
+      const int32_t* tuple_idx = partition.rows.data() + row * len_;
+
+      bool evict = false;
+      for (int i = 0; i < len_; i++) {
+        evict |= tuple_idx[i] <= offset[i];
+      }
+      if (evict) {
+        continue;
+      }
+
+      if (kept != row) {
+        memcpy(partition.rows.data() + kept * len_, tuple_idx,
+               len_ * sizeof(int32_t));
+      }
+      kept++;
+    }
+
+    if (kept == partition.size) {
+      continue;
+    }
+
+    size_ -= partition.size - kept;
+    partition.size = kept;
+    partition.rows.resize(kept * len_);
+    partition.rows.shrink_to_fit();
+
+    uint64_t capacity = INITIAL_CAPACITY;
+    while (capacity < 2 * uint64_t(kept)) {
+      capacity *= 2;
+    }
+    Rehash(partition, capacity);
+  }
+}
+
+int64_t HashSet::Size() const { return size_; }
+
+std::vector<int32_t*> HashSet::Sorted() {
+  std::vector<int32_t*> output;
+  output.reserve(size_);
+  for (auto& partition : partitions_) {
+    for (int32_t row = 0; row < partition.size; row++) {
+      output.push_back(partition.rows.data() + row * len_);
+    }
+  }
+
+  // The ART orders rows by the bytes of their in-memory representation.
+  const auto bytes = len_ * sizeof(int32_t);
+  std::sort(output.begin(), output.end(), [bytes](int32_t* a, int32_t* b) {
+    return memcmp(a, b, bytes) < 0;
+  });
+  return output;
+}
+
+}  // namespace kush::runtime::TupleIdxTable
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace kush::runtime::TupleIdxTable {
+
+// Open addressing hash set of fixed width tuple idx rows. The set is split
+// into partitions by the high bits of the hash so that each partition grows
+// independently and a resize only rehashes a fraction of the rows.
+class HashSet {
+ public:
+  explicit HashSet(int32_t len);
+
+  // Returns true if the row was not present before.
+  bool Insert(const int32_t* tuple_idx);
+
+  // Removes every row that has some tuple_idx[i] <= offset[i].
+  void Evict(const int32_t* offset);
+
+  int64_t Size() const;
+
+  // Returns every row in the same order as the ART iterator.
+  std::vector<int32_t*> Sorted();
+
+ private:
+  static constexpr int PARTITION_BITS = 6;
+  static constexpr int NUM_PARTITIONS = 1 << PARTITION_BITS;
+
+  struct Partition {
+    // Each slot holds the upper 32 bits of the hash and the row idx + 1 in the
+    // lower 32 bits. An empty slot is 0.
+    std::vector<uint64_t> slots;
+    uint64_t mask;
+    std::vector<int32_t> rows;
+    int32_t size;
+  };
+
+  uint64_t Hash(const int32_t* tuple_idx) const;
+  bool Equals(const int32_t* a, const int32_t* b) const;
+  void Rehash(Partition& partition, uint64_t capacity);
+
+  const int32_t len_;
+  int64_t size_;
+  Partition partitions_[NUM_PARTITIONS];
+};
+
+}  // namespace kush::runtime::TupleIdxTable
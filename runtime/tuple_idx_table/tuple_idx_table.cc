@@ -6,6 +6,7 @@
 #include <memory>
 #include <vector>
 
+#include "runtime/tuple_idx_table/hash_set.h"
 #include "runtime/tuple_idx_table/key.h"
 #include "runtime/tuple_idx_table/leaf.h"
 #include "runtime/tuple_idx_table/node.h"
@@ -93,9 +94,49 @@ bool InsertImpl(Allocator& allocator, Node*& node, Key* value, uint32_t depth) {
   return true;
 }
 
+void MigrateToHashSet(TupleIdxTable* t, int32_t len) {
+  auto hash_set = std::make_unique<HashSet>(len);
+
+  Iterator it;
+  for (bool valid = Begin(t, &it); valid; valid = IteratorNext(t, &it)) {
+    hash_set->Insert(Get(&it));
+  }
+  t->hash_set = std::move(hash_set);
+
+  // The hash set keeps its own copy of every tuple so the tree and its keys
+  // can go.
+  t->tree = nullptr;
+  t->allocator.reset();
+}
+
 bool Insert(TupleIdxTable* t, const int32_t* tuple_idx, int32_t len) {
-  return InsertImpl(t->allocator, t->tree,
-                    Key::CreateKey(t->allocator, tuple_idx, len), 0);
+  if (t->hash_set != nullptr) {
+    return t->hash_set->Insert(tuple_idx);
+  }
+
+  if (!InsertImpl(*t->allocator, t->tree,
+                  Key::CreateKey(*t->allocator, tuple_idx, len), 0)) {
+    return false;
+  }
+
+  t->size++;
+  if (t->size > t->hash_threshold) {
+    MigrateToHashSet(t, len);
+  }
+  return true;
+}
+
+void Evict(TupleIdxTable* t, const int32_t* offset) {
+  if (t->hash_set == nullptr) {
+    return;
+  }
+
+  if (t->hash_set->Size() < 2 * t->last_evict_size) {
+    return;
+  }
+
+  t->hash_set->Evict(offset);
+  t->last_evict_size = t->hash_set->Size();
 }
 
 IteratorEntry::IteratorEntry() : node(nullptr), pos(0) {}
@@ -146,6 +187,12 @@ void BeginImpl(Iterator& it, Node& node) {
 }
 
 bool Begin(TupleIdxTable* table, Iterator* it) {
+  if (table->hash_set != nullptr) {
+    it->sorted = table->hash_set->Sorted();
+    it->sorted_pos = 0;
+    return !it->sorted.empty();
+  }
+
   if (table->tree) {
     BeginImpl(*it, *table->tree);
     return true;
@@ -154,6 +201,11 @@ bool Begin(TupleIdxTable* table, Iterator* it) {
 }
 
 bool IteratorNext(TupleIdxTable* table, Iterator* it) {
+  if (table->hash_set != nullptr) {
+    it->sorted_pos++;
+    return it->sorted_pos < it->sorted.size();
+  }
+
   // Skip leaf
   if ((it->depth) &&
       ((it->stack[it->depth - 1].node)->type == NodeType::NLeaf)) {
@@ -194,6 +246,11 @@ Iterator* CreateIt() { return new Iterator; }
 
 void FreeIt(Iterator* t) { delete t; }
 
-int32_t* Get(Iterator* t) { return t->node->value->Data(); }
+int32_t* Get(Iterator* t) {
+  if (!t->sorted.empty()) {
+    return t->sorted[t->sorted_pos];
+  }
+  return t->node->value->Data();
+}
 
 }  // namespace kush::runtime::TupleIdxTable
\ No newline at end of file
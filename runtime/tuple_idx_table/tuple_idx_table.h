@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "runtime/allocator.h"
+#include "runtime/tuple_idx_table/hash_set.h"
 #include "runtime/tuple_idx_table/key.h"
 #include "runtime/tuple_idx_table/leaf.h"
 #include "runtime/tuple_idx_table/node.h"
@@ -28,16 +29,36 @@ struct Iterator {
   int32_t depth = 0;
   std::vector<IteratorEntry> stack;
 
+  // Used instead of the ART state when the table is backed by a hash set.
+  std::vector<int32_t*> sorted;
+  int64_t sorted_pos = 0;
+
   void SetEntry(int32_t depth, IteratorEntry entry);
 };
 
+// Number of distinct tuples after which the table migrates from the ART to
+// the hash set. Small results stay in the ART since it is cheap to build and
+// iterates in order, large ones are dominated by the ART's pointer chasing.
+constexpr int64_t HASH_THRESHOLD = 1 << 16;
+
 struct TupleIdxTable {
-  Allocator allocator;
+  // Holds the ART. Released once the table migrates to the hash set.
+  std::unique_ptr<Allocator> allocator = std::make_unique<Allocator>();
   Node* tree = nullptr;
+  std::unique_ptr<HashSet> hash_set;
+  int64_t size = 0;
+  int64_t hash_threshold = HASH_THRESHOLD;
+  int64_t last_evict_size = 0;
 };
 
 bool Insert(TupleIdxTable* t, const int32_t* tuple_idx, int32_t len);
 
+// Drops tuples that can no longer be inserted again since some tuple_idx[i] <=
+// offset[i]. Only the hash set is compacted, the ART is already bounded by the
+// hash threshold. The scan is skipped until the table has doubled since the
+// last one so that eviction stays amortized constant per insert.
+void Evict(TupleIdxTable* t, const int32_t* offset);
+
 bool Begin(TupleIdxTable* t, Iterator* it);
 
 bool IteratorNext(TupleIdxTable* t, Iterator* it);
@@ -0,0 +1,56 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "runtime/tuple_idx_table/tuple_idx_table.h"
+
+using namespace kush::runtime;
+
+// Compares the ART and hash set backends of the TupleIdxTable by inserting
+// a result with 50% duplicates and then iterating it in sorted order.
+double Run(int64_t hash_threshold, int64_t num_tuples, int32_t len) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int32_t> dist(0, 1 << 20);
+  std::vector<int32_t> tuples(num_tuples * len);
+  for (auto& x : tuples) {
+    x = dist(gen);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  auto table = TupleIdxTable::Create();
+  table->hash_threshold = hash_threshold;
+  for (int64_t i = 0; i < 2 * num_tuples; i++) {
+    TupleIdxTable::Insert(table, tuples.data() + (i / 2) * len, len);
+  }
+
+  int64_t checksum = 0;
+  auto it = TupleIdxTable::CreateIt();
+  for (bool valid = TupleIdxTable::Begin(table, it); valid;
+       valid = TupleIdxTable::IteratorNext(table, it)) {
+    checksum += TupleIdxTable::Get(it)[0];
+  }
+  TupleIdxTable::FreeIt(it);
+  TupleIdxTable::Free(table);
+
+  auto end = std::chrono::steady_clock::now();
+  if (checksum == 0) {
+    std::cerr << "Invalid checksum" << std::endl;
+  }
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main() {
+  std::cout << "len,num_tuples,art_ms,hash_ms" << std::endl;
+  for (int32_t len : {2, 4, 8}) {
+    for (int64_t num_tuples : {1 << 10, 1 << 14, 1 << 18, 1 << 21}) {
+      auto art = Run(std::numeric_limits<int64_t>::max(), num_tuples, len);
+      auto hash = Run(0, num_tuples, len);
+      std::cout << len << "," << num_tuples << "," << art << "," << hash
+                << std::endl;
+    }
+  }
+}
@@ -1,5 +1,8 @@
 #include "runtime/tuple_idx_table/tuple_idx_table.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 using namespace kush;
@@ -68,4 +71,104 @@ TEST(TupleIdxTableTest, MultipleValuesSortedOrderWithDuplicates) {
   EXPECT_TRUE(IteratorNext(&table, &it));
   EXPECT_EQ(memcmp(tuple_idx3, Get(&it), len * sizeof(int32_t)), 0);
   EXPECT_FALSE(IteratorNext(&table, &it));
-}
\ No newline at end of file
+}
+
+TEST(TupleIdxTableTest, HashSetSortedOrderWithDuplicates) {
+  constexpr int len = 3;
+  int tuple_idx1[len]{1, 0, 2};
+  int tuple_idx2[len]{0, 1, 2};
+  int tuple_idx3[len]{1, 2, 0};
+
+  TupleIdxTable::TupleIdxTable table;
+  table.hash_threshold = 0;
+  EXPECT_EQ(Insert(&table, tuple_idx1, len), true);
+  EXPECT_NE(table.hash_set, nullptr);
+  EXPECT_EQ(Insert(&table, tuple_idx2, len), true);
+  EXPECT_EQ(Insert(&table, tuple_idx3, len), true);
+  EXPECT_EQ(Insert(&table, tuple_idx3, len), false);
+  EXPECT_EQ(Insert(&table, tuple_idx2, len), false);
+  EXPECT_EQ(Insert(&table, tuple_idx1, len), false);
+
+  TupleIdxTable::Iterator it;
+  EXPECT_TRUE(Begin(&table, &it));
+  EXPECT_EQ(memcmp(tuple_idx2, Get(&it), len * sizeof(int32_t)), 0);
+  EXPECT_TRUE(IteratorNext(&table, &it));
+  EXPECT_EQ(memcmp(tuple_idx1, Get(&it), len * sizeof(int32_t)), 0);
+  EXPECT_TRUE(IteratorNext(&table, &it));
+  EXPECT_EQ(memcmp(tuple_idx3, Get(&it), len * sizeof(int32_t)), 0);
+  EXPECT_FALSE(IteratorNext(&table, &it));
+}
+
+TEST(TupleIdxTableTest, MigrateToHashSet) {
+  constexpr int len = 11;
+  constexpr int num_tuples = 5000;
+
+  TupleIdxTable::TupleIdxTable table;
+  table.hash_threshold = 1000;
+
+  std::vector<std::vector<int32_t>> expected;
+  for (int i = 0; i < num_tuples; i++) {
+    std::vector<int32_t> tuple_idx(len);
+    for (int j = 0; j < len; j++) {
+      tuple_idx[j] = (i * (j + 7)) % 1013;
+    }
+    tuple_idx[len - 1] = i;
+    expected.push_back(tuple_idx);
+    EXPECT_EQ(Insert(&table, tuple_idx.data(), len), true);
+    EXPECT_EQ(Insert(&table, expected[i / 2].data(), len), false);
+  }
+  EXPECT_NE(table.hash_set, nullptr);
+  EXPECT_EQ(table.tree, nullptr);
+  EXPECT_EQ(table.allocator, nullptr);
+
+  std::sort(expected.begin(), expected.end(), [](auto& a, auto& b) {
+    return memcmp(a.data(), b.data(), len * sizeof(int32_t)) < 0;
+  });
+
+  TupleIdxTable::Iterator it;
+  bool valid = Begin(&table, &it);
+  for (const auto& tuple_idx : expected) {
+    ASSERT_TRUE(valid);
+    EXPECT_EQ(memcmp(tuple_idx.data(), Get(&it), len * sizeof(int32_t)), 0);
+    valid = IteratorNext(&table, &it);
+  }
+  EXPECT_FALSE(valid);
+}
+
+TEST(TupleIdxTableTest, EvictBelowOffset) {
+  constexpr int len = 2;
+  constexpr int num_tuples = 100;
+
+  TupleIdxTable::TupleIdxTable table;
+  table.hash_threshold = 0;
+  for (int i = 0; i < num_tuples; i++) {
+    for (int j = 0; j < num_tuples; j++) {
+      int tuple_idx[len]{i, j};
+      EXPECT_TRUE(Insert(&table, tuple_idx, len));
+    }
+  }
+
+  int offset[len]{49, 9};
+  Evict(&table, offset);
+
+  std::vector<std::vector<int32_t>> expected;
+  for (int i = 50; i < num_tuples; i++) {
+    for (int j = 10; j < num_tuples; j++) {
+      int tuple_idx[len]{i, j};
+      EXPECT_FALSE(Insert(&table, tuple_idx, len));
+      expected.push_back({i, j});
+    }
+  }
+  std::sort(expected.begin(), expected.end(), [](auto& a, auto& b) {
+    return memcmp(a.data(), b.data(), len * sizeof(int32_t)) < 0;
+  });
+
+  TupleIdxTable::Iterator it;
+  bool valid = Begin(&table, &it);
+  for (const auto& tuple_idx : expected) {
+    ASSERT_TRUE(valid);
+    EXPECT_EQ(memcmp(tuple_idx.data(), Get(&it), len * sizeof(int32_t)), 0);
+    valid = IteratorNext(&table, &it);
+  }
+  EXPECT_FALSE(valid);
+}
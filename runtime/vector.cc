@@ -4,18 +4,22 @@
 #include <cstdlib>
 #include <cstring>
 
+#include "runtime/allocator.h"
+
 namespace kush::runtime::Vector {
 
 void Create(Vector* vec, int64_t element_size, int32_t initial_capacity) {
   vec->element_size = element_size;
   vec->size = 0;
   vec->capacity = initial_capacity;
-  vec->data = static_cast<int8_t*>(malloc(initial_capacity * element_size));
+  vec->data = reinterpret_cast<int8_t*>(
+      runtime::Allocate(initial_capacity * element_size));
 }
 
 void Grow(Vector* vec, int32_t new_capacity) {
-  vec->data = static_cast<int8_t*>(
-      realloc(vec->data, new_capacity * vec->element_size));
+  vec->data = reinterpret_cast<int8_t*>(
+      runtime::Reallocate(vec->data, vec->capacity * vec->element_size,
+                          new_capacity * vec->element_size));
   vec->capacity = new_capacity;
 }
 
@@ -40,7 +44,9 @@ int32_t Size(Vector* vec) {
   return vec->size;
 }
 
-void Free(Vector* vec) { free(vec->data); }
+void Free(Vector* vec) {
+  runtime::Free(vec->data, vec->capacity * vec->element_size);
+}
 
 void Merge(Vector* vec, std::add_pointer<bool(int8_t*, int8_t*)>::type comp_fn,
            int l, int m, int r) {
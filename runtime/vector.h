@@ -14,6 +14,8 @@ struct Vector {
 
 void Create(Vector* vec, int64_t element_size, int32_t initial_capacity);
 
+void Grow(Vector* vec, int32_t new_capacity);
+
 int8_t* PushBack(Vector* vec);
 
 int8_t* Get(Vector* vec, int32_t idx);
@@ -0,0 +1,899 @@
+#include "util/load.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <execution>
+#include <fcntl.h>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "absl/flags/flag.h"
+
+#include "runtime/column_data.h"
+#include "runtime/column_index.h"
+#include "runtime/date.h"
+#include "runtime/enum.h"
+#include "runtime/string.h"
+
+ABSL_FLAG(int32_t, max_enum_size, 1 << 18,
+          "Text columns with at most this many distinct values are also "
+          "written dictionary encoded. Disabled if 0.");
+
+namespace kush::util {
+
+namespace {
+
+// Raw bytes parsed in memory at once.
+constexpr uint64_t BATCH_SIZE = 256ull << 20;
+
+// Chunks per thread in each batch so that uneven lines balance out.
+constexpr int CHUNKS_PER_THREAD = 4;
+
+int NumThreads() { return std::max(1u, std::thread::hardware_concurrency()); }
+
+void ParallelFor(int n, const std::function<void(int)>& body) {
+  std::atomic<int> next(0);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  auto worker = [&]() {
+    for (int i = next++; i < n; i = next++) {
+      try {
+        body(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) error = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  int num_threads = std::min(NumThreads(), n);
+  for (int i = 1; i < num_threads; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+[[noreturn]] void ThrowParseError(std::string_view s) {
+  throw std::runtime_error(std::string(__FILE__) + ":" +
+                           std::to_string(__LINE__) + " unable to parse " +
+                           std::string(s));
+}
+
+template <typename T>
+T ParseInteger(std::string_view s) {
+  if (s.empty()) {
+    return 0;
+  }
+
+  // Matches std::stoi in accepting a leading plus and trailing characters.
+  const char* begin = s.data();
+  if (*begin == '+') begin++;
+  int64_t value;
+  auto [ptr, ec] = std::from_chars(begin, s.data() + s.size(), value);
+  if (ec != std::errc() || ptr == begin) {
+    ThrowParseError(s);
+  }
+  return static_cast<T>(value);
+}
+
+double ParseDouble(std::string_view s) {
+  if (s.empty()) {
+    return 0;
+  }
+
+  char buffer[64];
+  std::string copy;
+  const char* str;
+  if (s.size() < sizeof(buffer)) {
+    std::memcpy(buffer, s.data(), s.size());
+    buffer[s.size()] = '\0';
+    str = buffer;
+  } else {
+    copy = std::string(s);
+    str = copy.c_str();
+  }
+
+  char* end;
+  double value = std::strtod(str, &end);
+  if (end == str) {
+    ThrowParseError(s);
+  }
+  return value;
+}
+
+int32_t ParseDate(std::string_view s) {
+  if (s.empty()) {
+    return runtime::Date::DateBuilder(0, 1, 1).Build();
+  }
+
+  auto first = s.find('-');
+  auto second = s.find('-', first + 1);
+  if (first == std::string_view::npos || second == std::string_view::npos) {
+    ThrowParseError(s);
+  }
+
+  return runtime::Date::DateBuilder(
+             ParseInteger<int32_t>(s.substr(0, first)),
+             ParseInteger<int32_t>(s.substr(first + 1, second - first - 1)),
+             ParseInteger<int32_t>(s.substr(second + 1)))
+      .Build();
+}
+
+int8_t ParseBool(std::string_view s) { return s == "true" ? 1 : 0; }
+
+// Appends s to dest, removing the surrounding quotes and escapes the same way
+// std::quoted does.
+void AppendUnescaped(std::string_view s, std::string& dest) {
+  bool quoted = s.size() >= 2 && s.front() == '"' && s.back() == '"';
+  if (quoted) {
+    s.remove_prefix(1);
+  } else if (s.find_first_of("\\\"") == std::string_view::npos) {
+    dest.append(s);
+    return;
+  }
+
+  for (size_t i = 0; i < s.size(); i++) {
+    if (s[i] == '\\') {
+      if (i + 1 < s.size()) {
+        dest.push_back(s[++i]);
+        continue;
+      }
+
+      // A trailing backslash escapes the implicit closing quote.
+      if (!quoted) dest.push_back('"');
+      break;
+    }
+
+    if (s[i] == '"') {
+      break;
+    }
+
+    dest.push_back(s[i]);
+  }
+}
+
+const char* Find(const char* begin, const char* end, char c) {
+  auto result = static_cast<const char*>(std::memchr(begin, c, end - begin));
+  return result == nullptr ? end : result;
+}
+
+// A quoted field extends over delimiters until it ends with an unescaped
+// quote.
+bool KeepGoing(const char* begin, const char* end) {
+  auto size = end - begin;
+  if (size < 2) {
+    return true;
+  }
+
+  if (size == 2) {
+    return end[-1] != '"';
+  }
+
+  if (end[-1] == '"') {
+    return end[-2] == '\\';
+  }
+
+  return true;
+}
+
+class File {
+ public:
+  File(const std::string& path, const char* mode)
+      : path_(path), file_(std::fopen(path.c_str(), mode)) {
+    if (file_ == nullptr) {
+      throw std::system_error(
+          errno, std::generic_category(),
+          std::string(__FILE__) + ":" + std::to_string(__LINE__) + " " + path);
+    }
+  }
+
+  ~File() {
+    if (file_ != nullptr) {
+      std::fclose(file_);
+    }
+  }
+
+  void Write(const void* data, uint64_t length) {
+    if (length > 0 && std::fwrite(data, 1, length, file_) != length) {
+      throw std::system_error(
+          errno, std::generic_category(),
+          std::string(__FILE__) + ":" + std::to_string(__LINE__) + " " + path_);
+    }
+  }
+
+  template <typename T>
+  void Write(const std::vector<T>& values) {
+    Write(values.data(), values.size() * sizeof(T));
+  }
+
+  void Close() {
+    if (std::fclose(file_) != 0) {
+      file_ = nullptr;
+      throw std::system_error(
+          errno, std::generic_category(),
+          std::string(__FILE__) + ":" + std::to_string(__LINE__) + " " + path_);
+    }
+    file_ = nullptr;
+  }
+
+  const std::string& Path() { return path_; }
+
+ private:
+  std::string path_;
+  FILE* file_;
+};
+
+// Maps a whole file read only.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) : data_(nullptr), length_(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      throw std::system_error(
+          errno, std::generic_category(),
+          std::string(__FILE__) + ":" + std::to_string(__LINE__) + " " + path);
+    }
+
+    struct stat sb;
+    if (fstat(fd, &sb) == -1) {
+      close(fd);
+      throw std::system_error(
+          errno, std::generic_category(),
+          std::string(__FILE__) + ":" + std::to_string(__LINE__));
+    }
+
+    length_ = sb.st_size;
+    if (length_ > 0) {
+      auto data = mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        close(fd);
+        throw std::system_error(
+            errno, std::generic_category(),
+            std::string(__FILE__) + ":" + std::to_string(__LINE__));
+      }
+      data_ = static_cast<const char*>(data);
+      madvise(data, length_, MADV_SEQUENTIAL);
+    }
+
+    close(fd);
+  }
+
+  ~MappedFile() {
+    if (data_ != nullptr) {
+      munmap(const_cast<char*>(data_), length_);
+    }
+  }
+
+  // Drops the pages of an already parsed range so they can be reclaimed.
+  void Release(uint64_t begin, uint64_t end) {
+    auto page_size = sysconf(_SC_PAGESIZE);
+    begin = begin / page_size * page_size;
+    end = end / page_size * page_size;
+    if (end > begin) {
+      madvise(const_cast<char*>(data_) + begin, end - begin, MADV_DONTNEED);
+    }
+  }
+
+  const char* Data() const { return data_; }
+  uint64_t Length() const { return length_; }
+
+ private:
+  const char* data_;
+  uint64_t length_;
+};
+
+// Replaces each non-null code in the column file at path with its new id.
+void RemapCodes(const std::string& path, const std::vector<int32_t>& ids) {
+  int fd = open(path.c_str(), O_RDWR);
+  if (fd == -1) {
+    throw std::system_error(
+        errno, std::generic_category(),
+        std::string(__FILE__) + ":" + std::to_string(__LINE__) + " " + path);
+  }
+
+  struct stat sb;
+  if (fstat(fd, &sb) == -1) {
+    close(fd);
+    throw std::system_error(
+        errno, std::generic_category(),
+        std::string(__FILE__) + ":" + std::to_string(__LINE__));
+  }
+
+  uint64_t size = sb.st_size / sizeof(int32_t);
+  if (size > 0) {
+    auto data =
+        mmap(nullptr, sb.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      throw std::system_error(
+          errno, std::generic_category(),
+          std::string(__FILE__) + ":" + std::to_string(__LINE__));
+    }
+
+    auto codes = static_cast<int32_t*>(data);
+    int num_blocks = NumThreads() * CHUNKS_PER_THREAD;
+    ParallelFor(num_blocks, [&](int i) {
+      for (uint64_t j = size * i / num_blocks; j < size * (i + 1) / num_blocks;
+           j++) {
+        if (codes[j] >= 0) {
+          codes[j] = ids[codes[j]];
+        }
+      }
+    });
+
+    if (munmap(data, sb.st_size) != 0) {
+      close(fd);
+      throw std::system_error(
+          errno, std::generic_category(),
+          std::string(__FILE__) + ":" + std::to_string(__LINE__));
+    }
+  }
+
+  if (close(fd) != 0) {
+    throw std::system_error(
+        errno, std::generic_category(),
+        std::string(__FILE__) + ":" + std::to_string(__LINE__));
+  }
+}
+
+template <typename T>
+void Group(std::vector<std::pair<T, int32_t>>& pairs,
+           std::vector<std::pair<T, std::vector<int32_t>>>& groups) {
+  std::sort(std::execution::par, pairs.begin(), pairs.end());
+
+  for (size_t i = 0; i < pairs.size();) {
+    auto& [key, tuples] = groups.emplace_back(pairs[i].first,
+                                              std::vector<int32_t>());
+    for (; i < pairs.size() && pairs[i].first == key; i++) {
+      tuples.push_back(pairs[i].second);
+    }
+  }
+
+  pairs.clear();
+  pairs.shrink_to_fit();
+}
+
+// Holds the values of a column parsed from one chunk.
+class ColumnChunk {
+ public:
+  virtual ~ColumnChunk() = default;
+  virtual void Add(std::string_view field) = 0;
+};
+
+// Writes a column out as its chunks are appended in order.
+class ColumnWriter {
+ public:
+  ColumnWriter(std::string_view dest, const LoadColumn& column)
+      : path_(std::string(dest) + column.name),
+        nullable_(column.nullable),
+        data_(path_ + ".kdb", "wb"),
+        tuple_idx_(0) {
+    if (nullable_) {
+      null_ = std::make_unique<File>(path_ + "_null.kdb", "wb");
+    }
+  }
+
+  virtual ~ColumnWriter() = default;
+  virtual std::unique_ptr<ColumnChunk> NewChunk() = 0;
+  virtual void Append(ColumnChunk& chunk) = 0;
+  virtual void Finish() = 0;
+
+ protected:
+  void AppendNulls(const std::vector<int8_t>& nulls) {
+    if (null_ != nullptr) {
+      null_->Write(nulls);
+    }
+  }
+
+  void CloseNulls() {
+    if (null_ != nullptr) {
+      null_->Close();
+    }
+  }
+
+  std::string path_;
+  bool nullable_;
+  File data_;
+  std::unique_ptr<File> null_;
+  int32_t tuple_idx_;
+};
+
+template <typename T, T (*Parse)(std::string_view)>
+class FixedColumnWriter : public ColumnWriter {
+ public:
+  FixedColumnWriter(std::string_view dest, const LoadColumn& column)
+      : ColumnWriter(dest, column) {}
+
+  class Chunk : public ColumnChunk {
+   public:
+    explicit Chunk(bool nullable) : nullable_(nullable) {}
+
+    void Add(std::string_view field) override {
+      values_.push_back(Parse(field));
+      if (nullable_) {
+        nulls_.push_back(field.empty());
+      }
+    }
+
+   private:
+    friend class FixedColumnWriter;
+    bool nullable_;
+    std::vector<T> values_;
+    std::vector<int8_t> nulls_;
+  };
+
+  std::unique_ptr<ColumnChunk> NewChunk() override {
+    return std::make_unique<Chunk>(nullable_);
+  }
+
+  void Append(ColumnChunk& base) override {
+    auto& chunk = static_cast<Chunk&>(base);
+    data_.Write(chunk.values_);
+    AppendNulls(chunk.nulls_);
+
+    for (size_t i = 0; i < chunk.values_.size(); i++) {
+      if (!nullable_ || !chunk.nulls_[i]) {
+        index_.emplace_back(chunk.values_[i], tuple_idx_ + i);
+      }
+    }
+    tuple_idx_ += chunk.values_.size();
+  }
+
+  void Finish() override {
+    data_.Close();
+    CloseNulls();
+
+    std::vector<std::pair<T, std::vector<int32_t>>> groups;
+    Group(index_, groups);
+    runtime::ColumnIndex::Serialize<T>(path_ + ".kdbindex", groups);
+  }
+
+ private:
+  std::vector<std::pair<T, int32_t>> index_;
+};
+
+// Strings are spilled to a payload file until the number of tuples is known,
+// which is needed to write the slots that precede them in the column file.
+class TextColumnWriter : public ColumnWriter {
+ public:
+  TextColumnWriter(std::string_view dest, const LoadColumn& column,
+                   bool encode)
+      : ColumnWriter(dest, column),
+        encode_(encode),
+        payload_(path_ + ".kdb.payload", "wb") {}
+
+  class Chunk : public ColumnChunk {
+   public:
+    explicit Chunk(bool nullable) : nullable_(nullable) {}
+
+    void Add(std::string_view field) override {
+      auto start = payload_.size();
+      AppendUnescaped(field, payload_);
+      lengths_.push_back(payload_.size() - start);
+      payload_.push_back('\0');
+      if (nullable_) {
+        nulls_.push_back(field.empty());
+      }
+    }
+
+   private:
+    friend class TextColumnWriter;
+    bool nullable_;
+    std::string payload_;
+    std::vector<int32_t> lengths_;
+    std::vector<int8_t> nulls_;
+  };
+
+  std::unique_ptr<ColumnChunk> NewChunk() override {
+    return std::make_unique<Chunk>(nullable_);
+  }
+
+  void Append(ColumnChunk& base) override {
+    auto& chunk = static_cast<Chunk&>(base);
+    payload_.Write(chunk.payload_.data(), chunk.payload_.size());
+    AppendNulls(chunk.nulls_);
+    lengths_.insert(lengths_.end(), chunk.lengths_.begin(),
+                    chunk.lengths_.end());
+    if (nullable_) {
+      nulls_.insert(nulls_.end(), chunk.nulls_.begin(), chunk.nulls_.end());
+    }
+    tuple_idx_ += chunk.lengths_.size();
+  }
+
+  void Finish() override {
+    payload_.Close();
+    CloseNulls();
+    MappedFile payload(payload_.Path());
+
+    WriteData(payload);
+    WriteIndex(payload);
+
+    if (unlink(payload_.Path().c_str()) != 0) {
+      throw std::system_error(
+          errno, std::generic_category(),
+          std::string(__FILE__) + ":" + std::to_string(__LINE__));
+    }
+  }
+
+ private:
+  void WriteData(const MappedFile& payload) {
+    // Same layout as ColumnData::Serialize<std::string>.
+    int32_t metadata[2] = {static_cast<int32_t>(lengths_.size()), 0};
+    data_.Write(metadata, sizeof(metadata));
+
+    uint64_t offset =
+        8 + sizeof(runtime::ColumnData::StringEntry) * lengths_.size();
+    uint64_t payload_offset = 0;
+    std::vector<runtime::ColumnData::StringEntry> slots;
+    for (size_t i = 0; i < lengths_.size(); i += slots.size()) {
+      slots.clear();
+      for (size_t j = i; j < lengths_.size() && slots.size() < (1 << 16);
+           j++) {
+        std::string_view value(payload.Data() + payload_offset, lengths_[j]);
+        runtime::ColumnData::InitStringEntry(&slots.emplace_back(), value,
+                                             offset);
+        if (lengths_[j] > runtime::String::INLINE_LENGTH) {
+          offset += lengths_[j] + 1;
+        }
+        payload_offset += lengths_[j] + 1;
+      }
+      data_.Write(slots);
+    }
+
+    // Only strings that are not inlined are stored after the slots.
+    payload_offset = 0;
+    for (auto length : lengths_) {
+      if (length > runtime::String::INLINE_LENGTH) {
+        data_.Write(payload.Data() + payload_offset, length + 1);
+      }
+      payload_offset += length + 1;
+    }
+    data_.Close();
+  }
+
+  void WriteIndex(const MappedFile& payload) {
+    std::vector<std::pair<std::string_view, int32_t>> index;
+    index.reserve(lengths_.size());
+    uint64_t offset = 0;
+    for (size_t i = 0; i < lengths_.size(); i++) {
+      if (!nullable_ || !nulls_[i]) {
+        index.emplace_back(
+            std::string_view(payload.Data() + offset, lengths_[i]), i);
+      }
+      offset += lengths_[i] + 1;
+    }
+
+    std::vector<std::pair<std::string_view, std::vector<int32_t>>> groups;
+    Group(index, groups);
+    runtime::ColumnIndex::Serialize(path_ + ".kdbindex", groups);
+
+    auto max_enum_size = absl::GetFlag(FLAGS_max_enum_size);
+    if (encode_ && max_enum_size > 0 &&
+        static_cast<int64_t>(groups.size()) <= max_enum_size) {
+      WriteEnum(groups);
+    }
+  }
+
+  // Writes the column as the ENUM column name + "_enum". The groups are
+  // sorted so the codes preserve the order of the strings.
+  void WriteEnum(
+      const std::vector<std::pair<std::string_view, std::vector<int32_t>>>&
+          groups) {
+    std::unordered_map<std::string, int32_t> dictionary;
+    std::vector<int32_t> codes(lengths_.size(), -1);
+    std::vector<std::pair<int32_t, std::vector<int32_t>>> code_groups;
+    for (size_t i = 0; i < groups.size(); i++) {
+      const auto& [key, tuples] = groups[i];
+      dictionary.emplace(key, i);
+      for (auto t : tuples) {
+        codes[t] = i;
+      }
+      code_groups.emplace_back(i, tuples);
+    }
+
+    File data(path_ + "_enum.kdb", "wb");
+    data.Write(codes);
+    data.Close();
+
+    if (nullable_) {
+      File null(path_ + "_enum_null.kdb", "wb");
+      null.Write(nulls_);
+      null.Close();
+    }
+
+    runtime::ColumnIndex::Serialize<int32_t>(path_ + "_enum.kdbindex",
+                                             code_groups);
+    runtime::Enum::Serialize(path_ + "_enum.kdbenum", dictionary);
+  }
+
+  bool encode_;
+  File payload_;
+  std::vector<int32_t> lengths_;
+  std::vector<int8_t> nulls_;
+};
+
+class EnumColumnWriter : public ColumnWriter {
+ public:
+  EnumColumnWriter(std::string_view dest, const LoadColumn& column)
+      : ColumnWriter(dest, column) {}
+
+  // Codes are local to the chunk and numbered in order of first appearance.
+  // They are remapped to ids in order of first appearance in the column as
+  // chunks are appended and to the sorted order of the values at the end.
+  class Chunk : public ColumnChunk {
+   public:
+    explicit Chunk(bool nullable) : nullable_(nullable) {}
+
+    void Add(std::string_view field) override {
+      value_.clear();
+      AppendUnescaped(field, value_);
+
+      if (nullable_) {
+        nulls_.push_back(value_.empty());
+        if (value_.empty()) {
+          codes_.push_back(-1);
+          return;
+        }
+      }
+
+      auto [it, inserted] = dictionary_.try_emplace(value_, values_.size());
+      if (inserted) {
+        values_.push_back(&it->first);
+      }
+      codes_.push_back(it->second);
+    }
+
+   private:
+    friend class EnumColumnWriter;
+    bool nullable_;
+    std::string value_;
+    std::unordered_map<std::string, int32_t> dictionary_;
+    std::vector<const std::string*> values_;
+    std::vector<int32_t> codes_;
+    std::vector<int8_t> nulls_;
+  };
+
+  std::unique_ptr<ColumnChunk> NewChunk() override {
+    return std::make_unique<Chunk>(nullable_);
+  }
+
+  void Append(ColumnChunk& base) override {
+    auto& chunk = static_cast<Chunk&>(base);
+
+    std::vector<int32_t> ids;
+    ids.reserve(chunk.values_.size());
+    for (auto value : chunk.values_) {
+      int32_t id = dictionary_.size();
+      auto [it, inserted] = dictionary_.try_emplace(*value, id);
+      ids.push_back(it->second);
+    }
+
+    for (size_t i = 0; i < chunk.codes_.size(); i++) {
+      auto& code = chunk.codes_[i];
+      if (code >= 0) {
+        code = ids[code];
+        index_.emplace_back(code, tuple_idx_ + i);
+      }
+    }
+
+    data_.Write(chunk.codes_);
+    AppendNulls(chunk.nulls_);
+    tuple_idx_ += chunk.codes_.size();
+  }
+
+  void Finish() override {
+    data_.Close();
+    CloseNulls();
+
+    // Number the values in sorted order so that codes compare like them.
+    std::vector<std::unordered_map<std::string, int32_t>::iterator> values;
+    values.reserve(dictionary_.size());
+    for (auto it = dictionary_.begin(); it != dictionary_.end(); it++) {
+      values.push_back(it);
+    }
+    std::sort(std::execution::par, values.begin(), values.end(),
+              [](const auto& a, const auto& b) { return a->first < b->first; });
+
+    std::vector<int32_t> ids(values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+      ids[values[i]->second] = i;
+      values[i]->second = i;
+    }
+
+    RemapCodes(path_ + ".kdb", ids);
+    for (auto& [code, tuple_idx] : index_) {
+      code = ids[code];
+    }
+
+    std::vector<std::pair<int32_t, std::vector<int32_t>>> groups;
+    Group(index_, groups);
+    runtime::ColumnIndex::Serialize<int32_t>(path_ + ".kdbindex", groups);
+    runtime::Enum::Serialize(path_ + ".kdbenum", dictionary_);
+  }
+
+ private:
+  std::unordered_map<std::string, int32_t> dictionary_;
+  std::vector<std::pair<int32_t, int32_t>> index_;
+};
+
+std::unique_ptr<ColumnWriter> MakeWriter(
+    std::string_view dest, const LoadColumn& column,
+    const std::vector<LoadColumn>& columns) {
+  switch (column.type) {
+    case LoadType::BOOLEAN:
+      return std::make_unique<FixedColumnWriter<int8_t, ParseBool>>(dest,
+                                                                     column);
+    case LoadType::INT8:
+      return std::make_unique<FixedColumnWriter<int8_t, ParseInteger<int8_t>>>(
+          dest, column);
+    case LoadType::INT16:
+      return std::make_unique<
+          FixedColumnWriter<int16_t, ParseInteger<int16_t>>>(dest, column);
+    case LoadType::INT32:
+      return std::make_unique<
+          FixedColumnWriter<int32_t, ParseInteger<int32_t>>>(dest, column);
+    case LoadType::INT64:
+      return std::make_unique<
+          FixedColumnWriter<int64_t, ParseInteger<int64_t>>>(dest, column);
+    case LoadType::FLOAT64:
+      return std::make_unique<FixedColumnWriter<double, ParseDouble>>(dest,
+                                                                      column);
+    case LoadType::DATE:
+      return std::make_unique<FixedColumnWriter<int32_t, ParseDate>>(dest,
+                                                                     column);
+    case LoadType::TEXT: {
+      // Skip the encoding if the same call already loads the ENUM column.
+      bool declared = std::any_of(
+          columns.begin(), columns.end(), [&](const LoadColumn& other) {
+            return other.name == column.name + "_enum";
+          });
+      return std::make_unique<TextColumnWriter>(dest, column, !declared);
+    }
+    case LoadType::ENUM:
+      return std::make_unique<EnumColumnWriter>(dest, column);
+  }
+
+  throw std::runtime_error("Unknown load type.");
+}
+
+// Returns the position after the newline ending the line that contains pos.
+uint64_t NextLine(const MappedFile& file, uint64_t pos) {
+  if (pos >= file.Length()) {
+    return file.Length();
+  }
+
+  auto end = file.Data() + file.Length();
+  auto newline = Find(file.Data() + pos, end, '\n');
+  return newline == end ? file.Length() : newline - file.Data() + 1;
+}
+
+void ParseChunk(const char* begin, const char* end, char delim,
+                const std::vector<LoadColumn>& columns, int num_fields,
+                std::vector<std::unique_ptr<ColumnChunk>>& chunks) {
+  std::vector<std::string_view> fields(num_fields);
+
+  while (begin < end) {
+    auto line_end = Find(begin, end, '\n');
+
+    // Missing trailing fields are empty.
+    auto field_begin = begin;
+    for (int i = 0; i < num_fields; i++) {
+      if (field_begin > line_end) {
+        fields[i] = std::string_view();
+        continue;
+      }
+
+      auto field_end = Find(field_begin, line_end, delim);
+      if (field_end != field_begin && *field_begin == '"') {
+        while (field_end != line_end && KeepGoing(field_begin, field_end)) {
+          field_end = Find(field_end + 1, line_end, delim);
+        }
+      }
+
+      fields[i] = std::string_view(field_begin, field_end - field_begin);
+      field_begin = field_end + 1;
+    }
+
+    for (size_t i = 0; i < columns.size(); i++) {
+      chunks[i]->Add(fields[columns[i].field]);
+    }
+
+    begin = line_end + 1;
+  }
+}
+
+}  // namespace
+
+LoadColumn NotNullColumn(int field, std::string name, LoadType type) {
+  return LoadColumn{field, std::move(name), type, false};
+}
+
+LoadColumn NullColumn(int field, std::string name, LoadType type) {
+  return LoadColumn{field, std::move(name), type, true};
+}
+
+void LoadTable(std::string_view raw, char delim, std::string_view dest,
+               const std::vector<LoadColumn>& columns) {
+  MappedFile file{std::string(raw)};
+
+  int num_fields = 0;
+  std::vector<std::unique_ptr<ColumnWriter>> writers;
+  for (const auto& column : columns) {
+    num_fields = std::max(num_fields, column.field + 1);
+    writers.push_back(MakeWriter(dest, column, columns));
+  }
+
+  const int num_chunks = NumThreads() * CHUNKS_PER_THREAD;
+  for (uint64_t batch_begin = 0; batch_begin < file.Length();) {
+    uint64_t batch_end = NextLine(file, batch_begin + BATCH_SIZE - 1);
+
+    std::vector<uint64_t> bounds{batch_begin};
+    for (int i = 1; i < num_chunks; i++) {
+      bounds.push_back(std::max(
+          bounds.back(),
+          NextLine(file, batch_begin +
+                             (batch_end - batch_begin) * i / num_chunks)));
+    }
+    bounds.push_back(batch_end);
+
+    // chunks[i][j] holds column j of chunk i.
+    std::vector<std::vector<std::unique_ptr<ColumnChunk>>> chunks(num_chunks);
+    ParallelFor(num_chunks, [&](int i) {
+      for (auto& writer : writers) {
+        chunks[i].push_back(writer->NewChunk());
+      }
+      ParseChunk(file.Data() + bounds[i], file.Data() + bounds[i + 1], delim,
+                 columns, num_fields, chunks[i]);
+    });
+
+    ParallelFor(writers.size(), [&](int j) {
+      for (int i = 0; i < num_chunks; i++) {
+        writers[j]->Append(*chunks[i][j]);
+        chunks[i][j].reset();
+      }
+    });
+
+    file.Release(batch_begin, batch_end);
+    batch_begin = batch_end;
+  }
+
+  for (auto& writer : writers) {
+    writer->Finish();
+  }
+}
+
+std::mutex cout_mutex;
+void Print(std::string_view x) {
+  const std::lock_guard<std::mutex> lock(cout_mutex);
+  std::cout << x << std::endl;
+}
+
+}  // namespace kush::util
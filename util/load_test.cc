@@ -0,0 +1,187 @@
+#include "util/load.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "gtest/gtest.h"
+
+#include "runtime/column_data.h"
+#include "runtime/column_index.h"
+#include "runtime/date.h"
+#include "runtime/enum.h"
+#include "runtime/posting_list.h"
+
+ABSL_DECLARE_FLAG(int32_t, max_enum_size);
+
+using namespace kush::util;
+using namespace kush::runtime;
+
+std::vector<int32_t> Values(ColumnIndexBucket* bucket) {
+  std::vector<int32_t> result;
+  for (int i = 0; i < bucket->size; i++) {
+    result.push_back(GetBucketValue(bucket, i));
+  }
+  return result;
+}
+
+std::vector<int32_t> Lookup(const std::string& path, int32_t key) {
+  ColumnIndex::ColumnIndex index;
+  ColumnIndex::Open(&index, path.c_str());
+  int32_t block_values[PostingList::BLOCK_SIZE];
+  ColumnIndexBucket bucket{.block_values = block_values};
+  ColumnIndex::GetInt32(&index, key, &bucket);
+  auto result = Values(&bucket);
+  ColumnIndex::Close(&index);
+  return result;
+}
+
+std::vector<int32_t> Lookup(const std::string& path, std::string_view key) {
+  ColumnIndex::ColumnIndex index;
+  ColumnIndex::Open(&index, path.c_str());
+  String::String key_str;
+  String::Init(&key_str, key.data(), key.size());
+  int32_t block_values[PostingList::BLOCK_SIZE];
+  ColumnIndexBucket bucket{.block_values = block_values};
+  ColumnIndex::GetText(&index, &key_str, &bucket);
+  auto result = Values(&bucket);
+  ColumnIndex::Close(&index);
+  return result;
+}
+
+TEST(LoadTest, LoadsAllColumnTypes) {
+  {
+    std::ofstream raw("/tmp/load_test.tbl");
+    raw << "1|alice|1995-03-15|\n";
+    raw << "2|\"b|o\\\"b\"|2001-12-01|1.5\n";
+    raw << "|alice||2.5\n";
+    raw << "3|a name longer than inline|2001-12-01|3.5\n";
+    raw << "1\n";
+  }
+
+  LoadTable("/tmp/load_test.tbl", '|', "/tmp/",
+            {NullColumn(0, "load_test_id", LoadType::INT32),
+             NotNullColumn(1, "load_test_name", LoadType::TEXT),
+             NullColumn(1, "load_test_enum", LoadType::ENUM),
+             NullColumn(2, "load_test_date", LoadType::DATE),
+             NotNullColumn(3, "load_test_score", LoadType::FLOAT64)});
+
+  ColumnData::Int32ColumnData id;
+  ColumnData::OpenInt32(&id, "/tmp/load_test_id.kdb");
+  ColumnData::Int8ColumnData id_null;
+  ColumnData::OpenInt8(&id_null, "/tmp/load_test_id_null.kdb");
+  ASSERT_EQ(ColumnData::SizeInt32(&id), 5);
+  EXPECT_EQ(ColumnData::GetInt32(&id, 0), 1);
+  EXPECT_EQ(ColumnData::GetInt32(&id, 1), 2);
+  EXPECT_EQ(ColumnData::GetInt8(&id_null, 1), 0);
+  EXPECT_EQ(ColumnData::GetInt8(&id_null, 2), 1);
+  EXPECT_EQ(ColumnData::GetInt32(&id, 4), 1);
+  ColumnData::CloseInt32(&id);
+  ColumnData::CloseInt8(&id_null);
+  EXPECT_EQ(Lookup("/tmp/load_test_id.kdbindex", 1),
+            std::vector<int32_t>({0, 4}));
+
+  ColumnData::TextColumnData name;
+  ColumnData::OpenText(&name, "/tmp/load_test_name.kdb");
+  ASSERT_EQ(ColumnData::SizeText(&name), 5);
+  String::String s;
+  ColumnData::GetText(&name, 1, &s);
+  EXPECT_EQ(String::View(&s), "b|o\"b");
+  ColumnData::GetText(&name, 3, &s);
+  EXPECT_EQ(String::View(&s), "a name longer than inline");
+  ColumnData::GetText(&name, 4, &s);
+  EXPECT_EQ(String::View(&s), "");
+  ColumnData::CloseText(&name);
+  EXPECT_EQ(Lookup("/tmp/load_test_name.kdbindex", "alice"),
+            std::vector<int32_t>({0, 2}));
+  EXPECT_EQ(Lookup("/tmp/load_test_name.kdbindex", ""),
+            std::vector<int32_t>({4}));
+  EXPECT_EQ(Lookup("/tmp/load_test_name.kdbindex", "a name longer than inline"),
+            std::vector<int32_t>({3}));
+
+  // Codes are numbered in sorted order of the values.
+  ColumnData::Int32ColumnData name_enum;
+  ColumnData::OpenInt32(&name_enum, "/tmp/load_test_enum.kdb");
+  EXPECT_EQ(ColumnData::GetInt32(&name_enum, 0), 1);
+  EXPECT_EQ(ColumnData::GetInt32(&name_enum, 1), 2);
+  EXPECT_EQ(ColumnData::GetInt32(&name_enum, 2), 1);
+  EXPECT_EQ(ColumnData::GetInt32(&name_enum, 3), 0);
+  EXPECT_EQ(ColumnData::GetInt32(&name_enum, 4), -1);
+  ColumnData::CloseInt32(&name_enum);
+  auto enum_id = Enum::EnumManager::Get().Register(
+      "/tmp/load_test_enum.kdbenum");
+  EXPECT_EQ(Enum::GetValue(enum_id, "b|o\"b"), 2);
+  EXPECT_EQ(Enum::Size(enum_id), 3);
+  EXPECT_TRUE(Enum::Sorted(enum_id));
+  EXPECT_EQ(Lookup("/tmp/load_test_enum.kdbindex", 1),
+            std::vector<int32_t>({0, 2}));
+
+  // The text column is small enough to also be dictionary encoded.
+  ColumnData::Int32ColumnData name_codes;
+  ColumnData::OpenInt32(&name_codes, "/tmp/load_test_name_enum.kdb");
+  EXPECT_EQ(ColumnData::GetInt32(&name_codes, 0), 2);
+  EXPECT_EQ(ColumnData::GetInt32(&name_codes, 1), 3);
+  EXPECT_EQ(ColumnData::GetInt32(&name_codes, 3), 1);
+  EXPECT_EQ(ColumnData::GetInt32(&name_codes, 4), 0);
+  ColumnData::CloseInt32(&name_codes);
+  auto name_enum_id = Enum::EnumManager::Get().Register(
+      "/tmp/load_test_name_enum.kdbenum");
+  EXPECT_EQ(Enum::GetValue(name_enum_id, "alice"), 2);
+  EXPECT_TRUE(Enum::Sorted(name_enum_id));
+  EXPECT_EQ(Lookup("/tmp/load_test_name_enum.kdbindex", 2),
+            std::vector<int32_t>({0, 2}));
+
+  ColumnData::Int32ColumnData date;
+  ColumnData::OpenInt32(&date, "/tmp/load_test_date.kdb");
+  EXPECT_EQ(ColumnData::GetInt32(&date, 0),
+            Date::DateBuilder(1995, 3, 15).Build());
+  ColumnData::CloseInt32(&date);
+
+  ColumnData::Float64ColumnData score;
+  ColumnData::OpenFloat64(&score, "/tmp/load_test_score.kdb");
+  EXPECT_EQ(ColumnData::GetFloat64(&score, 0), 0);
+  EXPECT_EQ(ColumnData::GetFloat64(&score, 2), 2.5);
+  ColumnData::CloseFloat64(&score);
+}
+
+TEST(LoadTest, SkipsEncodingOfDeclaredEnumColumn) {
+  {
+    std::ofstream raw("/tmp/load_test_declared.tbl");
+    raw << "alice|x\n";
+    raw << "bob|y\n";
+    raw << "carol|y\n";
+  }
+
+  // The text column is written last so an encoding of it would overwrite
+  // the declared column.
+  LoadTable("/tmp/load_test_declared.tbl", '|', "/tmp/",
+            {NotNullColumn(1, "load_test_declared_enum", LoadType::ENUM),
+             NotNullColumn(0, "load_test_declared", LoadType::TEXT)});
+
+  auto enum_id = Enum::EnumManager::Get().Register(
+      "/tmp/load_test_declared_enum.kdbenum");
+  EXPECT_EQ(Enum::Size(enum_id), 2);
+  EXPECT_EQ(Enum::GetValue(enum_id, "y"), 1);
+  EXPECT_EQ(Lookup("/tmp/load_test_declared_enum.kdbindex", 1),
+            std::vector<int32_t>({1, 2}));
+}
+
+TEST(LoadTest, DictionaryEncodingCanBeDisabled) {
+  {
+    std::ofstream raw("/tmp/load_test_plain.tbl");
+    raw << "alice\n";
+    raw << "bob\n";
+  }
+
+  std::remove("/tmp/load_test_plain_name_enum.kdb");
+  absl::SetFlag(&FLAGS_max_enum_size, 0);
+  LoadTable("/tmp/load_test_plain.tbl", '|', "/tmp/",
+            {NotNullColumn(0, "load_test_plain_name", LoadType::TEXT)});
+  absl::SetFlag(&FLAGS_max_enum_size, 1 << 18);
+
+  EXPECT_TRUE(std::ifstream("/tmp/load_test_plain_name.kdb").good());
+  EXPECT_FALSE(std::ifstream("/tmp/load_test_plain_name_enum.kdb").good());
+}
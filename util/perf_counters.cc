@@ -0,0 +1,124 @@
+#include "util/perf_counters.h"
+
+#include <cstdint>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "absl/flags/flag.h"
+
+#include "nlohmann/json.hpp"
+
+ABSL_FLAG(bool, perf_counters, false,
+          "Read hardware performance counters around each pipeline.");
+
+namespace kush::util {
+
+PerfCounterValues& PerfCounterValues::operator+=(
+    const PerfCounterValues& other) {
+  cycles += other.cycles;
+  instructions += other.instructions;
+  llc_misses += other.llc_misses;
+  branch_misses += other.branch_misses;
+  return *this;
+}
+
+PerfCounterValues PerfCounterValues::operator-(
+    const PerfCounterValues& other) const {
+  PerfCounterValues result;
+  result.cycles = cycles - other.cycles;
+  result.instructions = instructions - other.instructions;
+  result.llc_misses = llc_misses - other.llc_misses;
+  result.branch_misses = branch_misses - other.branch_misses;
+  return result;
+}
+
+nlohmann::json PerfCounterValues::ToJson() const {
+  nlohmann::json j;
+  j["cycles"] = cycles;
+  j["instructions"] = instructions;
+  j["llc_misses"] = llc_misses;
+  j["branch_misses"] = branch_misses;
+  if (cycles > 0) {
+    j["ipc"] = static_cast<double>(instructions) / cycles;
+  }
+  if (instructions > 0) {
+    j["llc_misses_per_kilo_instr"] = 1000.0 * llc_misses / instructions;
+    j["branch_misses_per_kilo_instr"] = 1000.0 * branch_misses / instructions;
+  }
+  return j;
+}
+
+int OpenCounter(uint64_t config, int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = group_fd == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  return syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+PerfCounters::PerfCounters() : group_fd_(-1), fds_{-1, -1, -1, -1} {
+  const uint64_t configs[4] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+  for (int i = 0; i < 4; i++) {
+    fds_[i] = OpenCounter(configs[i], group_fd_);
+    if (fds_[i] < 0) {
+      for (int j = 0; j < i; j++) {
+        close(fds_[j]);
+        fds_[j] = -1;
+      }
+      fds_[i] = -1;
+      group_fd_ = -1;
+      return;
+    }
+
+    if (i == 0) {
+      group_fd_ = fds_[0];
+    }
+  }
+
+  ioctl(group_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(group_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounters::~PerfCounters() {
+  for (int i = 3; i >= 0; i--) {
+    if (fds_[i] >= 0) {
+      close(fds_[i]);
+    }
+  }
+}
+
+bool PerfCounters::Valid() const { return group_fd_ >= 0; }
+
+PerfCounterValues PerfCounters::Read() const {
+  PerfCounterValues result;
+  if (group_fd_ < 0) {
+    return result;
+  }
+
+  // PERF_FORMAT_GROUP: the number of counters followed by their values.
+  uint64_t buffer[5];
+  if (read(group_fd_, buffer, sizeof(buffer)) != sizeof(buffer)) {
+    return result;
+  }
+
+  result.cycles = buffer[1];
+  result.instructions = buffer[2];
+  result.llc_misses = buffer[3];
+  result.branch_misses = buffer[4];
+  return result;
+}
+
+bool PerfCountersEnabled() { return FLAGS_perf_counters.Get(); }
+
+}  // namespace kush::util
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+#include "nlohmann/json.hpp"
+
+namespace kush::util {
+
+struct PerfCounterValues {
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+  uint64_t llc_misses = 0;
+  uint64_t branch_misses = 0;
+
+  PerfCounterValues& operator+=(const PerfCounterValues& other);
+  PerfCounterValues operator-(const PerfCounterValues& other) const;
+
+  nlohmann::json ToJson() const;
+};
+
+// Hardware counters of the calling thread read in-process through
+// perf_event_open. Counting starts on construction. Valid() is false if the
+// kernel does not allow opening the counters, e.g. due to
+// perf_event_paranoid, in which case all reads are zero.
+class PerfCounters {
+ public:
+  PerfCounters();
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+  ~PerfCounters();
+
+  bool Valid() const;
+  PerfCounterValues Read() const;
+
+ private:
+  int group_fd_;
+  int fds_[4];
+};
+
+bool PerfCountersEnabled();
+
+}  // namespace kush::util
@@ -0,0 +1,138 @@
+#include "util/query_stats.h"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "absl/flags/flag.h"
+
+#include "nlohmann/json.hpp"
+
+ABSL_FLAG(std::string, query_stats, "",
+          "Path to append per query compilation and execution statistics to "
+          "as JSON lines. Disabled if empty.");
+
+namespace kush::util {
+
+bool QueryStats::Enabled() const {
+  return !FLAGS_query_stats.CurrentValue().empty();
+}
+
+void QueryStats::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  phases_.clear();
+  functions_.clear();
+  pipelines_.clear();
+}
+
+void QueryStats::AddPhaseTime(std::string_view phase, double ms) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& [name, total] : phases_) {
+    if (name == phase) {
+      total += ms;
+      return;
+    }
+  }
+  phases_.emplace_back(std::string(phase), ms);
+}
+
+void QueryStats::SetInstructionCount(std::string_view backend,
+                                     std::string_view func,
+                                     int64_t num_instrs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  functions_[{std::string(backend), std::string(func)}].num_instrs =
+      num_instrs;
+}
+
+void QueryStats::SetCodeSize(std::string_view backend, std::string_view func,
+                             int64_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  functions_[{std::string(backend), std::string(func)}].code_size = bytes;
+}
+
+void QueryStats::AddPipeline(
+    int id, double ms, int64_t num_tuples,
+    std::map<std::string, PerfCounterValues> counters) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pipelines_.push_back({id, ms, num_tuples, std::move(counters)});
+}
+
+nlohmann::json QueryStats::ToJson() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  nlohmann::json j;
+  j["phases"] = nlohmann::json::object();
+  for (const auto& [name, ms] : phases_) {
+    j["phases"][name] = ms;
+  }
+
+  j["functions"] = nlohmann::json::array();
+  for (const auto& [key, stats] : functions_) {
+    nlohmann::json f;
+    f["backend"] = key.first;
+    f["name"] = key.second;
+    if (stats.num_instrs >= 0) {
+      f["instructions"] = stats.num_instrs;
+    }
+    if (stats.code_size >= 0) {
+      f["code_size"] = stats.code_size;
+    }
+    j["functions"].push_back(f);
+  }
+
+  j["pipelines"] = nlohmann::json::array();
+  for (const auto& pipeline : pipelines_) {
+    nlohmann::json p;
+    p["id"] = pipeline.id;
+    p["time"] = pipeline.ms;
+    if (pipeline.num_tuples >= 0) {
+      p["tuples"] = pipeline.num_tuples;
+    }
+    for (const auto& [tier, values] : pipeline.counters) {
+      p["counters"][tier] = values.ToJson();
+    }
+    j["pipelines"].push_back(p);
+  }
+
+  return j;
+}
+
+void QueryStats::Write(const nlohmann::json& plan) const {
+  nlohmann::json j;
+  j["plan"] = plan;
+  j["stats"] = ToJson();
+
+  // One line per statement so that a run of several queries keeps all of
+  // them.
+  std::ofstream fout(FLAGS_query_stats.CurrentValue(),
+                     std::ofstream::out | std::ofstream::app);
+  if (!fout) {
+    throw std::runtime_error("Unable to open query stats file.");
+  }
+  fout << j.dump() << std::endl;
+}
+
+PhaseTimer::PhaseTimer(std::string_view phase)
+    : phase_(phase), enabled_(QueryStats::Get().Enabled()) {
+  if (enabled_) {
+    start_ = std::chrono::steady_clock::now();
+  }
+}
+
+PhaseTimer::~PhaseTimer() { Stop(); }
+
+void PhaseTimer::Stop() {
+  if (enabled_) {
+    std::chrono::duration<double, std::milli> duration =
+        std::chrono::steady_clock::now() - start_;
+    QueryStats::Get().AddPhaseTime(phase_, duration.count());
+    enabled_ = false;
+  }
+}
+
+}  // namespace kush::util
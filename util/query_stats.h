@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+#include "util/perf_counters.h"
+
+namespace kush::util {
+
+// Collects the time spent in each compilation phase, the size of each
+// generated function and the execution time of each pipeline of a query.
+// Enabled by setting --query_stats to the path of the output file.
+class QueryStats {
+ private:
+  QueryStats() = default;
+
+ public:
+  QueryStats(QueryStats const&) = delete;
+  void operator=(QueryStats const&) = delete;
+
+  static QueryStats& Get() {
+    static QueryStats instance;
+    return instance;
+  }
+
+  bool Enabled() const;
+  void Reset();
+
+  void AddPhaseTime(std::string_view phase, double ms);
+  void SetInstructionCount(std::string_view backend, std::string_view func,
+                           int64_t num_instrs);
+  void SetCodeSize(std::string_view backend, std::string_view func,
+                   int64_t bytes);
+  // Counters are the hardware counters of the body calls by backend tier.
+  void AddPipeline(int id, double ms, int64_t num_tuples,
+                   std::map<std::string, PerfCounterValues> counters = {});
+
+  nlohmann::json ToJson() const;
+
+  // Appends the plan and the collected statistics as a single line to the
+  // --query_stats file.
+  void Write(const nlohmann::json& plan) const;
+
+ private:
+  struct FunctionStats {
+    int64_t num_instrs = -1;
+    int64_t code_size = -1;
+  };
+
+  struct PipelineStats {
+    int id;
+    double ms;
+    int64_t num_tuples;
+    std::map<std::string, PerfCounterValues> counters;
+  };
+
+  mutable std::mutex mutex_;
+  std::vector<std::pair<std::string, double>> phases_;
+  std::map<std::pair<std::string, std::string>, FunctionStats> functions_;
+  std::vector<PipelineStats> pipelines_;
+};
+
+// Adds the time from construction to destruction, or to Stop, to the given
+// phase. Phases run on several threads are summed.
+class PhaseTimer {
+ public:
+  explicit PhaseTimer(std::string_view phase);
+  ~PhaseTimer();
+
+  void Stop();
+
+ private:
+  std::string_view phase_;
+  bool enabled_;
+  std::chrono::time_point<std::chrono::steady_clock> start_;
+};
+
+}  // namespace kush::util
@@ -0,0 +1,44 @@
+#include "util/query_stats.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "gtest/gtest.h"
+
+#include "nlohmann/json.hpp"
+
+ABSL_DECLARE_FLAG(std::string, query_stats);
+
+using namespace kush::util;
+
+TEST(QueryStatsTest, AppendsEveryQuery) {
+  auto path = testing::TempDir() + "query_stats_test.json";
+  std::remove(path.c_str());
+  absl::SetFlag(&FLAGS_query_stats, path);
+
+  auto& stats = QueryStats::Get();
+  for (int i = 0; i < 3; i++) {
+    stats.AddPipeline(i, 1.5, 10 * i);
+    stats.Write(nlohmann::json{{"query", i}});
+    stats.Reset();
+  }
+
+  std::vector<nlohmann::json> lines;
+  std::ifstream fin(path);
+  for (std::string line; std::getline(fin, line);) {
+    lines.push_back(nlohmann::json::parse(line));
+  }
+
+  ASSERT_EQ(lines.size(), 3);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(lines[i]["plan"]["query"], i);
+    ASSERT_EQ(lines[i]["stats"]["pipelines"].size(), 1);
+    EXPECT_EQ(lines[i]["stats"]["pipelines"][0]["id"], i);
+    EXPECT_EQ(lines[i]["stats"]["pipelines"][0]["tuples"], 10 * i);
+  }
+
+  absl::SetFlag(&FLAGS_query_stats, "");
+}
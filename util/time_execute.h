@@ -13,6 +13,7 @@
 #include "khir/llvm/llvm_backend.h"
 #include "plan/operator/output_operator.h"
 #include "util/profiler.h"
+#include "util/query_stats.h"
 #include "util/test_util.h"
 
 ABSL_FLAG(int, num_trials, 5, "Number of benchmark trials");
@@ -25,6 +26,13 @@ void TimeExecute(kush::plan::Operator& query) {
     executable_query.Execute();
   }
 
+  // Statistics of the first execution, including any parse and plan time
+  // recorded by the caller.
+  if (QueryStats::Get().Enabled()) {
+    QueryStats::Get().Write(query.ToJson());
+  }
+  QueryStats::Get().Reset();
+
 #if PROFILE_ENABLED
   Profiler::profile([&]() {
     auto start = std::chrono::system_clock::now();
@@ -37,7 +45,6 @@ void TimeExecute(kush::plan::Operator& query) {
 #else
   for (int i = 0; i < FLAGS_num_trials.Get(); i++) {
 #ifdef COMP_TIME
-    khir::ASMBackend::ResetCompilationTime();
     khir::LLVMBackend::ResetCompilationTime();
 #endif
 
@@ -48,7 +55,8 @@ void TimeExecute(kush::plan::Operator& query) {
     std::chrono::duration<double, std::milli> duration = end - start;
     std::cerr << duration.count();
 #ifdef COMP_TIME
-    std::cerr << ' ' << khir::ASMBackend::CompilationTime() << ' '
+    std::cerr << ' ' << executable_query.ASMCompilationTime() << ' '
+              << executable_query.ASMOptimizationTime() << ' '
               << khir::LLVMBackend::CompilationTime();
 #endif
     std::cerr << std::endl;